@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include "CellFactory.hh"
+#include "Cell_Utils.hh"
+#include "EnvironmentSettings.hh"
+#include "RandomCellDistribution.hh"
+#include "RandomEngineManager.hh"
+#include "RoundCellProperties.hh"
+#include "SimpleSpheroidalCell.hh"
+#include "SpheresSDelimitation.hh"
+#include "UnitSystemManager.hh"
+
+#include <CLHEP/Random/MTwistEngine.h>
+
+#include <cmath>
+#include <map>
+
+// Cells per second of RandomCellDistribution::distribute for a spheroid of the given number of cells.
+// Mode 0 : cells created and added one by one
+// Mode 1 : positions generated in batch and cells added in one insertion
+// Mode 2 : as mode 1 with a minimal distance between cell centers
+
+using namespace Settings::nCell;
+using namespace Settings::nEnvironment;
+
+namespace {
+
+enum Mode { ONE_BY_ONE = 0, BULK = 1, BULK_MINIMAL_DISTANCE = 2 };
+
+RoundCellProperties* makeCellProperties() {
+	double micrometer = UnitSystemManager::getInstance()->getMetricUnit(UnitSystemManager::Micrometer);
+	double nanogram = UnitSystemManager::getInstance()->getWeightUnit(UnitSystemManager::Nanogram);
+
+	auto* cellProperties = new RoundCellProperties();
+	cellProperties->automaticFill(
+		CellVariableAttribute<double>(8.*micrometer, 10.*micrometer),
+		CellVariableAttribute<double>(1.*nanogram, 1.*nanogram),
+		CellVariableAttribute<double>(4.*micrometer, 6.*micrometer),
+		BARYCENTER, nullptr, nullptr
+	);
+	return cellProperties;
+}
+
+/// \brief radius of the spheroid holding nbCell cells of 10 micrometers with a 0.6 packing
+double spheroidRadius(std::size_t pNbCell) {
+	double micrometer = UnitSystemManager::getInstance()->getMetricUnit(UnitSystemManager::Micrometer);
+	return 10.*micrometer * std::cbrt(pNbCell / 0.6);
+}
+
+}
+
+static void BM_RandomCellDistribution(benchmark::State& state) {
+	CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	const auto nbCell = static_cast<unsigned int>(state.range(0));
+	const auto mode = static_cast<Mode>(state.range(1));
+	double micrometer = UnitSystemManager::getInstance()->getMetricUnit(UnitSystemManager::Micrometer);
+
+	RoundCellProperties* cellProperties = makeCellProperties();
+	std::map<LifeCycles::LifeCycle, double> rates = Utils::generateUniformLifeCycle();
+
+	RandomCellDistribution<double, Point_3, Vector_3> distribution;
+	distribution.setBulk(mode != ONE_BY_ONE);
+	if(mode == BULK_MINIMAL_DISTANCE)
+		distribution.setMinimalDistance(8.*micrometer);
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto* env = new t_Environment_3("main Environment");
+		auto* delimitation = new SpheresSDelimitation(0., spheroidRadius(nbCell), Point_3(0., 0., 0.));
+		auto* subEnv = new t_SimulatedSubEnv_3(env, "MySimulatedSubEnv", static_cast<t_SpatialDelimitation_3*>(delimitation));
+		state.ResumeTiming();
+
+		distribution.distribute(subEnv, cellProperties, nbCell, rates);
+		benchmark::DoNotOptimize(subEnv->getNbAgent());
+
+		state.PauseTiming();
+		delete env;
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(state.iterations()*nbCell);
+	delete cellProperties;
+}
+BENCHMARK(BM_RandomCellDistribution)
+	->ArgsProduct({{1 << 10, 1 << 14, 100000}, {ONE_BY_ONE, BULK, BULK_MINIMAL_DISTANCE}})
+	->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
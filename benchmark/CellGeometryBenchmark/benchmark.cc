@@ -0,0 +1,233 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkPopulation.hh"
+
+#include "EnvironmentSettings.hh"
+#include "Geometry_Utils_Sphere.hh"
+#include "Population.hh"
+#include "RandomEngineManager.hh"
+#include "SteppingAction.hh"
+#include "UnitSystemManager.hh"
+
+#include "G4Box.hh"
+#include "G4GeometryManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4TouchableHistory.hh"
+
+#include <CLHEP/Random/MTwistEngine.h>
+
+#include <sys/resource.h>
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Cost of finding the cell and organelle of energy deposits for 1k, 10k and 50k cells.
+// Lookup : octree of sampled cells and SpheroidalCell::hasIn, as done by SteppingAction by default
+// Geometry : cells placed as Geant4 volumes, the cell is read from the touchable found by the navigator
+// Each deposit is a uniform point in the spheroid, the rate is given in deposits per second.
+// The rss_MB counter is the resident memory increase of building each representation.
+// ConvertToG4 : resident memory added by converting a 20k cells population to Geant4 volumes,
+// with a new solid per shape (0), shared solids (1), shared solids and freed CGAL meshes (2).
+// The peak (VmHWM) is reset to the current resident memory before each conversion (Linux /proc/self/clear_refs),
+// rss_delta_MB is the peak reached during the conversion minus the resident memory before it.
+// LoadPopulation : loading a 20k cells population and defining its regions with 10 sampled cells per region,
+// meshing every cell (0) or only the sampled ones (1).
+
+using namespace Settings::nCell;
+using namespace Settings::nEnvironment;
+
+namespace {
+
+constexpr std::size_t nbDeposit = 1 << 14;
+
+double residentMemoryMB() {
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024.;
+}
+
+/// \brief return a memory field of /proc/self/status (VmRSS, VmHWM...) in MB, -1 if unavailable
+double procStatusMB(std::string const& pField) {
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while(std::getline(status, line)) {
+		if(line.compare(0, pField.size() + 1, pField + ":") == 0)
+			return std::stod(line.substr(pField.size() + 1)) / 1024.;
+	}
+	return -1.;
+}
+
+/// \brief reset the peak resident memory to the current one, return false if not supported
+bool resetPeakResidentMemory() {
+	std::ofstream clearRefs("/proc/self/clear_refs");
+	clearRefs << "5";
+	clearRefs.flush();
+	return clearRefs.good();
+}
+
+struct Setup {
+	cpop::Population population;
+	std::vector<Point_3> deposits;                ///< \brief deposits in CPOP unit
+	std::unique_ptr<cpop::SteppingAction> lookup;
+	G4VPhysicalVolume* world = nullptr;
+	double lookupMemory = 0.;
+	double geometryMemory = 0.;
+};
+
+Setup& getSetup(unsigned int pNbCell) {
+	static std::map<unsigned int, std::unique_ptr<Setup>> setups;
+	auto& setup = setups[pNbCell];
+	if(setup)
+		return *setup;
+
+	static CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	setup = std::make_unique<Setup>();
+	cpop::Population& population = setup->population;
+	population.setPopulation_file(BenchmarkPopulation::getPopulationFile(pNbCell));
+	population.setNumber_max_facet_poly(100);
+	population.setDelta_reffinement(0);
+	population.loadPopulation();
+	population.setInternal_layer_ratio(0.25);
+	population.setIntermediary_layer_ratio(0.75);
+	population.defineRegion();
+
+	double radius = population.spheroid_radius()*UnitSystemManager::getInstance()->getConversionFromG4();
+	Utils::Geometry::Sphere::getSpotsOnSphere(nbDeposit, radius, Point_3(0., 0., 0.), setup->deposits);
+
+	double memory = residentMemoryMB();
+	setup->lookup = std::make_unique<cpop::SteppingAction>(population);
+	setup->lookup->findCell(setup->deposits.front()); // build the octree
+	setup->lookupMemory = residentMemoryMB() - memory;
+
+	memory = residentMemoryMB();
+	double worldSize = 2.*population.spheroid_radius();
+	auto* solidWorld = new G4Box("sWorld", worldSize, worldSize, worldSize);
+	auto* logicWorld = new G4LogicalVolume(solidWorld, G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER"), "LV_World");
+	setup->world = new G4PVPlacement(G4Transform3D(), logicWorld, "PV_World", nullptr, false, 0, false);
+	population.placeCellsInG4(logicWorld);
+	setup->geometryMemory = residentMemoryMB() - memory;
+
+	return *setup;
+}
+
+}
+
+static void BM_FindCell_Lookup(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+
+	for(auto _ : state) {
+		std::size_t nbInNucleus = 0;
+		for(auto const& deposit : setup.deposits) {
+			auto const* cell = setup.lookup->findCell(deposit);
+			if(cell && cell->hasIn(deposit))
+				nbInNucleus += setup.population.locate(cell, deposit).in_nucleus();
+		}
+		benchmark::DoNotOptimize(nbInNucleus);
+	}
+
+	state.SetItemsProcessed(state.iterations()*setup.deposits.size());
+	state.counters["rss_MB"] = setup.lookupMemory;
+}
+BENCHMARK(BM_FindCell_Lookup)->Arg(1000)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+static void BM_FindCell_G4Geometry(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	const cpop::Population& population = setup.population;
+	double convertionToG4 = UnitSystemManager::getInstance()->getConversionToG4();
+
+	// the smart voxels are built when closing the geometry
+	G4GeometryManager::GetInstance()->OpenGeometry();
+	G4GeometryManager::GetInstance()->CloseGeometry(true, false, setup.world);
+
+	G4Navigator navigator;
+	navigator.SetWorldVolume(setup.world);
+	G4TouchableHistory touchable;
+
+	for(auto _ : state) {
+		std::size_t nbInNucleus = 0;
+		for(auto const& deposit : setup.deposits) {
+			G4ThreeVector position(deposit.x()*convertionToG4, deposit.y()*convertionToG4, deposit.z()*convertionToG4);
+			navigator.LocateGlobalPointAndUpdateTouchable(position, &touchable, false);
+
+			cpop::CellLocation location = population.locate(&touchable);
+			if(location.in_cell() && population.cell_tag(location.cell_index).sampled)
+				nbInNucleus += location.in_nucleus();
+		}
+		benchmark::DoNotOptimize(nbInNucleus);
+	}
+
+	state.SetItemsProcessed(state.iterations()*setup.deposits.size());
+	state.counters["rss_MB"] = setup.geometryMemory;
+}
+BENCHMARK(BM_FindCell_G4Geometry)->Arg(1000)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+static void BM_ConvertToG4(benchmark::State& state) {
+	static CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	auto nbCell = static_cast<unsigned int>(state.range(0));
+	std::string populationFile = BenchmarkPopulation::getPopulationFile(nbCell);
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		cpop::Population population;
+		population.setPopulation_file(populationFile);
+		population.setNumber_max_facet_poly(100);
+		population.setDelta_reffinement(0);
+		population.loadPopulation();
+		population.setShare_g4_solids(state.range(1) > 0);
+
+		double worldSize = 2.*population.spheroid_radius();
+		auto* solidWorld = new G4Box("sWorld", worldSize, worldSize, worldSize);
+		auto* logicWorld = new G4LogicalVolume(solidWorld, G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER"), "LV_World");
+		if(!resetPeakResidentMemory()) {
+			state.SkipWithError("the peak resident memory can't be reset");
+			break;
+		}
+		double rssBefore = procStatusMB("VmRSS");
+		state.ResumeTiming();
+
+		population.placeCellsInG4(logicWorld, 0, false, state.range(1) > 1);
+
+		state.PauseTiming();
+		double rssPeak = procStatusMB("VmHWM");
+		state.counters["rss_before_MB"] = rssBefore;
+		state.counters["rss_peak_MB"] = rssPeak;
+		state.counters["rss_delta_MB"] = rssPeak - rssBefore;
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(BM_ConvertToG4)->Args({20000, 0})->Args({20000, 1})->Args({20000, 2})->Iterations(1)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadPopulation(benchmark::State& state) {
+	static CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	std::string populationFile = BenchmarkPopulation::getPopulationFile(static_cast<unsigned int>(state.range(0)));
+
+	for(auto _ : state) {
+		cpop::Population population;
+		population.setPopulation_file(populationFile);
+		population.setNumber_max_facet_poly(100);
+		population.setDelta_reffinement(0);
+		population.setLazy_meshing(state.range(1) > 0);
+		population.setInternal_layer_ratio(0.25);
+		population.setIntermediary_layer_ratio(0.75);
+		population.setNumber_sampling_cell_per_region(10);
+		population.loadPopulation();
+		population.defineRegion();
+
+		state.counters["meshed_cells"] = static_cast<double>(population.lazy_meshing() ? population.nb_meshed_cells() : population.cells().size());
+	}
+}
+BENCHMARK(BM_LoadPopulation)->Args({20000, 0})->Args({20000, 1})->Iterations(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
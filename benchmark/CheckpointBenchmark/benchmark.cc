@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+
+#include "Cell_Utils.hh"
+#include "EnvironmentSettings.hh"
+#include "File_CPOP_Checkpoint.hh"
+#include "RandomCellDistribution.hh"
+#include "RandomEngineManager.hh"
+#include "RoundCellProperties.hh"
+#include "SpheresSDelimitation.hh"
+#include "UnitSystemManager.hh"
+
+#include <CLHEP/Random/MTwistEngine.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+
+// Write and read time of a binary checkpoint of a spheroid of the given number of cells.
+// The cells are distributed at random once per size, the checkpoint only stores their state.
+
+using namespace Settings::nCell;
+using namespace Settings::nEnvironment;
+
+namespace {
+
+struct Setup {
+	t_Environment_3* env = nullptr;
+	t_SimulatedSubEnv_3* subEnv = nullptr;
+	std::string path;
+
+	~Setup() {
+		delete env;
+		std::remove(path.c_str());
+	}
+};
+
+Setup& getSetup(unsigned int pNbCell) {
+	static std::map<unsigned int, std::unique_ptr<Setup>> setups;
+	auto itSetup = setups.find(pNbCell);
+	if(itSetup != setups.end())
+		return *itSetup->second;
+
+	static CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+	double micrometer = UnitSystemManager::getInstance()->getMetricUnit(UnitSystemManager::Micrometer);
+	double nanogram = UnitSystemManager::getInstance()->getWeightUnit(UnitSystemManager::Nanogram);
+
+	RoundCellProperties cellProperties;
+	cellProperties.automaticFill(
+		CellVariableAttribute<double>(8.*micrometer, 10.*micrometer),
+		CellVariableAttribute<double>(1.*nanogram, 1.*nanogram),
+		CellVariableAttribute<double>(4.*micrometer, 6.*micrometer),
+		BARYCENTER, nullptr, nullptr
+	);
+	std::map<LifeCycles::LifeCycle, double> rates = Utils::generateUniformLifeCycle();
+
+	auto setup = std::make_unique<Setup>();
+	setup->env = new t_Environment_3("main Environment");
+	// 10 micrometers cells with a 0.6 packing
+	auto* delimitation = new SpheresSDelimitation(0., 10.*micrometer*std::cbrt(pNbCell/0.6), Point_3(0., 0., 0.));
+	setup->subEnv = new t_SimulatedSubEnv_3(setup->env, "MySimulatedSubEnv", static_cast<t_SpatialDelimitation_3*>(delimitation));
+	setup->path = "benchmark_checkpoint_" + std::to_string(pNbCell) + ".ckpt";
+
+	RandomCellDistribution<double, Point_3, Vector_3> distribution;
+	distribution.setBulk(true);
+	distribution.distribute(setup->subEnv, &cellProperties, pNbCell, rates);
+
+	return *setups.emplace(pNbCell, std::move(setup)).first->second;
+}
+
+double fileSize(std::string const& pPath) {
+	std::ifstream file(pPath, std::ios::binary | std::ios::ate);
+	return static_cast<double>(file.tellg());
+}
+
+}
+
+static void BM_SaveCheckpoint(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+
+	for(auto _ : state) {
+		if(!IO::CPOP::saveCheckpoint(setup.subEnv, setup.path)) {
+			state.SkipWithError("can't write the checkpoint");
+			break;
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations()*state.range(0));
+	state.counters["bytes"] = fileSize(setup.path);
+}
+BENCHMARK(BM_SaveCheckpoint)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadCheckpoint(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	if(!IO::CPOP::saveCheckpoint(setup.subEnv, setup.path)) {
+		state.SkipWithError("can't write the checkpoint");
+		return;
+	}
+
+	for(auto _ : state) {
+		if(!IO::CPOP::loadCheckpoint(setup.subEnv, setup.path)) {
+			state.SkipWithError("can't read the checkpoint");
+			break;
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations()*state.range(0));
+}
+BENCHMARK(BM_LoadCheckpoint)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
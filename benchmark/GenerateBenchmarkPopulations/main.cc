@@ -0,0 +1,36 @@
+#include "BenchmarkPopulation.hh"
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Generate the populations used by the benchmarks, so their generation is not part of a benchmark run.
+// Usage : GenerateBenchmarkPopulations [nbCell...], the sizes of CPOP_BENCHMARK_SIZES (1000 and 10000 by default)
+// are generated if none is given. Files are written in CPOP_BENCHMARK_DATA (working directory by default)
+// and always regenerated.
+
+int main(int argc, char** argv) {
+	std::vector<int64_t> sizes;
+	for(int iArg = 1; iArg < argc; ++iArg) {
+		try {
+			sizes.push_back(std::stoll(argv[iArg]));
+		} catch(std::exception const&) {
+			std::cerr << "invalid number of cells : " << argv[iArg] << std::endl;
+			return 1;
+		}
+	}
+	if(sizes.empty())
+		sizes = BenchmarkPopulation::getPopulationSizes({1000, 10000});
+
+	for(int64_t size : sizes) {
+		if(size <= 0) {
+			std::cerr << "invalid number of cells : " << size << std::endl;
+			return 1;
+		}
+		std::cout << "generating " << size << " cells ... " << std::flush;
+		std::cout << BenchmarkPopulation::generatePopulationFile(static_cast<unsigned int>(size)) << std::endl;
+	}
+	return 0;
+}
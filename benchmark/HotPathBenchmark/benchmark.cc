@@ -0,0 +1,229 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkPopulation.hh"
+
+#include "CPOP_Loader.hh"
+#include "CPOP_UserSpectrum.hh"
+#include "DistributedSource.hh"
+#include "EnvironmentSettings.hh"
+#include "Geometry_Utils_Sphere.hh"
+#include "LinearOctree.hh"
+#include "MeshFactory.hh"
+#include "Population.hh"
+#include "RandomEngineManager.hh"
+#include "SpheroidalCell.hh"
+#include "SpheroidalCellMesh.hh"
+#include "UnitSystemManager.hh"
+
+#include <CLHEP/Random/MTwistEngine.h>
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Hot paths of a CPOP run for 1k and 10k cells (CPOP_BENCHMARK_SIZES).
+// HasIn : SpheroidalCell::hasIn for a point close to each sampled cell.
+// OctreeNearest : LinearOctree::getNearestSpatialableAgent for uniform points in the spheroid, as done by SteppingAction.
+// GenerateMesh : SpheroidalCellMesh::generateMesh, the population is loaded out of the timing.
+// LoadPopulation : parsing of the population file by CPOP_Loader.
+// DistributedSourceInit : DistributedSource::Initialize, sources distributed in the three regions.
+// UserSpectrumSampling : CPOP_UserSpectrum::GetEnergy for discrete, histogram and interpolated spectra.
+// Rates are given in items per second (points, cells or energies).
+
+using namespace Settings::nCell;
+using namespace Settings::nEnvironment;
+
+namespace {
+
+constexpr std::size_t nbPoint = 1 << 14;
+constexpr std::size_t nbEnergy = 1 << 16;
+
+struct Setup {
+	cpop::Population population;
+	std::vector<Point_3> points;                  ///< \brief uniform points in the spheroid, in CPOP unit
+};
+
+Setup& getSetup(unsigned int pNbCell) {
+	static std::map<unsigned int, std::unique_ptr<Setup>> setups;
+	auto& setup = setups[pNbCell];
+	if(setup)
+		return *setup;
+
+	static CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	setup = std::make_unique<Setup>();
+	cpop::Population& population = setup->population;
+	population.setPopulation_file(BenchmarkPopulation::getPopulationFile(pNbCell));
+	population.setVerbose_level(0);
+	population.setNumber_max_facet_poly(100);
+	population.setDelta_reffinement(0);
+	population.loadPopulation();
+	population.setInternal_layer_ratio(0.25);
+	population.setIntermediary_layer_ratio(0.75);
+	population.defineRegion();
+
+	double radius = population.spheroid_radius()*UnitSystemManager::getInstance()->getConversionFromG4();
+	Utils::Geometry::Sphere::getSpotsOnSphere(nbPoint, radius, Point_3(0., 0., 0.), setup->points);
+	return *setup;
+}
+
+/// \brief write a spectrum of nbBin energies between 1 keV and 1 MeV, in the CPOP_UserSpectrum format
+std::string writeSpectrum(int pMode, int pNbBin) {
+	std::string path = "benchmark_spectrum_" + std::to_string(pMode) + "_" + std::to_string(pNbBin) + ".spec";
+	std::ofstream file(path, std::ios::trunc);
+	file << pNbBin << " " << pMode << " 0.001\n";
+	for(int iBin = 1; iBin <= pNbBin; ++iBin)
+		file << 0.001 + iBin*(1. - 0.001)/pNbBin << " " << 1. + (iBin % 7) << "\n";
+	return path;
+}
+
+}
+
+static void BM_HasIn(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	auto const& cells = setup.population.sampled_cells();
+
+	// half of the points are inside their cell
+	std::vector<Point_3> points;
+	points.reserve(cells.size());
+	for(std::size_t iCell = 0; iCell < cells.size(); ++iCell) {
+		auto const* cell = dynamic_cast<const SpheroidalCell*>(cells[iCell]);
+		double offset = (iCell % 2 ? 2. : 0.5)*(cell ? cell->getRadius() : 0.);
+		points.push_back(cells[iCell]->getPosition() + Vector_3(offset, 0., 0.));
+	}
+
+	for(auto _ : state) {
+		std::size_t nbIn = 0;
+		for(std::size_t iCell = 0; iCell < cells.size(); ++iCell)
+			nbIn += cells[iCell]->hasIn(points[iCell]);
+		benchmark::DoNotOptimize(nbIn);
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()*cells.size()));
+}
+BENCHMARK(BM_HasIn)->Apply(BenchmarkPopulation::applyPopulationSizes<1000, 10000>)->Unit(benchmark::kMicrosecond);
+
+static void BM_OctreeNearest(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	auto const& cells = setup.population.sampled_cells();
+	std::vector<const Settings::nAgent::t_SpatialableAgent_3*> spatialables(cells.begin(), cells.end());
+
+	LinearOctree octree;
+	octree.build(spatialables.begin(), spatialables.end());
+
+	for(auto _ : state) {
+		for(auto const& point : setup.points)
+			benchmark::DoNotOptimize(octree.getNearestSpatialableAgent(point));
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()*setup.points.size()));
+}
+BENCHMARK(BM_OctreeNearest)->Apply(BenchmarkPopulation::applyPopulationSizes<1000, 10000>)->Unit(benchmark::kMillisecond);
+
+static void BM_GenerateMesh(benchmark::State& state) {
+	static CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	auto nbCell = static_cast<unsigned int>(state.range(0));
+	std::string populationFile = BenchmarkPopulation::getPopulationFile(nbCell);
+
+	for(auto _ : state) {
+		state.PauseTiming();
+		t_Environment_3* environment;
+		{
+			CPOP_Loader loader;
+			environment = loader.load3DEnvironment(populationFile, true);
+		}
+		int error;
+		std::unique_ptr<SpheroidalCellMesh> mesh(dynamic_cast<SpheroidalCellMesh*>(MeshFactory::getInstance()->create_3DMesh(
+			&error,
+			dynamic_cast<t_SimulatedSubEnv_3*>(environment->getFirstChild()),
+			MeshTypes::Round_Cell_Tesselation,
+			100,
+			0
+		)));
+		state.ResumeTiming();
+
+		benchmark::DoNotOptimize(mesh->generateMesh());
+
+		state.PauseTiming();
+		mesh.reset();
+		delete environment;
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()*nbCell));
+}
+BENCHMARK(BM_GenerateMesh)->Apply(BenchmarkPopulation::applyPopulationSizes<1000, 10000>)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadPopulation(benchmark::State& state) {
+	auto nbCell = static_cast<unsigned int>(state.range(0));
+	std::string populationFile = BenchmarkPopulation::getPopulationFile(nbCell);
+
+	for(auto _ : state) {
+		t_Environment_3* environment;
+		{
+			CPOP_Loader loader;
+			environment = loader.load3DEnvironment(populationFile, true);
+		}
+		benchmark::DoNotOptimize(environment);
+
+		state.PauseTiming();
+		delete environment;
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()*nbCell));
+}
+BENCHMARK(BM_LoadPopulation)->Apply(BenchmarkPopulation::applyPopulationSizes<1000, 10000>)->Unit(benchmark::kMillisecond);
+
+static void BM_DistributedSourceInit(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	int nbSourcePerRegion = static_cast<int>(state.range(0));
+
+	// a source is only initialized once, a new one is built at each iteration
+	for(auto _ : state) {
+		state.PauseTiming();
+		auto source = std::make_unique<cpop::DistributedSource>("benchmark", setup.population);
+		source->setNumber_particles_per_source(1);
+		source->setNumber_source(3*nbSourcePerRegion);
+		source->setNumber_source_necrosis(nbSourcePerRegion);
+		source->setNumber_source_intermediary(nbSourcePerRegion);
+		source->setNumber_source_external(nbSourcePerRegion);
+		source->setMax_number_source_per_cell_necrosis(100);
+		source->setMax_number_source_per_cell_intermediary(100);
+		source->setMax_number_source_per_cell_external(100);
+		source->setCell_Labeling_Percentage_necrosis(100.);
+		source->setCell_Labeling_Percentage_intermediary(100.);
+		source->setCell_Labeling_Percentage_external(100.);
+		source->setOrganelle_weight(0.25, 0.25, 0.25, 0.25);
+		state.ResumeTiming();
+
+		source->Initialize();
+
+		state.PauseTiming();
+		source.reset();
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()*3*nbSourcePerRegion));
+}
+BENCHMARK(BM_DistributedSourceInit)->Apply(BenchmarkPopulation::applyPopulationSizes<1000, 10000>)->Unit(benchmark::kMillisecond);
+
+// first argument : mode of the spectrum (1 discrete, 2 histogram, 3 interpolated), second one : number of energies
+static void BM_UserSpectrumSampling(benchmark::State& state) {
+	CPOP_UserSpectrum spectrum(writeSpectrum(static_cast<int>(state.range(0)), static_cast<int>(state.range(1))));
+
+	for(auto _ : state) {
+		for(std::size_t iEnergy = 0; iEnergy < nbEnergy; ++iEnergy)
+			benchmark::DoNotOptimize(spectrum.GetEnergy());
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()*nbEnergy));
+}
+BENCHMARK(BM_UserSpectrumSampling)->Args({1, 100})->Args({1, 10000})->Args({2, 100})->Args({2, 10000})->Args({3, 100})->Args({3, 10000})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include "IDManager.hh"
+
+// Allocation of 10^7 IDs shared between the benchmark threads.
+// Each thread either requests its IDs one by one from the shared counter
+// or reserves ranges of IDs and takes its IDs from them.
+
+namespace {
+
+constexpr unsigned long int nbID = 10000000;
+
+}
+
+static void BM_IDManager_GetID(benchmark::State& state) {
+	auto* manager = IDManager::getInstance();
+	const unsigned long int nbIDPerThread = nbID / state.threads();
+	for(auto _ : state) {
+		unsigned long int lastID = 0;
+		for(unsigned long int iID = 0; iID < nbIDPerThread; ++iID)
+			lastID = manager->getID();
+		benchmark::DoNotOptimize(lastID);
+	}
+	state.SetItemsProcessed(state.iterations()*nbIDPerThread);
+}
+BENCHMARK(BM_IDManager_GetID)->ThreadRange(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_IDManager_ReservedRange(benchmark::State& state) {
+	auto* manager = IDManager::getInstance();
+	const unsigned long int nbIDPerThread = nbID / state.threads();
+	const auto rangeSize = static_cast<unsigned long int>(state.range(0));
+	for(auto _ : state) {
+		unsigned long int lastID = 0;
+		IDRange range{0, 0};
+		for(unsigned long int iID = 0; iID < nbIDPerThread; ++iID) {
+			if(range.empty())
+				range = manager->reserveIDs(rangeSize);
+			lastID = range.next();
+		}
+		benchmark::DoNotOptimize(lastID);
+	}
+	state.SetItemsProcessed(state.iterations()*nbIDPerThread);
+}
+BENCHMARK(BM_IDManager_ReservedRange)->Arg(64)->Arg(4096)->ThreadRange(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_IDManager_SpecificIDByName(benchmark::State& state) {
+	auto* manager = IDManager::getInstance();
+	const unsigned long int nbIDPerThread = nbID / state.threads() / 10;
+	const QString name("benchmark_IDsMap");
+	for(auto _ : state) {
+		unsigned long int lastID = 0;
+		for(unsigned long int iID = 0; iID < nbIDPerThread; ++iID)
+			lastID = manager->getSpecificIDFor(name);
+		benchmark::DoNotOptimize(lastID);
+	}
+	state.SetItemsProcessed(state.iterations()*nbIDPerThread);
+}
+BENCHMARK(BM_IDManager_SpecificIDByName)->ThreadRange(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_IDManager_SpecificIDByHandle(benchmark::State& state) {
+	auto* manager = IDManager::getInstance();
+	const unsigned long int nbIDPerThread = nbID / state.threads() / 10;
+	const IDManager::IDSpace space = manager->registerIDSpace("benchmark_IDsMap");
+	for(auto _ : state) {
+		unsigned long int lastID = 0;
+		for(unsigned long int iID = 0; iID < nbIDPerThread; ++iID)
+			lastID = manager->getID(space);
+		benchmark::DoNotOptimize(lastID);
+	}
+	state.SetItemsProcessed(state.iterations()*nbIDPerThread);
+}
+BENCHMARK(BM_IDManager_SpecificIDByHandle)->ThreadRange(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
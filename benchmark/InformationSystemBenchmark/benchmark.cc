@@ -0,0 +1,163 @@
+#include <benchmark/benchmark.h>
+
+#include "InformationSystemManager.hh"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Overhead of the message sites of the meshing loop (Voronoi_3D_Mesh::add...).
+// The loop does a small amount of work per cell, like computing a weight from a position,
+// then reaches a message site which is either absent, disabled or enabled.
+
+namespace {
+
+struct FakeCell {
+	unsigned long id;
+	double x, y, z;
+	double radius;
+};
+
+std::vector<FakeCell> makeCells(std::size_t pNbCell) {
+	std::vector<FakeCell> cells(pNbCell);
+	for(std::size_t iCell = 0; iCell < pNbCell; ++iCell)
+		cells[iCell] = {iCell, std::cos(iCell*1.), std::sin(iCell*1.), iCell*1e-3, 1. + (iCell%7)*0.1};
+	return cells;
+}
+
+double cellWork(const FakeCell& pCell) {
+	return std::sqrt(pCell.x*pCell.x + pCell.y*pCell.y + pCell.z*pCell.z) * pCell.radius;
+}
+
+/// \brief discard std::cout during the benchmark to measure the logging path only
+class NullOutput {
+public:
+	NullOutput(): _old(std::cout.rdbuf(nullptr)) {}
+	~NullOutput() {
+		InformationSystemManager::getInstance()->flush();
+		std::cout.clear();
+		std::cout.rdbuf(_old);
+	}
+private:
+	std::streambuf* _old;
+};
+
+constexpr std::size_t nbCell = 1 << 12;
+
+}
+
+static void BM_MeshingLoop_NoMessage(benchmark::State& state) {
+	auto cells = makeCells(nbCell);
+	for(auto _ : state) {
+		double sum = 0.;
+		for(auto const& cell : cells)
+			sum += cellWork(cell);
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations()*nbCell);
+}
+BENCHMARK(BM_MeshingLoop_NoMessage);
+
+// message built before the call, as done before the lazy API
+static void BM_MeshingLoop_DisabledEagerMessage(benchmark::State& state) {
+	auto cells = makeCells(nbCell);
+	auto* manager = InformationSystemManager::getInstance();
+	manager->setEnabled(InformationSystemManager::INFORMATION_MES, false);
+	for(auto _ : state) {
+		double sum = 0.;
+		for(auto const& cell : cells) {
+			sum += cellWork(cell);
+			std::string mess = "adding the point at " + std::to_string(cell.x) + ", " + std::to_string(cell.y) + " to the voronoi with weight : " + std::to_string(cell.radius);
+			manager->Message(InformationSystemManager::INFORMATION_MES, mess, "Weighted Voronoi 3D");
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	manager->setEnabled(InformationSystemManager::INFORMATION_MES, true);
+	state.SetItemsProcessed(state.iterations()*nbCell);
+}
+BENCHMARK(BM_MeshingLoop_DisabledEagerMessage);
+
+// message type disabled at run time
+static void BM_MeshingLoop_DisabledLazyMessage(benchmark::State& state) {
+	auto cells = makeCells(nbCell);
+	auto* manager = InformationSystemManager::getInstance();
+	manager->setEnabled(InformationSystemManager::INFORMATION_MES, false);
+	for(auto _ : state) {
+		double sum = 0.;
+		for(auto const& cell : cells) {
+			sum += cellWork(cell);
+			manager->LazyMessage(InformationSystemManager::INFORMATION_MES, "Weighted Voronoi 3D",
+				"adding the point at ", cell.x, ", ", cell.y, " to the voronoi with weight : ", cell.radius);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	manager->setEnabled(InformationSystemManager::INFORMATION_MES, true);
+	state.SetItemsProcessed(state.iterations()*nbCell);
+}
+BENCHMARK(BM_MeshingLoop_DisabledLazyMessage);
+
+// debug messages are removed at compile time in release mode
+static void BM_MeshingLoop_CompiledOutMessage(benchmark::State& state) {
+	auto cells = makeCells(nbCell);
+	auto* manager = InformationSystemManager::getInstance();
+	for(auto _ : state) {
+		double sum = 0.;
+		for(auto const& cell : cells) {
+			sum += cellWork(cell);
+			if constexpr(!InformationSystemManager::isCompiled(InformationSystemManager::DEBUG_MES))
+				continue;
+			manager->LazyMessage(InformationSystemManager::DEBUG_MES, "Weighted Voronoi 3D",
+				"adding the point at ", cell.x, ", ", cell.y, " to the voronoi with weight : ", cell.radius);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations()*nbCell);
+}
+BENCHMARK(BM_MeshingLoop_CompiledOutMessage);
+
+// enabled message, written by the background thread, without rate limit
+static void BM_MeshingLoop_EnabledMessage(benchmark::State& state) {
+	auto cells = makeCells(nbCell);
+	auto* manager = InformationSystemManager::getInstance();
+	manager->setMaxMessagesPerSecond(0);
+	manager->setAsynchronous(state.range(0) != 0);
+	{
+		NullOutput nullOutput;
+		for(auto _ : state) {
+			double sum = 0.;
+			for(auto const& cell : cells) {
+				sum += cellWork(cell);
+				manager->LazyMessage(InformationSystemManager::INFORMATION_MES, "Weighted Voronoi 3D",
+					"adding the point at ", cell.x, ", ", cell.y, " to the voronoi with weight : ", cell.radius);
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+	}
+	manager->setAsynchronous(true);
+	manager->setMaxMessagesPerSecond(1000);
+	state.SetItemsProcessed(state.iterations()*nbCell);
+}
+BENCHMARK(BM_MeshingLoop_EnabledMessage)->Arg(0)->Arg(1)->UseRealTime();
+
+// enabled message with the default rate limit : most messages are rejected before formatting
+static void BM_MeshingLoop_RateLimitedMessage(benchmark::State& state) {
+	auto cells = makeCells(nbCell);
+	auto* manager = InformationSystemManager::getInstance();
+	{
+		NullOutput nullOutput;
+		for(auto _ : state) {
+			double sum = 0.;
+			for(auto const& cell : cells) {
+				sum += cellWork(cell);
+				manager->LazyMessage(InformationSystemManager::INFORMATION_MES, "Weighted Voronoi 3D",
+					"adding the point at ", cell.x, ", ", cell.y, " to the voronoi with weight : ", cell.radius);
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+	}
+	state.SetItemsProcessed(state.iterations()*nbCell);
+}
+BENCHMARK(BM_MeshingLoop_RateLimitedMessage);
+
+BENCHMARK_MAIN();
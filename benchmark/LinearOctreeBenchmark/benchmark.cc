@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkPopulation.hh"
+
+#include "LinearOctree.hh"
+#include "SimpleSpheroidalCell.hh"
+#include "UnitSystemManager.hh"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Linear (Morton ordered) octree for 10k, 100k and 1M agents (CPOP_BENCHMARK_SIZES).
+// The agents are cells of 8 to 10 micrometers uniformly placed in a sphere of the density of the
+// benchmark populations. Only their position and radius are used, no mesh is generated.
+// Rebuild : radix sort of the Morton codes and node construction (counters : memory in bytes, number of nodes).
+// Refit : bounding boxes recomputed after the agents moved of 0.1 micrometer.
+// Nearest : getNearestSpatialableAgent for uniform points in the sphere.
+
+namespace {
+
+constexpr std::size_t nbPoint = 1 << 14;
+
+struct Setup {
+	std::vector<std::unique_ptr<SimpleSpheroidalCell>> cells;
+	std::vector<const t_SpatialableAgent_3*> spatialables;
+	std::vector<Point_3> points;                  ///< \brief uniform points in the sphere, in CPOP unit
+	double radius;                                ///< \brief radius of the sphere, in CPOP unit
+};
+
+Point_3 getPointInSphere(std::mt19937_64& pGenerator, double pRadius) {
+	std::uniform_real_distribution<double> distribution(-pRadius, pRadius);
+	while(true) {
+		Point_3 point(distribution(pGenerator), distribution(pGenerator), distribution(pGenerator));
+		if(CGAL::squared_distance(point, CGAL::ORIGIN) <= pRadius*pRadius)
+			return point;
+	}
+}
+
+Setup& getSetup(unsigned int pNbAgent) {
+	static std::map<unsigned int, std::unique_ptr<Setup>> setups;
+	auto& setup = setups[pNbAgent];
+	if(setup)
+		return *setup;
+
+	double micrometer = UnitSystemManager::getInstance()->getMetricUnit(UnitSystemManager::Micrometer);
+	std::mt19937_64 generator(1234567);
+	std::uniform_real_distribution<double> cellRadius(8.*micrometer, 10.*micrometer);
+
+	setup = std::make_unique<Setup>();
+	setup->radius = 10.*micrometer*std::cbrt(pNbAgent/0.6);
+	setup->cells.reserve(pNbAgent);
+	for(unsigned int iAgent = 0; iAgent < pNbAgent; ++iAgent) {
+		double radius = cellRadius(generator);
+		setup->cells.push_back(std::make_unique<SimpleSpheroidalCell>(nullptr, getPointInSphere(generator, setup->radius), radius, radius/2.));
+		setup->spatialables.push_back(setup->cells.back().get());
+	}
+	for(std::size_t iPoint = 0; iPoint < nbPoint; ++iPoint)
+		setup->points.push_back(getPointInSphere(generator, setup->radius));
+	return *setup;
+}
+
+}
+
+static void BM_Rebuild(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	LinearOctree octree;
+	octree.build(setup.spatialables.begin(), setup.spatialables.end());
+
+	for(auto _ : state)
+		octree.rebuild();
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()*setup.spatialables.size()));
+	state.counters["memory"] = static_cast<double>(octree.getMemoryUsage());
+	state.counters["nodes"] = static_cast<double>(octree.getNodes().size());
+}
+BENCHMARK(BM_Rebuild)->Apply(BenchmarkPopulation::applyPopulationSizes<10000, 100000, 1000000>)->Unit(benchmark::kMillisecond);
+
+static void BM_Refit(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	LinearOctree octree;
+	octree.build(setup.spatialables.begin(), setup.spatialables.end());
+
+	double shift = 0.1*UnitSystemManager::getInstance()->getMetricUnit(UnitSystemManager::Micrometer);
+	for(auto const& cell : setup.cells)
+		cell->setPosition(cell->getPosition() + Vector_3(shift, 0., 0.));
+
+	for(auto _ : state)
+		octree.refit();
+
+	for(auto const& cell : setup.cells)
+		cell->setPosition(cell->getPosition() - Vector_3(shift, 0., 0.));
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()*setup.spatialables.size()));
+}
+BENCHMARK(BM_Refit)->Apply(BenchmarkPopulation::applyPopulationSizes<10000, 100000, 1000000>)->Unit(benchmark::kMillisecond);
+
+static void BM_Nearest(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	LinearOctree octree;
+	octree.build(setup.spatialables.begin(), setup.spatialables.end());
+
+	for(auto _ : state) {
+		for(auto const& point : setup.points)
+			benchmark::DoNotOptimize(octree.getNearestSpatialableAgent(point));
+	}
+
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()*setup.points.size()));
+}
+BENCHMARK(BM_Nearest)->Apply(BenchmarkPopulation::applyPopulationSizes<10000, 100000, 1000000>)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
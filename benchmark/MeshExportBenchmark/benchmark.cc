@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkPopulation.hh"
+
+#include "CPOP_Loader.hh"
+#include "EnvironmentSettings.hh"
+#include "MeshFactory.hh"
+#include "RandomEngineManager.hh"
+#include "SpheroidalCellMesh.hh"
+
+#include <CLHEP/Random/MTwistEngine.h>
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+
+// Throughput of the mesh exporters for 1k and 10k cells (CPOP_BENCHMARK_SIZES), given in bytes per second of the written file.
+// OFF and STL : SpheroidalCellMesh::exportToFile, the _nuclei.txt file written with it is counted in the bytes.
+// NucleiTXT : the _nuclei.txt file alone.
+// The cells are meshed once before the benchmarks.
+
+using namespace Settings::nCell;
+using namespace Settings::nEnvironment;
+
+namespace {
+
+struct Setup {
+	t_Environment_3* environment = nullptr;
+	std::unique_ptr<SpheroidalCellMesh> mesh;
+	std::vector<SpheroidalCell*> cells;
+};
+
+Setup& getSetup(unsigned int pNbCell) {
+	static std::map<unsigned int, std::unique_ptr<Setup>> setups;
+	auto& setup = setups[pNbCell];
+	if(setup)
+		return *setup;
+
+	static CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	setup = std::make_unique<Setup>();
+	CPOP_Loader loader;
+	setup->environment = loader.load3DEnvironment(BenchmarkPopulation::getPopulationFile(pNbCell), true);
+
+	int error;
+	setup->mesh.reset(dynamic_cast<SpheroidalCellMesh*>(MeshFactory::getInstance()->create_3DMesh(
+		&error,
+		dynamic_cast<t_SimulatedSubEnv_3*>(setup->environment->getFirstChild()),
+		MeshTypes::Round_Cell_Tesselation,
+		100,
+		0
+	)));
+	setup->cells = setup->mesh->generateMesh();
+	return *setup;
+}
+
+std::size_t fileSize(std::string const& pPath) {
+	std::error_code error;
+	auto size = std::filesystem::file_size(pPath, error);
+	return error ? 0 : static_cast<std::size_t>(size);
+}
+
+}
+
+static void exportMesh(benchmark::State& state, MeshOutFormats::outputFormat pFormat, std::string const& pExtension) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	std::string path = "benchmark_mesh_" + std::to_string(state.range(0));
+
+	for(auto _ : state)
+		benchmark::DoNotOptimize(setup.mesh->exportToFile(path, pFormat));
+
+	std::size_t nbByte = fileSize(path + pExtension) + fileSize(path + "_nuclei.txt");
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()*nbByte));
+	state.counters["file_MB"] = nbByte/(1024.*1024.);
+}
+
+static void BM_ExportOFF(benchmark::State& state) {
+	exportMesh(state, MeshOutFormats::OFF, ".off");
+}
+BENCHMARK(BM_ExportOFF)->Apply(BenchmarkPopulation::applyPopulationSizes<1000, 10000>)->Unit(benchmark::kMillisecond);
+
+static void BM_ExportSTL(benchmark::State& state) {
+	exportMesh(state, MeshOutFormats::STL, ".stl");
+}
+BENCHMARK(BM_ExportSTL)->Apply(BenchmarkPopulation::applyPopulationSizes<1000, 10000>)->Unit(benchmark::kMillisecond);
+
+static void BM_ExportNucleiTXT(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	std::string path = "benchmark_mesh_" + std::to_string(state.range(0)) + "_nuclei.txt";
+
+	for(auto _ : state)
+		benchmark::DoNotOptimize(SpheroidalCellMesh::exportNucleiToFile(path, setup.cells));
+
+	std::size_t nbByte = fileSize(path);
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()*nbByte));
+	state.counters["file_MB"] = nbByte/(1024.*1024.);
+}
+BENCHMARK(BM_ExportNucleiTXT)->Apply(BenchmarkPopulation::applyPopulationSizes<1000, 10000>)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkPopulation.hh"
+
+#include "CPOP_Loader.hh"
+#include "EnvironmentSettings.hh"
+#include "MeshFactory.hh"
+#include "RandomEngineManager.hh"
+#include "Slicer_3.hh"
+#include "SpheroidalCellMesh.hh"
+
+#include <CLHEP/Random/MTwistEngine.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+// Slicing of a 10k cells population along z, the rate is given in slices per second.
+// Cut : sections of a single plane through the spheroid center, kept in memory.
+// ExportSlices : 100 equally spaced slices across the spheroid, written in one sweep, one file per slice.
+// The cells are meshed once before the benchmarks.
+
+using namespace Settings::nCell;
+using namespace Settings::nEnvironment;
+
+namespace {
+
+struct Setup {
+	t_Environment_3* environment = nullptr;
+	std::unique_ptr<SpheroidalCellMesh> mesh;
+	std::vector<SpheroidalCell*> cells;
+};
+
+Setup& getSetup(unsigned int pNbCell) {
+	static std::map<unsigned int, std::unique_ptr<Setup>> setups;
+	auto& setup = setups[pNbCell];
+	if(setup)
+		return *setup;
+
+	static CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	setup = std::make_unique<Setup>();
+	CPOP_Loader loader;
+	setup->environment = loader.load3DEnvironment(BenchmarkPopulation::getPopulationFile(pNbCell), true);
+
+	int error;
+	setup->mesh.reset(dynamic_cast<SpheroidalCellMesh*>(MeshFactory::getInstance()->create_3DMesh(
+		&error,
+		dynamic_cast<t_SimulatedSubEnv_3*>(setup->environment->getFirstChild()),
+		MeshTypes::Round_Cell_Tesselation,
+		100,
+		0
+	)));
+	setup->cells = setup->mesh->generateMesh();
+	return *setup;
+}
+
+}
+
+static void BM_Cut(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	Slicer_3 slicer(setup.cells, TOP);
+	double center = 0.5*(slicer.getMin() + slicer.getMax());
+
+	for(auto _ : state)
+		benchmark::DoNotOptimize(slicer.cut(center));
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Cut)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+static void BM_ExportSlices(benchmark::State& state) {
+	Setup& setup = getSetup(static_cast<unsigned int>(state.range(0)));
+	Slicer_3 slicer(setup.cells, TOP);
+	auto nbSlice = static_cast<unsigned int>(state.range(1));
+
+	for(auto _ : state)
+		benchmark::DoNotOptimize(slicer.exportSlices("benchmark_slices", slicer.getMin(), slicer.getMax(), nbSlice));
+
+	state.SetItemsProcessed(state.iterations()*nbSlice);
+}
+BENCHMARK(BM_ExportSlices)->Args({10000, 100})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,62 @@
+#Compare two Google Benchmark JSON outputs (--benchmark_out=file.json --benchmark_out_format=json)
+#usage : python3 compare_benchmarks.py baseline.json contender.json [threshold_percent]
+#The change of each benchmark present in both files is printed, a negative change is faster.
+#The exit code is 1 if a benchmark is slower than the threshold (5 % by default).
+
+import json
+import sys
+
+
+def load(filename):
+	with open(filename) as file:
+		data = json.load(file)
+
+	results = {}
+	for benchmark in data["benchmarks"]:
+		# keep the mean of repeated runs, skip the other aggregates
+		if benchmark.get("run_type") == "aggregate" and benchmark.get("aggregate_name") != "mean":
+			continue
+		results[benchmark.get("run_name", benchmark["name"])] = benchmark
+	return results
+
+
+def change(baseline, contender, key):
+	if baseline[key] == 0:
+		return 0.
+	# times are given in the unit of each benchmark, which may differ between the runs
+	unit = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.}
+	baselineTime = baseline[key] * unit[baseline.get("time_unit", "ns")]
+	contenderTime = contender[key] * unit[contender.get("time_unit", "ns")]
+	return 100. * (contenderTime - baselineTime) / baselineTime
+
+
+def main(baselineFile, contenderFile, threshold):
+	baseline = load(baselineFile)
+	contender = load(contenderFile)
+
+	width = max([len(name) for name in baseline] + [9])
+	print("%-*s %12s %12s" % (width, "benchmark", "real_time", "cpu_time"))
+
+	nbSlower = 0
+	for name in baseline:
+		if name not in contender:
+			print("%-*s %12s" % (width, name, "missing"))
+			continue
+		realTime = change(baseline[name], contender[name], "real_time")
+		cpuTime = change(baseline[name], contender[name], "cpu_time")
+		slower = realTime > threshold
+		nbSlower += slower
+		print("%-*s %+11.1f%% %+11.1f%%%s" % (width, name, realTime, cpuTime, "  <- slower" if slower else ""))
+
+	for name in contender:
+		if name not in baseline:
+			print("%-*s %12s" % (width, name, "new"))
+
+	return 1 if nbSlower > 0 else 0
+
+
+if __name__ == "__main__":
+	if len(sys.argv) < 3:
+		print("usage : python3 compare_benchmarks.py baseline.json contender.json [threshold_percent]")
+		sys.exit(2)
+	sys.exit(main(sys.argv[1], sys.argv[2], float(sys.argv[3]) if len(sys.argv) > 3 else 5.))
@@ -0,0 +1,111 @@
+#ifndef BENCHMARK_POPULATION_HH
+#define BENCHMARK_POPULATION_HH
+
+#include "Cell_Utils.hh"
+#include "DistributionFactory.hh"
+#include "EnvironmentSettings.hh"
+#include "File_CPOP_Data.hh"
+#include "RandomEngineManager.hh"
+#include "RoundCellProperties.hh"
+#include "SpheresSDelimitation.hh"
+#include "UnitSystemManager.hh"
+
+#include <CLHEP/Random/MTwistEngine.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Synthetic populations shared by the benchmarks.
+// A population of n cells is a spheroid of cells of 8 to 10 micrometers (nucleus of 4 to 5 micrometers)
+// randomly distributed with the seed 1234567. It is saved as benchmark_population_<n>.xml in the
+// directory given by the CPOP_BENCHMARK_DATA environment variable (working directory by default) and
+// only generated if the file does not exist : populations can be generated offline with
+// GenerateBenchmarkPopulations. No Geant4 run is needed.
+// The CPOP_BENCHMARK_SIZES environment variable ("1000,10000") overrides the population sizes of the
+// benchmarks using getPopulationSizes.
+
+namespace BenchmarkPopulation {
+
+/// \brief return the directory of the population files
+inline std::string getDataDirectory() {
+	const char* directory = std::getenv("CPOP_BENCHMARK_DATA");
+	return directory ? directory : ".";
+}
+
+/// \brief return the path of the population file of nbCell cells
+inline std::string getPopulationPath(unsigned int pNbCell) {
+	return getDataDirectory() + "/benchmark_population_" + std::to_string(pNbCell) + ".xml";
+}
+
+/// \brief generate a spheroid of nbCell cells and save it, as done by tool/GeneratePopulation
+/// \return the path of the population file
+inline std::string generatePopulationFile(unsigned int pNbCell) {
+	static CLHEP::MTwistEngine engine;
+	engine.setSeed(1234567, 0);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	double micrometer = UnitSystemManager::getInstance()->getMetricUnit(UnitSystemManager::Micrometer);
+	double nanogram = UnitSystemManager::getInstance()->getWeightUnit(UnitSystemManager::Nanogram);
+
+	RoundCellProperties cellProperties;
+	cellProperties.automaticFill(
+		CellVariableAttribute<double>(8.*micrometer, 10.*micrometer),
+		CellVariableAttribute<double>(1.*nanogram, 1.*nanogram),
+		CellVariableAttribute<double>(4.*micrometer, 5.*micrometer)
+	);
+
+	auto* env = new Settings::nEnvironment::t_Environment_3("main Environment");
+	auto* delimitation = new SpheresSDelimitation(0., 10.*micrometer*std::cbrt(pNbCell/0.6), Point_3(0., 0., 0.));
+	auto* subEnv = new Settings::nEnvironment::t_SimulatedSubEnv_3(env, "MySimulatedSubEnv", static_cast<t_SpatialDelimitation_3*>(delimitation));
+
+	auto* distribution = DistributionFactory::getInstance()->getDistribution<double, Point_3, Vector_3>(Distribution::RANDOM);
+	distribution->distribute(subEnv, &cellProperties, pNbCell, Utils::generateUniformLifeCycle());
+	delete distribution;
+
+	std::string fileName = getPopulationPath(pNbCell);
+	IO::CPOP::save(static_cast<Writable*>(env), fileName.c_str());
+	delete env;
+	return fileName;
+}
+
+/// \brief return the path of the population file of nbCell cells, generated if it does not exist yet
+inline std::string getPopulationFile(unsigned int pNbCell) {
+	std::string fileName = getPopulationPath(pNbCell);
+	if(std::filesystem::exists(fileName))
+		return fileName;
+	return generatePopulationFile(pNbCell);
+}
+
+/// \brief return the population sizes given by CPOP_BENCHMARK_SIZES, or the default ones
+inline std::vector<int64_t> getPopulationSizes(std::vector<int64_t> pDefaultSizes) {
+	const char* sizes = std::getenv("CPOP_BENCHMARK_SIZES");
+	if(!sizes)
+		return pDefaultSizes;
+
+	std::vector<int64_t> result;
+	std::stringstream stream(sizes);
+	std::string size;
+	while(std::getline(stream, size, ',')) {
+		if(!size.empty())
+			result.push_back(std::stoll(size));
+	}
+	return result.empty() ? pDefaultSizes : result;
+}
+
+/// \brief register the population sizes as the first argument of a benchmark : ->Apply(applyPopulationSizes<1000, 10000>)
+template<int64_t... DefaultSizes>
+void applyPopulationSizes(benchmark::internal::Benchmark* pBenchmark) {
+	for(int64_t size : getPopulationSizes({DefaultSizes...}))
+		pBenchmark->Arg(size);
+}
+
+}
+
+#endif
@@ -104,7 +104,7 @@ void SimulationEnvironment::setSpheroidProperties(double internalRadius, double
 		assert(simulatedEnv);
 		assert(simulatedEnv->getSpatialDelimitation());
 		grid->applySpatialDelimitation(simulatedEnv->getSpatialDelimitation());
-		std::set<Agent*> agents = static_cast<Layer*>(simulatedEnv)->getAgents();
+		auto const& agents = static_cast<Layer*>(simulatedEnv)->getAgents();
 		grid->distributePosition(agents.begin(), agents.end(), GEP_CENTER);
 		delete grid;
 	}
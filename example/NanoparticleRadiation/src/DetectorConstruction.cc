@@ -1,5 +1,6 @@
 #include "DetectorConstruction.hh"
 #include "DetectorConstructionMessenger.hh"
+#include "Population.hh"
 
 #include <stdexcept>
 
@@ -9,8 +10,10 @@
 #include "G4PVPlacement.hh"
 #include "G4NistManager.hh"
 
-DetectorConstruction::DetectorConstruction():
-	_worldSize(-1*CLHEP::micrometer)
+DetectorConstruction::DetectorConstruction(cpop::Population& population):
+	_population(&population),
+	_worldSize(-1*CLHEP::micrometer),
+	_cellGeometry(false)
 {
 	_messenger = new DetectorConstructionMessenger(this);
 }
@@ -27,7 +30,7 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 	auto* solidWorld = new G4Box("sWorld", this->getWorldSize(), this->getWorldSize(), this->getWorldSize());
 	auto* logicWorld = new G4LogicalVolume( solidWorld, lWater, "LV_World", nullptr, nullptr, nullptr);
 
-	return new G4PVPlacement(
+	auto* physWorld = new G4PVPlacement(
 		G4Transform3D(),// no rotation
 		logicWorld,     // its logical volume
 		"PV_World",     // its name
@@ -36,6 +39,12 @@ G4VPhysicalVolume *DetectorConstruction::Construct() {
 		0,              // copy number
 		false           // surface overlaps
 	);
+
+	// cells and nuclei as volumes : the stepping action reads them from the touchable
+	if(getCellGeometry())
+		_population->placeCellsInG4(logicWorld);
+
+	return physWorld;
 }
 
 double DetectorConstruction::getWorldSize() const {
@@ -45,3 +54,11 @@ double DetectorConstruction::getWorldSize() const {
 void DetectorConstruction::setWorldSize(double value) {
 	_worldSize = value;
 }
+
+bool DetectorConstruction::getCellGeometry() const {
+	return _cellGeometry;
+}
+
+void DetectorConstruction::setCellGeometry(bool value) {
+	_cellGeometry = value;
+}
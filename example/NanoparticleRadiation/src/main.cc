@@ -9,6 +9,7 @@
 #include "Population.hh"
 #include "PhysicsList.hh"
 #include "ActionInitialization.hh"
+#include "RunSweep.hh"
 
 #include "G4UImanager.hh"
 #include "Randomize.hh"
@@ -53,6 +54,12 @@ int main(int argc, char** argv) {
 	std::string macro;
 	parser.add_opt_value('m', "macro", macro, std::string("input_filename.mac"), "macro file", "file").require();
 
+	// Get the list of source macros to run on the population set up by the macro. Specify option --sweep <fileName>
+	std::string sweep;
+	parser.add_opt_value(-1, "sweep", sweep, std::string(""), "list of source macros, one run per macro", "file");
+	std::string sweepOutput;
+	parser.add_opt_value(-1, "sweep-output", sweepOutput, std::string("output"), "base name of the output files of the sweep", "string");
+
 	parser.parse(argc, argv);
 
 	// check errors
@@ -80,12 +87,14 @@ int main(int argc, char** argv) {
 
 	// Set mandatory initialization classes
 	// Set the geometry ie a box filled with G4_WATER
-	auto* detector = new DetectorConstruction();
+	auto* detector = new DetectorConstruction(population);
 	runManager->SetUserInitialization(detector);
 
 	// Set the physics list
 	auto* physicsList = new cpop::PhysicsList();
 	physicsList->messenger().BuildCommands("/cpop/physics");
+	// step limits can be set per region or per organelle of the population
+	physicsList->SetPopulation(population);
 	runManager->SetUserInitialization(physicsList);
 
 	// Set custom action to extract informations from the simulation
@@ -97,6 +106,17 @@ int main(int argc, char** argv) {
 	G4String command = "/control/execute ";
 	UImanager->ApplyCommand(command+macro);
 
+	if(!sweep.empty()) {
+		// the population, the geometry and the physics are set up once for all the runs
+		std::chrono::duration<double> setup_seconds = std::chrono::high_resolution_clock::now() - start;
+
+		cpop::RunSweep runSweep(population, actionInitialisation->source_messenger(), sweepOutput);
+		runSweep.readList(sweep);
+		runSweep.setSetup_duration(setup_seconds.count());
+		runSweep.run();
+		runSweep.printReport(std::cout);
+	}
+
 	auto end = std::chrono::high_resolution_clock::now();
 	std::chrono::duration<double> elapsed_seconds = end - start;
 
@@ -0,0 +1,86 @@
+#Compare the tracking speed and the nucleus energy of macros/run.mac and macros/run_stepMaxPerRegion.mac
+#usage : python3 compare_step_limits.py path/to/targetedAlphaTherapy [number_of_threads]
+#To run from the example directory (the one containing data/, macros/ and output/). Requires PyROOT.
+#Each macro is run with /run/verbose 1 so Geant4 prints the duration of the event loop, the events/s
+#are computed from it. The energies deposited in the nuclei are read from the "Run" ntuple of each output.
+
+import glob
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+import ROOT
+
+runs = [
+	("stepMax", "macros/run.mac", "output/output"),
+	("stepMaxPerRegion", "macros/run_stepMaxPerRegion.mac", "output/output_stepMaxPerRegion"),
+]
+
+
+def run(executable, macro, nbThread):
+	with open(macro) as file:
+		content = file.read()
+	nbEvent = int(re.findall(r"^/run/beamOn\s+(\d+)", content, re.MULTILINE)[-1])
+	content = re.sub(r"^/run/verbose\s+\d+", "/run/verbose 1", content, flags=re.MULTILINE)
+
+	with tempfile.NamedTemporaryFile("w", suffix=".mac", dir="macros", delete=False) as verboseMacro:
+		verboseMacro.write(content)
+	try:
+		command = [executable, "-m", verboseMacro.name]
+		if nbThread:
+			command += ["-t", str(nbThread)]
+		output = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True, check=True).stdout
+	finally:
+		os.remove(verboseMacro.name)
+
+	# the timer of the event loop, printed at the end of the run, or the whole execution
+	times = re.findall(r"Run terminated\.[\s\S]*?Real=([0-9.eE+-]+)\s*s", output)
+	if times:
+		return nbEvent, float(times[-1]), "event loop"
+	return nbEvent, float(re.findall(r"elapsed time: ([0-9.eE+-]+) s", output)[-1]), "whole execution"
+
+
+def getNucleusEnergies(prefix):
+	# sequential run or one file per thread
+	files = [prefix + ".root"] if os.path.exists(prefix + ".root") else sorted(glob.glob(prefix + "_t[0-9]*.root"))
+	if not files:
+		sys.exit("no output found for " + prefix)
+
+	energies = {}
+	for filename in files:
+		rootFile = ROOT.TFile.Open(filename)
+		for row in rootFile.Get("Run"):
+			cellID = int(row.ID_Cell)
+			energies[cellID] = energies.get(cellID, 0.) + row.fEdepn
+		rootFile.Close()
+	return energies
+
+
+def main(executable, nbThread):
+	os.makedirs("output", exist_ok=True)
+	results = {}
+	for name, macro, prefix in runs:
+		nbEvent, duration, timed = run(executable, macro, nbThread)
+		results[name] = (nbEvent/duration, getNucleusEnergies(prefix))
+		print("%-16s %10.2f events/s (%d events, %s of %.1f s)" % (name, nbEvent/duration, nbEvent, timed, duration))
+
+	(baselineRate, baseline), (contenderRate, contender) = results["stepMax"], results["stepMaxPerRegion"]
+	print("speedup : %.2f" % (contenderRate/baselineRate))
+
+	baselineTotal = sum(baseline.values())
+	contenderTotal = sum(contender.values())
+	if baselineTotal > 0.:
+		print("energy in the nuclei : %g MeV, %g MeV (%+.2f %%)" % (baselineTotal, contenderTotal, 100.*(contenderTotal - baselineTotal)/baselineTotal))
+
+	# cells hit in both runs
+	differences = [abs(contender.get(cellID, 0.) - energy)/energy for cellID, energy in baseline.items() if energy > 0. and contender.get(cellID, 0.) > 0.]
+	if differences:
+		print("mean relative difference of the energy per nucleus : %.2f %% (%d nuclei hit in both runs)" % (100.*sum(differences)/len(differences), len(differences)))
+
+
+if __name__ == "__main__":
+	if len(sys.argv) < 2:
+		sys.exit("usage : python3 compare_step_limits.py path/to/targetedAlphaTherapy [number_of_threads]")
+	main(sys.argv[1], int(sys.argv[2]) if len(sys.argv) > 2 else 0)
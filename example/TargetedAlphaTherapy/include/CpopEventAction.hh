@@ -16,7 +16,8 @@ class CpopEventAction : public G4UserEventAction {
 public:
 	CpopEventAction(const Population& population, CpopRunAction* runAction);
 
-	std::string PreOrganelle;
+	/// \brief Location of the last step in a cell
+	CellLocation PreLocation;
 
 	void BeginOfEventAction(const G4Event*evt) override;
 	void EndOfEventAction(const G4Event*) override;
@@ -5,8 +5,7 @@
 
 #include "G4UserSteppingAction.hh"
 
-#include "Octree.hh"
-#include "OctreeNodeForSpheroidalCell.hh"
+#include "LinearOctree.hh"
 #include "PGA_impl.hh"
 #include "Population.hh"
 
@@ -23,23 +22,21 @@ public:
 
 	/// \brief point in CPOP unit
 	const Settings::nCell::t_Cell_3 *findCell(const Settings::Geometry::Point_3& point);
-	std::string findOrganelle(const Settings::nCell::t_Cell_3* cell, const Settings::Geometry::Point_3& point);
-	std::string findRegion(const Settings::nCell::t_Cell_3* cell);
+	/// \brief return the location of the point (in CPOP unit) if it is in a sampled cell, the last one being tested first
+	CellLocation locate(const Settings::Geometry::Point_3& point);
 
 	G4double Ei_He;
 	G4double Ei_He_temp;
 
-	void addTupleRow(const G4Step* step, int cellID, const std::string& organelle, const std::string& region);
+	void addTupleRow(const G4Step* step, const CellLocation& location);
 
 private:
 	/// \brief Octree containing SAMPLED cells
-	std::unique_ptr<Octree<OctreeNodeForSpheroidalCell>> octree_;
+	std::unique_ptr<LinearOctree> octree_;
 	/// \brief Cell population
 	const Population* population_;
 	/// \brief The last sampled cell where a step occured
 	const Settings::nCell::t_Cell_3* last_cell_ = nullptr;
-	/// \brief The region containing the last sampled cell
-	std::string last_region_ = "";
 
 	bool is_initialized_ = false;
 
@@ -26,7 +26,7 @@ void CpopEventAction::BeginOfEventAction(const G4Event * evt) {
 	G4int print_modulo = G4RunManager::GetRunManager()->GetPrintProgress();
 	eventIDForSteppingAction = evt->GetEventID() ;
 
-	PreOrganelle = "";
+	PreLocation = CellLocation();
 
 	if (print_modulo > 0 && evt_id%print_modulo == 0) {
 		G4int total_evt = G4RunManager::GetRunManager()->GetCurrentRun()->GetNumberOfEventToBeProcessed();
@@ -52,7 +52,6 @@ void CpopEventAction::BeginOfEventAction(const G4Event * evt) {
 	countArretdsNoyauApresGenDansLeNoyau=0;
 
 	const Population* population = _population;
-	std::vector<SpheroidRegion> regions = population->regions();
 
 	for (int id_cell=0; id_cell<(population->nbCellXml); ++id_cell) {
 		fEdepn.push_back(0);
@@ -66,7 +65,6 @@ void CpopEventAction::EndOfEventAction(const G4Event* Event) {
 	G4int event_id = Event->GetEventID();
 
 	const Population* population = _population;
-	std::vector<SpheroidRegion> regions = population->regions();
 
 	/////// Collect energy deposited in each cell for RunAction //////////
 
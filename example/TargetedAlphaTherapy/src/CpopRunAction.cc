@@ -36,7 +36,6 @@ void CpopRunAction::BeginOfRunAction(const G4Run * /*run*/) {
 	fEdep_sph_tot = 0;
 
 	const Population* population = _population;
-	std::vector<SpheroidRegion> regions = population->regions();
 
 	for(int id_cell=0; id_cell<(population->nbCellXml); ++id_cell) {
 		fEdepn_tot.push_back(0);
@@ -56,7 +55,7 @@ void CpopRunAction::EndOfRunAction(const G4Run * /*run*/) {
 	G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
 
 	const Population* population = _population;
-	std::vector<SpheroidRegion> regions = population->regions();
+	auto const& regions = population->regions();
 	int nb_cell = 0;
 	for(const SpheroidRegion& region : regions)
 		nb_cell += (region.cells_in_region()).size();
@@ -86,19 +85,11 @@ void CpopRunAction::EndOfRunAction(const G4Run * /*run*/) {
 }
 
 std::string CpopRunAction::determine_cell_region_by_id(G4int cell_id) {
-	auto const& regions = _population->regions();
-	for(const SpheroidRegion& region : regions) {
-		std::vector<const Settings::nCell::t_Cell_3 *> cells_in_region = region.cells_in_region();
-		auto it = std::find_if(
-			cells_in_region.begin(), cells_in_region.end(),
-			[cell_id](const Settings::nCell::t_Cell_3* cell) { return cell->getID() == static_cast<unsigned long>(cell_id); }
-		);
-
-		if (it != cells_in_region.end())
-			return region.name();
-	}
+	const SpheroidRegion* region = _population->region_by_id(cell_id);
+	if(!region)
+		return "Unknown";
 
-	return "Unknown";
+	return region->name();
 }
 
 std::string CpopRunAction::file_name() const {
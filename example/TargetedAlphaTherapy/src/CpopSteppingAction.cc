@@ -35,31 +35,17 @@ void CpopSteppingAction::UserSteppingAction(const G4Step * step) {
 	G4StepPoint * preStep = step->GetPreStepPoint();
 	G4StepPoint * postStep = step->GetPostStepPoint();
 
-	std::string PreOrganelle;
-
 	G4String nameParticle = step->GetTrack()->GetDynamicParticle()->GetDefinition()->GetParticleName();
 	const G4String &processName = postStep->GetProcessDefinedStep()->GetProcessName();
 
-	if(edep > 0) {
-		G4ThreeVector pEdepPos = step->GetPreStepPoint()->GetPosition();
+	G4ThreeVector pEdepPos = step->GetPreStepPoint()->GetPosition();
+	Point_3 edep_pos = Utils::myCGAL::to_CPOP(pEdepPos);
 
-		Point_3 edep_pos = Utils::myCGAL::to_CPOP(pEdepPos);
-		std::string organelle("");
+	// the step is classified once, names are only given when writing the tuples
+	CellLocation location = locate(edep_pos);
 
-		if(last_cell_ != nullptr && last_cell_->hasIn(edep_pos)) { // Avoid region search and findCell
-			organelle = findOrganelle(last_cell_, edep_pos);
-			addTupleRow(step, last_cell_->getID(), organelle, last_region_);
-		} else {
-			auto cell = findCell(edep_pos);
-			if(cell && cell->hasIn(edep_pos)) {
-				last_cell_ = cell;
-				last_region_ = findRegion(last_cell_);
-				organelle = findOrganelle(cell, edep_pos);
-				addTupleRow(step, last_cell_->getID(), organelle, last_region_);
-			}
-		}
-
-	}
+	if(edep > 0 && location.in_cell())
+		addTupleRow(step, location);
 
 	if((fPGA_impl->indiceIfDiffusion)==1) {
 		(fEventAction->indiceIfDiffusionEvent) = 1;
@@ -67,7 +53,6 @@ void CpopSteppingAction::UserSteppingAction(const G4Step * step) {
 
 	G4Track* track = step->GetTrack();
 
-	G4ThreeVector pEdepPos = step->GetPreStepPoint()->GetPosition();
 	double distance_from_center = pow(pEdepPos[0]*pEdepPos[0] + pEdepPos[1]*pEdepPos[1] + pEdepPos[2]*pEdepPos[2], 0.5);
 
 
@@ -76,11 +61,7 @@ void CpopSteppingAction::UserSteppingAction(const G4Step * step) {
 		fEventAction->AddEdepSpheroid(edep);
 	}
 
-	Point_3 edep_pos = Utils::myCGAL::to_CPOP(pEdepPos);
-
-	PreOrganelle = fEventAction->PreOrganelle ;
-
-	auto cell = findCell(edep_pos);
+	CellLocation PreLocation = fEventAction->PreLocation;
 
 	// if (step->IsFirstStepInVolume())
 	// {
@@ -91,12 +72,12 @@ void CpopSteppingAction::UserSteppingAction(const G4Step * step) {
 
 	if (step->IsFirstStepInVolume() and (track->GetParentID() == 0) and ((fEventAction->countFirstAppearance)==0)) {
 		// G4cout << "First position: " << preStepPoint->GetPosition().x() << preStepPoint->GetPosition().y() << preStepPoint->GetPosition().z() << G4endl;
-		// G4cout << "First volume: " << PreOrganelle << G4endl;
+		// G4cout << "First volume: " << organelle_name(PreLocation.organelle) << G4endl;
 
-		if (cell && cell->hasIn(edep_pos)) {
+		if (location.in_cell()) {
 			// Détecte le premier step de la particule dans le world et permet de renvoyer son volume et énergie d'émission
 
-			fEventAction->firstVolume = findOrganelle(cell, edep_pos);
+			fEventAction->firstVolume = organelle_name(location.organelle);
 			// G4cout << "Energie_emission" << preStep->GetKineticEnergy()/CLHEP::keV << G4endl;
 			fEventAction->energyEmission=preStep->GetKineticEnergy()/CLHEP::keV;
 			fEventAction->idCellDEmission = fPGA_impl->currentCellId;
@@ -114,22 +95,22 @@ void CpopSteppingAction::UserSteppingAction(const G4Step * step) {
 			G4cout << "Ek: " << fEventAction->Energie_emission << G4endl;*/
 	}
 
-	if(cell && cell->hasIn(edep_pos)) {
-		std::string PostOrganelle;
-		PostOrganelle = findOrganelle(cell, edep_pos);
+	if(location.in_cell()) {
+		const Settings::nCell::t_Cell_3* cell = population_->cells()[location.cell_index];
+		const CellLocation& PostLocation = location;
 
-		fEventAction->PreOrganelle = PostOrganelle;
+		fEventAction->PreLocation = PostLocation;
 
 		G4String PreLVName;
 		PreLVName = step->GetPreStepPoint()->GetTouchable()->GetVolume()->GetLogicalVolume()->GetName();
 
-		if ((PreOrganelle == "nucleus") and (track->GetParentID() == 0)) {
+		if (PreLocation.in_nucleus() and (track->GetParentID() == 0)) {
 			// Get energy deposited by alphas in nucleus //
 			G4double edepStepn = step->GetTotalEnergyDeposit()/CLHEP::keV;
 			fEventAction->AddEdepNucl(edepStepn, cell->getID() - 3);
 		}
 
-		if ((PreOrganelle == "cytoplasm") and (cell->hasIn(edep_pos)) and (track->GetParentID() == 0)) {
+		if (PreLocation.in_cytoplasm() and (track->GetParentID() == 0)) {
 			// Get energy deposited by alphas in cytoplasm //
 			G4double edepStepc = step->GetTotalEnergyDeposit()/CLHEP::keV;
 			fEventAction->AddEdepCyto(edepStepc, cell->getID() - 3);
@@ -137,7 +118,7 @@ void CpopSteppingAction::UserSteppingAction(const G4Step * step) {
 
 		preCellID = cell->getID();
 
-		if ((PostOrganelle == "nucleus") and step->IsFirstStepInVolume() and (track->GetParentID() == 0)) {
+		if (PostLocation.in_nucleus() and step->IsFirstStepInVolume() and (track->GetParentID() == 0)) {
 			// Détecte quand une particule rentre dans (ou est émise depuis) un noyau pour la première fois, et gère le cas où la particule s'arrête dans ce noyau après y avoir été émise
 
 			Ei_He_temp=preStep->GetKineticEnergy()/CLHEP::keV;
@@ -157,7 +138,7 @@ void CpopSteppingAction::UserSteppingAction(const G4Step * step) {
 			fEventAction-> nameParticle=nameParticle;
 		}
 
-		if ((PreOrganelle != "nucleus") and (PostOrganelle == "nucleus") and (track->GetParentID() == 0)) {
+		if (!PreLocation.in_nucleus() and PostLocation.in_nucleus() and (track->GetParentID() == 0)) {
 			// G4cout << "Ei: " << preStep->GetKineticEnergy()/CLHEP::keV << G4endl;
 			fEventAction->Ei.push_back(preStep->GetKineticEnergy()/CLHEP::keV);
 			fEventAction->sizeEi += 1;
@@ -168,7 +149,7 @@ void CpopSteppingAction::UserSteppingAction(const G4Step * step) {
 			fEventAction->idCelluleArretDsNoyau = cell->getID();
 		}
 
-		if ((PreOrganelle == "nucleus") and (PostOrganelle == "cytoplasm") and (track->GetParentID() == 0)) {
+		if (PreLocation.in_nucleus() and PostLocation.in_cytoplasm() and (track->GetParentID() == 0)) {
 			// G4cout << "Ef: " << postStep->GetKineticEnergy()/CLHEP::keV << G4endl;
 			fEventAction->Ef.push_back(postStep->GetKineticEnergy()/CLHEP::keV)  ;
 			fEventAction->sizeEf+=1;
@@ -192,12 +173,10 @@ const Settings::nCell::t_Cell_3* CpopSteppingAction::findCell(const Point_3 &poi
 		std::vector<const Settings::nCell::t_Cell_3*> sampled_cells = population_->sampled_cells();
 		std::vector<const Settings::nAgent::t_SpatialableAgent_3*> spatialables(sampled_cells.begin(), sampled_cells.end());
 
-		int nbCellPerNode = 2000;
-		octree_ = std::make_unique<Octree<OctreeNodeForSpheroidalCell>>(
-			Utils::getBoundingBox(spatialables.begin(), spatialables.end()),
-			&spatialables,
-			nbCellPerNode
-		);
+		// built by each Geant4 worker thread, not on the shared ThreadPool
+		octree_ = std::make_unique<LinearOctree>();
+		octree_->setParallel(false);
+		octree_->build(spatialables.begin(), spatialables.end());
 		is_initialized_ = true;
 	}
 	const t_SpatialableAgent_3* lNearestAgent = octree_->getNearestSpatialableAgent(point);
@@ -205,33 +184,18 @@ const Settings::nCell::t_Cell_3* CpopSteppingAction::findCell(const Point_3 &poi
 	return dynamic_cast<const Settings::nCell::t_Cell_3*>(lNearestAgent);
 }
 
-std::string CpopSteppingAction::findOrganelle(const Settings::nCell::t_Cell_3 *cell, const Point_3 &point) {
-	auto const& nuclei = cell->getNuclei();
-	for(auto const& itNuclei : nuclei) {
-		if(itNuclei->hasIn(point))
-			return "nucleus";
-	}
-
-	// If the point is not in the nucleus, it is in the cytoplasm
-	return "cytoplasm";
-}
-
-std::string CpopSteppingAction::findRegion(const Settings::nCell::t_Cell_3 *cell) {
-	auto regions = population_->regions();
-	for(auto& region : regions) {
-		const std::unordered_set<const Settings::nCell::t_Cell_3*>& samples = region.sample();
-		auto found = samples.find(cell);
-
-		if(found != samples.end()) {
-			return region.name();
-		}
+CellLocation CpopSteppingAction::locate(const Point_3 &point) {
+	if(last_cell_ == nullptr || !last_cell_->hasIn(point)) { // Avoid findCell
+		auto cell = findCell(point);
+		if(!cell || !cell->hasIn(point))
+			return {};
+		last_cell_ = cell;
 	}
 
-	// TODO check validity
-	return {};
+	return population_->locate(last_cell_, point);
 }
 
-void CpopSteppingAction::addTupleRow(const G4Step *step, int cellID, const std::string &organelle, const std::string &region) {
+void CpopSteppingAction::addTupleRow(const G4Step *step, const CellLocation& location) {
 	G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
 	double edep = step->GetTotalEnergyDeposit();
 	G4StepPoint* preStepPoint = step->GetPreStepPoint();
@@ -251,9 +215,9 @@ void CpopSteppingAction::addTupleRow(const G4Step *step, int cellID, const std::
 		analysisManager->FillNtupleDColumn(0, 5, momDir.z());
 		analysisManager->FillNtupleDColumn(0, 6, edep);
 		analysisManager->FillNtupleDColumn(0, 7, eKin); //in keV
-		analysisManager->FillNtupleIColumn(0, 8, cellID);
-		analysisManager->FillNtupleSColumn(0, 9, organelle);
-		analysisManager->FillNtupleSColumn(0, 10, region);
+		analysisManager->FillNtupleIColumn(0, 8, population->cells()[location.cell_index]->getID());
+		analysisManager->FillNtupleSColumn(0, 9, organelle_name(location.organelle));
+		analysisManager->FillNtupleSColumn(0, 10, population->region_name(location.region));
 		analysisManager->FillNtupleIColumn(0, 11, fEventAction->eventIDForSteppingAction);
 		analysisManager->AddNtupleRow(0);
 	}
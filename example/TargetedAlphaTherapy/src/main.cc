@@ -101,6 +101,8 @@ int main(int argc, char** argv) {
 	// Set the physics list
 	auto* physicsList = new cpop::PhysicsList();
 	physicsList->messenger().BuildCommands("/cpop/physics");
+	// step limits can be set per region or per organelle of the population
+	physicsList->SetPopulation(population);
 	runManager->SetUserInitialization(physicsList);
 
 	// Set custom action to extract informations from the simulation
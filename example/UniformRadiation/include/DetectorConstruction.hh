@@ -6,10 +6,14 @@
 
 class DetectorConstructionMessenger;
 
+namespace cpop {
+class Population;
+}
+
 class DetectorConstruction : public G4VUserDetectorConstruction
 {
 public:
-	DetectorConstruction();
+	explicit DetectorConstruction(cpop::Population& population);
 	~DetectorConstruction() override;
 
 	G4VPhysicalVolume* Construct() override;
@@ -17,8 +21,14 @@ public:
 	[[nodiscard]] double getWorldSize() const;
 	void setWorldSize(double value);
 
+	[[nodiscard]] bool getCellGeometry() const;
+	void setCellGeometry(bool value);
+
 private:
+	cpop::Population* _population;
 	double _worldSize;
+	/// \brief if true cells and nuclei are placed as Geant4 volumes
+	bool _cellGeometry;
 	DetectorConstructionMessenger* _messenger;
 };
 
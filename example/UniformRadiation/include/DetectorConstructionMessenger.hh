@@ -3,6 +3,7 @@
 
 #include "G4UImessenger.hh"
 #include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 
 class DetectorConstruction;
@@ -20,6 +21,7 @@ private:
 
 	G4UIdirectory* _dir = nullptr;
 	G4UIcmdWithADoubleAndUnit* _sizeCmd = nullptr;
+	G4UIcmdWithABool* _cellGeometryCmd = nullptr;
 };
 
 #endif
@@ -21,16 +21,25 @@ DetectorConstructionMessenger::DetectorConstructionMessenger(DetectorConstructio
     _sizeCmd->SetParameterName("WorldSize", false);
     _sizeCmd->SetRange("WorldSize>0");
     _sizeCmd->AvailableForStates(G4State_PreInit);
+
+    _cellGeometryCmd = new G4UIcmdWithABool("/detector/cellGeometry", this);
+    _cellGeometryCmd->SetGuidance("Place cells and nuclei as Geant4 volumes instead of looking them up at each step");
+    _cellGeometryCmd->SetParameterName("CellGeometry", true);
+    _cellGeometryCmd->SetDefaultValue(true);
+    _cellGeometryCmd->AvailableForStates(G4State_PreInit);
 }
 
 DetectorConstructionMessenger::~DetectorConstructionMessenger()
 {
     delete _sizeCmd;
+    delete _cellGeometryCmd;
 }
 
 void DetectorConstructionMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
 {
     if( command == _sizeCmd ) {
         _detector->setWorldSize(_sizeCmd->GetNewDoubleValue(newValue));
+    } else if( command == _cellGeometryCmd ) {
+        _detector->setCellGeometry(_cellGeometryCmd->GetNewBoolValue(newValue));
     }
 }
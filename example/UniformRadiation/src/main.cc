@@ -82,12 +82,14 @@ int main(int argc, char** argv) {
 
 	// Set mandatory initialization classes
 	// Set the geometry ie a box filled with G4_WATER
-	auto* detector = new DetectorConstruction();
+	auto* detector = new DetectorConstruction(population);
 	runManager->SetUserInitialization(detector);
 
 	// Set the physics list
 	auto* physicsList = new cpop::PhysicsList();
 	physicsList->messenger().BuildCommands("/cpop/physics");
+	// step limits can be set per region or per organelle of the population
+	physicsList->SetPopulation(population);
 	runManager->SetUserInitialization(physicsList);
 
 	// Set custom action to extract informations from the simulation
@@ -1,12 +1,30 @@
 #ifndef INFORMATION_SYSTEM_MANAGER_HH
 #define INFORMATION_SYSTEM_MANAGER_HH
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <QMutex>
 
+class MessageRingBuffer;
+
+/// \brief DEBUG_MES are compiled only in debug mode, unless INFORMATION_SYSTEM_WITH_DEBUG is set to 1
+#ifndef INFORMATION_SYSTEM_WITH_DEBUG
+	#ifdef NDEBUG
+		#define INFORMATION_SYSTEM_WITH_DEBUG 0
+	#else
+		#define INFORMATION_SYSTEM_WITH_DEBUG 1
+	#endif
+#endif
+
 /// \brief The informationSystemManager is the manager dealing with messages and
 /// making sure they are display on there integrality
 /// He is defined as a singleton
+/// \details Messages are filtered by type before any formatting, rate limited per thread,
+/// then pushed in a lock-free queue written on the output by a background thread.
 /// @author Henri Payno
 class InformationSystemManager {
 public:
@@ -23,10 +41,35 @@ public:
 	};
 
 public:
+	InformationSystemManager();
+	~InformationSystemManager();
+
 	/// \brief return the singleton of the Information system manager
 	static InformationSystemManager* getInstance();
 	/// \brief display a message
 	void Message(MessageType, std::string, std::string);
+	/// \brief display a message made of the given arguments, formatted only if it will be displayed
+	template<typename... Args>
+	void LazyMessage(MessageType, const char* pSource, const Args&... pArgs);
+
+	/// \brief return true if messages of the given type are compiled
+	static constexpr bool isCompiled(MessageType pMessType) {
+		return pMessType != DEBUG_MES || INFORMATION_SYSTEM_WITH_DEBUG;
+	}
+	/// \brief return true if messages of the given type will be displayed
+	[[nodiscard]] bool isEnabled(MessageType pMessType) const {
+		return isCompiled(pMessType) && _on.load(std::memory_order_relaxed)
+			&& (_enabledTypes.load(std::memory_order_relaxed) & (1u << pMessType));
+	}
+	/// \brief enable or disable the display of a message type
+	void setEnabled(MessageType, bool);
+
+	/// \brief set the maximal number of messages per second for each thread, 0 for no limit (default)
+	void setMaxMessagesPerSecond(unsigned int pMax) { _maxMessagesPerSecond.store(pMax, std::memory_order_relaxed); }
+	/// \brief if false, messages are written by the calling thread
+	void setAsynchronous(bool);
+	/// \brief wait until all the messages already sent are written
+	void flush();
 
 	/// \brief stop mute
 	void turnOn()	{ _on = true; }
@@ -38,8 +81,48 @@ public:
 	void unlockOutput();
 
 private:
+	static constexpr unsigned int allTypes = (1u << (OTHER_MES + 1)) - 1;
+
+	/// \brief return false if the calling thread sent too many messages recently
+	bool acceptMessage(MessageType);
+	/// \brief return the message with its header
+	static std::string format(MessageType, const std::string&, const std::string&);
+	/// \brief add the header and send the message to the output
+	void send(MessageType, const std::string&, const std::string&);
+	/// \brief write the given line on the output
+	void write(const std::string&);
+	/// \brief background thread loop
+	void writerLoop();
+	/// \brief stop the background thread after writing the pending messages
+	void stopWriter();
+
 	QMutex _printLock;  ///< \brief used to give write of display to an unick emitter ( used on lock putput/unlock output)
-	bool _on = true;    ///< \brief is the display is turned off or on ?
+	std::atomic<bool> _on{true};                            ///< \brief is the display is turned off or on ?
+	std::atomic<unsigned int> _enabledTypes{allTypes};      ///< \brief bit mask of the displayed message types
+	std::atomic<unsigned int> _maxMessagesPerSecond{0};     ///< \brief rate limit per thread, 0 for no limit
+	std::atomic<std::size_t> _nbUnreported{0};              ///< \brief suppressed messages not reported yet, all threads
+	std::atomic<bool> _asynchronous{true};                  ///< \brief are messages written by the background thread ?
+
+	std::unique_ptr<MessageRingBuffer> _buffer;   ///< \brief messages waiting to be written
+	std::atomic<std::size_t> _nbSent{0};          ///< \brief number of messages pushed in the buffer
+	std::atomic<std::size_t> _nbWritten{0};       ///< \brief number of messages written by the background thread
+	std::atomic<bool> _running{false};            ///< \brief is the background thread running ?
+	std::once_flag _writerStarted;                ///< \brief used to start the background thread once
+	std::thread _writer;                          ///< \brief background thread writing messages
 };
 
+/// \param pMessType the type of message
+/// \param pSource the origin of message
+/// \param pArgs streamed one after the other to build the message
+/// \details the arguments are only formatted if the message passes the type and rate filters.
+template<typename... Args>
+void InformationSystemManager::LazyMessage(MessageType pMessType, const char* pSource, const Args&... pArgs) {
+	if(!isEnabled(pMessType) || !acceptMessage(pMessType))
+		return;
+
+	std::ostringstream message;
+	(message << ... << pArgs);
+	send(pMessType, message.str(), pSource);
+}
+
 #endif
@@ -0,0 +1,42 @@
+#ifndef MESSAGE_RING_BUFFER_HH
+#define MESSAGE_RING_BUFFER_HH
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/// \brief Bounded lock-free queue of messages, with many producers and a single consumer.
+/// \details Each slot carries a sequence number telling whether it is free for the producer
+/// holding the matching ticket or ready to be read by the consumer (Vyukov's bounded queue).
+/// Producers only contend on a single atomic counter, the consumer never blocks them.
+class MessageRingBuffer {
+public:
+	/// \brief create a buffer able to hold at least pCapacity messages (rounded to a power of two)
+	explicit MessageRingBuffer(std::size_t pCapacity);
+
+	MessageRingBuffer(const MessageRingBuffer&) = delete;
+	MessageRingBuffer& operator=(const MessageRingBuffer&) = delete;
+
+	/// \brief add a message, return false if the buffer is full. Can be called from any thread
+	bool push(std::string&& pMessage);
+	/// \brief take the oldest message, return false if the buffer is empty. Must only be called by the consumer
+	bool pop(std::string& pMessage);
+
+	/// \brief return the number of slots
+	[[nodiscard]] std::size_t capacity() const { return _mask + 1; }
+
+private:
+	/// \brief a message slot, aligned to avoid false sharing between producers
+	struct alignas(64) Slot {
+		std::atomic<std::size_t> sequence; ///< \brief ticket of the producer allowed to write, or ticket+1 once written
+		std::string message;               ///< \brief the message
+	};
+
+	std::size_t _mask;                                 ///< \brief capacity - 1
+	std::unique_ptr<Slot[]> _slots;                    ///< \brief the slots
+	alignas(64) std::atomic<std::size_t> _enqueuePos;  ///< \brief next producer ticket
+	alignas(64) std::size_t _dequeuePos;               ///< \brief next slot read by the consumer
+};
+
+#endif
@@ -1,13 +1,41 @@
 #include "InformationSystemManager.hh"
+#include "MessageRingBuffer.hh"
+
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 
 static InformationSystemManager* informationManager = nullptr;
 
+/// \brief number of messages the queue can hold before producers have to wait
+static constexpr std::size_t bufferCapacity = 4096;
+
+/// \brief per thread message counter used by the rate limiter
+struct MessageRate {
+	std::chrono::steady_clock::time_point windowStart; ///< \brief beginning of the current one second window
+	unsigned int nbMessages = 0;                       ///< \brief messages accepted in the current window
+	unsigned int nbSuppressed = 0;                     ///< \brief messages rejected in the current window
+};
+
+static thread_local MessageRate threadMessageRate;
+
+InformationSystemManager::InformationSystemManager():
+	_buffer(std::make_unique<MessageRingBuffer>(bufferCapacity))
+{
+}
+
+InformationSystemManager::~InformationSystemManager() {
+	stopWriter();
+}
+
 /// \return the singleton of InformationSystemManager
 InformationSystemManager* InformationSystemManager::getInstance() {
-	if(!informationManager)
+	if(!informationManager) {
 		informationManager = new InformationSystemManager();
+		// the singleton is never deleted, make sure pending messages are written at exit
+		std::atexit([]{ informationManager->stopWriter(); });
+	}
 	return informationManager;
 }
 
@@ -21,15 +49,73 @@ void InformationSystemManager::unlockOutput() {
 	_printLock.unlock();
 }
 
+/// \param pMessType the message type
+/// \param pEnabled true to display this message type
+void InformationSystemManager::setEnabled(MessageType pMessType, bool pEnabled) {
+	if(pEnabled)
+		_enabledTypes.fetch_or(1u << pMessType, std::memory_order_relaxed);
+	else
+		_enabledTypes.fetch_and(~(1u << pMessType), std::memory_order_relaxed);
+}
+
+/// \param pAsynchronous true to write the messages from the background thread
+void InformationSystemManager::setAsynchronous(bool pAsynchronous) {
+	if(!pAsynchronous)
+		flush();
+	_asynchronous = pAsynchronous;
+}
+
 /// \param pMessType 	The type of message
 /// \param pMessage 	The inforamtion to display
 /// \param pSource 		The origin of message
 void InformationSystemManager::Message(MessageType pMessType, std::string pMessage, std::string pSource) {
-	std::stringstream global;
 	// if mute mode : no display. But no message saves.
-	if(!_on) return;
+	if(!isEnabled(pMessType) || !acceptMessage(pMessType))
+		return;
+
+	send(pMessType, pMessage, pSource);
+}
+
+/// \param pMessType the type of the message to accept or not
+/// \return true if the calling thread did not reach its message rate
+/// \details fatal errors are never rejected. The number of rejected messages is reported
+/// when the next window starts, or when the writer stops for the windows never closed.
+bool InformationSystemManager::acceptMessage(MessageType pMessType) {
+	unsigned int maxMessages = _maxMessagesPerSecond.load(std::memory_order_relaxed);
+	if(maxMessages == 0 || pMessType == FATAL_ERROR_MES)
+		return true;
+
+	MessageRate& rate = threadMessageRate;
+	auto now = std::chrono::steady_clock::now();
+	if(now - rate.windowStart >= std::chrono::seconds(1)) {
+		if(rate.nbSuppressed > 0) {
+			_nbUnreported.fetch_sub(rate.nbSuppressed, std::memory_order_relaxed);
+			std::string mess = std::to_string(rate.nbSuppressed) + " message(s) of this thread suppressed by the rate limit";
+			send(WARNING_MES, mess, "InformationSystemManager");
+		}
+
+		rate.windowStart = now;
+		rate.nbMessages = 0;
+		rate.nbSuppressed = 0;
+	}
+
+	if(rate.nbMessages >= maxMessages) {
+		++rate.nbSuppressed;
+		_nbUnreported.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	++rate.nbMessages;
+	return true;
+}
+
+/// \param pMessType 	The type of message
+/// \param pMessage 	The inforamtion to display
+/// \param pSource 		The origin of message
+/// \return the line to write, with the header matching the type
+std::string InformationSystemManager::format(MessageType pMessType, const std::string& pMessage, const std::string& pSource) {
+	std::stringstream global;
 
-	// printLock.lock();
 	/// TODO : color display according to message type
 	switch(pMessType) {
 		case CANT_PROCESS_MES :
@@ -39,9 +125,7 @@ void InformationSystemManager::Message(MessageType pMessType, std::string pMessa
 		}
 		case DEBUG_MES :
 		{
-#ifndef NDEBUG
 			global << "  --- DEBUG INFORMATION  ---";
-#endif
 			break;
 		}
 		case FATAL_ERROR_MES :
@@ -61,7 +145,101 @@ void InformationSystemManager::Message(MessageType pMessType, std::string pMessa
 		}
 	}
 	global << " @@@ " << pSource;
-	global << " : " << pMessage << std::endl;
+	global << " : " << pMessage << '\n';
+	return global.str();
+}
+
+/// \param pMessType 	The type of message
+/// \param pMessage 	The inforamtion to display
+/// \param pSource 		The origin of message
+void InformationSystemManager::send(MessageType pMessType, const std::string& pMessage, const std::string& pSource) {
+	std::string line = format(pMessType, pMessage, pSource);
+
+	// a fatal error may stop the execution : write everything now
+	if(pMessType == FATAL_ERROR_MES || !_asynchronous) {
+		flush();
+		write(line);
+		std::cout.flush();
+		return;
+	}
+
+	std::call_once(_writerStarted, [this] {
+		_running = true;
+		_writer = std::thread(&InformationSystemManager::writerLoop, this);
+	});
+
+	// the background thread has been stopped (program exit)
+	if(!_running) {
+		write(line);
+		return;
+	}
+
+	while(!_buffer->push(std::move(line))) {
+		// the background thread is behind
+		if(!_running) {
+			write(line);
+			return;
+		}
+		std::this_thread::yield();
+	}
+	_nbSent.fetch_add(1, std::memory_order_release);
+}
+
+/// \param pLine the line to write
+void InformationSystemManager::write(const std::string& pLine) {
+	_printLock.lock();
+	std::cout << pLine;
+	_printLock.unlock();
+}
+
+/// \details messages are written by batch to take the output lock once per batch.
+void InformationSystemManager::writerLoop() {
+	static constexpr std::size_t maxBatchSize = 1 << 16;
+
+	std::string line;
+	std::string batch;
+	for(;;) {
+		bool running = _running.load(std::memory_order_acquire);
+
+		std::size_t nbMessages = 0;
+		batch.clear();
+		while(batch.size() < maxBatchSize && _buffer->pop(line)) {
+			batch += line;
+			++nbMessages;
+		}
+
+		if(nbMessages > 0) {
+			write(batch);
+			_nbWritten.fetch_add(nbMessages, std::memory_order_release);
+		} else if(!running) {
+			break;
+		} else {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+	std::cout.flush();
+}
+
+void InformationSystemManager::flush() {
+	std::size_t nbSent = _nbSent.load(std::memory_order_acquire);
+	while(_running.load(std::memory_order_acquire) && _nbWritten.load(std::memory_order_acquire) < nbSent)
+		std::this_thread::yield();
+	std::cout.flush();
+}
+
+void InformationSystemManager::stopWriter() {
+	_running = false;
+	if(_writer.joinable())
+		_writer.join();
+
+	// messages pushed while the thread was stopping
+	std::string line;
+	while(_buffer->pop(line))
+		write(line);
 
-	std::cout << global.str();
+	// messages suppressed in windows no message closed
+	std::size_t nbUnreported = _nbUnreported.exchange(0, std::memory_order_relaxed);
+	if(nbUnreported > 0)
+		write(format(WARNING_MES, std::to_string(nbUnreported) + " message(s) suppressed by the rate limit", "InformationSystemManager"));
+	std::cout.flush();
 }
@@ -0,0 +1,59 @@
+#include "MessageRingBuffer.hh"
+
+/// \param pCapacity minimal number of messages the buffer can hold
+MessageRingBuffer::MessageRingBuffer(std::size_t pCapacity) {
+	std::size_t capacity = 2;
+	while(capacity < pCapacity)
+		capacity <<= 1;
+
+	_mask = capacity - 1;
+	_slots = std::make_unique<Slot[]>(capacity);
+	for(std::size_t iSlot = 0; iSlot < capacity; ++iSlot)
+		_slots[iSlot].sequence.store(iSlot, std::memory_order_relaxed);
+
+	_enqueuePos.store(0, std::memory_order_relaxed);
+	_dequeuePos = 0;
+}
+
+/// \param pMessage the message to add, moved only on success
+/// \return false if the buffer is full
+bool MessageRingBuffer::push(std::string&& pMessage) {
+	std::size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+	Slot* slot;
+	for(;;) {
+		slot = &_slots[pos & _mask];
+		std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+		if(diff == 0) {
+			// the slot is free for this ticket, try to take it
+			if(_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if(diff < 0) {
+			// the consumer did not release this slot yet : full
+			return false;
+		} else {
+			// another producer took the ticket
+			pos = _enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->message = std::move(pMessage);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+/// \param pMessage filled with the oldest message
+/// \return false if the buffer is empty
+bool MessageRingBuffer::pop(std::string& pMessage) {
+	Slot* slot = &_slots[_dequeuePos & _mask];
+	std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+	if(sequence != _dequeuePos + 1)
+		return false;
+
+	pMessage = std::move(slot->message);
+	slot->message.clear();
+	// release the slot for the producer of the next round
+	slot->sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+	++_dequeuePos;
+	return true;
+}
@@ -41,9 +41,11 @@ public:
 	[[nodiscard]] Point getRequestedPosition() const { return _requiredNewPos; }   ///< \brief required position getter
 	/// \brief called to validate the new agent position.
 	void validRequiredPos() {
-		Spatialable<Kernel, Point, Vector>::position = _requiredNewPos;
+		Spatialable<Kernel, Point, Vector>::_position = _requiredNewPos;
 		_bIsReqNewPos = false;
 	}
+	/// \brief called by the conflict solvers to correct the requested position
+	void setRequestedPosition(Point p) { _requiredNewPos = p; }
 	/// \brief called when the agent require a new position
 	void setIsRequiringNewPos(bool b) { _bIsReqNewPos = b; }
 	/// \brief true when the agent is requiring a new position
@@ -66,7 +68,8 @@ protected:
 template<typename Kernel, typename Point, typename Vector>
 DynamicAgent<Kernel, Point, Vector>::DynamicAgent(Body* pBody, Point pPosition, Vector pOrientation):
 	SpatialableAgent<Kernel, Point, Vector>(pBody, pPosition, pOrientation),
-	Movable<Kernel, Point, Vector>(Vector(), Kernel(), Vector())
+	Movable<Kernel, Point, Vector>(Vector(), Kernel(), Vector()),
+	_bIsReqNewPos(false)
 {
 }
 
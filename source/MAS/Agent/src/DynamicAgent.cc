@@ -22,12 +22,17 @@ void DynamicAgent<double, Point_2, Vector_2>::updatePosition(double deltaT) {
 	}
 
 #ifdef SIMULATION_VALID_AGENT_NEW_POS
-	requireNewPos(K::Point_2(position + movement));
+	// the conflict solvers correct the requested position before it is applied
+	requireNewPos(_position + movement);
 #else
-	setPosition(_position + movement);
+	// in deterministic mode the other agents of the step must still see the current position
+	if(SimulationManager::getInstance()->isDeterministic())
+		requireNewPos(_position + movement);
+	else
+		setPosition(_position + movement);
+#endif
 	_direction = movement;
 	_speed = sqrt(_direction.squared_length());
-#endif
 
 	assert(CGAL::is_finite(_position.x()));
 	assert(CGAL::is_finite(_position.y()));
@@ -54,12 +59,17 @@ void DynamicAgent<double, Point_3, Vector_3>::updatePosition(double deltaT) {
 	}
 
 #ifdef SIMULATION_VALID_AGENT_NEW_POS
-	requireNewPos(K::Point_3(position + movement));
+	// the conflict solvers correct the requested position before it is applied
+	requireNewPos(_position + movement);
 #else
-	setPosition(_position + movement);
+	// in deterministic mode the other agents of the step must still see the current position
+	if(SimulationManager::getInstance()->isDeterministic())
+		requireNewPos(_position + movement);
+	else
+		setPosition(_position + movement);
+#endif
 	_direction = movement;
 	_speed = sqrt(_direction.squared_length());
-#endif
 
 	assert(CGAL::is_finite(_position.x()));
 	assert(CGAL::is_finite(_position.y()));
@@ -15,7 +15,12 @@ public:
 
 	///\brief solve the pendante conflict with the Agents
 	/// \param pAgent The agent we want to solve the conflict for
-	[[nodiscard]] virtual bool solveConflict(std::vector<Agent*> pAgent) const = 0;
+	[[nodiscard]] virtual bool solveConflict(const std::vector<Agent*>& pAgent) const = 0;
+	/// \brief return the number of conflicts detected by the last call to solveConflict
+	[[nodiscard]] unsigned int getNbConflictLastCall() const { return _nbConflictLastCall; }
+
+protected:
+	mutable unsigned int _nbConflictLastCall = 0; ///< \brief number of conflicts detected by the last call to solveConflict
 };
 
 #endif
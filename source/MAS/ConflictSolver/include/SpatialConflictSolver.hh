@@ -3,69 +3,204 @@
 
 #include "DynamicAgent.hh"
 #include "ConflictSolver.hh"
+#include "ThreadPool.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 #define NB_MAX_ITER_TO_SOLVE_SPA_POS 100
 
 /// \brief The agent class : define rules to solve conflict between DYNAMIC AGENT ONLY and make
-/// sure two dynamic agent aren't at the same spot.
+/// sure two dynamic agent do not overlap.
+/// \details Two agents overlap if their positions are closer than twice the agent radius minus the tolerance
+/// (with a null radius, if they are at the same position). The positions are hashed in a uniform grid whose
+/// cells have this minimal distance as size, so only the agents of the neighbouring cells are compared.
+///
+/// The agents which do not move have the priority, then the moving agents by increasing ID. An agent overlapping
+/// an agent of higher priority goes back on its journey (its displacement is halved) and the conflicts are
+/// detected again, until none remains. After NB_MAX_ITER_TO_SOLVE_SPA_POS halvings the move of the agent is
+/// cancelled. Detection and resolution run in parallel by cell of the grid, each agent only writing its own
+/// position : the result does not depend on the number of threads nor on the order of the agents.
 /// \warning this solver only affect dynamic agent.
 /// @author Henri Payno
 template <typename Kernel, typename Point, typename Vector>
 class SpatialConflictSolver : public ConflictSolver {
+	using t_DynamicAgent = DynamicAgent<Kernel, Point, Vector>;	///< \brief the dynamic agents handled
+	using t_CellCoordinates = std::array<std::int64_t, 3>;		///< \brief coordinates of a cell of the grid
+
 public:
+	/// \param pRadius the radius of the agents
+	/// \param pTolerance the overlap allowed between two agents
+	explicit SpatialConflictSolver(Kernel pRadius = Kernel(), Kernel pTolerance = Kernel()):
+		_radius(pRadius),
+		_tolerance(pTolerance)
+	{
+	}
+
 	/// \brief solve the pendante conflict with the Agents
-	[[nodiscard]] inline bool solveConflict(std::vector<Agent*> agent) const override;
+	[[nodiscard]] inline bool solveConflict(const std::vector<Agent*>& agent) const override;
+
+	/// \brief radius setter
+	void setRadius(Kernel pRadius) { _radius = pRadius; }
+	/// \brief radius getter
+	[[nodiscard]] Kernel getRadius() const { return _radius; }
+	/// \brief tolerance setter
+	void setTolerance(Kernel pTolerance) { _tolerance = pTolerance; }
+	/// \brief tolerance getter
+	[[nodiscard]] Kernel getTolerance() const { return _tolerance; }
+	/// \brief return the number of moves cancelled by the last call to solveConflict
+	[[nodiscard]] unsigned int getNbCancelledMoveLastCall() const { return _nbCancelledMoveLastCall; }
+
+private:
+	/// \brief return the distance under which two agents overlap
+	[[nodiscard]] Kernel getMinimalDistance() const { return std::max(Kernel(), 2*_radius - _tolerance); }
+	/// \brief return the coordinates of the grid cell containing the point
+	[[nodiscard]] static t_CellCoordinates getCellCoordinates(const Point& pPoint, Kernel pCellSize);
+
+	Kernel _radius;											///< \brief radius of the agents
+	Kernel _tolerance;										///< \brief overlap allowed between two agents
+	mutable unsigned int _nbCancelledMoveLastCall = 0;		///< \brief number of moves cancelled by the last call
 };
 
 //////////////////// FUNCTION DEFINITIONS ///////////////////////////////////
 
+/// \param pPoint the point to hash
+/// \param pCellSize the size of the grid cells
+/// \return the cell coordinates, the unused dimensions are 0
+template<typename Kernel, typename Point, typename Vector>
+typename SpatialConflictSolver<Kernel, Point, Vector>::t_CellCoordinates
+SpatialConflictSolver<Kernel, Point, Vector>::getCellCoordinates(const Point& pPoint, Kernel pCellSize) {
+	t_CellCoordinates coordinates = {0, 0, 0};
+	for(int iDim = 0; iDim < Point::Ambient_dimension::value; ++iDim)
+		coordinates[iDim] = static_cast<std::int64_t>(std::floor(pPoint[iDim]/pCellSize));
+	return coordinates;
+}
+
 /// \param agents The agents we have to solve conflict for
 /// \return true if conflict solving succeded
 template<typename Kernel, typename Point, typename Vector>
-bool SpatialConflictSolver<Kernel, Point, Vector>::solveConflict(std::vector<Agent*> agents) const {
-	std::set<Point> alreadySettedPosition;
-
-	/// cast agent to dynamic
-	/// set none dynamic agent first.
-	using DynamicAgentKPV = DynamicAgent<Kernel, Point, Vector>;
-	using DynamicAgents = std::set<DynamicAgentKPV*>;
-	DynamicAgents dynamicAgents;
+bool SpatialConflictSolver<Kernel, Point, Vector>::solveConflict(const std::vector<Agent*>& agents) const {
+	_nbConflictLastCall = 0;
+	_nbCancelledMoveLastCall = 0;
 
-	for(auto const& iniAgt: agents) {
-		auto const* dymAgt = dynamic_cast<DynamicAgentKPV const*>(iniAgt);
+	/// cast agent to dynamic. Positions are the fixed ones first, then the requested ones by agent ID.
+	std::vector<Point> positions;
+	std::vector<t_DynamicAgent*> movingAgents;
+	for(auto* iniAgt: agents) {
+		auto* dymAgt = dynamic_cast<t_DynamicAgent*>(iniAgt);
 		if(dymAgt) {
 			// if doesn't require a new position, he is prioritary
 			if(!dymAgt->isRequiringNewPos())
-				alreadySettedPosition.insert(dymAgt->getPosition());
+				positions.push_back(dymAgt->getPosition());
 			else
-				dynamicAgents.insert(dymAgt);
+				movingAgents.push_back(dymAgt);
 		}
 	}
+	if(movingAgents.empty())
+		return true;
 
-	/// check position
-	for(auto const& agent: dynamicAgents) {
-		if(alreadySettedPosition.find(agent->getRequestedPosition()) == alreadySettedPosition.end())
-			alreadySettedPosition.insert(agent->getRequestedPosition());
-		else {
-			// get a random point on "journey"/ flight
-			double ratio;
-			Vector v(agent->getPosition() - agent->getRequestedPosition());
-			unsigned int nbIter = 0;
-			while((alreadySettedPosition.find(agent->getPosition() + v*ratio) != alreadySettedPosition.end() ) &&
-					(nbIter < NB_MAX_ITER_TO_SOLVE_SPA_POS)) {
-				ratio = ratio / 2.;
-				nbIter++;
+	std::sort(movingAgents.begin(), movingAgents.end(), [](const t_DynamicAgent* a, const t_DynamicAgent* b) {
+		return a->getID() < b->getID();
+	});
+	std::size_t nbFixed = positions.size();
+	for(auto const* agent: movingAgents)
+		positions.push_back(agent->getRequestedPosition());
+
+	Kernel minDistance = getMinimalDistance();
+	Kernel squareMinDistance = minDistance*minDistance;
+	Kernel cellSize = minDistance > Kernel() ? minDistance : Kernel(1);
+	int nbDimension = Point::Ambient_dimension::value;
+
+	std::vector<Kernel> ratios(movingAgents.size(), Kernel(1));
+	std::vector<char> hasConflict(movingAgents.size(), 0);
+	std::vector<char> isCorrected(movingAgents.size(), 0);
+
+	// priority of a position, lower is higher. Fixed positions and cancelled moves have the highest one
+	auto priority = [&](std::size_t pIndex) -> std::int64_t {
+		if(pIndex < nbFixed || ratios[pIndex - nbFixed] <= Kernel())
+			return -1;
+		return static_cast<std::int64_t>(pIndex - nbFixed);
+	};
+
+	std::vector<std::pair<t_CellCoordinates, std::size_t>> entries(positions.size());
+	std::vector<std::size_t> cellBegins;
+	for(unsigned int iRound = 0; ; ++iRound) {
+		/// hash the positions, entries of a cell are contiguous
+		ThreadPool::getInstance()->parallelFor(positions.size(), [&](std::size_t pBegin, std::size_t pEnd) {
+			for(std::size_t iPos = pBegin; iPos < pEnd; ++iPos)
+				entries[iPos] = std::make_pair(getCellCoordinates(positions[iPos], cellSize), iPos);
+		}, 1024);
+		std::sort(entries.begin(), entries.end());
+
+		cellBegins.clear();
+		for(std::size_t iEntry = 0; iEntry < entries.size(); ++iEntry) {
+			if(iEntry == 0 || entries[iEntry].first != entries[iEntry - 1].first)
+				cellBegins.push_back(iEntry);
+		}
+		cellBegins.push_back(entries.size());
+
+		/// detect conflicts with the positions of higher priority, by cell
+		ThreadPool::getInstance()->parallelFor(cellBegins.size() - 1, [&](std::size_t pBegin, std::size_t pEnd) {
+			for(std::size_t iCell = pBegin; iCell < pEnd; ++iCell) {
+				for(std::size_t iEntry = cellBegins[iCell]; iEntry < cellBegins[iCell + 1]; ++iEntry) {
+					std::size_t iPos = entries[iEntry].second;
+					if(iPos < nbFixed)
+						continue;
+					std::int64_t lPriority = priority(iPos);
+					if(lPriority < 0) {
+						hasConflict[iPos - nbFixed] = false;
+						continue;
+					}
+
+					bool conflict = false;
+					t_CellCoordinates cell = entries[iEntry].first;
+					for(std::int64_t dx = -1; dx <= 1 && !conflict; ++dx) {
+						for(std::int64_t dy = -1; dy <= 1 && !conflict; ++dy) {
+							for(std::int64_t dz = (nbDimension > 2 ? -1 : 0); dz <= (nbDimension > 2 ? 1 : 0) && !conflict; ++dz) {
+								t_CellCoordinates neighbour = {cell[0] + dx, cell[1] + dy, cell[2] + dz};
+								auto itOther = std::lower_bound(entries.begin(), entries.end(), std::make_pair(neighbour, std::size_t(0)));
+								for(; itOther != entries.end() && itOther->first == neighbour && !conflict; ++itOther) {
+									if(itOther->second == iPos || priority(itOther->second) >= lPriority)
+										continue;
+									Kernel squareDistance = CGAL::squared_distance(positions[iPos], positions[itOther->second]);
+									conflict = squareDistance <= Kernel() || squareDistance < squareMinDistance;
+								}
+							}
+						}
+					}
+					hasConflict[iPos - nbFixed] = conflict;
+				}
 			}
+		});
+
+		if(std::none_of(hasConflict.begin(), hasConflict.end(), [](char c) { return c; }))
+			break;
 
-			if(nbIter >= NB_MAX_ITER_TO_SOLVE_SPA_POS ) {
-				std::cout << " too much conflict " << std::endl;
-				return false;
+		/// the agents in conflict go back on their journey, their move is cancelled after too many iterations
+		ThreadPool::getInstance()->parallelFor(movingAgents.size(), [&](std::size_t pBegin, std::size_t pEnd) {
+			for(std::size_t iAgent = pBegin; iAgent < pEnd; ++iAgent) {
+				if(!hasConflict[iAgent])
+					continue;
+				isCorrected[iAgent] = true;
+				ratios[iAgent] = (iRound + 1 < NB_MAX_ITER_TO_SOLVE_SPA_POS) ? ratios[iAgent]/2 : Kernel();
+				auto const* agent = movingAgents[iAgent];
+				Vector v(agent->getRequestedPosition() - agent->getPosition());
+				positions[nbFixed + iAgent] = agent->getPosition() + v*ratios[iAgent];
 			}
+		}, 1024);
+	}
 
-			Point newPos = agent->getPosition() + v*ratio;
-			agent->setRequiredPosition(newPos);
-			alreadySettedPosition.insert(newPos);
-		}
+	for(std::size_t iAgent = 0; iAgent < movingAgents.size(); ++iAgent) {
+		if(!isCorrected[iAgent])
+			continue;
+		++_nbConflictLastCall;
+		if(ratios[iAgent] <= Kernel())
+			++_nbCancelledMoveLastCall;
+		movingAgents[iAgent]->setRequestedPosition(positions[nbFixed + iAgent]);
 	}
 	return true;
 }
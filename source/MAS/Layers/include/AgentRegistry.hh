@@ -0,0 +1,118 @@
+#ifndef AGENT_REGISTRY_HH
+#define AGENT_REGISTRY_HH
+
+#include "Agent.hh"
+
+#include <cstddef>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+/// \brief Set of agents stored in a contiguous array.
+/// \details The agent pointer is the handle of the agent : it stays valid whatever the insertions and
+/// removals, only its index in the array may change. Membership is tested in constant time and an agent
+/// is removed by moving the last agent at its place (the order of the agents is the insertion one until
+/// a removal).
+class AgentRegistry {
+public:
+	using const_iterator = std::vector<Agent*>::const_iterator;	///< \brief iterator on the agents
+
+	/// \brief add an agent, return false if already registered
+	bool insert(Agent*);
+	/// \brief add a range of agents, the ones already registered are skipped
+	template<typename AgentIterator>
+	void insert(AgentIterator pBegin, AgentIterator pEnd);
+	/// \brief remove an agent, return false if not registered
+	bool erase(const Agent*);
+	/// \brief remove all agents
+	void clear();
+	/// \brief reserve memory for n agents
+	void reserve(std::size_t);
+
+	/// \brief return true if the agent is registered
+	[[nodiscard]] bool contains(const Agent* pAgent) const { return _indexes.find(pAgent) != _indexes.end(); }
+	/// \brief return the index of the agent in the array, size() if not registered
+	[[nodiscard]] std::size_t indexOf(const Agent*) const;
+	/// \brief return the number of agents
+	[[nodiscard]] std::size_t size() const { return _agents.size(); }
+	/// \brief return true if no agent is registered
+	[[nodiscard]] bool empty() const { return _agents.empty(); }
+	/// \brief return the agent at the given index
+	[[nodiscard]] Agent* operator[](std::size_t pIndex) const { return _agents[pIndex]; }
+
+	[[nodiscard]] const_iterator begin() const { return _agents.begin(); }
+	[[nodiscard]] const_iterator end() const { return _agents.end(); }
+	/// \brief return the contiguous array of agents
+	[[nodiscard]] const std::vector<Agent*>& getAgents() const { return _agents; }
+
+private:
+	std::vector<Agent*> _agents;								///< \brief the agents
+	std::unordered_map<const Agent*, std::size_t> _indexes;		///< \brief index of each agent in _agents
+};
+
+/// \brief Non owning view on the agents of several registries (typically a layer and its sub layers).
+/// \details An agent registered in several registries is only visited once, from the first registry
+/// containing it. A filter can exclude some agents from the view. No agent is copied, the registries must
+/// outlive the view and not be modified while iterating.
+class AgentRange {
+public:
+	/// \brief return true if the agent is part of the view
+	using Filter = bool (*)(const Agent*);
+
+	/// \brief forward iterator on the unique agents of the registries
+	class const_iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Agent*;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Agent* const*;
+		using reference = Agent* const&;
+
+		const_iterator(const AgentRange* pRange, std::size_t pRegistry, std::size_t pIndex);
+
+		reference operator*() const { return current(); }
+		pointer operator->() const { return &current(); }
+		const_iterator& operator++();
+		const_iterator operator++(int) { const_iterator lCopy = *this; ++(*this); return lCopy; }
+		bool operator==(const const_iterator& pOther) const { return _registry == pOther._registry && _index == pOther._index; }
+		bool operator!=(const const_iterator& pOther) const { return !(*this == pOther); }
+
+	private:
+		/// \brief return the current agent
+		[[nodiscard]] reference current() const { return _range->_registries[_registry]->getAgents()[_index]; }
+		/// \brief move to the next valid position from the current one, included
+		void skipInvalid();
+
+		const AgentRange* _range;	///< \brief the range iterated
+		std::size_t _registry;		///< \brief index of the current registry
+		std::size_t _index;			///< \brief index of the agent in the current registry
+	};
+
+	AgentRange() = default;
+	explicit AgentRange(std::vector<const AgentRegistry*> pRegistries, Filter pFilter = nullptr);
+
+	[[nodiscard]] const_iterator begin() const { return {this, 0, 0}; }
+	[[nodiscard]] const_iterator end() const { return {this, _registries.size(), 0}; }
+	/// \brief return the number of unique agents, linear in the number of agents
+	[[nodiscard]] std::size_t size() const;
+	/// \brief return true if no agent is visited
+	[[nodiscard]] bool empty() const { return begin() == end(); }
+	/// \brief return true if an agent is contained in one of the registries and accepted by the filter
+	[[nodiscard]] bool contains(const Agent*) const;
+
+private:
+	std::vector<const AgentRegistry*> _registries;	///< \brief the registries viewed
+	Filter _filter = nullptr;						///< \brief agents accepted by the view, all if null
+};
+
+//////////////////// FUNCTION DEFINITIONS ///////////////////////////////////
+
+/// \param pBegin iterator on the first agent to add
+/// \param pEnd iterator after the last agent to add
+template<typename AgentIterator>
+void AgentRegistry::insert(AgentIterator pBegin, AgentIterator pEnd) {
+	for(; pBegin != pEnd; ++pBegin)
+		insert(*pBegin);
+}
+
+#endif
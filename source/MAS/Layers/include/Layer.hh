@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "Agent.hh"
+#include "AgentRegistry.hh"
 
 /// \brief Define a layer.
 /// a layer handle mainly the display procedures.
@@ -38,14 +39,14 @@ public:
 	/// \brief display the layer and all the agent included
 	virtual void draw() const;
 
-	/// \brief return the list of agent contained inside the layer
-	[[nodiscard]] inline virtual std::set<Agent*> getAgents() const { return _agents; }
+	/// \brief return the agents contained inside the layer
+	[[nodiscard]] inline const AgentRegistry& getAgents() const { return _agents; }
 	/// \brief return the number of agent contained on the world
 	[[nodiscard]] inline unsigned long int getNbAgent() const	{ return (unsigned long int) _agents.size(); }
-	/// \brief return the set of agents contained inside sub layer with a unicity constrain
-	[[nodiscard]] std::set<Agent*> getUniqueSubAgents() const;
-	/// \brief return all the contained agents from this layer to the sublayers
-	[[nodiscard]] std::set<Agent*> getUniqueAgentsAndSubAgents() const;
+	/// \brief return a view on the agents contained inside sub layer with a unicity constrain
+	[[nodiscard]] AgentRange getUniqueSubAgents() const;
+	/// \brief return a view on all the contained agents from this layer to the sublayers
+	[[nodiscard]] AgentRange getUniqueAgentsAndSubAgents() const;
 
 	/// \brief return true if contains the layer requested
 	virtual bool contains(Layer*) const;
@@ -70,9 +71,9 @@ public:
 	[[nodiscard]] float getColor(int index) const { return _color[index]; }
 
 protected:
-	/// \brief set of agent included on the layer.
+	/// \brief agents included on the layer.
 	/// no setter because the WorldLayer will be able to add some but not the world
-	std::set<Agent*> _agents;
+	AgentRegistry _agents;
 
 	std::string _name;                        ///< \brief the name of the layer
 	float _alpha;                             ///< \brief the alpha parameter for the display
@@ -83,6 +84,8 @@ protected:
 
 	/// \brief include all agents contained inside sub layer on this layer
 	void includeSubLayersAgents();
+	/// \brief add the registries of the sub layers, recursively
+	void collectSubRegistries(std::vector<const AgentRegistry*>&) const;
 
 	/// \brief adding a layer child
 	bool addChild(Layer*);
@@ -40,7 +40,7 @@ World<Kernel, Point, Vector>::World(std::string const& name):
 
 template<typename Kernel, typename Point, typename Vector>
 World<Kernel, Point, Vector>::~World() {
-	std::set<Agent*> const& lAllAgents = Layer::getUniqueAgentsAndSubAgents();
+	AgentRange lAllAgents = Layer::getUniqueAgentsAndSubAgents();
 	for(auto const& agent: lAllAgents)
 			delete agent;
 }
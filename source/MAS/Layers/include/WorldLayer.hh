@@ -22,6 +22,9 @@ public:
 
 	/// \brief adding an agent to the world layer
 	inline bool addAgent(Agent*);
+	/// \brief adding a range of agents to the world layer
+	template <typename AgentIterator>
+	void addAgents(AgentIterator, AgentIterator);
 	/// \brief removing an agent to the world layer
 	void removeAgent(Agent*);
 	/// \brief display the layer and all the agent included
@@ -69,12 +72,21 @@ bool WorldLayer<Kernel, Point, Vector>::addAgent(Agent* pAgentToAdd) {
 	if(!pAgentToAdd)
 		return false;
 
-	if(Layer::_agents.find(pAgentToAdd) == Layer::_agents.end())
-		Layer::_agents.insert(pAgentToAdd);
+	Layer::_agents.insert(pAgentToAdd);
 
 	return true;
 }
 
+/// \brief add a range of agents on a layer in one insertion
+/// \param pBegin first agent to add
+/// \param pEnd end of the agents to add
+template<typename Kernel, typename Point, typename Vector>
+template<typename AgentIterator>
+void WorldLayer<Kernel, Point, Vector>::addAgents(AgentIterator pBegin, AgentIterator pEnd) {
+	Layer::_agents.insert(pBegin, pEnd);
+	assert(!Layer::_agents.contains(nullptr));
+}
+
 /// \brief add an agent on a layer
 template<typename Kernel, typename Point, typename Vector>
 void WorldLayer<Kernel, Point, Vector>::removeAgent(Agent* pAgentToRemove) {
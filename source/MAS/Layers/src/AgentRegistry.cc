@@ -0,0 +1,115 @@
+#include "AgentRegistry.hh"
+
+#include <cassert>
+
+/// \param pAgent The agent to add
+/// \return true if the agent has been added
+bool AgentRegistry::insert(Agent* pAgent) {
+	assert(pAgent);
+	if(!_indexes.emplace(pAgent, _agents.size()).second)
+		return false;
+	_agents.push_back(pAgent);
+	return true;
+}
+
+/// \param pAgent The agent to remove
+/// \return true if the agent has been removed
+bool AgentRegistry::erase(const Agent* pAgent) {
+	auto itIndex = _indexes.find(pAgent);
+	if(itIndex == _indexes.end())
+		return false;
+
+	// the last agent takes the place of the removed one
+	std::size_t index = itIndex->second;
+	_indexes.erase(itIndex);
+	if(index + 1 != _agents.size()) {
+		_agents[index] = _agents.back();
+		_indexes[_agents[index]] = index;
+	}
+	_agents.pop_back();
+	return true;
+}
+
+void AgentRegistry::clear() {
+	_agents.clear();
+	_indexes.clear();
+}
+
+/// \param pNbAgent The number of agents to reserve memory for
+void AgentRegistry::reserve(std::size_t pNbAgent) {
+	_agents.reserve(pNbAgent);
+	_indexes.reserve(pNbAgent);
+}
+
+/// \param pAgent The agent to look for
+/// \return the index of the agent, size() if not registered
+std::size_t AgentRegistry::indexOf(const Agent* pAgent) const {
+	auto itIndex = _indexes.find(pAgent);
+	return itIndex == _indexes.end() ? _agents.size() : itIndex->second;
+}
+
+/// \param pRegistries The registries to view, in the order of iteration
+/// \param pFilter Return true for the agents to view, all agents are viewed if null
+AgentRange::AgentRange(std::vector<const AgentRegistry*> pRegistries, Filter pFilter):
+	_registries(std::move(pRegistries)),
+	_filter(pFilter)
+{
+}
+
+/// \return the number of unique agents
+std::size_t AgentRange::size() const {
+	return static_cast<std::size_t>(std::distance(begin(), end()));
+}
+
+/// \param pAgent The agent to look for
+/// \return true if one of the registries contains the agent and the filter accepts it
+bool AgentRange::contains(const Agent* pAgent) const {
+	if(_filter && !_filter(pAgent))
+		return false;
+	for(auto const* registry : _registries) {
+		if(registry->contains(pAgent))
+			return true;
+	}
+	return false;
+}
+
+/// \param pRange The range iterated
+/// \param pRegistry The index of the registry
+/// \param pIndex The index of the agent in the registry
+AgentRange::const_iterator::const_iterator(const AgentRange* pRange, std::size_t pRegistry, std::size_t pIndex):
+	_range(pRange),
+	_registry(pRegistry),
+	_index(pIndex)
+{
+	skipInvalid();
+}
+
+AgentRange::const_iterator& AgentRange::const_iterator::operator++() {
+	++_index;
+	skipInvalid();
+	return *this;
+}
+
+/// \details skip the end of the registries, the agents rejected by the filter and the agents already visited in a previous registry
+void AgentRange::const_iterator::skipInvalid() {
+	auto const& registries = _range->_registries;
+	while(_registry < registries.size()) {
+		if(_index >= registries[_registry]->size()) {
+			++_registry;
+			_index = 0;
+			continue;
+		}
+
+		const Agent* agent = (*registries[_registry])[_index];
+		if(_range->_filter && !_range->_filter(agent)) {
+			++_index;
+			continue;
+		}
+		bool alreadyVisited = false;
+		for(std::size_t iRegistry = 0; iRegistry < _registry && !alreadyVisited; ++iRegistry)
+			alreadyVisited = registries[iRegistry]->contains(agent);
+		if(!alreadyVisited)
+			return;
+		++_index;
+	}
+}
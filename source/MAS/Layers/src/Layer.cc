@@ -76,38 +76,28 @@ void Layer::removeChild(Layer* pLayer) {
 		_layerType = LEAF;
 }
 
-/// \return The list of unique agents include inside sub layers}
-std::set<Agent*> Layer::getUniqueSubAgents() const {
-	std::set<Agent*> res;
-
+/// \param pRegistries The registries of the sub layers are added to it, depth first
+void Layer::collectSubRegistries(std::vector<const AgentRegistry*>& pRegistries) const {
 	for(auto const& _childLayer : _childLayers) {
-		std::set<Agent*> agentsLvl1 = _childLayer.second->getAgents();
-
-		for(auto* itAgent : agentsLvl1) {
-			/// the set insure the unicity of an element. If already exists, we not be added
-			res.insert(itAgent);
-		}
-
-		std::set<Agent*> agentsLvl2 = _childLayer.second->getUniqueSubAgents();
-		for(auto* itAgent : agentsLvl2) {
-			/// the set insure the unicity of an element. If already exists, we not be added
-			res.insert(itAgent);
-		}
+		pRegistries.push_back(&_childLayer.second->_agents);
+		_childLayer.second->collectSubRegistries(pRegistries);
 	}
+}
 
-	return res;
+/// \return The view on the unique agents include inside sub layers
+AgentRange Layer::getUniqueSubAgents() const {
+	std::vector<const AgentRegistry*> registries;
+	collectSubRegistries(registries);
+	return AgentRange(std::move(registries));
 }
 
 void Layer::includeSubLayersAgents() {
 	if(DEBUG_LAYER)
 		InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, "Start layer initialiation", "Layer");
 
-	std::set<Agent*> lSubAgents = getUniqueSubAgents();
-
-	for(auto* lSubAgent : lSubAgents) {
-		/// the set insure the unicity of an element. If already exists, we not be added
-		_agents.insert(lSubAgent);
-	}
+	/// the registry insure the unicity of an element. If already exists, we not be added
+	AgentRange lSubAgents = getUniqueSubAgents();
+	_agents.insert(lSubAgents.begin(), lSubAgents.end());
 
 	if(DEBUG_LAYER) {
 		std::string mess = " after initialisation, layer " + _name + " contained : " + std::to_string(_agents.size());
@@ -115,15 +105,11 @@ void Layer::includeSubLayersAgents() {
 	}
 }
 
-/// \return the set of agent include at the level and down ( until LEAF )
-std::set<Agent*> Layer::getUniqueAgentsAndSubAgents() const {
-	std::set<Agent*> res = _agents;
-	std::set<Agent*> subAgents = getUniqueSubAgents();
-
-	for(auto* subAgent : subAgents)
-		res.insert(subAgent);
-
-	return res;
+/// \return the view on the agents include at the level and down ( until LEAF )
+AgentRange Layer::getUniqueAgentsAndSubAgents() const {
+	std::vector<const AgentRegistry*> registries = {&_agents};
+	collectSubRegistries(registries);
+	return AgentRange(std::move(registries));
 }
 
 /// will reference all unique agent and make sure each his execute only once
@@ -210,7 +196,7 @@ Layer* Layer::getChild(std::string const& pID) const {
 std::set<Agent*> Layer::getNRandomAgent(unsigned int pNbAgentToPick) const {
 	assert(pNbAgentToPick <= getNbAgent());
 	if(pNbAgentToPick >= getNbAgent())
-		return _agents;
+		return {_agents.begin(), _agents.end()};
 
 	std::set<Agent*> requestedAgts;
 	while(requestedAgts.size() < pNbAgentToPick) {
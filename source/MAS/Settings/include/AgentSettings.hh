@@ -4,7 +4,7 @@
 #include "DynamicAgent.hh"
 #include "GeometrySettings.hh"
 
-// #define SIMULATION_VALID_AGENT_NEW_POS ///< \brief. if true at each iteration the simulation manager validate the requiered position of the agent. Else no check is made, Agent can be at the same position
+// #define SIMULATION_VALID_AGENT_NEW_POS ///< \brief. defined by the WITH_AGENT_CONFLICT_SOLVING CMake option. if true at each iteration the simulation manager validate the requiered position of the agent. Else no check is made, Agent can be at the same position
 
 /// \brief settings used by the libraries.
 namespace Settings::nAgent {
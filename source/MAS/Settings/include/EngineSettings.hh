@@ -5,6 +5,8 @@
 
 static const unsigned int INITIAL_MAX_THREAD = 12;
 static const QThread::Priority SIMU_THREAD_PRIORITY = QThread::LowPriority;
+/// \brief number of agent IDs reserved for each agent executed by a deterministic step, cf. SimulationManager::runOneStepWithPool
+static const unsigned long int NB_RESERVED_ID_PER_AGENT = 4;
 
 #include "GeometrySettings.hh"
 #include "SpatialDataStructure.hh"
@@ -21,8 +21,8 @@ public:
 public:
 	Action(ACTION_FREQUENCY pFrequency, double pTime = 0.);
 
-	/// \brief destructor
-	virtual ~Action() = default;
+	/// \brief destructor, remove the action from the scheduler
+	virtual ~Action();
 
 	/// The function executed when the action his called.
 	virtual bool exec() = 0;
@@ -5,59 +5,109 @@
 
 #include <QString>
 
+#include <array>
+#include <atomic>
 #include <map>
-#include <set>
+#include <mutex>
+#include <vector>
 
 /// \brief define a struct of an ID Map
 struct IDMap
 {
-	unsigned long int currentID; ///< the next ID to give from the first itération (make sure we give unreleased IDs first )
-	/// \warning we will start giving IDs at currentID +1.
-	std::set<unsigned long int> releasedIDs;  ///< \brief the released IDS to give once all unsigned long int have been distributed.
+	std::atomic<unsigned long int> currentID; ///< \brief the last ID given, IDs are given from currentID+1
+	std::mutex releasedIDsMutex;              ///< \brief protect the released IDs
+	/// \warning released IDs are only kept if requested and given once all unsigned long int have been distributed.
+	std::vector<unsigned long int> releasedIDs;  ///< \brief the released IDS to give once all unsigned long int have been distributed.
+
 	/// \brief store ID information, free ID and lock IDs
-	IDMap(unsigned long int pCurrentID = 0, std::set<unsigned long int> pReleaseIDs = std::set<unsigned long int>()):
-		currentID(pCurrentID),
-		releasedIDs(std::move(pReleaseIDs))
-	{
-	}
+	IDMap(): currentID(0) {}
+};
+
+/// \brief a range of consecutive IDs [first, last) reserved to a caller
+struct IDRange
+{
+	unsigned long int first;  ///< \brief next ID of the range
+	unsigned long int last;   ///< \brief end of the range (excluded)
+
+	/// \brief return true if all IDs of the range have been taken
+	[[nodiscard]] bool empty() const { return first == last; }
+	/// \brief return the number of IDs remaining in the range
+	[[nodiscard]] unsigned long int size() const { return last - first; }
+	/// \brief take the next ID of the range, the range must not be empty
+	unsigned long int next() { return first++; }
 };
 
 /// \brief Defined as a singleton, this will handle ID attribution for all entities
 /// requiring a unique ID.
 /// \details The ID '0' correspond to unsetted ID (ID by default : because is an unsigned long int)
 /// IDManager return IDs starting at 1.
-/// \note For now only attribution, no deletion. But as setted on an unsigned int, this havn't be
-/// juged usefull.
+/// Each ID space (agents, cell properties...) is addressed by an integer handle, IDs are given
+/// by an atomic counter so IDs can be requested from any thread.
+/// A thread can reserve a range of IDs and install it with a ScopedIDRange : agents created by this thread
+/// will take their IDs from the range. Reserving the ranges in a fixed order makes the IDs independent of
+/// the thread scheduling.
+/// Handles are shared by all instances : they stay valid after destroyInstance and can be cached.
 class IDManager {
 public:
+	using IDSpace = std::size_t;                         ///< \brief handle of an ID space
+	static constexpr IDSpace agentIDSpace = 0;           ///< \brief ID space of the agents
+	static constexpr std::size_t maxNbIDSpace = 64;      ///< \brief maximal number of ID spaces
+
+	/// \brief install a range of agent IDs for the current thread during its lifetime
+	class ScopedIDRange {
+	public:
+		explicit ScopedIDRange(IDRange* pRange);
+		~ScopedIDRange();
+
+		ScopedIDRange(const ScopedIDRange&) = delete;
+		ScopedIDRange& operator=(const ScopedIDRange&) = delete;
+
+	private:
+		IDRange* _previous; ///< \brief the range installed before this one
+	};
+
 	static IDManager* getInstance();
 	/// \brief return the next available ID
-	unsigned long int getID() { return getID_internal(&_agentIDs); }
+	unsigned long int getID() { return getID_internal(&_idSpaces[agentIDSpace]); }
 	/// \brief will set an ID to the given agent
 	bool setID(Agent*);
 	/// \brief will release/free the given ID to be resed if needed
-	void releaseID(unsigned long int pID)	{ releaseID_internal(&_agentIDs, pID); }
+	void releaseID(unsigned long int pID)	{ releaseID_internal(&_idSpaces[agentIDSpace], pID); }
+
+	/// \brief return the handle of the ID space of the given name, registering it if needed
+	IDSpace registerIDSpace(const QString&);
+	/// \brief return the next available ID of the given ID space
+	unsigned long int getID(IDSpace pSpace) { return getID_internal(&_idSpaces[pSpace]); }
+	/// \brief release an ID of the given ID space
+	void releaseID(IDSpace pSpace, unsigned long int pID) { releaseID_internal(&_idSpaces[pSpace], pID); }
+	/// \brief reserve nbID consecutive IDs of the given ID space
+	IDRange reserveIDs(unsigned long int nbID, IDSpace pSpace = agentIDSpace);
+	/// \brief give back a reserved range none of whose IDs were taken, if it is the last one given
+	bool unreserveIDs(const IDRange& pRange, IDSpace pSpace = agentIDSpace);
 
 	/// \brief this will return an Id from a specific ID map ( != agentID). If the map doesn't exists yet, she will be created
-	unsigned long int getSpecificIDFor(QString IDMap);
+	unsigned long int getSpecificIDFor(const QString& IDMap) { return getID(registerIDSpace(IDMap)); }
 	/// \brief release an ID from a specific map IS
-	void releaseSpecificIDFor(QString IDMap, unsigned long int);
+	void releaseSpecificIDFor(const QString& IDMap, unsigned long int pID) { releaseID(registerIDSpace(IDMap), pID); }
 
+	/// \brief if true released IDs are kept to be given again once all IDs have been given
+	void setKeepReleasedIDs(bool pKeep) { _keepReleasedIDs.store(pKeep, std::memory_order_relaxed); }
+
+	/// \brief restart all ID spaces from the first ID. Registered ID spaces keep their handle.
 	void reset();
 	void destroyInstance();
 
 private:
+	IDManager();
+
 	/// \brief deal directly with function giving unsigned long int and the set corresponding.
 	unsigned long int getID_internal(IDMap* );
 	/// \brief release an ID on the given ID Map
 	void releaseID_internal(IDMap*, unsigned long int);
-	/// \brief return the IDsMap corresponding to the given name.
-	IDMap* getOrCreateIDsMap(QString);
 
 private:
-	IDMap _agentIDs; ///< \brief the current free ID "pointer" and the corresponding set. Free ID will be setted once max(unsigned long int) reach. Is a set to make sure none affected twice.
-
-	std::map<QString, IDMap > _specificsIDsMap; ///< \brief all the existings specifics map IDs;
+	std::array<IDMap, maxNbIDSpace> _idSpaces;   ///< \brief the ID spaces, the first one is for the agents
+	std::atomic<bool> _keepReleasedIDs;          ///< \brief true if the released IDs are kept
 };
 
 #endif
@@ -35,6 +35,11 @@ public:
 	void setDisplacementThreshold(double pThreshold) const;
 	/// \brief displacementThreshold getter
 	[[nodiscard]] double getDisplacementThreshold() const;
+	/// \brief set the radius of the agents and the overlap allowed between two of them, used by the spatial conflict solvers
+	void setAgentRadius(double pRadius, double pTolerance = 0.) const;
+
+	/// \brief start the next simulation from the given step and time instead of 0
+	void resumeFrom(unsigned long int pStep, double pTime);
 
 	/// \brief set the duration of steps
 	void setNbMaxThreads(int);
@@ -50,6 +55,15 @@ public:
 	void limiteNbAgentToSimulate(unsigned int);
 	/// \brief avoid limitation of agent, execute all agent
 	void unlimiteNbAgentToSimulate(bool);
+	/// \brief run the agents on the shared thread pool, the result does not depend on the number of threads
+	void setDeterministic(bool);
+
+	/// \brief return the profile of the last simulated steps, from the oldest to the newest
+	[[nodiscard]] std::vector<SimulationProfiler::StepProfile> getStepProfiles() const;
+	/// \brief write the profile of the last simulated steps to a CSV file
+	bool exportStepProfiles(std::string const& pPath) const;
+	/// \brief set the number of simulated steps profiled kept
+	void setStepProfilesCapacity(std::size_t);
 
 private: 
 	/// \brief defined the agent to simulate from the layer
@@ -33,18 +33,24 @@ class Scheduler {
 
 public:
 	Scheduler();
-	~Scheduler() = default;
+	~Scheduler();
 
 	/// \brief schedule a given action to process
 	bool scheduleAction(Action*);
+	/// \brief remove an action from the scheduled ones
+	void unscheduleAction(Action*);
 
 	/// \brief return the simulation time
 	[[nodiscard]] inline double getRunningTime() const { return _currentTime; }
 
 	/// \brief return the duration of the current simulated step
 	[[nodiscard]] inline double getStepDuration() const	{ return _stepDuration; }
+	/// \brief return the number of steps started since the simulation start, the current one included
+	[[nodiscard]] inline unsigned long int getNbStep() const { return _nbStep; }
 	/// \brief return the singleton of the instance
 	static Scheduler* getInstance();
+	/// \brief return true if the singleton exists
+	static bool hasInstance();
 	/// \brief reset all scheduler parameters, timers and action scheduled
 	void reset();
 	/// \brief Compute the simulation step duration
@@ -61,6 +67,8 @@ protected:
 	void setDuration(double pDuration) { _totalDuration = pDuration; }
 	/// \brief  define the duration of a step
 	void setStepDuration(double pDuration) { _stepDuration = pDuration; }
+	/// \brief define the step and time the next run starts from, used to resume a simulation
+	void setStart(unsigned long int pStep, double pTime) { _startStep = pStep; _startTime = pTime; }
 
 private:
 	/// \brief will run each requested actions
@@ -72,6 +80,12 @@ private:
 	double _currentTime; 		///< in s
 	/// \brief duration of the simulation;
 	double _totalDuration; 	//< in s
+	/// \brief the number of steps started
+	unsigned long int _nbStep;
+	/// \brief the time the run starts from
+	double _startTime;		///< in s
+	/// \brief the step the run starts from
+	unsigned long int _startStep;
 
 	// The vector structure enable to process actions in the same order they have been registred.
 	// \todo : find a better data structure to speed up this process.
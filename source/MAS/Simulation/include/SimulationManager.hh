@@ -3,6 +3,7 @@
 
 #include "ConflictSolver.hh"
 #include "Layer.hh"
+#include "SimulationProfiler.hh"
 #include "ThreadAgentGroup.hh"
 
 #include <QThread>
@@ -37,6 +38,12 @@ public:
 	void reset();
 	/// \brief displacementThreshold getter
 	[[nodiscard]] double getDisplacementThreshold() const { return _displacementThreshold; };
+	/// \brief return true if the agents run on the shared thread pool and their new positions are applied at the end of the step
+	[[nodiscard]] bool isDeterministic() const { return _deterministic; }
+	/// \brief return the profiler of the simulation steps, empty if not compiled WITH_SIMULATION_PROFILING
+	[[nodiscard]] const SimulationProfiler& getProfiler() const { return _profiler; }
+	/// \brief return the profiler of the simulation steps, empty if not compiled WITH_SIMULATION_PROFILING
+	SimulationProfiler& getProfiler() { return _profiler; }
 
 protected:
 	/// \brief add the agent on the simulation
@@ -53,11 +60,15 @@ protected:
 
 	/// \brief displacementThreshold setter
 	void setDisplacementThreshold(double pThreshold) { _displacementThreshold = pThreshold; }
+	/// \brief set the radius of the agents and the overlap allowed between two of them, used by the spatial conflict solvers
+	void setAgentRadius(double pRadius, double pTolerance = 0.);
 
 	/// \brief we will execute randomly a limited number of agent
 	void limiteNbAgentToSimulate(unsigned int i) { _numberOfAgentToExecute = i; }
 	/// \brief avoid limitation of agent, execute all agent
 	void unlimiteNbAgentToSimulate(bool b) { _bExecuteAllAgent = b; }
+	/// \brief if true the steps does not depend on the number of threads
+	void setDeterministic(bool b) { _deterministic = b; }
 
 private:
 	/// \brief return the best trhad to set this agent on.
@@ -71,14 +82,16 @@ private:
 	bool runOneStep();
 	/// \brief run one step by the intermediary thread agent group
 	bool runOneStepWithThread();
+	/// \brief run one step on the shared thread pool, agents are processed by blocks of their registration order
+	bool runOneStepWithPool();
 	/// \brief pick randomly agent from the one to simulate
-	std::set<Agent*> pickRandomlyAgts(unsigned int);
+	AgentRegistry pickRandomlyAgts(unsigned int);
 	/// \brief setter  of the maximal number of thread
 	void setMaxNumberOfThread(int nb) { _maxThreadAgentGroup = nb; }
 	/// \brief top layer setter, needed to know SDS to update.
 	void setTopLayer(Layer*);
 	/// \brief return all the agents running
-	std::vector<Agent*> getAllAgents();
+	[[nodiscard]] const std::vector<Agent*>& getAllAgents() const { return _managedAgents; }
 	/// \brief update spatial data structures
 	void updateSDS();
 	/// \brief run all conflict manager
@@ -87,6 +100,8 @@ private:
 	bool updateAgentState();
 	/// \brief tag agent to execute during the next simulation step
 	void updateAgentToExecute();
+	/// \brief return the number of dynamic agents executed last step with a non null speed
+	[[nodiscard]] unsigned int countMovedAgents() const;
 
 private:
 	/// \brief the map of agent group. The key is the trehad ID
@@ -109,13 +124,21 @@ private:
 	Layer* _topLayer;
 	/// \brief the displacement threshold for each step simulation. If negative none
 	double _displacementThreshold;
+	/// \brief the radius of the agents for the spatial conflict solvers
+	double _agentRadius;
+	/// \brief the overlap allowed between two agents by the spatial conflict solvers
+	double _agentTolerance;
 
 	/// \brief do we execute all agent
 	bool _bExecuteAllAgent;
 	/// \brief the number of agent to exexute if we want to execute a limited number of them.
 	unsigned int _numberOfAgentToExecute;
-	/// \brief the set of agent executed last step
-	std::set<Agent*> _agentExecutedLastStep;
+	/// \brief true if agents are executed on the shared thread pool, from the positions of the previous step
+	bool _deterministic;
+	/// \brief the agents executed last step
+	std::vector<Agent*> _agentExecutedLastStep;
+	/// \brief record of the duration of each phase of the last steps
+	SimulationProfiler _profiler;
 
 signals:
 	/// \brief the signal of the step has end run
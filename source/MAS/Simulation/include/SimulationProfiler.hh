@@ -0,0 +1,116 @@
+#ifndef SIMULATION_PROFILER_HH
+#define SIMULATION_PROFILER_HH
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// \brief Records the wall-clock duration of each phase of the simulation steps and some counters.
+/// \details The last steps are kept on a ring buffer. Recording is only compiled with the
+/// WITH_SIMULATION_PROFILING definition (cmake option of the same name), the PROFILE_* macros
+/// are empty otherwise and the profiler stays empty.
+class SimulationProfiler {
+public:
+	/// \brief the phases of a simulation step, in their execution order
+	enum Phase {
+		PRE_ACTIONS,    ///< \brief Scheduler pre actions
+		AGENTS,         ///< \brief agents execution
+		CONFLICTS,      ///< \brief conflict solvers
+		AGENT_STATE,    ///< \brief validation of the new agents states
+		SDS_UPDATE,     ///< \brief spatial data structures update
+		POST_ACTIONS,   ///< \brief Scheduler post actions
+		VIEWER,         ///< \brief step signal to the viewer updater
+		NB_PHASE
+	};
+
+	/// \brief the record of one step
+	struct StepProfile {
+		unsigned long int step = 0;                 ///< \brief index of the step since the simulation start
+		double stepDuration = 0.;                   ///< \brief simulated duration of the step, in s
+		std::array<double, NB_PHASE> phases{};      ///< \brief wall-clock duration of each phase, in s
+		std::vector<double> threadBusy;             ///< \brief time spent executing agents by each thread, in s
+		unsigned int nbAgentExecuted = 0;           ///< \brief number of agents executed
+		unsigned int nbAgentMoved = 0;              ///< \brief number of dynamic agents which moved
+		unsigned int nbConflict = 0;                ///< \brief number of conflicts detected by the solvers
+
+		/// \brief return the wall-clock duration of the step, in s
+		[[nodiscard]] double getDuration() const;
+		/// \brief return the time the threads waited during the agents phase, in s
+		[[nodiscard]] double getThreadIdle() const;
+	};
+
+	/// \brief measure a phase of the current step from its construction to its destruction
+	class PhaseTimer {
+	public:
+		PhaseTimer(SimulationProfiler& pProfiler, Phase pPhase):
+			_profiler(pProfiler), _phase(pPhase), _start(std::chrono::steady_clock::now()) {}
+		~PhaseTimer() { _profiler.addPhaseDuration(_phase, std::chrono::steady_clock::now() - _start); }
+
+		PhaseTimer(const PhaseTimer&) = delete;
+		PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+	private:
+		SimulationProfiler& _profiler;                         ///< \brief the profiler to record in
+		Phase _phase;                                          ///< \brief the measured phase
+		std::chrono::steady_clock::time_point _start;          ///< \brief start of the measure
+	};
+
+	explicit SimulationProfiler(std::size_t pCapacity = DEFAULT_CAPACITY);
+
+	/// \brief start the record of a new step
+	void beginStep(double pStepDuration);
+	/// \brief add the duration of a phase to the current step
+	void addPhaseDuration(Phase, std::chrono::steady_clock::duration);
+	/// \brief add the busy time of a thread to the current step, thread safe
+	void addThreadBusy(std::chrono::steady_clock::duration);
+	/// \brief set the counters of the current step
+	void setAgentCounters(unsigned int pNbExecuted, unsigned int pNbMoved);
+	/// \brief add conflicts to the current step
+	void addConflicts(unsigned int pNbConflict) { current().nbConflict += pNbConflict; }
+
+	/// \brief return the recorded steps, from the oldest to the newest
+	[[nodiscard]] std::vector<StepProfile> getSteps() const;
+	/// \brief return the number of steps recorded since the last reset
+	[[nodiscard]] unsigned long int getNbStepRecorded() const { return _nbStep; }
+	/// \brief set the number of steps kept, reset the recorded steps
+	void setCapacity(std::size_t);
+	/// \brief remove all recorded steps
+	void reset();
+
+	/// \brief write the recorded steps as CSV, one line per step
+	void writeCSV(std::ostream&) const;
+	/// \brief write the recorded steps to a CSV file
+	bool exportToCSV(std::string const& pPath) const;
+
+	/// \brief return the name of a phase, as used in the CSV header
+	static const char* getPhaseName(Phase);
+
+	static constexpr std::size_t DEFAULT_CAPACITY = 1024;   ///< \brief default number of steps kept
+
+private:
+	/// \brief the step being recorded
+	StepProfile& current() { return _steps[(_nbStep - 1) % _steps.size()]; }
+
+private:
+	std::vector<StepProfile> _steps;    ///< \brief the ring buffer of steps
+	unsigned long int _nbStep;          ///< \brief number of steps recorded since the last reset
+	std::mutex _threadMutex;            ///< \brief protect the threads busy times
+};
+
+#ifdef WITH_SIMULATION_PROFILING
+	#define PROFILE_CONCAT_IMPL(a, b) a##b
+	#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+	/// \brief measure the enclosing scope as the given phase
+	#define PROFILE_PHASE(profiler, phase) SimulationProfiler::PhaseTimer PROFILE_CONCAT(lPhaseTimer, __LINE__)(profiler, SimulationProfiler::phase)
+	/// \brief execute the statement only if profiling is compiled
+	#define PROFILE_STATEMENT(statement) statement
+#else
+	#define PROFILE_PHASE(profiler, phase)
+	#define PROFILE_STATEMENT(statement)
+#endif
+
+#endif
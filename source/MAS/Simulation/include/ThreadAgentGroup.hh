@@ -2,10 +2,11 @@
 #define THREAD_AGENT_GROUP_HH
 
 #include "Agent.hh"
+#include "AgentRegistry.hh"
 
 #include <QThread>
 
-#include <set>
+#include <chrono>
 
 /// \brief ThreadAgentGroup register a set of agent to be executed. This is the
 /// object insuring the multithreded part of the simulation.
@@ -20,6 +21,8 @@ public:
 
 	/// \brief return the run success or not
 	bool hasSucceeded() { return runSucced;};
+	/// \brief return the time spent executing agents during the last run, null if not compiled WITH_SIMULATION_PROFILING
+	[[nodiscard]] std::chrono::steady_clock::duration getBusyDuration() const { return _busyDuration; }
 
 protected:
 	/// \brief add the agent on the group
@@ -42,15 +45,17 @@ protected:
 	void stop();
 private:
 	/// \brief execute and update agent states
-	inline void processAgent(Agent*);
+	static void processAgent(Agent*);
 
 private:
-	std::set<Agent*> _agents; ///< \brief  the map of agent the thread agent group handles.
+	AgentRegistry _agents;    ///< \brief  the agents the thread agent group handles.
 	double _stepDuration;     ///< \brief  simulation step duration ( in s )
 	int _ID;                  ///< \brief  the thread ID, set by the simulation manager
 
 	/// \brief  bool update after the run to know if succeeded or not.
 	bool runSucced;
+	/// \brief time spent executing agents during the last run
+	std::chrono::steady_clock::duration _busyDuration{};
 };
 
 #endif
@@ -0,0 +1,61 @@
+#ifndef THREAD_POOL_HH
+#define THREAD_POOL_HH
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// \brief A pool of worker threads shared by the parallel stages (simulation, meshing, export...).
+/// \details parallelFor splits a range of items in contiguous blocks, block i is always made of the same items
+/// for a given number of blocks. The result of a stage does not depend on the scheduling as long as
+/// each item only writes its own data.
+/// Defined as a singleton.
+class ThreadPool {
+public:
+	/// \brief the function processing the items [begin, end)
+	using RangeFunction = std::function<void(std::size_t, std::size_t)>;
+
+	static ThreadPool* getInstance();
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// \brief set the number of threads used by parallelFor, including the calling thread
+	void setNbThread(unsigned int);
+	/// \brief return the number of threads used by parallelFor, including the calling thread
+	[[nodiscard]] unsigned int getNbThread() const { return _nbThread; }
+
+	/// \brief process the items [0, pNbItem) by contiguous blocks, return once all blocks are processed
+	void parallelFor(std::size_t pNbItem, const RangeFunction& pFunction, std::size_t pMinItemPerBlock = 1);
+
+private:
+	ThreadPool();
+
+	/// \brief start the worker threads
+	void startWorkers(unsigned int);
+	/// \brief stop and join the worker threads
+	void stopWorkers();
+	/// \brief loop of a worker thread
+	void work(unsigned int pWorkerIndex, unsigned long int pGeneration);
+
+private:
+	unsigned int _nbThread;                 ///< \brief number of threads, including the calling thread
+	std::vector<std::thread> _workers;      ///< \brief the worker threads
+
+	std::mutex _mutex;                      ///< \brief protect the task description below
+	std::condition_variable _taskReady;     ///< \brief signaled when a task is given to the workers
+	std::condition_variable _taskDone;      ///< \brief signaled when a worker ended its block
+	std::mutex _callMutex;                  ///< \brief one parallelFor at a time
+	const RangeFunction* _function;         ///< \brief the function of the current task
+	std::size_t _nbItem;                    ///< \brief number of items of the current task
+	std::size_t _nbBlock;                   ///< \brief number of blocks of the current task
+	std::size_t _nbBlockRunning;            ///< \brief number of worker blocks not processed yet
+	unsigned long int _generation;          ///< \brief incremented at each task
+	bool _stop;                             ///< \brief true when the workers must exit
+};
+
+#endif
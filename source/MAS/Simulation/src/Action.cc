@@ -7,3 +7,9 @@ Action::Action(ACTION_FREQUENCY pFrequency, double pTime):
 {
 	Scheduler::getInstance()->scheduleAction(this);
 }
+
+/// \details The scheduler only keeps the address of the action, it must forget it before the action is deleted.
+Action::~Action() {
+	if(Scheduler::hasInstance())
+		Scheduler::getInstance()->unscheduleAction(this);
+}
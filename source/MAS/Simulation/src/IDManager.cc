@@ -2,44 +2,104 @@
 #include "InformationSystemManager.hh"
 
 #include <cassert>
+#include <cstdlib>
 #include <limits>
-#include <iostream>
 
-static IDManager* idManager = nullptr;
+static std::atomic<IDManager*> idManager{nullptr};
+static std::mutex idManagerMutex;
+
+/// \brief protect the registration of ID spaces
+static std::mutex idSpaceRegistrationMutex;
+
+/// \return the handle of the named ID spaces, kept when the instance is destroyed
+static std::map<QString, IDManager::IDSpace>& getIDSpaceHandles() {
+	static std::map<QString, IDManager::IDSpace> idSpaceHandles{{QString("agent_IDsMap"), IDManager::agentIDSpace}};
+	return idSpaceHandles;
+}
+
+/// \brief range of agent IDs installed for the current thread, nullptr if none
+static thread_local IDRange* threadIDRange = nullptr;
 
 /// \return the ID manager singleton.
 IDManager* IDManager::getInstance() {
-	if(!idManager) idManager = new IDManager();
-	return idManager;
+	IDManager* lManager = idManager.load(std::memory_order_acquire);
+	if(!lManager) {
+		std::lock_guard<std::mutex> lock(idManagerMutex);
+		lManager = idManager.load(std::memory_order_relaxed);
+		if(!lManager) {
+			lManager = new IDManager();
+			idManager.store(lManager, std::memory_order_release);
+		}
+	}
+	return lManager;
+}
+
+IDManager::IDManager():
+	_keepReleasedIDs(false)
+{
 }
 
 /// \param pIDsMap The pair (IDsMap) we want to opere on
-/// \return the next available id. If none empty will return the limist::max<double> value
+/// \return the next available id. If none available will return 0
 unsigned long int IDManager::getID_internal(IDMap* pIDsMap) {
-	if(pIDsMap->currentID < std::numeric_limits<unsigned long int>::max()) {
-		pIDsMap->currentID ++;
-		return pIDsMap->currentID;
-	} else {
-		// look at free ID
-		if(pIDsMap->releasedIDs.size()==0) {
-			InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "No more available ID", "IDManager");
-			return 0;
-		} else {
-			unsigned long int lID = *(pIDsMap->releasedIDs.begin());
-			pIDsMap->releasedIDs.erase(lID);
-			return lID;
-		}
+	unsigned long int lCurrentID = pIDsMap->currentID.load(std::memory_order_relaxed);
+	while(lCurrentID < std::numeric_limits<unsigned long int>::max()) {
+		if(pIDsMap->currentID.compare_exchange_weak(lCurrentID, lCurrentID + 1, std::memory_order_relaxed))
+			return lCurrentID + 1;
+	}
+
+	// look at free ID
+	std::lock_guard<std::mutex> lock(pIDsMap->releasedIDsMutex);
+	if(pIDsMap->releasedIDs.empty()) {
+		InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "No more available ID", "IDManager");
+		return 0;
 	}
 
-	return pIDsMap->currentID;
+	unsigned long int lID = pIDsMap->releasedIDs.back();
+	pIDsMap->releasedIDs.pop_back();
+	return lID;
+}
+
+/// \param pNbID The number of IDs to reserve
+/// \param pSpace The ID space to reserve the IDs from
+/// \return the range reserved, empty if not enough IDs are available
+IDRange IDManager::reserveIDs(unsigned long int pNbID, IDSpace pSpace) {
+	assert(pSpace < maxNbIDSpace);
+	IDMap& lIDsMap = _idSpaces[pSpace];
+	unsigned long int lCurrentID = lIDsMap.currentID.load(std::memory_order_relaxed);
+	do {
+		if(std::numeric_limits<unsigned long int>::max() - lCurrentID < pNbID) {
+			InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "Not enough available IDs to reserve the range", "IDManager");
+			return {0, 0};
+		}
+	} while(!lIDsMap.currentID.compare_exchange_weak(lCurrentID, lCurrentID + pNbID, std::memory_order_relaxed));
+
+	return {lCurrentID + 1, lCurrentID + 1 + pNbID};
+}
+
+/// \details the IDs given since the reservation would be lost, so nothing is done if the range is not the last one given.
+/// \param pRange The range as returned by reserveIDs
+/// \param pSpace The ID space the IDs were reserved from
+/// \return true if the IDs are given back
+bool IDManager::unreserveIDs(const IDRange& pRange, IDSpace pSpace) {
+	assert(pSpace < maxNbIDSpace);
+	if(pRange.empty())
+		return false;
+
+	unsigned long int lLastID = pRange.last - 1;
+	return _idSpaces[pSpace].currentID.compare_exchange_strong(lLastID, pRange.first - 1, std::memory_order_relaxed);
 }
 
 /// \param pAgt The agent we want to set the ID for
 /// \return  True if set is a success.
 bool IDManager::setID(Agent* pAgt) {
 	assert(pAgt);
-	unsigned long int lID = this->getID_internal(&_agentIDs);
-	std::cout << "Setting id: " << lID << std::endl;
+	unsigned long int lID;
+	if(threadIDRange && !threadIDRange->empty())
+		lID = threadIDRange->next();
+	else
+		lID = this->getID_internal(&_idSpaces[agentIDSpace]);
+
 	if(lID == 0) {
 		return false;
 	} else {
@@ -51,35 +111,54 @@ bool IDManager::setID(Agent* pAgt) {
 /// \param pIDsMap The pair (IDsMap) we want to opere on
 /// \param pID The ID to release
 void IDManager::releaseID_internal(IDMap* pIDsMap, unsigned long int pID) {
-	pIDsMap->releasedIDs.insert(pID);
-}
+	if(pID == 0 || !_keepReleasedIDs.load(std::memory_order_relaxed))
+		return;
 
-/// \param pName The name of the targetted IDs map
-IDMap* IDManager::getOrCreateIDsMap(QString pName) {
-	// if not existing
-	if(_specificsIDsMap.find(pName) == _specificsIDsMap.end())
-		_specificsIDsMap.insert(std::make_pair(pName, IDMap()));
-	return &_specificsIDsMap[pName];
+	std::lock_guard<std::mutex> lock(pIDsMap->releasedIDsMutex);
+	pIDsMap->releasedIDs.push_back(pID);
 }
 
-/// \param pIDMap The map to apply the request
-/// \return the id requested
-unsigned long int IDManager::getSpecificIDFor(QString pIDMap) {
-	return getID_internal( getOrCreateIDsMap(pIDMap));
-}
+/// \param pName The name of the ID space
+/// \return the handle of the ID space. The same name always gives the same handle.
+IDManager::IDSpace IDManager::registerIDSpace(const QString& pName) {
+	std::lock_guard<std::mutex> lock(idSpaceRegistrationMutex);
+	auto& idSpaceHandles = getIDSpaceHandles();
+	auto itHandle = idSpaceHandles.find(pName);
+	if(itHandle != idSpaceHandles.end())
+		return itHandle->second;
 
-/// \param pIDMap The map to apply the request
-/// \param pID The id to release
-void IDManager::releaseSpecificIDFor(QString pIDMap, unsigned long int pID) {
-	releaseID_internal(getOrCreateIDsMap(pIDMap), pID);
+	IDSpace lSpace = idSpaceHandles.size();
+	if(lSpace >= maxNbIDSpace) {
+		std::string mess = "Too many ID spaces, can't register " + pName.toStdString();
+		InformationSystemManager::getInstance()->Message(InformationSystemManager::FATAL_ERROR_MES, mess, "IDManager");
+		exit(EXIT_FAILURE);
+	}
+
+	idSpaceHandles.emplace(pName, lSpace);
+	return lSpace;
 }
 
+/// \warning must not be called while IDs are requested by other threads
 void IDManager::reset() {
-	_agentIDs = IDMap(); // Resets the stored ID map
-	_specificsIDsMap.clear(); // Clears all specific ID maps
+	for(auto& lIDsMap : _idSpaces) {
+		lIDsMap.currentID.store(0, std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lock(lIDsMap.releasedIDsMutex);
+		lIDsMap.releasedIDs.clear();
+	}
 }
 
 void IDManager::destroyInstance() {
-	delete idManager;
-	idManager = nullptr;
+	std::lock_guard<std::mutex> lock(idManagerMutex);
+	delete idManager.exchange(nullptr);
+}
+
+/// \param pRange The range to take the agent IDs from. Once empty, IDs are taken from the agent ID space.
+IDManager::ScopedIDRange::ScopedIDRange(IDRange* pRange):
+	_previous(threadIDRange)
+{
+	threadIDRange = pRange;
+}
+
+IDManager::ScopedIDRange::~ScopedIDRange() {
+	threadIDRange = _previous;
 }
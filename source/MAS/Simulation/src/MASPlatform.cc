@@ -33,7 +33,7 @@ bool MASPlatform::initAgentToSimulate() {
 	SimulationManager::getInstance()->reset();
 	// // is 2D or is 3D ?
 	SimulationManager::getInstance()->setTopLayer(_layerToSimulate);
-	std::set<Agent*> agentsFromLayer = _layerToSimulate->getUniqueAgentsAndSubAgents();
+	AgentRange agentsFromLayer = _layerToSimulate->getUniqueAgentsAndSubAgents();
 	/// for all agents in the layer : add them to the simulation
 	for(auto const& agent: agentsFromLayer) {
 		assert(agent);
@@ -54,11 +54,10 @@ int MASPlatform::startSimulation() {
 	}
 
 	// if we can start the simulation
-	std::set<Agent*> agentsFromLayer = _layerToSimulate->getUniqueAgentsAndSubAgents();
-	std::cout << " number of agent to simulate : " << agentsFromLayer.size() << std::endl;
+	std::cout << " number of agent to simulate : " << _layerToSimulate->getUniqueAgentsAndSubAgents().size() << std::endl;
 
 	// check as some agent to simulate
-	if(agentsFromLayer.size() < 1 ) {
+	if(_layerToSimulate->getUniqueAgentsAndSubAgents().empty()) {
 		InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "can't launch simulation, no participant", "MASPlatform");
 		return 3;
 	}
@@ -68,8 +67,7 @@ int MASPlatform::startSimulation() {
 		return 3;
 	}
 
-	agentsFromLayer = _layerToSimulate->getUniqueAgentsAndSubAgents();
-	std::cout << " number of agent to simulate : " << agentsFromLayer.size() << std::endl;
+	std::cout << " number of agent to simulate : " << _layerToSimulate->getUniqueAgentsAndSubAgents().size() << std::endl;
 	// then run the simulation
 	SimulationManager::getInstance()->run();
 
@@ -116,6 +114,15 @@ void MASPlatform::setStepDuration(double pStepDuration) {
 		Scheduler::getInstance()->setStepDuration(pStepDuration);
 }
 
+/// \details Used to restart from a checkpoint : the step counter and the running time of the scheduler
+/// continue from the checkpoint, the simulation still ends at the duration set.
+/// \param pStep The number of steps already simulated
+/// \param pTime The simulation time already simulated ( in s )
+void MASPlatform::resumeFrom(unsigned long int pStep, double pTime) {
+	assert(pTime >= 0.);
+	Scheduler::getInstance()->setStart(pStep, pTime);
+}
+
 /// \param pNbThread duration of a step ( in s)
 void MASPlatform::setNbMaxThreads(int pNbThread) {
 	assert(pNbThread > 0);
@@ -151,6 +158,13 @@ double MASPlatform::getDisplacementThreshold() const {
 	return SimulationManager::getInstance()->getDisplacementThreshold();
 }
 
+/// \details the solvers are registered when compiled WITH_AGENT_CONFLICT_SOLVING
+/// \param pRadius the radius of the agents, the largest one if they differ
+/// \param pTolerance the overlap allowed between two agents
+void MASPlatform::setAgentRadius(double pRadius, double pTolerance) const {
+	SimulationManager::getInstance()->setAgentRadius(pRadius, pTolerance);
+}
+
 /// \param pNbAgent The number of agent to simulate at each step.
 /// \warning this function will avoid multithreading to simulate agent.
 /// \warning agent will be picked randomly at each iteration
@@ -164,3 +178,30 @@ void MASPlatform::limiteNbAgentToSimulate(unsigned int pNbAgent) {
 void MASPlatform::unlimiteNbAgentToSimulate(bool b) {
 	SimulationManager::getInstance()->unlimiteNbAgentToSimulate(b);
 }
+
+/// \details In deterministic mode the agents of a step all read the positions of the previous step,
+/// their new positions are applied once the step is over. The number of threads is the one of the ThreadPool.
+/// \param b True to activate the deterministic mode
+void MASPlatform::setDeterministic(bool b) {
+	SimulationManager::getInstance()->setDeterministic(b);
+}
+
+/// \details The profile is only recorded if CPOP is compiled with the WITH_SIMULATION_PROFILING option.
+/// \return The profile of the last steps kept by the simulation manager
+std::vector<SimulationProfiler::StepProfile> MASPlatform::getStepProfiles() const {
+	return SimulationManager::getInstance()->getProfiler().getSteps();
+}
+
+/// \param pPath The path of the CSV file
+/// \return true if the file has been written
+bool MASPlatform::exportStepProfiles(std::string const& pPath) const {
+#ifndef WITH_SIMULATION_PROFILING
+	InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "steps are not profiled, CPOP must be compiled WITH_SIMULATION_PROFILING", "MASPlatform");
+#endif
+	return SimulationManager::getInstance()->getProfiler().exportToCSV(pPath);
+}
+
+/// \param pNbStep The number of steps kept, the oldest ones are overwritten
+void MASPlatform::setStepProfilesCapacity(std::size_t pNbStep) {
+	SimulationManager::getInstance()->getProfiler().setCapacity(pNbStep);
+}
@@ -1,6 +1,8 @@
 #include "Scheduler.hh"
 #include "InformationSystemManager.hh"
 
+#include <algorithm>
+
 static Scheduler* scheduler = nullptr;
 
 #include <QString>
@@ -15,6 +17,12 @@ Scheduler::Scheduler() {
 	reset();
 }
 
+/// \details The actions are not deleted, they are owned by their creator.
+Scheduler::~Scheduler() {
+	if(scheduler == this)
+		scheduler = nullptr;
+}
+
 /// \param pAction The action to schedule
 /// \return true if scheduling is a success
 bool Scheduler::scheduleAction(Action* pAction) {
@@ -47,6 +55,17 @@ bool Scheduler::scheduleAction(Action* pAction) {
 	}
 }
 
+/// \details Actions are compared on their frequency and time only, the action is looked for by address.
+/// \param pAction The action to remove
+void Scheduler::unscheduleAction(Action* pAction) {
+	assert(pAction);
+	for(auto* actions : {&_preIterationActions, &_postIterationActions}) {
+		auto itAction = std::find(actions->begin(), actions->end(), pAction);
+		if(itAction != actions->end())
+			actions->erase(itAction);
+	}
+}
+
 /// \param postIteration True if we want to apply the post iteration if we want to apply the pre iteration this will be set as false
 /// \return true if the action proceeding ok
 bool Scheduler::processActions(bool postIteration) {
@@ -100,6 +119,11 @@ Scheduler* Scheduler::getInstance() {
 	return scheduler;
 }
 
+/// \return true if the scheduler has been created and not deleted since
+bool Scheduler::hasInstance() {
+	return scheduler != nullptr;
+}
+
 /// \return {The duration of the next step}
 double Scheduler::computeSimulationStepDuration() {
 	if(DEBUG_SCHEDULER) {
@@ -118,6 +142,8 @@ double Scheduler::computeSimulationStepDuration() {
 		lNextStepDuration = _totalDuration - _currentTime;
 
 	_currentTime += lNextStepDuration;
+	if(lNextStepDuration > 0.)
+		++_nbStep;
 
 	return lNextStepDuration;
 }
@@ -130,6 +156,9 @@ void Scheduler::reset() {
 	_stepDuration = 0.;
 	_currentTime = 0.;
 	_totalDuration = 0.;
+	_nbStep = 0;
+	_startTime = 0.;
+	_startStep = 0;
 }
 
 void Scheduler::init() {
@@ -137,5 +166,6 @@ void Scheduler::init() {
 		InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, "Scheduler initalisation", "SCHEDULER");
 	}
 
-	_currentTime = 0.;
+	_currentTime = _startTime;
+	_nbStep = _startStep;
 }
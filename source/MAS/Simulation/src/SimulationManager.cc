@@ -1,10 +1,15 @@
 #include "InformationSystemManager.hh"
 
+#include "AgentSettings.hh"
 #include "RandomEngineManager.hh"
 #include "Scheduler.hh"
 #include "SimulationManager.hh"
 #include "SpatialDataStructureManager.hh"
 #include "EngineSettings.hh"
+#include "IDManager.hh"
+#include "SpatialConflictSolver.hh"
+#include "ThreadPool.hh"
+#include <algorithm>
 #include <limits>
 
 static SimulationManager* simulationManager = nullptr;
@@ -19,13 +24,18 @@ SimulationManager::SimulationManager() :
 	_maxThreadAgentGroup(INITIAL_MAX_THREAD),
 	_nextThreadID(0),
 	_displacementThreshold(-1.),
-	_numberOfAgentToExecute(1)
+	_agentRadius(0.),
+	_agentTolerance(0.),
+	_bExecuteAllAgent(false),
+	_numberOfAgentToExecute(1),
+	_deterministic(false)
 {
 
 #ifdef SIMULATION_VALID_AGENT_NEW_POS
 	// add spatial conflict solver
-	addConflictSolver( new SpatialConflictSolver<double, Point_2, Vector_2>());
-	addConflictSolver( new SpatialConflictSolver<double, Point_3, Vector_3>());
+	// the radius is given by setAgentRadius
+	addConflictSolver( new SpatialConflictSolver<double, Point_2, Vector_2>(_agentRadius, _agentTolerance));
+	addConflictSolver( new SpatialConflictSolver<double, Point_3, Vector_3>(_agentRadius, _agentTolerance));
 #endif
 
 }
@@ -43,6 +53,9 @@ SimulationManager::~SimulationManager()
 		delete agentGroup.second;
 
 	_agentGroups.clear();
+
+	if(simulationManager == this)
+		simulationManager = nullptr;
 }
 
 /// \brief return the simulation manager.
@@ -63,6 +76,7 @@ void SimulationManager::reset() {
 	// reset agents
 	_agentHandler.clear();
 	_managedAgents.clear();
+	_profiler.reset();
 }
 
 /// \brief the initalisation procedure
@@ -74,6 +88,11 @@ int SimulationManager::init() {
 	// update SDS if some agent change of position from the SDS creation
 	updateSDS();
 
+#ifdef SIMULATION_VALID_AGENT_NEW_POS
+	if(_agentRadius <= 0.)
+		InformationSystemManager::getInstance()->Message(InformationSystemManager::WARNING_MES, "No agent radius set, only agents requesting the same position are in conflict", "SimulationManager");
+#endif
+
 	return 0;
 }
 
@@ -117,12 +136,31 @@ void SimulationManager::setTopLayer(Layer* pLayer) {
 	_topLayer = pLayer;
 }
 
+/// \details the radius is given to the spatial conflict solvers already registered
+/// \param pRadius the radius of the agents, the largest one if they differ
+/// \param pTolerance the overlap allowed between two agents
+void SimulationManager::setAgentRadius(double pRadius, double pTolerance) {
+	_agentRadius = pRadius;
+	_agentTolerance = pTolerance;
+	for(auto* conflictSolver: _conflictSolvers) {
+		if(auto* solver2D = dynamic_cast<SpatialConflictSolver<double, Point_2, Vector_2>*>(conflictSolver)) {
+			solver2D->setRadius(pRadius);
+			solver2D->setTolerance(pTolerance);
+		} else if(auto* solver3D = dynamic_cast<SpatialConflictSolver<double, Point_3, Vector_3>*>(conflictSolver)) {
+			solver3D->setRadius(pRadius);
+			solver3D->setTolerance(pTolerance);
+		}
+	}
+}
+
 /// \return {True if sucess}
 bool SimulationManager::solveConflicts() {
-	std::vector<Agent*> agents = getAllAgents();
+	auto const& agents = getAllAgents();
 
 	for(auto conflictSolver: _conflictSolvers) {
-		if(!conflictSolver->solveConflict(agents))
+		bool solved = conflictSolver->solveConflict(agents);
+		PROFILE_STATEMENT(_profiler.addConflicts(conflictSolver->getNbConflictLastCall()));
+		if(!solved)
 			return false;
 	}
 	return true;
@@ -130,9 +168,23 @@ bool SimulationManager::solveConflicts() {
 
 /// \return {True if sucess}
 bool SimulationManager::updateAgentState() {
+	/// in deterministic mode agents only request their new position during the step
+	if(_deterministic) {
+		for(auto* agent : _agentExecutedLastStep) {
+			if(auto* dynAgent = dynamic_cast<Settings::nAgent::t_DynamicAgent_3*>(agent)) {
+				if(dynAgent->isRequiringNewPos())
+					dynAgent->validRequiredPos();
+			} else if(auto* dynAgent2D = dynamic_cast<Settings::nAgent::t_DynamicAgent_2*>(agent)) {
+				if(dynAgent2D->isRequiringNewPos())
+					dynAgent2D->validRequiredPos();
+			}
+		}
+		return true;
+	}
+
 #ifdef SIMULATION_VALID_AGENT_NEW_POS
 	/// update position of the agent executed.
-	for(auto itAgent = agentExecutedLastStep.begin(); itAgent != agentExecutedLastStep.end(); ++itAgent) {
+	for(auto itAgent = _agentExecutedLastStep.begin(); itAgent != _agentExecutedLastStep.end(); ++itAgent) {
 		// try 2D cast
 		{
 			t_DynamicAgent_2* dymAgent = dynamic_cast<t_DynamicAgent_2*>(*itAgent);
@@ -173,35 +225,63 @@ void SimulationManager::run() {
 			InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, "Run over", "SimlationManager");
 			return;
 		}
+		PROFILE_STATEMENT(_profiler.beginStep(lDurationStep));
 
 		/// - process pre actions
-		if(!Scheduler::getInstance()->processPreActions()) {
+		bool succeeded;
+		{
+			PROFILE_PHASE(_profiler, PRE_ACTIONS);
+			succeeded = Scheduler::getInstance()->processPreActions();
+		}
+		if(!succeeded) {
 			InformationSystemManager::getInstance()->Message(InformationSystemManager::FATAL_ERROR_MES, "Fail to process pre actions", "SimlationManager");
 			return;
 		}
 
 		/// - if running the next step failed
-		if(!runOneStep())
+		{
+			PROFILE_PHASE(_profiler, AGENTS);
+			succeeded = runOneStep();
+		}
+		if(!succeeded)
 			return;
 
 		/// - solve conflicts
-		if( !solveConflicts()) {
+		{
+			PROFILE_PHASE(_profiler, CONFLICTS);
+			succeeded = solveConflicts();
+		}
+		if(!succeeded) {
 			InformationSystemManager::getInstance()->Message(InformationSystemManager::FATAL_ERROR_MES, "Fail, unable to solve conflicts", "SimlationManager");
 			return;
 		}
 
 		/// - set agents state
-		updateAgentState();
+		{
+			PROFILE_PHASE(_profiler, AGENT_STATE);
+			updateAgentState();
+		}
+		PROFILE_STATEMENT(_profiler.setAgentCounters(static_cast<unsigned int>(_agentExecutedLastStep.size()), countMovedAgents()));
 		/// - update Spatial data structures
-		updateSDS();
+		{
+			PROFILE_PHASE(_profiler, SDS_UPDATE);
+			updateSDS();
+		}
 		/// - process post actions
-		if(!Scheduler::getInstance()->processPostActions() ) {
+		{
+			PROFILE_PHASE(_profiler, POST_ACTIONS);
+			succeeded = Scheduler::getInstance()->processPostActions();
+		}
+		if(!succeeded) {
 			InformationSystemManager::getInstance()->Message(InformationSystemManager::FATAL_ERROR_MES, "Fail to process post actions", "SimlationManager");
 			return;
 		}
 
 		// 	- signal we runned a step
-		emit si_stepRunned();
+		{
+			PROFILE_PHASE(_profiler, VIEWER);
+			emit si_stepRunned();
+		}
 	}
 
 	/// stop thread agent group
@@ -213,14 +293,17 @@ void SimulationManager::run() {
 
 /// \param <nbAgent> {The number of agent to pick}
 /// \return {The randomly picked agent}
-std::set<Agent*> SimulationManager::pickRandomlyAgts(unsigned int nbAgent)
+AgentRegistry SimulationManager::pickRandomlyAgts(unsigned int nbAgent)
 {
-	if(nbAgent >= getNbAgent())
-		return {_managedAgents.begin(), _managedAgents.end()};
+	AgentRegistry agentsPicked;
+	if(nbAgent >= getNbAgent()) {
+		agentsPicked.insert(_managedAgents.begin(), _managedAgents.end());
+		return agentsPicked;
+	}
 
 	assert(getNbAgent() > nbAgent);
 
-	std::set<Agent*> agentsPicked;
+	agentsPicked.reserve(nbAgent);
 	while(agentsPicked.size() < nbAgent) {
 		Agent* pickAgt = RandomEngineManager::getInstance()->pickRandom(&_managedAgents);
 		assert(pickAgt);
@@ -267,7 +350,10 @@ bool SimulationManager::runOneStep() {
 	// update agent state to set if to execute or not
 	updateAgentToExecute();
 	// run them
-	runOneStepWithThread();
+	if(_deterministic)
+		runOneStepWithPool();
+	else
+		runOneStepWithThread();
 
 
 	if(DEBUG_SIMULATION_MANAGER) InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, "end running a step", "SimulationManager");
@@ -292,6 +378,11 @@ bool SimulationManager::runOneStepWithThread()
 	for(auto & agentGroup: _agentGroups)
 		agentGroup.second->wait();
 
+#ifdef WITH_SIMULATION_PROFILING
+	for(auto & agentGroup: _agentGroups)
+		_profiler.addThreadBusy(agentGroup.second->getBusyDuration());
+#endif
+
 	/// check if run is a succes or not
 	for(auto & agentGroup: _agentGroups) {
 		if(!agentGroup.second->hasSucceeded()) {
@@ -303,15 +394,70 @@ bool SimulationManager::runOneStepWithThread()
 	return true;
 }
 
+/// \details Agents are processed by contiguous blocks of their registration order, so each block
+/// is the same whatever the number of threads. The agents read the positions of the previous step :
+/// new positions are only applied by updateAgentState.
+/// Each agent takes the IDs of the agents it creates from its own range, reserved in registration order,
+/// so the IDs do not depend on the number of threads either.
+/// \return {True if succes, else false}
+bool SimulationManager::runOneStepWithPool() {
+	std::vector<Agent*> agents;
+	agents.reserve(_agentExecutedLastStep.size());
+	for(auto* agent : _managedAgents) {
+		if(agent->hasToBeExecuted())
+			agents.push_back(agent);
+	}
+
+	IDManager* idManager = IDManager::getInstance();
+	IDRange reservedIDs = idManager->reserveIDs(agents.size()*NB_RESERVED_ID_PER_AGENT);
+	std::vector<IDRange> agentIDs(agents.size(), IDRange{0, 0});
+	if(reservedIDs.size() == agents.size()*NB_RESERVED_ID_PER_AGENT) {
+		for(std::size_t iAgent = 0; iAgent < agents.size(); ++iAgent) {
+			agentIDs[iAgent].first = reservedIDs.first + iAgent*NB_RESERVED_ID_PER_AGENT;
+			agentIDs[iAgent].last = agentIDs[iAgent].first + NB_RESERVED_ID_PER_AGENT;
+		}
+	}
+
+	ThreadPool::getInstance()->parallelFor(agents.size(), [&](std::size_t pBegin, std::size_t pEnd) {
+		PROFILE_STATEMENT(auto start = std::chrono::steady_clock::now());
+		for(std::size_t iAgent = pBegin; iAgent < pEnd; ++iAgent) {
+			IDManager::ScopedIDRange scopedIDs(&agentIDs[iAgent]);
+			ThreadAgentGroup::processAgent(agents[iAgent]);
+		}
+		PROFILE_STATEMENT(_profiler.addThreadBusy(std::chrono::steady_clock::now() - start));
+	});
+
+	// most steps create no agent : the IDs are given back so they stay contiguous
+	bool idTaken = std::any_of(agentIDs.begin(), agentIDs.end(), [](const IDRange& pRange) { return pRange.size() < NB_RESERVED_ID_PER_AGENT; });
+	if(!idTaken)
+		idManager->unreserveIDs(reservedIDs);
+
+	return true;
+}
+
+/// \details an agent moved if its speed computed during its last execution is not null
+unsigned int SimulationManager::countMovedAgents() const {
+	unsigned int nbMoved = 0;
+	for(auto* agent : _agentExecutedLastStep) {
+		if(auto* dynAgent = dynamic_cast<Settings::nAgent::t_DynamicAgent_3*>(agent)) {
+			if(dynAgent->getSpeed() > 0.)
+				++nbMoved;
+		} else if(auto* dynAgent2D = dynamic_cast<Settings::nAgent::t_DynamicAgent_2*>(agent)) {
+			if(dynAgent2D->getSpeed() > 0.)
+				++nbMoved;
+		}
+	}
+	return nbMoved;
+}
+
 /// \details will tag agent to execute, if tagged to true : will be executed next
 /// round else will not be.
 void SimulationManager::updateAgentToExecute() {
 	// get the agent to execute
 	if(_bExecuteAllAgent || getNbAgent() > _numberOfAgentToExecute) {
-		_agentExecutedLastStep.clear();
-		_agentExecutedLastStep.insert(_managedAgents.begin(), _managedAgents.end());
+		_agentExecutedLastStep.assign(_managedAgents.begin(), _managedAgents.end());
 	} else {
-		_agentExecutedLastStep = pickRandomlyAgts(_numberOfAgentToExecute);
+		_agentExecutedLastStep = pickRandomlyAgts(_numberOfAgentToExecute).getAgents();
 	}
 
 	// reset agent execution
@@ -319,7 +465,6 @@ void SimulationManager::updateAgentToExecute() {
 		managedAgent->setToBeExecute(false);
 
 	// then tag them
-	std::set<Agent*>::iterator itAgentSet;
 	for(auto* agent: _agentExecutedLastStep) {
 		assert(agent);
 		agent->setToBeExecute(true);
@@ -389,8 +534,3 @@ void SimulationManager::removeConflictSolver(ConflictSolver* pConflictSolver) {
 		}
 	}
 }
-
-/// \return Return all the agents currently registred
-std::vector<Agent*> SimulationManager::getAllAgents() {
-	return _managedAgents;
-}
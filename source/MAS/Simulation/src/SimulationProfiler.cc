@@ -0,0 +1,120 @@
+#include "SimulationProfiler.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+double SimulationProfiler::StepProfile::getDuration() const {
+	return std::accumulate(phases.begin(), phases.end(), 0.);
+}
+
+/// \details The idle time is the duration of the agents phase for each thread minus their busy time.
+double SimulationProfiler::StepProfile::getThreadIdle() const {
+	double busy = std::accumulate(threadBusy.begin(), threadBusy.end(), 0.);
+	return std::max(0., threadBusy.size()*phases[AGENTS] - busy);
+}
+
+/// \param pCapacity The number of steps kept, the oldest ones are overwritten
+SimulationProfiler::SimulationProfiler(std::size_t pCapacity):
+	_steps(std::max<std::size_t>(1, pCapacity)),
+	_nbStep(0)
+{
+}
+
+/// \param pStepDuration The simulated duration of the step
+void SimulationProfiler::beginStep(double pStepDuration) {
+	++_nbStep;
+	StepProfile& step = current();
+	step.step = _nbStep - 1;
+	step.stepDuration = pStepDuration;
+	step.phases.fill(0.);
+	step.threadBusy.clear();
+	step.nbAgentExecuted = 0;
+	step.nbAgentMoved = 0;
+	step.nbConflict = 0;
+}
+
+void SimulationProfiler::addPhaseDuration(Phase pPhase, std::chrono::steady_clock::duration pDuration) {
+	if(_nbStep == 0)
+		return;
+	current().phases[pPhase] += std::chrono::duration<double>(pDuration).count();
+}
+
+/// \details called by the threads executing the agents at the end of their work
+void SimulationProfiler::addThreadBusy(std::chrono::steady_clock::duration pDuration) {
+	std::lock_guard<std::mutex> lock(_threadMutex);
+	if(_nbStep == 0)
+		return;
+	current().threadBusy.push_back(std::chrono::duration<double>(pDuration).count());
+}
+
+void SimulationProfiler::setAgentCounters(unsigned int pNbExecuted, unsigned int pNbMoved) {
+	if(_nbStep == 0)
+		return;
+	current().nbAgentExecuted = pNbExecuted;
+	current().nbAgentMoved = pNbMoved;
+}
+
+std::vector<SimulationProfiler::StepProfile> SimulationProfiler::getSteps() const {
+	std::size_t nbKept = std::min<std::size_t>(_nbStep, _steps.size());
+	std::vector<StepProfile> steps;
+	steps.reserve(nbKept);
+	for(unsigned long int iStep = _nbStep - nbKept; iStep < _nbStep; ++iStep)
+		steps.push_back(_steps[iStep % _steps.size()]);
+	return steps;
+}
+
+void SimulationProfiler::setCapacity(std::size_t pCapacity) {
+	_steps.assign(std::max<std::size_t>(1, pCapacity), StepProfile());
+	_nbStep = 0;
+}
+
+void SimulationProfiler::reset() {
+	_nbStep = 0;
+}
+
+/// \details Durations are given in seconds. The busy time of each thread is given in the last
+/// column, separated by spaces.
+void SimulationProfiler::writeCSV(std::ostream& pOut) const {
+	pOut << "step,step_duration";
+	for(int iPhase = 0; iPhase < NB_PHASE; ++iPhase)
+		pOut << ',' << getPhaseName(static_cast<Phase>(iPhase));
+	pOut << ",total,nb_agent_executed,nb_agent_moved,nb_conflict,nb_thread,thread_idle,thread_busy\n";
+
+	for(auto const& step : getSteps()) {
+		pOut << step.step << ',' << step.stepDuration;
+		for(double phase : step.phases)
+			pOut << ',' << phase;
+		pOut << ',' << step.getDuration()
+			<< ',' << step.nbAgentExecuted
+			<< ',' << step.nbAgentMoved
+			<< ',' << step.nbConflict
+			<< ',' << step.threadBusy.size()
+			<< ',' << step.getThreadIdle()
+			<< ',';
+		for(std::size_t iThread = 0; iThread < step.threadBusy.size(); ++iThread)
+			pOut << (iThread ? " " : "") << step.threadBusy[iThread];
+		pOut << '\n';
+	}
+}
+
+/// \param pPath The path of the CSV file
+/// \return true if the file has been written
+bool SimulationProfiler::exportToCSV(std::string const& pPath) const {
+	std::ofstream out(pPath, std::ios::trunc);
+	writeCSV(out);
+	return out.good();
+}
+
+const char* SimulationProfiler::getPhaseName(Phase pPhase) {
+	switch(pPhase) {
+		case PRE_ACTIONS:  return "pre_actions";
+		case AGENTS:       return "agents";
+		case CONFLICTS:    return "conflicts";
+		case AGENT_STATE:  return "agent_state";
+		case SDS_UPDATE:   return "sds_update";
+		case POST_ACTIONS: return "post_actions";
+		case VIEWER:       return "viewer";
+		default:           return "unknown";
+	}
+}
@@ -11,6 +11,9 @@ SpatialDataStructureManager::~SpatialDataStructureManager() {
 		delete sds3;
 
 	spatialDataStructures_3D.clear();
+
+	if(SDSManager == this)
+		SDSManager = nullptr;
 }
 
 SpatialDataStructureManager* SpatialDataStructureManager::getInstance() {
@@ -31,18 +31,15 @@ int ThreadAgentGroup::addAgent(Agent* agentToAdd) {
 	}
 
 	/// if already contains the agent
-	if(_agents.find(agentToAdd) != _agents.end()) {
+	if(!_agents.insert(agentToAdd)) {
 		InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "unable to add an agent twice", "ThreadAgentGroup");
 		return 2;
-	} else {
-		_agents.insert(agentToAdd);
-		return 0;
 	}
+	return 0;
 }
 
 int ThreadAgentGroup::removeAgent(Agent* agentToRemove) {
-	if(_agents.find(agentToRemove) != _agents.end())
-		_agents.erase(agentToRemove);
+	_agents.erase(agentToRemove);
 
 	return 0;
 }
@@ -53,12 +50,18 @@ void ThreadAgentGroup::run() {
 		InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, mess, "ThreadAgentGroup");
 	}
 
+#ifdef WITH_SIMULATION_PROFILING
+	auto start = std::chrono::steady_clock::now();
+#endif
 	/// process all agent contained
 	for(auto* agent : _agents) {
 		assert(agent);
 		if(agent->hasToBeExecuted())
 			processAgent(static_cast<Agent*>(agent));
 	}
+#ifdef WITH_SIMULATION_PROFILING
+	_busyDuration = std::chrono::steady_clock::now() - start;
+#endif
 
 	runSucced = true;
 
@@ -0,0 +1,130 @@
+#include "ThreadPool.hh"
+
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+
+static std::atomic<ThreadPool*> threadPool{nullptr};
+static std::mutex threadPoolMutex;
+
+ThreadPool* ThreadPool::getInstance() {
+	ThreadPool* lPool = threadPool.load(std::memory_order_acquire);
+	if(!lPool) {
+		std::lock_guard<std::mutex> lock(threadPoolMutex);
+		lPool = threadPool.load(std::memory_order_relaxed);
+		if(!lPool) {
+			lPool = new ThreadPool();
+			threadPool.store(lPool, std::memory_order_release);
+		}
+	}
+	return lPool;
+}
+
+ThreadPool::ThreadPool():
+	_nbThread(1),
+	_function(nullptr),
+	_nbItem(0),
+	_nbBlock(0),
+	_nbBlockRunning(0),
+	_generation(0),
+	_stop(false)
+{
+	startWorkers(static_cast<unsigned int>(std::max(1, QThread::idealThreadCount())));
+}
+
+ThreadPool::~ThreadPool() {
+	stopWorkers();
+}
+
+/// \param pNbThread The number of threads, the calling thread included. At least 1.
+void ThreadPool::setNbThread(unsigned int pNbThread) {
+	pNbThread = std::max(1u, pNbThread);
+	if(pNbThread == _nbThread)
+		return;
+
+	std::lock_guard<std::mutex> callLock(_callMutex);
+	stopWorkers();
+	startWorkers(pNbThread);
+}
+
+void ThreadPool::startWorkers(unsigned int pNbThread) {
+	_nbThread = pNbThread;
+	_stop = false;
+	for(unsigned int iWorker = 1; iWorker < _nbThread; ++iWorker)
+		_workers.emplace_back(&ThreadPool::work, this, iWorker, _generation);
+}
+
+void ThreadPool::stopWorkers() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_taskReady.notify_all();
+	for(auto& worker : _workers)
+		worker.join();
+	_workers.clear();
+}
+
+/// \param pWorkerIndex The index of the worker, it processes the block of the same index
+/// \param pGeneration The generation of the last task given before the worker creation
+void ThreadPool::work(unsigned int pWorkerIndex, unsigned long int pGeneration) {
+	unsigned long int lastGeneration = pGeneration;
+	while(true) {
+		const RangeFunction* function;
+		std::size_t nbItem;
+		std::size_t nbBlock;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_taskReady.wait(lock, [&]() { return _stop || _generation != lastGeneration; });
+			if(_stop)
+				return;
+			lastGeneration = _generation;
+			function = _function;
+			nbItem = _nbItem;
+			nbBlock = _nbBlock;
+		}
+
+		if(pWorkerIndex < nbBlock) {
+			(*function)(pWorkerIndex*nbItem/nbBlock, (pWorkerIndex + 1)*nbItem/nbBlock);
+
+			std::lock_guard<std::mutex> lock(_mutex);
+			if(--_nbBlockRunning == 0)
+				_taskDone.notify_one();
+		}
+	}
+}
+
+/// \details The items are split in min(number of threads, pNbItem / pMinItemPerBlock) blocks of consecutive items.
+/// The first block is processed by the calling thread. Calls from different threads are serialized,
+/// pFunction must not call parallelFor.
+/// \param pNbItem The number of items to process
+/// \param pFunction The function processing the items [begin, end)
+/// \param pMinItemPerBlock The minimal number of items worth a block
+void ThreadPool::parallelFor(std::size_t pNbItem, const RangeFunction& pFunction, std::size_t pMinItemPerBlock) {
+	if(pNbItem == 0)
+		return;
+
+	std::lock_guard<std::mutex> callLock(_callMutex);
+	std::size_t nbBlock = std::min<std::size_t>(_nbThread, std::max<std::size_t>(1, pNbItem/std::max<std::size_t>(1, pMinItemPerBlock)));
+	if(nbBlock == 1) {
+		pFunction(0, pNbItem);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_function = &pFunction;
+		_nbItem = pNbItem;
+		_nbBlock = nbBlock;
+		_nbBlockRunning = nbBlock - 1;
+		++_generation;
+	}
+	_taskReady.notify_all();
+
+	pFunction(0, pNbItem/nbBlock);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_taskDone.wait(lock, [this]() { return _nbBlockRunning == 0; });
+	_function = nullptr;
+}
@@ -0,0 +1,64 @@
+#ifndef G4_SHAPE_CACHE_HH
+#define G4_SHAPE_CACHE_HH
+
+#if defined(WITH_GEANT_4) || defined(WITH_GDML_EXPORT)
+
+#include "G4ThreeVector.hh"
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class G4Orb;
+class G4TessellatedSolid;
+
+/// \brief share the G4 solids of identical (up to a tolerance) cell shapes during a conversion to G4.
+/// \details Solids are defined relatively to the cell or nucleus origin and placed with a translation, so
+/// all nuclei of the same radius share a G4Orb and membranes of the same shape share a G4TessellatedSolid.
+/// Each cell keeps its own G4LogicalVolume (material, region), only the solids are shared.
+/// The solids are owned by the G4SolidStore, the cache must not be used once the geometry is cleaned.
+class G4ShapeCache {
+public:
+	using Facet = std::array<G4ThreeVector, 3>; ///< \brief a triangular facet in G4 unit, counter clockwise
+
+	explicit G4ShapeCache(double pTolerance);
+
+	/// \brief return a G4Orb of the given radius (G4 unit), shared with previous requests of the same radius
+	G4Orb* getOrb(std::string const& pName, double pRadius);
+	/// \brief return a closed tessellated solid made of the given facets, shared with previous identical requests
+	G4TessellatedSolid* getTessellatedSolid(std::string const& pName, const std::vector<Facet>& pFacets);
+
+	/// \brief return the buffer to fill with the facets of the next tessellated solid, reused between cells
+	std::vector<Facet>& facetBuffer() { _facetBuffer.clear(); return _facetBuffer; }
+
+	/// \brief number of solids requested
+	[[nodiscard]] std::size_t getNbRequest() const { return _nbRequest; }
+	/// \brief number of requests answered by an existing solid
+	[[nodiscard]] std::size_t getNbShared() const { return _nbShared; }
+
+	/// \brief create a closed tessellated solid from facets, nullptr if it would have less than 4 facets
+	static G4TessellatedSolid* createTessellatedSolid(std::string const& pName, const std::vector<Facet>& pFacets);
+
+private:
+	/// \brief return the quantized value of a length
+	[[nodiscard]] long long quantize(double) const;
+	/// \brief hash of the quantized facets
+	[[nodiscard]] std::size_t hash(const std::vector<Facet>&) const;
+	/// \brief return true if the solid is made of the same facets, up to the tolerance
+	[[nodiscard]] bool isSame(const G4TessellatedSolid*, const std::vector<Facet>&) const;
+
+private:
+	double _tolerance;                                                     ///< \brief maximal distance between two vertices considered equal
+	std::map<long long, G4Orb*> _orbs;                                     ///< \brief orbs by quantized radius
+	std::unordered_multimap<std::size_t, G4TessellatedSolid*> _tessellated; ///< \brief tessellated solids by hash of their facets
+	std::vector<Facet> _facetBuffer;                                       ///< \brief facets of the solid being converted
+	std::size_t _nbRequest;                                                ///< \brief number of solids requested
+	std::size_t _nbShared;                                                 ///< \brief number of requests sharing an existing solid
+};
+
+#endif
+
+#endif
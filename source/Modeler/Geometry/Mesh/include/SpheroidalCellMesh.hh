@@ -37,6 +37,14 @@ public:
 	unsigned int getNumberOfVisibleCell()	{ return Voronoi_3D_Mesh::_delaunay.number_of_vertices(); }
 	/// \brief generate all cell structures.
 	std::vector<SpheroidalCell*> generateMesh() override;
+	/// \brief solve conflicts, compute the neighbourhood of the cells and generate their nuclei, without meshing them. cf. meshCell
+	std::vector<SpheroidalCell*> prepareMesh();
+	/// \brief mesh a single cell then freeze its mesh. Cells can be meshed concurrently once prepareMesh has been called
+	bool meshCell(SpheroidalCell*);
+	/// \brief replace the cell meshes by their compact read only form, cf. SpheroidalCell::freezeMesh
+	void freezeMeshes();
+	/// \brief export the nuclei of the cells, one per line, to a .txt file
+	static bool exportNucleiToFile(std::string const&, SpheroidalCells const&);
 
 #if defined(WITH_GEANT_4) || defined(WITH_GDML_EXPORT)
 	/// \brief export the configuration to a G4PVPlacement. The one returned is the "world"/top G4 entity
@@ -51,6 +59,16 @@ public:
 	/// \brief return the bounding box englobing the spheroid. Without converting cell into G4 entities
 	virtual G4LogicalVolume* getG4BoundingLogicalVolume(G4ThreeVector&, G4Material* pMaterialBetwwenCell = nullptr);
 
+	/// \brief if true identical nuclei and membranes share their G4 solid
+	void setShareG4Solids(bool pShare) { _shareG4Solids = pShare; }
+	/// \brief return true if identical nuclei and membranes share their G4 solid
+	[[nodiscard]] bool shareG4Solids() const { return _shareG4Solids; }
+	/// \brief if true the mesh of each cell is freed once the cell is converted to G4
+	/// \warning spots on/in the cytoplasm and SpheroidalCell::hasIn need the mesh, they can't be used after
+	void setReleaseMeshAfterG4Conversion(bool pRelease) { _releaseMeshAfterG4Conversion = pRelease; }
+	/// \brief return true if the mesh of each cell is freed once the cell is converted to G4
+	[[nodiscard]] bool releaseMeshAfterG4Conversion() const { return _releaseMeshAfterG4Conversion; }
+
 	/// \brief export the configuration to a G4LogicalVolume. The one returned is the "world"/top G4 entity
 	virtual G4LogicalVolume* convertToG4Logical(
 		G4LogicalVolume* parent,
@@ -71,9 +89,12 @@ protected:
 
 #ifdef WITH_GDML_EXPORT
 	/// \brief export to a GDML file
-	virtual int exportToFileGDML(std::string const&, SpheroidalCells const&, bool);
+	virtual int exportToFileGDML(std::string const&, SpheroidalCells const&);
 #endif
 
+private:
+	bool _shareG4Solids = true;                 ///< \brief true if identical shapes share their G4 solid
+	bool _releaseMeshAfterG4Conversion = false; ///< \brief true if the cell meshes are freed once converted to G4
 };
 
 #endif
@@ -0,0 +1,126 @@
+#include "G4ShapeCache.hh"
+
+#if defined(WITH_GEANT_4) || defined(WITH_GDML_EXPORT)
+
+#include "InformationSystemManager.hh"
+
+#ifdef WITH_GEANT_4
+	#include "G4Orb.hh"
+	#include "G4TriangularFacet.hh"
+	#include "G4TessellatedSolid.hh"
+#else
+	#include "geometry/solid/G4Orb.hh"
+	#include "geometry/solid/specific/G4TriangularFacet.hh"
+	#include "geometry/solid/specific/G4TessellatedSolid.hh"
+#endif
+
+#include <cassert>
+#include <cmath>
+
+/// \param pTolerance The maximal distance (G4 unit) between two vertices to consider them equal
+G4ShapeCache::G4ShapeCache(double pTolerance):
+	_tolerance(pTolerance),
+	_nbRequest(0),
+	_nbShared(0)
+{
+	assert(_tolerance > 0.);
+}
+
+long long G4ShapeCache::quantize(double pValue) const {
+	return std::llround(pValue / _tolerance);
+}
+
+/// \param pName The name to give to the solid if it has to be created
+/// \param pRadius The orb radius in G4 unit
+/// \return the orb of this radius
+G4Orb* G4ShapeCache::getOrb(std::string const& pName, double pRadius) {
+	++_nbRequest;
+	auto itOrb = _orbs.find(quantize(pRadius));
+	if(itOrb != _orbs.end()) {
+		++_nbShared;
+		return itOrb->second;
+	}
+
+	auto* orb = new G4Orb(pName, pRadius);
+	_orbs.emplace(quantize(pRadius), orb);
+	return orb;
+}
+
+std::size_t G4ShapeCache::hash(const std::vector<Facet>& pFacets) const {
+	// FNV-1a over the quantized coordinates
+	std::size_t h = 14695981039346656037ull;
+	auto combine = [&h](long long value) {
+		h ^= static_cast<std::size_t>(value);
+		h *= 1099511628211ull;
+	};
+
+	combine(static_cast<long long>(pFacets.size()));
+	for(auto const& facet : pFacets) {
+		for(auto const& vertex : facet) {
+			combine(quantize(vertex.x()));
+			combine(quantize(vertex.y()));
+			combine(quantize(vertex.z()));
+		}
+	}
+	return h;
+}
+
+bool G4ShapeCache::isSame(const G4TessellatedSolid* pSolid, const std::vector<Facet>& pFacets) const {
+	if(static_cast<std::size_t>(pSolid->GetNumberOfFacets()) != pFacets.size())
+		return false;
+
+	for(std::size_t iFacet = 0; iFacet < pFacets.size(); ++iFacet) {
+		const G4VFacet* facet = pSolid->GetFacet(static_cast<G4int>(iFacet));
+		for(G4int iVertex = 0; iVertex < 3; ++iVertex) {
+			if((facet->GetVertex(iVertex) - pFacets[iFacet][iVertex]).mag() > _tolerance)
+				return false;
+		}
+	}
+	return true;
+}
+
+/// \details Shapes are only shared if their facets are given in the same order, which is the case for
+/// cells meshed from the same initial shape and refinement settings.
+/// \param pName The name to give to the solid if it has to be created
+/// \param pFacets The facets of the solid, relative to its origin
+/// \return the tessellated solid, nullptr if it can't be created
+G4TessellatedSolid* G4ShapeCache::getTessellatedSolid(std::string const& pName, const std::vector<Facet>& pFacets) {
+	++_nbRequest;
+	std::size_t key = hash(pFacets);
+	auto range = _tessellated.equal_range(key);
+	for(auto itSolid = range.first; itSolid != range.second; ++itSolid) {
+		if(isSame(itSolid->second, pFacets)) {
+			++_nbShared;
+			return itSolid->second;
+		}
+	}
+
+	G4TessellatedSolid* solid = createTessellatedSolid(pName, pFacets);
+	if(solid)
+		_tessellated.emplace(key, solid);
+	return solid;
+}
+
+/// \param pName The name of the solid
+/// \param pFacets The facets of the solid
+/// \return the closed tessellated solid, nullptr if it would have less than 4 facets
+G4TessellatedSolid* G4ShapeCache::createTessellatedSolid(std::string const& pName, const std::vector<Facet>& pFacets) {
+	if(pFacets.size() < 4) {
+		InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "cannot create a tesselated solid with less than 4 facets", "G4ShapeCache");
+		return nullptr;
+	}
+
+	auto* solid = new G4TessellatedSolid(pName);
+	solid->SetSolidClosed(false);
+	for(auto const& facet : pFacets) {
+		// the facets are owned and deleted by the solid
+		if(!solid->AddFacet(new G4TriangularFacet(facet[0], facet[1], facet[2], ABSOLUTE)))
+			InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "error during facet addition", "G4ShapeCache");
+	}
+
+	// very important command because otherwise, Geant4 will see this entity as boundless
+	solid->SetSolidClosed(true);
+	return solid;
+}
+
+#endif
@@ -84,8 +84,7 @@ void MeshFactory::get3DWeightedSpatialables(std::set<t_Cell_3*>* pCells, std::se
 /// \param pSmallestGain		The gain of the better subdivision threashold to stop membrane mesh subdivision
 t_Mesh_2* MeshFactory::create_2DMesh(int* pError, const t_Sub_Env_2* pLayer, MeshTypes::MeshType pMeshType, unsigned int pMeanNbPointPerCell, double pSmallestGain) {
 	std::set<t_Cell_2*> lCells;
-	std::set<Agent*> lAgents = pLayer->getAgents(WITHOUT_DELIMITATION);
-	for(auto lAgent : lAgents) {
+	for(auto lAgent : pLayer->getAgents(WITHOUT_DELIMITATION)) {
 		auto* lSpa = dynamic_cast<t_Cell_2*>(lAgent);
 		if(lSpa)
 			lCells.insert(lSpa);
@@ -101,9 +100,9 @@ t_Mesh_2* MeshFactory::create_2DMesh(int* pError, const t_Sub_Env_2* pLayer, Mes
 /// \param pSmallestGain		The gain of the better subdivision threashold to stop membrane mesh subdivision
 t_Mesh_3* MeshFactory::create_3DMesh(int* pError, const t_Sub_Env_3* pLayer, MeshTypes::MeshType pMeshType, unsigned int pMeanNbSegPerCell, double pSmallestGain) {
 	std::set<t_Cell_3*> lCells;
-	std::set<Agent*> lAgents = pLayer->getAgents(WITHOUT_DELIMITATION);
+	AgentRange lAgents = pLayer->getAgents(WITHOUT_DELIMITATION);
 	//std::cout << " nb agents : " << lAgents.size() << std::endl;
-	assert(lAgents.size() > 0);
+	assert(!lAgents.empty());
 	// G4int int_test = 0 ;
 	for(auto lAgent : lAgents) {
 		auto* lSpa = dynamic_cast<t_Cell_3*>(lAgent);
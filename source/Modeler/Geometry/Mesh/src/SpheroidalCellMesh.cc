@@ -6,20 +6,27 @@
 #include "CGAL_Utils.hh"
 #include "CellMeshSettings.hh"
 #include "EngineSettings.hh"
+#include "File_Utils.hh"
 #include "File_Utils_OFF.hh"
+#include "G4ShapeCache.hh"
 #include "MaterialManager.hh"
 #include "SpheroidalCell_MeshSub_Thread.hh"
+#include "ThreadPool.hh"
 #include "UnitSystemManager.hh"
 
 #include <CGAL/convex_hull_3.h>
 
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <filesystem>
+#include <numeric>
+#include <sstream>
+#include <thread>
 namespace fs = std::filesystem;
 
 #ifdef WITH_GDML_EXPORT
-	#include "MyGDML_Parser.hh"	// The GDML parser.
+	#include "File_Utils_GDML.hh"	// The GDML writer.
 #endif
 
 #ifdef G4_LINK
@@ -90,7 +97,7 @@ int SpheroidalCellMesh::exportToFile(std::string const& path, MeshOutFormats::ou
 		case MeshOutFormats::GDML:
 		{
 #ifdef WITH_GDML_EXPORT
-			error = exportToFileGDML(path, cells, divided);
+			error = exportToFileGDML(path, cells);
 #else
 			error = 1;
 			InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES,
@@ -120,15 +127,27 @@ int SpheroidalCellMesh::exportToFile(std::string const& path, MeshOutFormats::ou
 	}
 
 	// TODO optional? Relocate?
-	if (!error) {
-		std::ofstream of(path + "_nuclei.txt", std::ios::trunc);
-		for(auto const& cell: cells)
-			cell->exportNucleiToStream(of);
-	}
+	if (!error && !exportNucleiToFile(path + "_nuclei.txt", cells))
+		error = 2;
 
 	return error;
 }
 
+/// \details cells are serialized in parallel, the output is written in the cell order
+/// \param pPath The output path file
+/// \param pCells The cells to export the nuclei of
+/// \return true if the file has been written
+bool SpheroidalCellMesh::exportNucleiToFile(std::string const& pPath, SpheroidalCells const& pCells) {
+	std::ofstream of(pPath, std::ios::trunc | std::ios::binary);
+	IO::writeInParallel(of, pCells.size(), [&pCells](std::size_t iCell, std::string& pBuffer) {
+		thread_local std::ostringstream nucleiStream;
+		nucleiStream.str(std::string());
+		pCells[iCell]->exportNucleiToStream(nucleiStream);
+		pBuffer += nucleiStream.str();
+	});
+	return of.good();
+}
+
 /// \return the vector of SpheroidalCell containg a mesh generated by this function
 std::vector<SpheroidalCell*> SpheroidalCellMesh::generateMesh() {
 	_neighboursCell.clear();
@@ -155,62 +174,101 @@ std::vector<SpheroidalCell*> SpheroidalCellMesh::generateMesh() {
 		for(auto const& cell : cells)
 			reffinement.reffineCell(cell);
 	} else {
-		std::vector<SpheroidalCellMeshSubThread*> reffinementThreads;
-		// create the reffinement threads
-		unsigned int nbThreadToCreate = (cells.size() / MIN_NB_CELL_PER_THREAD) + 1;
-		{
-			// create as much thread as needed
-			if(nbThreadToCreate > INITIAL_MAX_THREAD)
-				nbThreadToCreate = INITIAL_MAX_THREAD;
-
-			unsigned int threadID = 0;
-			while(reffinementThreads.size() < nbThreadToCreate) {
-				if(SPHEROIDAL_CELL_MESH_DEBUG) {
-					mess = "create a new thread of ID "  + std::to_string(threadID);
-					InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, mess, "SpheroidalCellMesh");
-				}
-
-				reffinementThreads.push_back(
-					new SpheroidalCellMeshSubThread(
-						threadID,
-						getMaxNbFacetPerCell(),
-						getDeltaWin(),
-						&neighbours,
-						MAX_RATIO_NUCLEUS_TO_CELL
-					)
-				);
-				threadID++;
+		// cells are refined by contiguous blocks, each block has its own refinement context
+		ThreadPool::getInstance()->parallelFor(cells.size(), [&](std::size_t pBegin, std::size_t pEnd) {
+			SpheroidalCellMeshSubThread reffinement(
+				static_cast<unsigned int>(pBegin),
+				getMaxNbFacetPerCell(),
+				getDeltaWin(),
+				&neighbours,
+				MAX_RATIO_NUCLEUS_TO_CELL
+			);
+			for(std::size_t iCell = pBegin; iCell < pEnd; ++iCell) {
+				if(!reffinement.reffineCell(cells[iCell]))
+					return;
 			}
-		}
+		}, MIN_NB_CELL_PER_THREAD);
+	}
 
-		// add cells to threads
-		{
-			std::vector<SpheroidalCell*>::iterator itCell;
-			int iCell = 0;
-			for(auto const& cell : cells)
-			{
-				// G4cout << " \n itCell getID " << itCell->getID() << G4endl;
-				reffinementThreads[iCell%nbThreadToCreate]->addCell(cell);
-				iCell++;
-			}
-		}
+	return cells;
+}
 
-		// run threads.
-		for(auto* reffinementThread : reffinementThreads)
-			reffinementThread->start(MESHING_THREAD_PRIORITY);
+/// \details the nuclei are generated as generateMesh does, so the cells and their nuclei are the same whether they
+/// are meshed now or on demand.
+/// \return the cells generateMesh would mesh, in the order of getCellsStructure
+std::vector<SpheroidalCell*> SpheroidalCellMesh::prepareMesh() {
+	_neighboursCell.clear();
+	assert(_delaunay.is_valid());
 
-		/// wait until all threads process
-		for(auto* reffinementThread : reffinementThreads)
-			reffinementThread->wait();
+	// remove conflicting cells ( if one is included into an other one )
+	removeConflicts();
 
-		//delete reffinement thread
-		for(auto*& reffinementThread : reffinementThreads) {
-			delete reffinementThread;
-			reffinementThread = nullptr;
-		}
+	auto const& cells = getCellsStructure();
+	std::vector<char> hasShape(cells.size(), 0);
+	ThreadPool::getInstance()->parallelFor(cells.size(), [&](std::size_t pBegin, std::size_t pEnd) {
+		SpheroidalCellMeshSubThread reffinement(
+			static_cast<unsigned int>(pBegin),
+			getMaxNbFacetPerCell(),
+			getDeltaWin(),
+			&_neighboursCell,
+			MAX_RATIO_NUCLEUS_TO_CELL
+		);
+		for(std::size_t iCell = pBegin; iCell < pEnd; ++iCell)
+			hasShape[iCell] = reffinement.generateNucleus(cells[iCell]);
+	}, MIN_NB_CELL_PER_THREAD);
+
+	std::vector<SpheroidalCell*> meshableCells;
+	meshableCells.reserve(cells.size());
+	for(std::size_t iCell = 0; iCell < cells.size(); ++iCell) {
+		if(hasShape[iCell])
+			meshableCells.push_back(cells[iCell]);
 	}
+	return meshableCells;
+}
 
-	return cells;
+/// \details the refinement only reads the position and radius of the neighbours, so different cells
+/// can be meshed at the same time. The neighbourhood must not change meanwhile.
+/// \param pCell the cell to mesh, returned by prepareMesh
+/// \return true if the cell has been meshed
+bool SpheroidalCellMesh::meshCell(SpheroidalCell* pCell) {
+	assert(pCell);
+	SpheroidalCellMeshSubThread reffinement(
+		0,
+		getMaxNbFacetPerCell(),
+		getDeltaWin(),
+		&_neighboursCell,
+		MAX_RATIO_NUCLEUS_TO_CELL
+	);
+	if(!reffinement.reffineMembrane(pCell) || !pCell->hasMesh())
+		return false;
+
+	pCell->freezeMesh();
+	return true;
+}
+
+/// \details to call once the meshes are no more refined. The memory used per cell before and after is reported.
+void SpheroidalCellMesh::freezeMeshes() {
+	auto const& cells = getCellsStructure();
+	if(cells.empty())
+		return;
+
+	std::vector<std::size_t> memoryBefore(cells.size());
+	std::vector<std::size_t> memoryAfter(cells.size());
+	ThreadPool::getInstance()->parallelFor(cells.size(), [&](std::size_t pBegin, std::size_t pEnd) {
+		for(std::size_t iCell = pBegin; iCell < pEnd; ++iCell) {
+			memoryBefore[iCell] = cells[iCell]->getMeshMemoryUsage();
+			cells[iCell]->freezeMesh();
+			memoryAfter[iCell] = cells[iCell]->getMeshMemoryUsage();
+		}
+	}, MIN_NB_CELL_PER_THREAD);
+
+	double nbCell = static_cast<double>(cells.size());
+	double meanBefore = static_cast<double>(std::accumulate(memoryBefore.begin(), memoryBefore.end(), std::size_t(0))) / nbCell;
+	double meanAfter = static_cast<double>(std::accumulate(memoryAfter.begin(), memoryAfter.end(), std::size_t(0))) / nbCell;
+	std::string mess = "meshes of " + std::to_string(cells.size()) + " cell(s) frozen, memory per cell : "
+		+ std::to_string(static_cast<std::size_t>(meanBefore)) + " bytes before, "
+		+ std::to_string(static_cast<std::size_t>(meanAfter)) + " bytes after";
+	InformationSystemManager::getInstance()->Message(InformationSystemManager::INFORMATION_MES, mess, "SpheroidalCellMesh");
 }
 
 /// \param pPath 	The output path file
@@ -222,63 +280,82 @@ std::vector<SpheroidalCell*> SpheroidalCellMesh::generateMesh() {
 ///
 int SpheroidalCellMesh::exportToFileOff_undivided(std::string const& path, SpheroidalCells const& cells) {
 	unsigned long int nbFacets = 0;				// hte total number of facet on the file
-	std::set<Point_3, comparePoint_3> points; 						// all the points included inside the mesh
-	std::map<Point_3, unsigned long int, comparePoint_3> indexes;	// the points and their ids
-	/// create .off file for the mesh
-	std::string fullPath = path + ".off";
-	std::ofstream* voronoiOut = IO::OFF::createOffFileWithHeader(fullPath);
+	IO::OFF::VertexIndex vertices;				// all the points included inside the mesh and their ids
 
 	// deal with markup points
-	std::map<std::set<Point_3>, std::pair<CGAL::Color, double>> boxes;
+	std::vector<std::pair<Polyhedron_3, std::string>> boxes;
 	{
-		// convert all of them to boxes
+		// convert all of them to boxes, ordered as the points they are made of
+		std::map<std::set<Point_3>, std::pair<CGAL::Color, double>> sortedBoxes;
 		for(auto const& markupPoint : markupPoints) {
 			std::set<Point_3> boxPoints = Utils::myCGAL::convertPointToBox(markupPoint.first, markupPoint.second.second);
-			boxes.insert(std::make_pair(boxPoints, markupPoint.second));
-			points.insert( boxPoints.begin(), boxPoints.end());
-			Polyhedron_3 polyMark;
-			CGAL::convex_hull_3(boxPoints.begin(), boxPoints.end(), polyMark);
-			nbFacets += Utils::myCGAL::getNumberOfFacets(&polyMark);
+			sortedBoxes.insert(std::make_pair(boxPoints, markupPoint.second));
+			vertices.add(boxPoints.begin(), boxPoints.end());
+		}
+
+		for(auto const& box : sortedBoxes) {
+			boxes.emplace_back();
+			CGAL::convex_hull_3(box.first.begin(), box.first.end(), boxes.back().first);
+			IO::appendColor(boxes.back().second, box.second.first);
+			nbFacets += Utils::myCGAL::getNumberOfFacets(&boxes.back().first);
 		}
 	}
 
-	Polyhedron_3::Point_iterator itPolyPts;
-	for(auto const& cell : cells)
+	// the nuclei meshes are computed once, in parallel
+	std::vector<std::vector<IO::OFF::TriangleMesh>> nuclei(cells.size());
 	{
-		points.insert(cell->shape_points_begin(), cell->shape_points_end());
-		// add shape facets
-		nbFacets += Utils::myCGAL::getNumberOfFacets(cell->getShape());
-
-		// add nucleus points
-		std::vector<t_Nucleus_3*> lNuclei = cell->getNuclei();
-		for(auto const& nucleus : lNuclei) {
-			std::vector<Point_3> lCellNucleusPoints = nucleus->getShapePoints();
-			points.insert(lCellNucleusPoints.begin(), lCellNucleusPoints.end());
-			// add the nucleus facets :
-			Polyhedron_3 polyNucleus;
-			CGAL::convex_hull_3(lCellNucleusPoints.begin(), lCellNucleusPoints.end(), polyNucleus);
-			nbFacets += Utils::myCGAL::getNumberOfFacets(&polyNucleus);
+		std::vector<std::thread> threads;
+		unsigned int nbThread = IO::getNbExportThread();
+		for(unsigned int iThread = 0; iThread < nbThread; ++iThread) {
+			threads.emplace_back([&, iThread]() {
+				for(std::size_t iCell = iThread; iCell < cells.size(); iCell += nbThread) {
+					for(auto const* nucleus : cells[iCell]->getNuclei())
+						nuclei[iCell].push_back(IO::OFF::getConvexHull(nucleus->getShapePoints()));
+				}
+			});
 		}
+		for(auto& thread : threads)
+			thread.join();
 	}
 
-	*voronoiOut << distance(points.begin(), points.end()) << " " << nbFacets << " 0" << std::endl;
-	/// \todo : generate a thread to write on it
-	IO::OFF::exportVerticesToOff(points, indexes, voronoiOut);
-	for(auto const& cell : cells)
-		IO::OFF::exportSpheroidalCellToOff(cell, voronoiOut, indexes);
+	std::vector<std::string> colors;
+	colors.reserve(cells.size());
+	for(std::size_t iCell = 0; iCell < cells.size(); ++iCell) {
+		auto* cell = cells[iCell];
+		auto const& points = cell->getMembranePoints();
+		vertices.add(points.begin(), points.end());
+		// add shape facets
+		nbFacets += cell->getNbMembraneFacets();
 
-	// export organelles points
-	{
-		for(auto const& box : boxes) {
-			Polyhedron_3 polyMark;
-			CGAL::convex_hull_3(box.first.begin(), box.first.end(), polyMark);
-			IO::OFF::exportPolyhedronToOff(&polyMark, voronoiOut, indexes, false, box.second.first);
+		// add nucleus points and facets
+		for(auto const& nucleus : nuclei[iCell]) {
+			vertices.add(nucleus.points.begin(), nucleus.points.end());
+			nbFacets += nucleus.facets.size();
 		}
+
+		colors.emplace_back();
+		IO::appendColor(colors.back(), cell->getColor());
 	}
+	vertices.build();
 
-	voronoiOut->close();
-	delete voronoiOut;
-	return 0;
+	/// create .off file for the mesh
+	std::string fullPath = path + ".off";
+	std::ofstream voronoiOut(fullPath, std::ios::trunc | std::ios::binary);
+	IO::OFF::writeHeaderAndVertices(voronoiOut, vertices, nbFacets);
+
+	IO::writeInParallel(voronoiOut, cells.size(), [&](std::size_t iCell, std::string& pBuffer) {
+		IO::OFF::appendTriangles(pBuffer, cells[iCell]->getMembraneTriangles(), vertices, colors[iCell]);
+		for(auto const& nucleus : nuclei[iCell])
+			IO::OFF::appendTriangleMesh(pBuffer, nucleus, vertices, colors[iCell]);
+	});
+
+	// export organelles points
+	std::string lBoxes;
+	for(auto const& box : boxes)
+		IO::OFF::appendPolyhedron(lBoxes, box.first, vertices, box.second);
+	voronoiOut << lBoxes;
+
+	return voronoiOut.good() ? 0 : 2;
 }
 
 #if defined(WITH_GEANT_4) || defined(WITH_GDML_EXPORT)
@@ -416,7 +493,11 @@ G4LogicalVolume* SpheroidalCellMesh::convertToG4Logical(
 	assert(_delaunay.is_valid());
 	InformationSystemManager::getInstance()->Message(InformationSystemManager::INFORMATION_MES, "starting convertion to G4Logical ", "SpheroidalCellMesh");
 
-	auto const& cells = generateMesh();
+	// the mesh is only generated if it was not done before
+	std::vector<SpheroidalCell*> cells = getCellsStructure();
+	bool meshed = !cells.empty() && std::all_of(cells.begin(), cells.end(), [](const SpheroidalCell* cell) { return cell->hasMesh(); });
+	if(!meshed)
+		cells = generateMesh();
 	if(cells.size() < 1)
 		return nullptr;
 
@@ -440,22 +521,29 @@ G4LogicalVolume* SpheroidalCellMesh::convertToG4Logical(
 	masses_file.close();
 
 	unsigned int nbRemovedForG4 = 0;
-	std::vector<std::pair<G4TessellatedSolid*, G4Orb*>> solids;
+	// the cache only lives during the conversion : the solids belong to the G4SolidStore
+	G4ShapeCache shapeCache(shapeSharingToleranceForG4);
+	G4ShapeCache* lShapeCache = _shareG4Solids ? &shapeCache : nullptr;
 	for(auto & cell : cells) {
 		std::string polyName = cellNamePrefix + std::to_string(iPoly);
 
-		// TODO ==?
 		// because of dimension changement from CPOP to G4 and numerical precision we can be forced to remove some cells to ensure no recovrement.
-		auto neighbours = static_cast<const std::map<SpheroidalCell*, std::set<const SpheroidalCell*>>>(_neighboursCell);
-
-		if(!cell->convertToG4Structure(logicBB, polyName, checkOverlaps, &_neighboursCell, getMaxNbFacetPerCell(), getDeltaWin(), pMapCells, pMapNuclei, pExportNuclei)) {
+		if(!cell->convertToG4Structure(logicBB, polyName, checkOverlaps, &_neighboursCell, getMaxNbFacetPerCell(), getDeltaWin(), pMapCells, pMapNuclei, pExportNuclei, lShapeCache)) {
 			std::cout << "\n polyname : " << polyName.c_str() << std::endl;
 			nbRemovedForG4++;
 		}
 
+		if(_releaseMeshAfterG4Conversion)
+			cell->resetMesh();
+
 		iPoly++;
 	}
 
+	if(lShapeCache) {
+		std::string mess = std::to_string(shapeCache.getNbShared()) + " of " + std::to_string(shapeCache.getNbRequest()) + " G4 solids shared between cells";
+		InformationSystemManager::getInstance()->Message(InformationSystemManager::INFORMATION_MES, mess, "SpheroidalCellMesh");
+	}
+
 	std::cout << "\n\n\n Real number of cells : " <<  cells.size() << "\n" << std::endl;
 	return logicBB;
 }
@@ -463,28 +551,22 @@ G4LogicalVolume* SpheroidalCellMesh::convertToG4Logical(
 #endif
 
 #ifdef WITH_GDML_EXPORT	/// if generate a connection with G4 by GDML ( including or not G4)
-/// \param pPath 	The output path file
+/// \details the file is written directly from the cell meshes, without converting them to G4 entities :
+/// no overlap check is done and all cells are written to a single file.
+/// \param pPath 	The output path file, without extension
 /// \param cells 	The set of cell to export
-/// \param pDivided True if we want to generate a file per cell
 /// \return return values :
 ///					- 0 : success
 ///					- 1 : not implemented yet
 ///					- 2 : failed during export
 ///
-int SpheroidalCellMesh::exportToFileGDML(std::string const& path, SpheroidalCells const& cells, bool checkOverLaps) {
+int SpheroidalCellMesh::exportToFileGDML(std::string const& path, SpheroidalCells const& cells) {
 	if(cells.size() < 1)
 		return 0;
 
-	auto* physiWorld = convertToG4World(checkOverLaps);
-
-	// export the G4 world
-	MyGDML_Parser GDMLParser;
-	std::string fullPath = path + ".gdml";
-
-	std::remove(fullPath.c_str());
-	// GDMLParser.write(path, physiWorld); //TODO : remove the hack to allow gdml writing if wanted
-
-	delete physiWorld;
+	unsigned int nbThread = static_cast<unsigned int>(std::max(1, QThread::idealThreadCount()));
+	if(!IO::GDML::exportSpheroidalCells(path + ".gdml", cells, nullptr, nbThread))
+		return 2;
 
 	return 0;
 }
@@ -3,7 +3,9 @@
 #include "CGAL_Utils.hh"
 #include "CellMeshSettings.hh"
 #include "EngineSettings.hh"
+#include "File_Utils.hh"
 #include "File_Utils_OFF.hh"
+#include "ThreadPool.hh"
 #include "Voronoi3DCellMeshSubThread.hh"
 
 #include <CGAL/Polyhedron_3.h>
@@ -79,15 +81,15 @@ bool Voronoi_3D_Mesh::add(t_Cell_3* pToAdd) {
 	auto* cell = dynamic_cast<SpheroidalCell*> (pToAdd);
 
 	if(!cell) {
-		std::string mess = "Unable to add the cell " + std::to_string(cell->getID()) + ", none spheroidal cell";
-		InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, mess, "Voronoi_3D_Mesh");
+		InformationSystemManager::getInstance()->LazyMessage(InformationSystemManager::CANT_PROCESS_MES, "Voronoi_3D_Mesh",
+			"Unable to add the cell ", pToAdd->getID(), ", none spheroidal cell");
 		return false;
 	}
 
 	if(VORONOI_3D_MESH_DEBUG) {
 		auto const& pos = pToAdd->getPosition();
-		std::string mess = "adding the point at " + std::to_string(pos.x()) + ", " + std::to_string(pos.y()) + " to the voronoi with weight : " + std::to_string(cell->getRadius());
-		InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, mess, "Weighted Voronoi 3D");
+		InformationSystemManager::getInstance()->LazyMessage(InformationSystemManager::DEBUG_MES, "Weighted Voronoi 3D",
+			"adding the point at ", pos.x(), ", ", pos.y(), " to the voronoi with weight : ", cell->getRadius());
 	}
 
 	if(!Delaunay_3D_SDS::add(pToAdd))
@@ -177,29 +179,31 @@ int Voronoi_3D_Mesh::exportToFileOff(std::string const& path, SpheroidalCells co
 int Voronoi_3D_Mesh::exportToFileOff_undivided(std::string const& path, SpheroidalCells const& cells) {
 	unsigned long int nbFacets = 0;
 
-	std::set<Point_3, comparePoint_3> points;
-	std::map<Point_3, unsigned long int, comparePoint_3> indexes;
-
-	std::string fullPath = path + ".off";
-	std::ofstream* voronoiOut = IO::OFF::createOffFileWithHeader(fullPath);
-	Polyhedron_3::Point_iterator itPolyPts;
+	IO::OFF::VertexIndex vertices;
+	std::vector<std::string> colors;
+	colors.reserve(cells.size());
 	for(auto const& cell : cells) {
 		// add shape points
-		for(itPolyPts = cell->shape_points_begin(); itPolyPts != cell->shape_points_end(); ++itPolyPts)
-			points.insert(*itPolyPts);
-		nbFacets += Utils::myCGAL::getNumberOfFacets(cell->getShape());
+		auto const& points = cell->getMembranePoints();
+		vertices.add(points.begin(), points.end());
+		nbFacets += cell->getNbMembraneFacets();
+
+		// random colors are drawn in the cell order
+		colors.emplace_back();
+		IO::appendColor(colors.back(), IO::getRandomColor());
 	}
+	vertices.build();
 
-	*voronoiOut << points.size() << " " << nbFacets << " 0" << std::endl;
-	IO::OFF::exportVerticesToOff(points, indexes, voronoiOut);
+	std::string fullPath = path + ".off";
+	std::ofstream voronoiOut(fullPath, std::ios::trunc | std::ios::binary);
+	IO::OFF::writeHeaderAndVertices(voronoiOut, vertices, nbFacets);
 
 	// export each cell to OFF
-	for(auto itCell = cells.begin(); itCell != cells.end(); ++itCell)
-	    IO::OFF::exportPolyhedronToOff((*itCell)->getShape(), voronoiOut, indexes);
+	IO::writeInParallel(voronoiOut, cells.size(), [&](std::size_t iCell, std::string& pBuffer) {
+		IO::OFF::appendTriangles(pBuffer, cells[iCell]->getMembraneTriangles(), vertices, colors[iCell]);
+	});
 
-	voronoiOut->close();
-	delete voronoiOut;
-	return 0;
+	return voronoiOut.good() ? 0 : 2;
 }
 
 /// \param pPath The oputput path file
@@ -244,54 +248,42 @@ int Voronoi_3D_Mesh::exportToFileSTL(std::string const& path, SpheroidalCells co
 ///
 int Voronoi_3D_Mesh::exportToFileSTL_undivided(std::string const& path, SpheroidalCells const& cells) {
 	std::uint32_t nbFacets = 0;
-
-	std::set<Point_3, comparePoint_3> points;
-	std::map<Point_3, unsigned long int, comparePoint_3> indexes;
-
-	std::vector<SpheroidalCell*>::iterator itCell;
-	for(auto const& cell : cells) {
-		// add shape points
-		for(auto itPolyPts = cell->shape_points_begin(); itPolyPts != cell->shape_points_end(); ++itPolyPts)
-			points.insert(*itPolyPts);
-		nbFacets += Utils::myCGAL::getNumberOfFacets(cell->getShape());
-	}
+	for(auto const& cell : cells)
+		nbFacets += cell->getNbMembraneFacets();
 
 	// write STL file
 	std::string fullPath = path + ".stl";
 	std::ofstream of(fullPath, std::ios::trunc | std::ios::binary);
 
 	// header, ignored but must not contain "solid"
-	for(int i = 0; i < 80; ++i) of.write("*", 1);
+	std::string header(80, '*');
+	of.write(header.data(), static_cast<std::streamsize>(header.size()));
 	of.write(reinterpret_cast<char*>(&nbFacets), sizeof nbFacets);
 
-	for(auto* cell: cells) {
-		auto const& shape = cell->getShape();
-		for(auto it = shape->facets_begin(); it != shape->facets_end(); ++it) {
-			auto const& points = {
-				(*it).halfedge()->vertex()->point(),
-				(*it).halfedge()->next()->vertex()->point(),
-				(*it).halfedge()->next()->next()->vertex()->point()
-			};
+	auto appendBytes = [](std::string& pBuffer, auto pValue) {
+		pBuffer.append(reinterpret_cast<const char*>(&pValue), sizeof pValue);
+	};
 
-			float nx = 0, ny = 0, nz = 0;
-			of.write(reinterpret_cast<char*>(&nx), sizeof nx);
-			of.write(reinterpret_cast<char*>(&ny), sizeof ny);
-			of.write(reinterpret_cast<char*>(&nz), sizeof nz);
+	IO::writeInParallel(of, cells.size(), [&](std::size_t iCell, std::string& pBuffer) {
+		for(auto const& triangle : cells[iCell]->getMembraneTriangles()) {
+			auto const& points = {triangle.vertex(0), triangle.vertex(1), triangle.vertex(2)};
 
-			for(auto& point : points) {
-				float x = point.x(), y = point.y(), z = point.z();
+			// null normal
+			appendBytes(pBuffer, 0.f);
+			appendBytes(pBuffer, 0.f);
+			appendBytes(pBuffer, 0.f);
 
-				of.write(reinterpret_cast<char*>(&x), sizeof x);
-				of.write(reinterpret_cast<char*>(&y), sizeof y);
-				of.write(reinterpret_cast<char*>(&z), sizeof z);
+			for(auto& point : points) {
+				appendBytes(pBuffer, static_cast<float>(point.x()));
+				appendBytes(pBuffer, static_cast<float>(point.y()));
+				appendBytes(pBuffer, static_cast<float>(point.z()));
 			}
 
-			std::uint16_t zero = 0;
-			of.write(reinterpret_cast<char*>(&zero), sizeof zero);
+			appendBytes(pBuffer, std::uint16_t(0));
 		}
-	}
+	});
 
-	return 0;
+	return of.good() ? 0 : 2;
 }
 
 /// \param pPath The oputput path file
@@ -431,8 +423,8 @@ std::vector<SpheroidalCell*> Voronoi_3D_Mesh::generateMesh() {
 	// G4cout << "\n\n\n generateMesh :: Voronoi3DMesh" << G4endl;
 	removeConflicts();
 
-	std::string mess = "start exporting for "  + std::to_string(_delaunay.number_of_vertices()) + " Cell(s) ";
-	InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, mess, "Voronoi_3DMesh");
+	InformationSystemManager::getInstance()->LazyMessage(InformationSystemManager::DEBUG_MES, "Voronoi_3DMesh",
+		"start exporting for ", _delaunay.number_of_vertices(), " Cell(s) ");
 
 	std::vector<SpheroidalCell*> cells = getCellsStructure();
 
@@ -451,60 +443,19 @@ std::vector<SpheroidalCell*> Voronoi_3D_Mesh::generateMesh() {
 		for(auto const& cell : cells)
 			reffinement.reffineCell(cell);
 	} else {
-		std::vector<Voronoi3DCellMeshSubThread*> reffinementThreads;
-		// create the reffinement threads
-		unsigned int nbThreadToCreate = (cells.size() / MIN_NB_CELL_PER_THREAD) + 1;
-		{
-			// create as much thread as needed
-			if(nbThreadToCreate > INITIAL_MAX_THREAD)
-				nbThreadToCreate = INITIAL_MAX_THREAD;
-
-			unsigned int threadID = 0;
-			while(reffinementThreads.size() < nbThreadToCreate) {
-				if(VORONOI_3D_MESH_DEBUG) {
-					mess = "create a new thread of ID "  + std::to_string(threadID);
-					InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, mess, "Voronoi_3DMesh");
-				}
-
-				reffinementThreads.push_back(
-					new Voronoi3DCellMeshSubThread(
-						threadID,
-						getMaxNbFacetPerCell(),
-						getDeltaWin(),
-						&neighbours
-					)
-				);
-
-				threadID++;
-			}
-		}
-
-		// add cells to threads
-		{
-			int iCell = 0;
-			for(auto const& cell : cells)
-			{
-				//IDManager::getInstance()->setID(this);
-				// itCell->forceID(iCell)
-				reffinementThreads[iCell%nbThreadToCreate]->addCell(cell);
-				iCell++;
+		// cells are refined by contiguous blocks, each block has its own refinement context
+		ThreadPool::getInstance()->parallelFor(cells.size(), [&](std::size_t pBegin, std::size_t pEnd) {
+			Voronoi3DCellMeshSubThread reffinement(
+				static_cast<unsigned int>(pBegin),
+				getMaxNbFacetPerCell(),
+				getDeltaWin(),
+				&neighbours
+			);
+			for(std::size_t iCell = pBegin; iCell < pEnd; ++iCell) {
+				if(!reffinement.reffineCell(cells[iCell]))
+					return;
 			}
-		}
-
-		// run threads.
-		for(auto* reffinementThread : reffinementThreads)
-			reffinementThread->start(MESHING_THREAD_PRIORITY);
-
-		/// wait until all threads process
-		for(auto* reffinementThread : reffinementThreads)
-			reffinementThread->wait();
-
-		//delete reffinement thread
-		for(auto*& reffinementThread : reffinementThreads)
-		{
-			delete reffinementThread;
-			reffinementThread = nullptr;
-		}
+		}, MIN_NB_CELL_PER_THREAD);
 	}
 
 	_neighboursCell.clear();
@@ -30,6 +30,10 @@ public:
 	
 	/// \brief main function called to reffine a specific cell
 	bool reffineCell(SpheroidalCell* cell) override;
+	/// \brief generate the nucleus of a cell as reffineCell does, without meshing the cell
+	bool generateNucleus(SpheroidalCell* cell);
+	/// \brief refine the membrane of a cell whose nucleus is already generated, cf. generateNucleus
+	bool reffineMembrane(SpheroidalCell* cell);
 	
 protected:
 	/// \brief generate the nucleus radius
@@ -49,11 +49,39 @@ bool SpheroidalCellMeshSubThread::reffineCell(SpheroidalCell* cell) {
 		if(!generateNucleusRadius(cell))			return false;
 		if(!subdivseCellMembraneMesh(cell))			return false;
 		cell->computeMembraneSurfaceArea();
+		cell->computeVolumeSampler();
 
 	}
 	return true;
 }
 
+/// \details the nucleus is placed from the coarse shape of the cell (its intersection planes with the neighbours),
+/// then the shape is released.
+///	\param <cell> [in] {The cell to generate the nucleus of.}
+///	\return {True if the cell has a shape, ie if reffineCell would mesh it.}
+bool SpheroidalCellMeshSubThread::generateNucleus(SpheroidalCell* cell) {
+	assert(cell);
+	clean();
+	if(!generateIntersectionPlane(cell))		return false;
+	bool hasShape = cell->hasMesh();
+	if(hasShape && !generateNucleusRadius(cell))	return false;
+	cell->resetMesh();
+	return hasShape;
+}
+
+/// \details the coarse shape is computed again, it does not depend on the nucleus
+///	\param <cell> [in] {The cell to reffine.}
+///	\return {True if sucess.}
+bool SpheroidalCellMeshSubThread::reffineMembrane(SpheroidalCell* cell) {
+	assert(cell);
+	clean();
+	if(!generateIntersectionPlane(cell)) 		return false;
+	if(!subdivseCellMembraneMesh(cell))			return false;
+	cell->computeMembraneSurfaceArea();
+	cell->computeVolumeSampler();
+	return true;
+}
+
 ///	\param <cell> [in] {The cell to reffine.}
 ///	\return {True if sucess.}
 bool SpheroidalCellMeshSubThread::generateNucleusRadius(SpheroidalCell* cell) {
@@ -62,6 +62,7 @@ bool Voronoi3DCellMeshSubThread::reffineCell(SpheroidalCell* cell) {
 		if(!generateIntersectionPlane(cell)) 		return false;
 		if(!subdivseCellMembraneMesh(cell))			return false;
 		cell->computeMembraneSurfaceArea();
+		cell->computeVolumeSampler();
 	}
 
 	return true;
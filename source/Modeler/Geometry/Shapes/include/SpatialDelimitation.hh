@@ -7,6 +7,7 @@
 #include "Writable.hh"
 
 #include <set>
+#include <vector>
 
 template <typename Kernel, typename Point, typename Vector>
 class ADistribution;
@@ -39,6 +40,8 @@ public:
 
 	/// \brief return a position inside this spatial delimitaion according to a distribution type.
 	virtual Point getSpot(Distribution::DistributionType type) const = 0;
+	/// \brief append nbSpot positions inside this spatial delimitation according to a distribution type.
+	virtual void getSpots(Distribution::DistributionType type, std::size_t nbSpot, std::vector<Point>& spots) const;
 
 	/// \brief return true if the given point is inside the spatial delimitation
 	virtual bool isIn(Point) const = 0;
@@ -82,6 +85,16 @@ SpatialDelimitation<Kernel, Point, Vector>::SpatialDelimitation(
 {
 }
 
+/// \param type The distribution type to apply
+/// \param nbSpot The number of spots to generate
+/// \param spots The vector the spots are appended to
+template <typename Kernel, typename Point, typename Vector>
+void SpatialDelimitation<Kernel, Point, Vector>::getSpots(Distribution::DistributionType type, std::size_t nbSpot, std::vector<Point>& spots) const {
+	spots.reserve(spots.size() + nbSpot);
+	for(std::size_t iSpot = 0; iSpot < nbSpot; ++iSpot)
+		spots.push_back(getSpot(type));
+}
+
 template <typename Kernel, typename Point, typename Vector>
 SpatialDelimitation<Kernel, Point, Vector>::~SpatialDelimitation() {
 	for(auto it = _internalDelimitation.begin(); it != _internalDelimitation.end(); ++it)
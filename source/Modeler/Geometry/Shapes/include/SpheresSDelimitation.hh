@@ -14,6 +14,8 @@ public:
 
 	/// \brief return the position according to the distribution.
 	[[nodiscard]] Point_3 getSpot(Distribution::DistributionType) const override;
+	/// \brief append n positions according to the distribution.
+	void getSpots(Distribution::DistributionType, std::size_t, std::vector<Point_3>&) const override;
 	/// \brief return true if the given point is inside the spatial delimitation
 	[[nodiscard]] bool isIn(Point_3) const override;
 	/// \brief print cell information (used also to save the cell on a .txt file)
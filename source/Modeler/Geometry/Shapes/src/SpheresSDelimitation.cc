@@ -69,6 +69,18 @@ Point_3 SpheresSDelimitation::getSpot(Distribution::DistributionType pDistType)
 	return p;
 }
 
+/// \param pDistType The distribution type to apply
+/// \param nbSpot The number of spots to generate
+/// \param spots The vector the spots are appended to
+void SpheresSDelimitation::getSpots(Distribution::DistributionType pDistType, std::size_t nbSpot, std::vector<Point_3>& spots) const {
+	if(pDistType != Distribution::RANDOM) {
+		SpatialDelimitation<double, Point_3, Vector_3>::getSpots(pDistType, nbSpot, spots);
+		return;
+	}
+
+	Utils::Geometry::Sphere::getSpotsOnSphere(nbSpot, externalRadius, this->getOrigin(), spots, internalRadius);
+}
+
 /// \param p The point to check if isIn the sphere
 /// \return True is the point is in the Sphere
 bool SpheresSDelimitation::isIn(Point_3 p) const {
@@ -0,0 +1,113 @@
+#ifndef LINEAR_OCTREE_HH
+#define LINEAR_OCTREE_HH
+
+#include "AgentSettings.hh"
+#include "GeometrySettings.hh"
+
+#include <array>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+using namespace Settings::Geometry;
+using namespace Settings::nAgent;
+
+/// \brief Octree stored as arrays sorted along a Morton (Z-order) curve.
+/// \details Agents are sorted by the Morton code of their position (21 bits per axis). A node is the range
+/// of agents sharing a code prefix, children of a node are contiguous in the node array. Each agent is
+/// stored once, nodes keep the tight bounding box of their agents (position +- radius for spheroidal cells)
+/// to prune the queries.
+///
+/// The tree is rebuilt with a radix sort of the codes, run on the ThreadPool. When the agents barely moved
+/// since the last rebuild, it can be refitted instead : the order and the nodes are kept and only the
+/// bounding boxes are recomputed. Queries stay exact, only their pruning becomes less efficient as the agents move away.
+class LinearOctree {
+public:
+	/// \brief a node : agents [begin, end) of the Morton sorted arrays
+	struct Node {
+		std::uint32_t begin;           ///< \brief index of the first agent
+		std::uint32_t end;             ///< \brief index after the last agent
+		std::int32_t firstChild;       ///< \brief index of the first child node, -1 for a leaf
+		std::uint8_t nbChild;          ///< \brief number of children (contiguous)
+		std::array<double, 3> min;     ///< \brief bottom left corner of the agents bounding box
+		std::array<double, 3> max;     ///< \brief top right corner of the agents bounding box
+	};
+
+	/// \param pMaxNbAgt the maximal number of agent of a leaf
+	explicit LinearOctree(unsigned int pMaxNbAgt = 16);
+
+	/// \brief set the agents of the octree and build it
+	template<typename TIt>
+	void build(TIt begin, TIt end);
+	/// \brief sort the agents again from their current positions and rebuild the nodes
+	void rebuild();
+	/// \brief recompute the bounding boxes from the current positions, keeping the order and the nodes
+	void refit();
+	/// \brief refit if no agent moved more than the refit threshold since the last rebuild, rebuild otherwise
+	/// \return true if the octree has been rebuilt
+	bool update();
+	/// \brief remove all agents
+	void clear();
+
+	/// \brief set the maximal displacement since the last rebuild allowing a refit. Default is the largest radius.
+	void setRefitThreshold(double pThreshold) { _refitThreshold = pThreshold; }
+	/// \brief if false the octree is built on the calling thread only, as needed when built from Geant4 worker threads. Default is true.
+	void setParallel(bool pParallel) { _parallel = pParallel; }
+
+	/// \brief return the agent whose position is the nearest of the given point, nullptr if empty
+	[[nodiscard]] const t_SpatialableAgent_3* getNearestSpatialableAgent(Point_3 pPt) const;
+	/// \brief return the agents in contact with the given one (distance lower than the largest of the two radii)
+	[[nodiscard]] std::set<const t_SpatialableAgent_3*> getNeighbours(const t_SpatialableAgent_3* pSpa) const;
+	/// \brief add to pResult the agents whose position is at most at pRadius of pPt
+	void getAgentsInSphere(Point_3 pPt, double pRadius, std::vector<const t_SpatialableAgent_3*>& pResult) const;
+	/// \brief return all contained agent
+	void getContainedAgents(std::set<const t_SpatialableAgent_3*>& pStruc) const;
+
+	/// \brief return the number of agents
+	[[nodiscard]] std::size_t size() const { return _agents.size(); }
+	/// \brief return the nodes, the first one is the root
+	[[nodiscard]] const std::vector<Node>& getNodes() const { return _nodes; }
+	/// \brief return the agents in Morton order
+	[[nodiscard]] const std::vector<const t_SpatialableAgent_3*>& getAgents() const { return _agents; }
+	/// \brief return the memory allocated by the octree, in bytes
+	[[nodiscard]] std::size_t getMemoryUsage() const;
+
+	/// \brief return the Morton code interleaving the 21 lower bits of each coordinate
+	static std::uint64_t getMortonCode(std::uint32_t pX, std::uint32_t pY, std::uint32_t pZ);
+
+private:
+	/// \brief read positions and radii from the agents
+	void readPositions();
+	/// \brief sort the agents by Morton code of their position
+	void sortByMortonCode();
+	/// \brief build the nodes from the sorted codes
+	void buildNodes();
+	/// \brief compute the bounding boxes of the nodes, from the leaves to the root
+	void computeBoxes();
+	/// \brief return the square distance between a point and the bounding box of a node
+	[[nodiscard]] double squaredDistance(const Node& pNode, const Point_3& pPt) const;
+	/// \brief return the number of chunks processed in parallel for n agents
+	[[nodiscard]] unsigned int getNbChunkFor(std::size_t pNbAgent) const;
+
+	std::vector<const t_SpatialableAgent_3*> _agents;   ///< \brief agents, in Morton order
+	std::vector<Point_3> _positions;                    ///< \brief position of the agents, in Morton order
+	std::vector<double> _radii;                         ///< \brief radius of the agents (0 if not a spheroidal cell)
+	std::vector<Point_3> _rebuildPositions;             ///< \brief position of the agents at the last rebuild
+	std::vector<std::uint64_t> _codes;                  ///< \brief Morton code of the agents at the last rebuild
+	std::vector<Node> _nodes;                           ///< \brief nodes, children are stored after their parent
+
+	unsigned int _maxNbAgt;                             ///< \brief maximal number of agent of a leaf
+	double _maxRadius;                                  ///< \brief largest agent radius
+	double _refitThreshold;                             ///< \brief maximal displacement allowing a refit, negative for the largest radius
+	bool _parallel;                                     ///< \brief true if the octree is built on the ThreadPool
+};
+
+/// \param begin iterator on the first agent
+/// \param end iterator after the last agent
+template<typename TIt>
+void LinearOctree::build(TIt begin, TIt end) {
+	_agents.assign(begin, end);
+	rebuild();
+}
+
+#endif
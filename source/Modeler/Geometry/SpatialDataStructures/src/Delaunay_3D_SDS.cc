@@ -2,6 +2,10 @@
 
 #include "Round_Shape.hh"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #ifndef NDEBUG
  	#define DEBUG_DELAUNAY_3D_SDS 0
 #else
@@ -27,8 +31,8 @@ bool Delaunay_3D_SDS::add(const t_SpatialableAgent_3* pSpaAgt) {
 
 	auto* shape = dynamic_cast<Round_Shape<double, Point_3, Vector_3>*>(pSpaAgt->getBody());
 	if(!shape) {
-		std::string mess = "unable to add the agent, the body isn't disc shape.";
-		InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, mess, "Weighted Delaunay 3D - SDS");
+		InformationSystemManager::getInstance()->LazyMessage(InformationSystemManager::DEBUG_MES, "Weighted Delaunay 3D - SDS",
+			"unable to add the agent, the body isn't disc shape.");
 		return false;
 	}
 
@@ -86,8 +90,8 @@ inline std::set<const t_SpatialableAgent_3*> Delaunay_3D_SDS::getNeighbours(cons
 	// check the agent is on the Spatial data structure
 	if(_agentToVertex.find(pAgent) == _agentToVertex.end()) {
 		if(DEBUG_DELAUNAY_3D_SDS) {
-			std::string mess = "unable to give neighbours for agent " + std::to_string(pAgent->getID()) + ", not set on the Spatial Data structure";
-			InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, mess, "Delaunay_3D_SDS");
+			InformationSystemManager::getInstance()->LazyMessage(InformationSystemManager::DEBUG_MES, "Delaunay_3D_SDS",
+				"unable to give neighbours for agent ", pAgent->getID(), ", not set on the Spatial Data structure");
 		}
 
 		return {};
@@ -119,16 +123,32 @@ bool Delaunay_3D_SDS::update(const t_SpatialableAgent_3* pSpaAgt) {
 	return true;	// if a collision return the vertex already at is position.
 }
 
+/// \details Because it is a delaunay it is faster to regenerate it all from scratch. Agents are inserted
+/// at once, ordered by ID : the triangulation does not depend on the agents addresses.
 int Delaunay_3D_SDS::update() {
 	assert(_delaunay.is_valid());
-	std::set<const t_SpatialableAgent_3*> agts;
-	/// because it is a delaunay it is faster to regenerate it all from scratch
+	std::vector<const t_SpatialableAgent_3*> agts;
+	agts.reserve(_agentToVertex.size());
 	for(auto const& itAgts : _agentToVertex)
-		agts.insert(itAgts.first);
+		agts.push_back(itAgts.first);
+	std::sort(agts.begin(), agts.end(), [](const t_SpatialableAgent_3* a, const t_SpatialableAgent_3* b) { return a->getID() < b->getID(); });
 	clean();
 
-	for(auto const& agt : agts)
-		add(agt);
+	std::vector<std::pair<Weighted_point_3, const t_SpatialableAgent_3*>> points;
+	points.reserve(agts.size());
+	for(auto const& agt : agts) {
+		auto* shape = dynamic_cast<Round_Shape<double, Point_3, Vector_3>*>(agt->getBody());
+		if(!shape || !SpatialDataStructure<double, Point_3, Vector_3>::add(agt))
+			continue;
+		points.emplace_back(Weighted_point_3(agt->getPosition(), shape->getRadius()), agt);
+	}
+
+	_delaunay.insert(points.begin(), points.end());
+	// hidden points have no vertex, as for add
+	for(auto itVertex = _delaunay.finite_vertices_begin(); itVertex != _delaunay.finite_vertices_end(); ++itVertex) {
+		assert(itVertex->info());
+		_agentToVertex.insert(std::make_pair(itVertex->info(), itVertex));
+	}
 
 	assert(_delaunay.is_valid());
 	return 0;
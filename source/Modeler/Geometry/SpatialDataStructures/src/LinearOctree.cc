@@ -0,0 +1,400 @@
+#include "LinearOctree.hh"
+
+#include "SpheroidalCell.hh"
+#include "ThreadPool.hh"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+/// \brief number of bits of each coordinate in a Morton code
+constexpr unsigned int MORTON_BITS = 21;
+/// \brief minimal number of agents of a chunk
+constexpr std::size_t MIN_AGENT_PER_CHUNK = 1 << 14;
+
+/// \brief spread the 21 lower bits of v so that two zeros separate them
+std::uint64_t spreadBits(std::uint64_t v) {
+	v &= 0x1fffff;
+	v = (v | v << 32) & 0x1f00000000ffffULL;
+	v = (v | v << 16) & 0x1f0000ff0000ffULL;
+	v = (v | v << 8)  & 0x100f00f00f00f00fULL;
+	v = (v | v << 4)  & 0x10c30c30c30c30c3ULL;
+	v = (v | v << 2)  & 0x1249249249249249ULL;
+	return v;
+}
+
+/// \brief call pFunction(iChunk, begin, end) on pNbChunk contiguous chunks of [0, pSize), on the shared ThreadPool.
+/// The chunks do not depend on the number of threads of the pool.
+template<typename F>
+void forEachChunk(unsigned int pNbChunk, std::size_t pSize, F&& pFunction) {
+	if(pNbChunk <= 1) {
+		pFunction(0u, std::size_t(0), pSize);
+		return;
+	}
+
+	ThreadPool::getInstance()->parallelFor(pNbChunk, [&pFunction, pNbChunk, pSize](std::size_t pBegin, std::size_t pEnd) {
+		for(std::size_t iChunk = pBegin; iChunk < pEnd; ++iChunk)
+			pFunction(static_cast<unsigned int>(iChunk), pSize*iChunk/pNbChunk, pSize*(iChunk + 1)/pNbChunk);
+	});
+}
+
+}
+
+LinearOctree::LinearOctree(unsigned int pMaxNbAgt):
+	_maxNbAgt(std::max(1u, pMaxNbAgt)),
+	_maxRadius(0.),
+	_refitThreshold(-1.),
+	_parallel(true)
+{
+}
+
+/// \details One chunk per thread of the ThreadPool, each chunk holding at least MIN_AGENT_PER_CHUNK agents.
+/// A single chunk if the octree is not built in parallel.
+unsigned int LinearOctree::getNbChunkFor(std::size_t pNbAgent) const {
+	if(!_parallel)
+		return 1;
+	return static_cast<unsigned int>(std::clamp<std::size_t>(pNbAgent/MIN_AGENT_PER_CHUNK, 1, ThreadPool::getInstance()->getNbThread()));
+}
+
+std::uint64_t LinearOctree::getMortonCode(std::uint32_t pX, std::uint32_t pY, std::uint32_t pZ) {
+	return spreadBits(pX) | (spreadBits(pY) << 1) | (spreadBits(pZ) << 2);
+}
+
+void LinearOctree::clear() {
+	_agents.clear();
+	_positions.clear();
+	_radii.clear();
+	_rebuildPositions.clear();
+	_codes.clear();
+	_nodes.clear();
+	_maxRadius = 0.;
+}
+
+void LinearOctree::rebuild() {
+	readPositions();
+	sortByMortonCode();
+	buildNodes();
+	computeBoxes();
+	_rebuildPositions = _positions;
+}
+
+void LinearOctree::refit() {
+	readPositions();
+	computeBoxes();
+}
+
+/// \details The displacement is measured from the positions of the last rebuild, a refit never
+/// accumulates more than the threshold.
+bool LinearOctree::update() {
+	readPositions();
+
+	double threshold = _refitThreshold >= 0. ? _refitThreshold : _maxRadius;
+	bool needRebuild = _rebuildPositions.size() != _positions.size();
+	for(std::size_t iAgent = 0; !needRebuild && iAgent < _positions.size(); ++iAgent)
+		needRebuild = CGAL::squared_distance(_positions[iAgent], _rebuildPositions[iAgent]) > threshold*threshold;
+
+	if(needRebuild) {
+		sortByMortonCode();
+		buildNodes();
+		_rebuildPositions = _positions;
+	}
+	computeBoxes();
+	return needRebuild;
+}
+
+void LinearOctree::readPositions() {
+	_positions.resize(_agents.size());
+	_radii.resize(_agents.size());
+	forEachChunk(getNbChunkFor(_agents.size()), _agents.size(), [this](unsigned int, std::size_t begin, std::size_t end) {
+		for(std::size_t iAgent = begin; iAgent < end; ++iAgent) {
+			_positions[iAgent] = _agents[iAgent]->getPosition();
+			auto const* lCell = dynamic_cast<const SpheroidalCell*>(_agents[iAgent]);
+			_radii[iAgent] = lCell ? lCell->getRadius() : 0.;
+		}
+	});
+	_maxRadius = _radii.empty() ? 0. : *std::max_element(_radii.begin(), _radii.end());
+}
+
+/// \details Least significant digit radix sort of the 63 bits codes, one byte per pass. The digits of
+/// each chunk are counted then the chunk is scattered after the previous chunks : the sort is stable and
+/// its result does not depend on the number of threads.
+void LinearOctree::sortByMortonCode() {
+	std::size_t nbAgent = _agents.size();
+	if(nbAgent == 0) {
+		_codes.clear();
+		return;
+	}
+
+	// quantize the positions in the bounding box of the agents
+	std::array<double, 3> min, max;
+	min.fill(std::numeric_limits<double>::max());
+	max.fill(std::numeric_limits<double>::lowest());
+	for(auto const& position : _positions) {
+		for(int iDim = 0; iDim < 3; ++iDim) {
+			min[iDim] = std::min(min[iDim], position[iDim]);
+			max[iDim] = std::max(max[iDim], position[iDim]);
+		}
+	}
+	double extent = std::max({max[0] - min[0], max[1] - min[1], max[2] - min[2]});
+	double scale = extent > 0. ? ((1u << MORTON_BITS) - 1)/extent : 0.;
+
+	unsigned int nbChunk = getNbChunkFor(nbAgent);
+	std::vector<std::uint64_t> keys(nbAgent), keysTmp(nbAgent);
+	std::vector<std::uint32_t> order(nbAgent), orderTmp(nbAgent);
+	forEachChunk(nbChunk, nbAgent, [&](unsigned int, std::size_t begin, std::size_t end) {
+		for(std::size_t iAgent = begin; iAgent < end; ++iAgent) {
+			auto const& position = _positions[iAgent];
+			keys[iAgent] = getMortonCode(
+				static_cast<std::uint32_t>((position.x() - min[0])*scale),
+				static_cast<std::uint32_t>((position.y() - min[1])*scale),
+				static_cast<std::uint32_t>((position.z() - min[2])*scale)
+			);
+			order[iAgent] = static_cast<std::uint32_t>(iAgent);
+		}
+	});
+
+	std::vector<std::array<std::size_t, 256>> histograms(nbChunk);
+	for(unsigned int shift = 0; shift < 3*MORTON_BITS; shift += 8) {
+		forEachChunk(nbChunk, nbAgent, [&](unsigned int iChunk, std::size_t begin, std::size_t end) {
+			auto& histogram = histograms[iChunk];
+			histogram.fill(0);
+			for(std::size_t iAgent = begin; iAgent < end; ++iAgent)
+				++histogram[(keys[iAgent] >> shift) & 0xff];
+		});
+
+		// skip the pass if all the keys share the same digit
+		bool sameDigit = false;
+		std::size_t offset = 0;
+		for(std::size_t iDigit = 0; iDigit < 256; ++iDigit) {
+			std::size_t nbDigit = 0;
+			for(unsigned int iChunk = 0; iChunk < nbChunk; ++iChunk) {
+				std::size_t count = histograms[iChunk][iDigit];
+				histograms[iChunk][iDigit] = offset;
+				offset += count;
+				nbDigit += count;
+			}
+			sameDigit |= (nbDigit == nbAgent);
+		}
+		if(sameDigit)
+			continue;
+
+		forEachChunk(nbChunk, nbAgent, [&](unsigned int iChunk, std::size_t begin, std::size_t end) {
+			auto& histogram = histograms[iChunk];
+			for(std::size_t iAgent = begin; iAgent < end; ++iAgent) {
+				std::size_t position = histogram[(keys[iAgent] >> shift) & 0xff]++;
+				keysTmp[position] = keys[iAgent];
+				orderTmp[position] = order[iAgent];
+			}
+		});
+		keys.swap(keysTmp);
+		order.swap(orderTmp);
+	}
+
+	// apply the order
+	std::vector<const t_SpatialableAgent_3*> agents(nbAgent);
+	std::vector<Point_3> positions(nbAgent);
+	std::vector<double> radii(nbAgent);
+	for(std::size_t iAgent = 0; iAgent < nbAgent; ++iAgent) {
+		agents[iAgent] = _agents[order[iAgent]];
+		positions[iAgent] = _positions[order[iAgent]];
+		radii[iAgent] = _radii[order[iAgent]];
+	}
+	_agents.swap(agents);
+	_positions.swap(positions);
+	_radii.swap(radii);
+	_codes.swap(keys);
+}
+
+/// \details A node is split on the next 3 bits of the codes. Its agents being sorted, each child is found by
+/// a binary search. A node is a leaf if it has at most _maxNbAgt agents or if all its codes are equal.
+void LinearOctree::buildNodes() {
+	_nodes.clear();
+	if(_agents.empty())
+		return;
+
+	std::vector<unsigned int> levels;
+	_nodes.push_back(Node{0, static_cast<std::uint32_t>(_agents.size()), -1, 0, {}, {}});
+	levels.push_back(0);
+
+	for(std::size_t iNode = 0; iNode < _nodes.size(); ++iNode) {
+		std::uint32_t begin = _nodes[iNode].begin;
+		std::uint32_t end = _nodes[iNode].end;
+		unsigned int level = levels[iNode];
+		if(end - begin <= _maxNbAgt || level >= MORTON_BITS || _codes[begin] == _codes[end - 1])
+			continue;
+
+		unsigned int shift = 3*(MORTON_BITS - 1 - level);
+		auto itBegin = _codes.begin() + begin;
+		auto itEnd = _codes.begin() + end;
+		_nodes[iNode].firstChild = static_cast<std::int32_t>(_nodes.size());
+		for(std::uint64_t iDigit = 0; iDigit < 8 && itBegin != itEnd; ++iDigit) {
+			auto itChildEnd = std::partition_point(itBegin, itEnd, [shift, iDigit](std::uint64_t code) {
+				return ((code >> shift) & 7) <= iDigit;
+			});
+			if(itChildEnd == itBegin)
+				continue;
+
+			_nodes.push_back(Node{
+				static_cast<std::uint32_t>(itBegin - _codes.begin()),
+				static_cast<std::uint32_t>(itChildEnd - _codes.begin()),
+				-1, 0, {}, {}
+			});
+			levels.push_back(level + 1);
+			++_nodes[iNode].nbChild;
+			itBegin = itChildEnd;
+		}
+	}
+}
+
+void LinearOctree::computeBoxes() {
+	// leaves, in parallel
+	forEachChunk(getNbChunkFor(_agents.size()), _nodes.size(), [this](unsigned int, std::size_t begin, std::size_t end) {
+		for(std::size_t iNode = begin; iNode < end; ++iNode) {
+			Node& node = _nodes[iNode];
+			if(node.firstChild >= 0)
+				continue;
+
+			node.min.fill(std::numeric_limits<double>::max());
+			node.max.fill(std::numeric_limits<double>::lowest());
+			for(std::uint32_t iAgent = node.begin; iAgent < node.end; ++iAgent) {
+				for(int iDim = 0; iDim < 3; ++iDim) {
+					node.min[iDim] = std::min(node.min[iDim], _positions[iAgent][iDim] - _radii[iAgent]);
+					node.max[iDim] = std::max(node.max[iDim], _positions[iAgent][iDim] + _radii[iAgent]);
+				}
+			}
+		}
+	});
+
+	// internal nodes, children are stored after their parent
+	for(std::size_t iNode = _nodes.size(); iNode-- > 0;) {
+		Node& node = _nodes[iNode];
+		if(node.firstChild < 0)
+			continue;
+
+		node.min = _nodes[node.firstChild].min;
+		node.max = _nodes[node.firstChild].max;
+		for(int iChild = 1; iChild < node.nbChild; ++iChild) {
+			auto const& child = _nodes[node.firstChild + iChild];
+			for(int iDim = 0; iDim < 3; ++iDim) {
+				node.min[iDim] = std::min(node.min[iDim], child.min[iDim]);
+				node.max[iDim] = std::max(node.max[iDim], child.max[iDim]);
+			}
+		}
+	}
+}
+
+double LinearOctree::squaredDistance(const Node& pNode, const Point_3& pPt) const {
+	double result = 0.;
+	for(int iDim = 0; iDim < 3; ++iDim) {
+		double delta = std::max({pNode.min[iDim] - pPt[iDim], 0., pPt[iDim] - pNode.max[iDim]});
+		result += delta*delta;
+	}
+	return result;
+}
+
+/// \details Depth first search, the nearest children being visited first. Nodes farther than the best
+/// candidate are pruned.
+const t_SpatialableAgent_3* LinearOctree::getNearestSpatialableAgent(Point_3 pPt) const {
+	if(_nodes.empty())
+		return nullptr;
+
+	double minDist = std::numeric_limits<double>::max();
+	const t_SpatialableAgent_3* nearest = nullptr;
+
+	std::vector<std::uint32_t> stack;
+	stack.reserve(64);
+	stack.push_back(0);
+	while(!stack.empty()) {
+		const Node& node = _nodes[stack.back()];
+		stack.pop_back();
+		if(squaredDistance(node, pPt) >= minDist)
+			continue;
+
+		if(node.firstChild < 0) {
+			for(std::uint32_t iAgent = node.begin; iAgent < node.end; ++iAgent) {
+				double dist = CGAL::squared_distance(pPt, _positions[iAgent]);
+				if(dist < minDist) {
+					minDist = dist;
+					nearest = _agents[iAgent];
+				}
+			}
+			continue;
+		}
+
+		// push the farthest children first
+		std::array<std::pair<double, std::uint32_t>, 8> children;
+		for(int iChild = 0; iChild < node.nbChild; ++iChild) {
+			std::uint32_t iChildNode = node.firstChild + iChild;
+			children[iChild] = {squaredDistance(_nodes[iChildNode], pPt), iChildNode};
+		}
+		std::sort(children.begin(), children.begin() + node.nbChild, std::greater<>());
+		for(int iChild = 0; iChild < node.nbChild; ++iChild) {
+			if(children[iChild].first < minDist)
+				stack.push_back(children[iChild].second);
+		}
+	}
+
+	return nearest;
+}
+
+void LinearOctree::getAgentsInSphere(Point_3 pPt, double pRadius, std::vector<const t_SpatialableAgent_3*>& pResult) const {
+	if(_nodes.empty())
+		return;
+
+	double squareRadius = pRadius*pRadius;
+	std::vector<std::uint32_t> stack;
+	stack.reserve(64);
+	stack.push_back(0);
+	while(!stack.empty()) {
+		const Node& node = _nodes[stack.back()];
+		stack.pop_back();
+		if(squaredDistance(node, pPt) > squareRadius)
+			continue;
+
+		if(node.firstChild < 0) {
+			for(std::uint32_t iAgent = node.begin; iAgent < node.end; ++iAgent) {
+				if(CGAL::squared_distance(pPt, _positions[iAgent]) <= squareRadius)
+					pResult.push_back(_agents[iAgent]);
+			}
+		} else {
+			for(int iChild = 0; iChild < node.nbChild; ++iChild)
+				stack.push_back(node.firstChild + iChild);
+		}
+	}
+}
+
+/// \details Same contact criterion as the previous octree with a Delaunay triangulation per leaf :
+/// two spheroidal cells are neighbours if the distance between their centers is lower than the largest
+/// of their radii. Only spheroidal cells have neighbours.
+std::set<const t_SpatialableAgent_3*> LinearOctree::getNeighbours(const t_SpatialableAgent_3* pSpa) const {
+	std::set<const t_SpatialableAgent_3*> result;
+	auto const* lCell = dynamic_cast<const SpheroidalCell*>(pSpa);
+	if(!lCell)
+		return result;
+
+	std::vector<const t_SpatialableAgent_3*> candidates;
+	getAgentsInSphere(lCell->getPosition(), std::max(lCell->getRadius(), _maxRadius), candidates);
+	for(auto const* candidate : candidates) {
+		auto const* lCell2 = dynamic_cast<const SpheroidalCell*>(candidate);
+		if(!lCell2 || lCell2 == lCell)
+			continue;
+		if(CGAL::squared_distance(lCell2->getPosition(), lCell->getPosition()) <= std::max(lCell->getSquareRadius(), lCell2->getSquareRadius()))
+			result.insert(candidate);
+	}
+	return result;
+}
+
+void LinearOctree::getContainedAgents(std::set<const t_SpatialableAgent_3*>& pStruc) const {
+	pStruc.insert(_agents.begin(), _agents.end());
+}
+
+std::size_t LinearOctree::getMemoryUsage() const {
+	return sizeof(*this)
+		+ _agents.capacity()*sizeof(const t_SpatialableAgent_3*)
+		+ _positions.capacity()*sizeof(Point_3)
+		+ _radii.capacity()*sizeof(double)
+		+ _rebuildPositions.capacity()*sizeof(Point_3)
+		+ _codes.capacity()*sizeof(std::uint64_t)
+		+ _nodes.capacity()*sizeof(Node);
+}
@@ -0,0 +1,36 @@
+#ifndef FILE_UTILS_GDML_HH
+#define FILE_UTILS_GDML_HH
+
+#include "SpheroidalCell.hh"
+
+#include <string>
+#include <vector>
+
+class G4Material;
+
+/// \brief write cell populations to GDML directly from the CPOP meshes, without building the G4 geometry.
+/// \details The hierarchy written is the one of SpheroidalCellMesh::convertToG4World :
+/// world -> spheroid bounding box -> cells (copy number = cell ID) -> nuclei.
+/// Membranes are tessellated solids defined relatively to the cell origin, nuclei are orbs.
+/// Cells are converted by chunks of GDML_NB_CELL_PER_CHUNK, possibly in parallel. Each section (define, solids,
+/// structure) of the chunks is appended in the chunk order to a temporary file, the temporary files are then
+/// concatenated : the output does not depend on the number of threads.
+namespace IO::GDML {
+
+/// \brief number of cells converted by a thread before its output is flushed
+static constexpr std::size_t GDML_NB_CELL_PER_CHUNK = 256;
+/// \brief number of decimals written for lengths (mm) and positions
+static constexpr int GDML_LENGTH_PRECISION = 9;
+
+/// \brief export the spheroidal cells to a GDML file
+bool exportSpheroidalCells(
+	std::string const& pPath,
+	std::vector<SpheroidalCell*> const& pCells,
+	G4Material* pMaterialBetweenCell = nullptr,
+	unsigned int pNbThread = 1,
+	bool pExportNuclei = true
+);
+
+}
+
+#endif
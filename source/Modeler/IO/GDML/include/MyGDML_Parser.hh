@@ -16,6 +16,8 @@ class MyGDML_Parser {
 public:
 	/// \brief write a G4World to a given file path
 	bool write(QString path, G4PVPlacement* topWorld);
+	/// \brief read a GDML file and return its world, nullptr if failed
+	G4VPhysicalVolume* read(QString path, bool validate = false);
 
 	/// \brief close the GDML
 	void close() {}
@@ -0,0 +1,392 @@
+#include "File_Utils_GDML.hh"
+
+#include "CellMeshSettings.hh"
+#include "InformationSystemManager.hh"
+#include "MaterialManager.hh"
+#include "RoundNucleus.hh"
+#include "UnitSystemManager.hh"
+
+#include "G4Element.hh"
+#include "G4Material.hh"
+#include "G4ThreeVector.hh"
+
+#include <CLHEP/Units/SystemOfUnits.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <thread>
+
+namespace IO::GDML {
+
+namespace {
+
+/// \brief the GDML sections written by chunk
+struct ChunkOutput {
+	std::string define;     ///< \brief positions of the tessellated solid vertices
+	std::string solids;     ///< \brief membranes and nuclei solids
+	std::string structure;  ///< \brief nuclei and cells logical volumes
+	std::string placements; ///< \brief placements of the cells in the spheroid volume
+	bool success = true;    ///< \brief false if a cell can't be converted
+};
+
+/// \brief append a number with a fixed number of decimals
+void appendFixed(std::string& pOut, double pValue, int pPrecision = GDML_LENGTH_PRECISION) {
+	char buffer[64];
+	int size = std::snprintf(buffer, sizeof(buffer), "%.*f", pPrecision, pValue);
+	pOut.append(buffer, static_cast<std::size_t>(size));
+}
+
+/// \brief append a number with a fixed number of significant digits
+void appendGeneral(std::string& pOut, double pValue) {
+	char buffer[64];
+	int size = std::snprintf(buffer, sizeof(buffer), "%.12g", pValue);
+	pOut.append(buffer, static_cast<std::size_t>(size));
+}
+
+/// \brief append the x, y, z attributes of a point
+void appendXYZ(std::string& pOut, double pX, double pY, double pZ) {
+	pOut += " x=\"";
+	appendFixed(pOut, pX);
+	pOut += "\" y=\"";
+	appendFixed(pOut, pY);
+	pOut += "\" z=\"";
+	appendFixed(pOut, pZ);
+	pOut += "\"";
+}
+
+/// \brief the name of a material in the GDML file
+std::string materialName(const G4Material* pMaterial) {
+	return pMaterial->GetName();
+}
+
+/// \brief return the material state as a GDML attribute value, empty if undefined
+std::string stateName(G4State pState) {
+	switch(pState) {
+		case kStateSolid: return "solid";
+		case kStateLiquid: return "liquid";
+		case kStateGas: return "gas";
+		default: return "";
+	}
+}
+
+/// \brief write the elements and materials used, each of them once
+void writeMaterials(std::ofstream& pOut, std::vector<const G4Material*> const& pMaterials) {
+	std::map<std::string, const G4Element*> elements;
+	for(auto const* material : pMaterials) {
+		for(std::size_t iElement = 0; iElement < material->GetNumberOfElements(); ++iElement) {
+			const G4Element* element = material->GetElement(static_cast<G4int>(iElement));
+			elements.emplace(element->GetName(), element);
+		}
+	}
+
+	std::string out = "\t<materials>\n";
+	for(auto const& element : elements) {
+		out += "\t\t<element name=\"" + element.first + "\" formula=\"" + element.second->GetSymbol() + "\" Z=\"";
+		appendGeneral(out, element.second->GetZ());
+		out += "\">\n\t\t\t<atom unit=\"g/mole\" value=\"";
+		appendGeneral(out, element.second->GetA()/(CLHEP::g/CLHEP::mole));
+		out += "\"/>\n\t\t</element>\n";
+	}
+
+	for(auto const* material : pMaterials) {
+		out += "\t\t<material name=\"" + materialName(material) + "\"";
+		std::string state = stateName(material->GetState());
+		if(!state.empty())
+			out += " state=\"" + state + "\"";
+		out += ">\n\t\t\t<D unit=\"g/cm3\" value=\"";
+		appendGeneral(out, material->GetDensity()/(CLHEP::g/CLHEP::cm3));
+		out += "\"/>\n";
+
+		const G4double* fractions = material->GetFractionVector();
+		for(std::size_t iElement = 0; iElement < material->GetNumberOfElements(); ++iElement) {
+			out += "\t\t\t<fraction n=\"";
+			appendGeneral(out, fractions[iElement]);
+			out += "\" ref=\"" + material->GetElement(static_cast<G4int>(iElement))->GetName() + "\"/>\n";
+		}
+		out += "\t\t</material>\n";
+	}
+	out += "\t</materials>\n";
+	pOut << out;
+}
+
+/// \brief materials of a cell
+struct CellMaterials {
+	const G4Material* cytoplasm;
+	const G4Material* nucleus;
+};
+
+/// \brief convert a cell to its GDML sections
+/// \param pCell The cell to convert
+/// \param pMaterials The materials of the cell
+/// \param pCenter The position of the spheroid volume, in G4 unit
+/// \param pExportNuclei true if we want to export nuclei as well
+/// \param pOut The chunk to append the cell to
+void writeCell(SpheroidalCell* pCell, CellMaterials const& pMaterials, G4ThreeVector const& pCenter, bool pExportNuclei, ChunkOutput& pOut) {
+	double convertToG4 = UnitSystemManager::getInstance()->getConversionToG4();
+	std::string cellName = cellNamePrefix + std::to_string(pCell->getID());
+	Point_3 origin = pCell->getOrigin();
+
+	// vertices of the membrane, relatively to the cell origin
+	std::map<Point_3, std::size_t, comparePoint_3> vertexIndex;
+	for(auto const& point : pCell->getMembranePoints()) {
+		if(!vertexIndex.emplace(point, vertexIndex.size()).second)
+			continue;
+
+		pOut.define += "\t\t<position name=\"" + cellName + "_v" + std::to_string(vertexIndex.size() - 1) + "\" unit=\"mm\"";
+		appendXYZ(pOut.define,
+			(point.x() - origin.x())*convertToG4,
+			(point.y() - origin.y())*convertToG4,
+			(point.z() - origin.z())*convertToG4
+		);
+		pOut.define += "/>\n";
+	}
+
+	// facets, with the same orientation as SpheroidalCell::convertMembraneToG4
+	std::size_t nbFacet = 0;
+	pOut.solids += "\t\t<tessellated name=\"" + cellName + "\" aunit=\"deg\" lunit=\"mm\">\n";
+	for(auto const& triangle : pCell->getMembraneTriangles()) {
+		Point_3 p1 = triangle.vertex(0);
+		Point_3 p2 = triangle.vertex(1);
+		Point_3 p3 = triangle.vertex(2);
+		if(CGAL::determinant(p1 - origin, p2 - origin, p3 - origin) < 0.)
+			std::swap(p1, p2);
+
+		pOut.solids += "\t\t\t<triangular vertex1=\"" + cellName + "_v" + std::to_string(vertexIndex[p1])
+			+ "\" vertex2=\"" + cellName + "_v" + std::to_string(vertexIndex[p2])
+			+ "\" vertex3=\"" + cellName + "_v" + std::to_string(vertexIndex[p3])
+			+ "\" type=\"ABSOLUTE\"/>\n";
+		++nbFacet;
+	}
+	pOut.solids += "\t\t</tessellated>\n";
+
+	if(nbFacet < 4) {
+		std::string mess = "cannot export " + cellName + " : a tesselated solid needs at least 4 facets";
+		InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, mess, "GDML");
+		pOut.success = false;
+	}
+
+	// nuclei volumes must be defined before the cell volume
+	std::string nucleiPlacements;
+	if(pExportNuclei) {
+		unsigned int iNucleus = 0;
+		for(auto const* nucleus : pCell->getNuclei()) {
+			auto const* roundNucleus = dynamic_cast<const RoundNucleus<double, Point_3, Vector_3>*>(nucleus);
+			if(!roundNucleus) {
+				InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "only round nuclei can be exported to GDML", "GDML");
+				pOut.success = false;
+				continue;
+			}
+
+			std::string nucleusName = nucleusNamePrefix + cellName + std::to_string(iNucleus++);
+			pOut.solids += "\t\t<orb name=\"" + nucleusName + "\" r=\"";
+			appendFixed(pOut.solids, roundNucleus->getRadius()*convertToG4);
+			pOut.solids += "\" lunit=\"mm\"/>\n";
+
+			pOut.structure += "\t\t<volume name=\"LV_" + nucleusName + "\">\n"
+				"\t\t\t<materialref ref=\"" + materialName(pMaterials.nucleus) + "\"/>\n"
+				"\t\t\t<solidref ref=\"" + nucleusName + "\"/>\n"
+				"\t\t</volume>\n";
+
+			Point_3 nucleusOrigin = roundNucleus->getOrigin();
+			nucleiPlacements += "\t\t\t<physvol name=\"PV_" + nucleusName + "\" copynumber=\"0\">\n"
+				"\t\t\t\t<volumeref ref=\"LV_" + nucleusName + "\"/>\n"
+				"\t\t\t\t<position name=\"PV_" + nucleusName + "_pos\" unit=\"mm\"";
+			appendXYZ(nucleiPlacements,
+				(nucleusOrigin.x() - origin.x())*convertToG4,
+				(nucleusOrigin.y() - origin.y())*convertToG4,
+				(nucleusOrigin.z() - origin.z())*convertToG4
+			);
+			nucleiPlacements += "/>\n\t\t\t</physvol>\n";
+		}
+	}
+
+	pOut.structure += "\t\t<volume name=\"LV_" + cellName + "\">\n"
+		"\t\t\t<materialref ref=\"" + materialName(pMaterials.cytoplasm) + "\"/>\n"
+		"\t\t\t<solidref ref=\"" + cellName + "\"/>\n"
+		+ nucleiPlacements +
+		"\t\t</volume>\n";
+
+	pOut.placements += "\t\t\t<physvol name=\"PV_" + cellName + "\" copynumber=\"" + std::to_string(pCell->getID()) + "\">\n"
+		"\t\t\t\t<volumeref ref=\"LV_" + cellName + "\"/>\n"
+		"\t\t\t\t<position name=\"PV_" + cellName + "_pos\" unit=\"mm\"";
+	appendXYZ(pOut.placements,
+		origin.x()*convertToG4 - pCenter.x(),
+		origin.y()*convertToG4 - pCenter.y(),
+		origin.z()*convertToG4 - pCenter.z()
+	);
+	pOut.placements += "/>\n\t\t\t</physvol>\n";
+}
+
+/// \brief copy a temporary file at the end of the output and remove it
+void appendAndRemove(std::ofstream& pOut, std::string const& pPath) {
+	{
+		std::ifstream in(pPath, std::ios::binary);
+		if(in.peek() != std::ifstream::traits_type::eof())
+			pOut << in.rdbuf();
+	}
+	std::remove(pPath.c_str());
+}
+
+}
+
+/// \param pPath The path of the GDML file
+/// \param pCells The cells to export
+/// \param pMaterialBetweenCell The material of the world and of the spheroid volume, default material if null
+/// \param pNbThread The number of threads converting the cells
+/// \param pExportNuclei true if we want to export nuclei as well
+/// \return true if the file has been written and all cells exported
+bool exportSpheroidalCells(std::string const& pPath, std::vector<SpheroidalCell*> const& pCells, G4Material* pMaterialBetweenCell, unsigned int pNbThread, bool pExportNuclei) {
+	double convertToG4 = UnitSystemManager::getInstance()->getConversionToG4();
+	const G4Material* worldMaterial = pMaterialBetweenCell ? pMaterialBetweenCell : MaterialManager::getInstance()->getDefaultMaterial();
+	assert(worldMaterial);
+
+	// materials and bounding box, each material is written once
+	std::vector<const G4Material*> materials{worldMaterial};
+	auto registerMaterial = [&materials](const G4Material* pMaterial) {
+		if(std::find(materials.begin(), materials.end(), pMaterial) == materials.end())
+			materials.push_back(pMaterial);
+	};
+
+	std::vector<CellMaterials> cellMaterials;
+	cellMaterials.reserve(pCells.size());
+	double inf = std::numeric_limits<double>::max();
+	G4ThreeVector bbMin(inf, inf, inf), bbMax(-inf, -inf, -inf);
+	for(auto* cell : pCells) {
+		CellMaterials lMaterials{
+			cell->getCellProperties()->getCytoplasmMaterial(cell->getLifeCycle()),
+			cell->getCellProperties()->getNucleusMaterial(cell->getLifeCycle())
+		};
+		if(!lMaterials.cytoplasm)
+			lMaterials.cytoplasm = MaterialManager::getInstance()->getDefaultMaterial();
+		if(!lMaterials.nucleus)
+			lMaterials.nucleus = MaterialManager::getInstance()->getDefaultMaterial();
+		registerMaterial(lMaterials.cytoplasm);
+		registerMaterial(lMaterials.nucleus);
+		cellMaterials.push_back(lMaterials);
+
+		for(auto const& membranePoint : cell->getMembranePoints()) {
+			G4ThreeVector point(membranePoint.x()*convertToG4, membranePoint.y()*convertToG4, membranePoint.z()*convertToG4);
+			bbMin.set(std::min(bbMin.x(), point.x()), std::min(bbMin.y(), point.y()), std::min(bbMin.z(), point.z()));
+			bbMax.set(std::max(bbMax.x(), point.x()), std::max(bbMax.y(), point.y()), std::max(bbMax.z(), point.z()));
+		}
+	}
+
+	if(pCells.empty())
+		bbMin = bbMax = G4ThreeVector();
+
+	// margin so the cells are strictly inside the spheroid volume
+	G4ThreeVector margin(overlapToleranceForG4, overlapToleranceForG4, overlapToleranceForG4);
+	bbMin -= margin;
+	bbMax += margin;
+	G4ThreeVector center = (bbMin + bbMax)/2.;
+	G4ThreeVector halfSize = (bbMax - bbMin)/2.;
+
+	// convert the cells by chunks. The chunks of a wave are converted in parallel then appended in order.
+	std::string definePath = pPath + ".define.tmp";
+	std::string solidsPath = pPath + ".solids.tmp";
+	std::string structurePath = pPath + ".structure.tmp";
+	std::string placementsPath = pPath + ".placements.tmp";
+	bool success = true;
+	{
+		std::ofstream defineOut(definePath, std::ios::binary | std::ios::trunc);
+		std::ofstream solidsOut(solidsPath, std::ios::binary | std::ios::trunc);
+		std::ofstream structureOut(structurePath, std::ios::binary | std::ios::trunc);
+		std::ofstream placementsOut(placementsPath, std::ios::binary | std::ios::trunc);
+
+		unsigned int nbThread = std::max(1u, pNbThread);
+		std::size_t nbChunk = (pCells.size() + GDML_NB_CELL_PER_CHUNK - 1)/GDML_NB_CELL_PER_CHUNK;
+		std::vector<ChunkOutput> wave(nbThread);
+
+		auto convertChunk = [&](std::size_t pChunk, ChunkOutput& pOut) {
+			pOut = ChunkOutput();
+			std::size_t end = std::min(pCells.size(), (pChunk + 1)*GDML_NB_CELL_PER_CHUNK);
+			for(std::size_t iCell = pChunk*GDML_NB_CELL_PER_CHUNK; iCell < end; ++iCell)
+				writeCell(pCells[iCell], cellMaterials[iCell], center, pExportNuclei, pOut);
+		};
+
+		for(std::size_t firstChunk = 0; firstChunk < nbChunk; firstChunk += nbThread) {
+			std::size_t nbChunkInWave = std::min<std::size_t>(nbThread, nbChunk - firstChunk);
+			std::vector<std::thread> threads;
+			for(std::size_t iChunk = 1; iChunk < nbChunkInWave; ++iChunk)
+				threads.emplace_back(convertChunk, firstChunk + iChunk, std::ref(wave[iChunk]));
+			convertChunk(firstChunk, wave[0]);
+			for(auto& thread : threads)
+				thread.join();
+
+			for(std::size_t iChunk = 0; iChunk < nbChunkInWave; ++iChunk) {
+				defineOut << wave[iChunk].define;
+				solidsOut << wave[iChunk].solids;
+				structureOut << wave[iChunk].structure;
+				placementsOut << wave[iChunk].placements;
+				success &= wave[iChunk].success;
+			}
+		}
+
+		success &= defineOut.good() && solidsOut.good() && structureOut.good() && placementsOut.good();
+	}
+
+	std::ofstream out(pPath, std::ios::binary | std::ios::trunc);
+	if(!out.is_open()) {
+		InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "unable to open " + pPath, "GDML");
+		for(auto const& tmpPath : {definePath, solidsPath, structurePath, placementsPath})
+			std::remove(tmpPath.c_str());
+		return false;
+	}
+
+	out << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\" ?>\n"
+		<< "<gdml xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xsi:noNamespaceSchemaLocation=\"http://service-spi.web.cern.ch/service-spi/app/releases/GDML/schema/gdml.xsd\">\n\n"
+		<< "\t<define>\n";
+	appendAndRemove(out, definePath);
+	out << "\t</define>\n\n";
+
+	writeMaterials(out, materials);
+
+	std::string boxes = "\n\t<solids>\n\t\t<box name=\"sWorld\" lunit=\"mm\"";
+	// the world is centered on the origin
+	appendXYZ(boxes,
+		2.*std::max(std::fabs(bbMin.x()), std::fabs(bbMax.x())),
+		2.*std::max(std::fabs(bbMin.y()), std::fabs(bbMax.y())),
+		2.*std::max(std::fabs(bbMin.z()), std::fabs(bbMax.z()))
+	);
+	boxes += "/>\n\t\t<box name=\"Spheroid_bb\" lunit=\"mm\"";
+	appendXYZ(boxes, 2.*halfSize.x(), 2.*halfSize.y(), 2.*halfSize.z());
+	boxes += "/>\n";
+	out << boxes;
+	appendAndRemove(out, solidsPath);
+	out << "\t</solids>\n\n\t<structure>\n";
+	appendAndRemove(out, structurePath);
+
+	out << "\t\t<volume name=\"LV_Spheroid_bb\">\n"
+		<< "\t\t\t<materialref ref=\"" << materialName(worldMaterial) << "\"/>\n"
+		<< "\t\t\t<solidref ref=\"Spheroid_bb\"/>\n";
+	appendAndRemove(out, placementsPath);
+	out << "\t\t</volume>\n";
+
+	std::string world = "\t\t<volume name=\"LV_World\">\n"
+		"\t\t\t<materialref ref=\"" + materialName(worldMaterial) + "\"/>\n"
+		"\t\t\t<solidref ref=\"sWorld\"/>\n"
+		"\t\t\t<physvol name=\"PV_Spheroid_bb\" copynumber=\"0\">\n"
+		"\t\t\t\t<volumeref ref=\"LV_Spheroid_bb\"/>\n"
+		"\t\t\t\t<position name=\"PV_Spheroid_bb_pos\" unit=\"mm\"";
+	appendXYZ(world, center.x(), center.y(), center.z());
+	world += "/>\n\t\t\t</physvol>\n\t\t</volume>\n";
+	out << world;
+
+	out << "\t</structure>\n\n"
+		<< "\t<setup name=\"Default\" version=\"1.0\">\n"
+		<< "\t\t<world ref=\"LV_World\"/>\n"
+		<< "\t</setup>\n\n"
+		<< "</gdml>\n";
+
+	success &= out.good();
+	if(!success)
+		InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "some cells failed to be exported to " + pPath, "GDML");
+	return success;
+}
+
+}
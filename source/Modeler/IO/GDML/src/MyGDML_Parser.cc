@@ -7,3 +7,10 @@ bool MyGDML_Parser::write(QString path, G4PVPlacement* topWorld) {
 	InformationSystemManager::getInstance()->Message(InformationSystemManager::INFORMATION_MES, "write on file with sucess", "GDML_Parser");
 	return true;
 }
+
+/// \param path The GDML file to read
+/// \param validate true to validate the file against the GDML schema
+G4VPhysicalVolume* MyGDML_Parser::read(QString path, bool validate) {
+	parser.Read(path.toStdString(), validate);
+	return parser.GetWorldVolume();
+}
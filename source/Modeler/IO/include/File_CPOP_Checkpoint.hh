@@ -0,0 +1,52 @@
+#ifndef FILE_CPOP_CHECKPOINT_HH
+#define FILE_CPOP_CHECKPOINT_HH
+
+#include "Action.hh"
+#include "Layer.hh"
+
+#include <string>
+
+/// \brief Binary checkpoints of a simulated population.
+/// \details A checkpoint stores the state of the 3D cells of a layer evolving during a simulation
+/// (positions, movement, radius, life cycle, age, mass, round nuclei), the state of the random engine,
+/// the step counter and the simulation time. Cells are identified by their ID : a checkpoint is restored
+/// on the population it was taken from, rebuilt the same way (same file or same distribution seed).
+/// Spatial data structures are not stored, they are rebuilt from the positions when the simulation starts.
+/// Restarting from a checkpoint gives the same trajectories as the uninterrupted run in deterministic mode
+/// (see MASPlatform::setDeterministic).
+namespace IO::CPOP {
+
+/// \brief the simulation state stored with the cells
+struct CheckpointInfo {
+	unsigned long int step = 0;     ///< \brief number of steps simulated
+	double time = 0.;               ///< \brief simulation time, in s
+	unsigned long int nbCell = 0;   ///< \brief number of cells stored
+};
+
+/// \brief write the state of the cells of the layer and of the simulation to a binary file
+bool saveCheckpoint(const Layer*, std::string const& pPath);
+/// \brief restore the state of the cells of the layer and of the random engine from a binary file
+bool loadCheckpoint(Layer*, std::string const& pPath, CheckpointInfo* pInfo = nullptr);
+
+/// \brief Action writing a checkpoint of a layer every n steps.
+/// \details The file is written next to the requested path then renamed, an interrupted write never
+/// replaces the previous checkpoint. Must be created once the platform is set up.
+class CheckpointAction : public Action {
+public:
+	CheckpointAction(const Layer* pLayer, std::string pPath, unsigned long int pNbStep);
+
+	bool exec() override;
+
+	/// \brief return the number of checkpoints written
+	[[nodiscard]] unsigned int getNbCheckpoint() const { return _nbCheckpoint; }
+
+private:
+	const Layer* _layer;            ///< \brief the layer to save
+	std::string _path;              ///< \brief the checkpoint file
+	unsigned long int _nbStep;      ///< \brief number of steps between two checkpoints
+	unsigned int _nbCheckpoint;     ///< \brief number of checkpoints written
+};
+
+}
+
+#endif
@@ -2,9 +2,14 @@
 #define FILE_Utils_HH
 
 #include "GeometrySettings.hh"
+#include "ThreadPool.hh"
 
 #include <CGAL/IO/Color.h>
 #include <QString>
+
+#include <algorithm>
+#include <ostream>
+#include <string>
 #include <vector>
 
 using namespace Settings::Geometry;
@@ -21,6 +26,55 @@ void savePositions(QString pFile, const std::vector<Point_3>* pPositions);
 /// \brief return a random color
 CGAL::Color getRandomColor();
 
+/// \brief append the color as "red green blue"
+void appendColor(std::string&, CGAL::Color);
+/// \brief append a number formatted as a default std::ostream would (6 significant digits)
+void appendNumber(std::string&, double);
+/// \brief append a point formatted as a default std::ostream would ("x y z")
+void appendPoint(std::string&, const Point_3&);
+/// \brief return the number of threads used by the exporters
+unsigned int getNbExportThread();
+
+/// \brief number of items serialized by a thread before its output is written
+static constexpr std::size_t NB_ITEM_PER_EXPORT_CHUNK = 1024;
+
+/// \brief serialize items in parallel and write them in the item order
+/// \details pSerializer(index, buffer) appends the item index to the buffer. Items are serialized by chunks,
+/// a wave of chunks is serialized in parallel on the ThreadPool then written : the output does not depend on the number of threads.
+/// pSerializer must not use the ThreadPool itself.
+/// \param pOut The stream to write to
+/// \param pNbItem The number of items to serialize
+/// \param pSerializer The function appending an item to a buffer
+/// \param pNbThread The number of chunks serialized in parallel
+template<typename Serializer>
+void writeInParallel(std::ostream& pOut, std::size_t pNbItem, Serializer pSerializer, unsigned int pNbThread = getNbExportThread()) {
+	pNbThread = std::max(1u, pNbThread);
+	std::size_t nbChunk = (pNbItem + NB_ITEM_PER_EXPORT_CHUNK - 1)/NB_ITEM_PER_EXPORT_CHUNK;
+	std::vector<std::string> buffers(pNbThread);
+
+	auto serializeChunk = [&](std::size_t pChunk, std::string* pBuffer) {
+		pBuffer->clear();
+		std::size_t end = std::min(pNbItem, (pChunk + 1)*NB_ITEM_PER_EXPORT_CHUNK);
+		for(std::size_t iItem = pChunk*NB_ITEM_PER_EXPORT_CHUNK; iItem < end; ++iItem)
+			pSerializer(iItem, *pBuffer);
+	};
+
+	for(std::size_t firstChunk = 0; firstChunk < nbChunk; firstChunk += pNbThread) {
+		std::size_t nbChunkInWave = std::min<std::size_t>(pNbThread, nbChunk - firstChunk);
+		if(nbChunkInWave == 1) {
+			serializeChunk(firstChunk, &buffers[0]);
+		} else {
+			ThreadPool::getInstance()->parallelFor(nbChunkInWave, [&](std::size_t pBegin, std::size_t pEnd) {
+				for(std::size_t iChunk = pBegin; iChunk < pEnd; ++iChunk)
+					serializeChunk(firstChunk + iChunk, &buffers[iChunk]);
+			});
+		}
+
+		for(std::size_t iChunk = 0; iChunk < nbChunkInWave; ++iChunk)
+			pOut.write(buffers[iChunk].data(), static_cast<std::streamsize>(buffers[iChunk].size()));
+	}
+}
+
 }
 
 #endif
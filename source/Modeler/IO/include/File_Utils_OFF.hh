@@ -7,6 +7,13 @@
 #include <CGAL/IO/Color.h>
 #include <CGAL/Polyhedron_3.h>
 
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace IO::OFF {
 
 using namespace Settings::Geometry;
@@ -27,6 +34,58 @@ bool exportVertices(std::map<Point_3, unsigned long int, comparePoint_3>&, std::
 /// \brief export a facet to the off format.
 bool exportFacetToOff(const Polyhedron_3::Facet*, std::ofstream*, std::map<Point_3, unsigned long int, comparePoint_3>&, QString = QString() );
 
+/// \brief the vertices of an .off file, sorted as a std::set<Point_3, comparePoint_3> would
+/// \details points are first all added, then build() sorts them and gives their index through a hash map.
+class VertexIndex {
+public:
+	/// \brief add a point, before build()
+	void add(const Point_3& pPoint) { _points.push_back(pPoint); }
+	/// \brief add a range of points, before build()
+	template<typename Iterator>
+	void add(Iterator pBegin, Iterator pEnd) { _points.insert(_points.end(), pBegin, pEnd); }
+	/// \brief sort and remove duplicated points, then index them
+	void build();
+
+	/// \brief number of distinct points, after build()
+	[[nodiscard]] std::size_t size() const { return _points.size(); }
+	/// \brief index of a point, after build()
+	[[nodiscard]] unsigned long int index(const Point_3& pPoint) const { return _indexes.at(pPoint); }
+	/// \brief the sorted distinct points, after build()
+	[[nodiscard]] const std::vector<Point_3>& points() const { return _points; }
+
+private:
+	/// \brief hash of a point, -0. and 0. have the same hash
+	struct PointHash {
+		std::size_t operator()(const Point_3& p) const {
+			std::size_t h = std::hash<double>()(p.x() + 0.);
+			h ^= std::hash<double>()(p.y() + 0.) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+			h ^= std::hash<double>()(p.z() + 0.) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+			return h;
+		}
+	};
+
+	std::vector<Point_3> _points;                                          ///< \brief the points
+	std::unordered_map<Point_3, unsigned long int, PointHash> _indexes;    ///< \brief index of each point
+};
+
+/// \brief triangles given by their vertex indices in a list of points
+struct TriangleMesh {
+	std::vector<Point_3> points;                          ///< \brief the points
+	std::vector<std::array<std::uint32_t, 3>> facets;     ///< \brief the facets, as indices in points
+};
+
+/// \brief return the convex hull of the points, as CGAL::convex_hull_3 gives it
+TriangleMesh getConvexHull(const std::vector<Point_3>&);
+
+/// \brief write the .off header, the counts and the vertices
+void writeHeaderAndVertices(std::ostream&, const VertexIndex&, unsigned long int nbFacets);
+/// \brief append the facets of a polyhedron, all with the given color ("r g b")
+void appendPolyhedron(std::string&, const Polyhedron_3&, const VertexIndex&, const std::string& color);
+/// \brief append the facets of a triangle mesh, all with the given color ("r g b")
+void appendTriangleMesh(std::string&, const TriangleMesh&, const VertexIndex&, const std::string& color);
+/// \brief append the triangles, all with the given color ("r g b")
+void appendTriangles(std::string&, const std::vector<Triangle_3>&, const VertexIndex&, const std::string& color);
+
 }
 
 #endif
@@ -0,0 +1,367 @@
+#include "File_CPOP_Checkpoint.hh"
+
+#include "CellSettings.hh"
+#include "InformationSystemManager.hh"
+#include "RandomEngineManager.hh"
+#include "Scheduler.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace Settings::nCell;
+
+namespace IO::CPOP {
+
+namespace {
+
+/// \brief first bytes of a checkpoint file
+constexpr char checkpoint_magic[8] = {'C', 'P', 'O', 'P', 'C', 'K', 'P', 'T'};
+/// \brief version of the format, to increment on each change of the layout
+constexpr std::uint32_t checkpoint_version = 1;
+
+/// \brief state of a round nucleus
+struct NucleusRecord {
+	double origin[3];
+	double radius;
+};
+
+/// \brief state of a cell
+struct CellRecord {
+	std::uint64_t id;
+	std::int32_t lifeCycle;
+	double age;
+	double mass;
+	double radius;              ///< \brief negative if not a round cell
+	double position[3];
+	double direction[3];
+	double speed;
+	std::vector<NucleusRecord> nuclei;
+};
+
+/// \brief number of bytes of a nucleus in the file
+constexpr std::size_t nucleus_size = 4*sizeof(double);
+/// \brief minimal number of bytes of a cell in the file, without nucleus
+constexpr std::size_t cell_min_size = sizeof(std::uint64_t) + sizeof(std::int32_t) + 10*sizeof(double) + sizeof(std::uint32_t);
+
+/// \brief append the bytes of trivially copyable values, in the native byte order
+class BinaryWriter {
+public:
+	template<typename T>
+	void put(T const& pValue) {
+		const char* bytes = reinterpret_cast<const char*>(&pValue);
+		_buffer.insert(_buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	void putPoint(Point_3 const& pPoint) {
+		put(pPoint.x());
+		put(pPoint.y());
+		put(pPoint.z());
+	}
+
+	void putVector(Vector_3 const& pVector) {
+		put(pVector.x());
+		put(pVector.y());
+		put(pVector.z());
+	}
+
+	void reserve(std::size_t pSize) { _buffer.reserve(pSize); }
+	[[nodiscard]] std::vector<char> const& buffer() const { return _buffer; }
+
+private:
+	std::vector<char> _buffer;
+};
+
+/// \brief read back the values written by BinaryWriter, fail instead of reading past the end
+class BinaryReader {
+public:
+	explicit BinaryReader(std::vector<char> pBuffer): _buffer(std::move(pBuffer)), _offset(0) {}
+
+	template<typename T>
+	bool get(T& pValue) {
+		if(_buffer.size() - _offset < sizeof(T))
+			return false;
+		std::memcpy(&pValue, _buffer.data() + _offset, sizeof(T));
+		_offset += sizeof(T);
+		return true;
+	}
+
+	bool get(double* pValues, std::size_t pNbValue) {
+		for(std::size_t iValue = 0; iValue < pNbValue; ++iValue) {
+			if(!get(pValues[iValue]))
+				return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] bool atEnd() const { return _offset == _buffer.size(); }
+	/// \brief return true if the bytes left can hold pNbItem items of pItemSize bytes
+	[[nodiscard]] bool canHold(std::uint64_t pNbItem, std::size_t pItemSize) const {
+		return pNbItem <= (_buffer.size() - _offset)/pItemSize;
+	}
+
+private:
+	std::vector<char> _buffer;
+	std::size_t _offset;
+};
+
+void message(std::string const& pMessage) {
+	InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, pMessage, "IO::CPOP::Checkpoint");
+}
+
+/// \brief return the 3D cells of the layer and its sub layers, ordered by ID
+std::vector<t_Cell_3*> getCells(const Layer* pLayer) {
+	std::vector<t_Cell_3*> cells;
+	for(auto* agent : pLayer->getUniqueAgentsAndSubAgents()) {
+		if(auto* cell = dynamic_cast<t_Cell_3*>(agent))
+			cells.push_back(cell);
+	}
+	std::sort(cells.begin(), cells.end(), [](const t_Cell_3* a, const t_Cell_3* b) { return a->getID() < b->getID(); });
+	return cells;
+}
+
+void writeCell(BinaryWriter& pWriter, const t_Cell_3* pCell) {
+	auto const* roundCell = dynamic_cast<const t_RoundCell_3*>(pCell);
+
+	pWriter.put(static_cast<std::uint64_t>(pCell->getID()));
+	pWriter.put(static_cast<std::int32_t>(pCell->getLifeCycle()));
+	pWriter.put(pCell->getAge());
+	pWriter.put(pCell->getMass());
+	pWriter.put(roundCell ? roundCell->getRadius() : -1.);
+	pWriter.putPoint(pCell->getPosition());
+	pWriter.putVector(*pCell->getDirection());
+	pWriter.put(pCell->getSpeed());
+
+	// only round nuclei have a state to store
+	std::vector<const t_RoundNucleus_3*> nuclei;
+	for(auto const* nucleus : pCell->getNuclei()) {
+		if(auto const* roundNucleus = dynamic_cast<const t_RoundNucleus_3*>(nucleus))
+			nuclei.push_back(roundNucleus);
+	}
+	pWriter.put(static_cast<std::uint32_t>(nuclei.size()));
+	for(auto const* nucleus : nuclei) {
+		pWriter.putPoint(nucleus->getOrigin());
+		pWriter.put(nucleus->getRadius());
+	}
+}
+
+bool readCell(BinaryReader& pReader, CellRecord& pRecord) {
+	std::uint32_t nbNucleus;
+	if(!pReader.get(pRecord.id) || !pReader.get(pRecord.lifeCycle) || !pReader.get(pRecord.age) || !pReader.get(pRecord.mass)
+		|| !pReader.get(pRecord.radius) || !pReader.get(pRecord.position, 3) || !pReader.get(pRecord.direction, 3)
+		|| !pReader.get(pRecord.speed) || !pReader.get(nbNucleus) || !pReader.canHold(nbNucleus, nucleus_size))
+		return false;
+
+	pRecord.nuclei.resize(nbNucleus);
+	for(auto& nucleus : pRecord.nuclei) {
+		if(!pReader.get(nucleus.origin, 3) || !pReader.get(nucleus.radius))
+			return false;
+	}
+	return true;
+}
+
+void applyCell(CellRecord const& pRecord, t_Cell_3* pCell) {
+	pCell->setLifeCycle(static_cast<LifeCycles::LifeCycle>(pRecord.lifeCycle));
+	pCell->setAge(pRecord.age);
+	pCell->setMass(pRecord.mass);
+	if(auto* roundCell = dynamic_cast<t_RoundCell_3*>(pCell); roundCell && pRecord.radius >= 0.)
+		roundCell->setRadius(pRecord.radius);
+	pCell->setPosition(Point_3(pRecord.position[0], pRecord.position[1], pRecord.position[2]));
+	pCell->setDirection(Vector_3(pRecord.direction[0], pRecord.direction[1], pRecord.direction[2]));
+	pCell->setSpeed(pRecord.speed);
+	pCell->setIsRequiringNewPos(false);
+
+	std::size_t iNucleus = 0;
+	for(auto* nucleus : pCell->getNuclei()) {
+		auto* roundNucleus = dynamic_cast<t_RoundNucleus_3*>(nucleus);
+		if(!roundNucleus || iNucleus >= pRecord.nuclei.size())
+			continue;
+		NucleusRecord const& record = pRecord.nuclei[iNucleus++];
+		roundNucleus->setOrigin(Point_3(record.origin[0], record.origin[1], record.origin[2]));
+		roundNucleus->setRadius(record.radius);
+	}
+
+	// the mesh was computed for the previous state
+	pCell->resetMesh();
+}
+
+}
+
+/// \details The file starts with the step counter and time of the Scheduler and the state of the
+/// random engine, followed by one record per cell ordered by ID. Values are written in the native byte order.
+/// \param pLayer The layer containing the cells to save
+/// \param pPath The checkpoint file
+/// \return true if the checkpoint has been written
+bool saveCheckpoint(const Layer* pLayer, std::string const& pPath) {
+	assert(pLayer);
+	std::vector<t_Cell_3*> cells = getCells(pLayer);
+
+	BinaryWriter writer;
+	// a cell with a single nucleus takes 128 bytes
+	writer.reserve(128 + 128*cells.size());
+	for(char c : checkpoint_magic)
+		writer.put(c);
+	writer.put(checkpoint_version);
+	writer.put(static_cast<std::uint64_t>(Scheduler::getInstance()->getNbStep()));
+	writer.put(Scheduler::getInstance()->getRunningTime());
+
+	std::vector<unsigned long> engineState;
+	if(auto const* engine = RandomEngineManager::getInstance()->getEngine())
+		engineState = engine->put();
+	writer.put(static_cast<std::uint64_t>(engineState.size()));
+	for(unsigned long word : engineState)
+		writer.put(static_cast<std::uint64_t>(word));
+
+	writer.put(static_cast<std::uint64_t>(cells.size()));
+	for(auto const* cell : cells)
+		writeCell(writer, cell);
+
+	std::ofstream file(pPath, std::ios::binary | std::ios::trunc);
+	if(!file.is_open()) {
+		message("can't save checkpoint - cannot open " + pPath);
+		return false;
+	}
+	file.write(writer.buffer().data(), static_cast<std::streamsize>(writer.buffer().size()));
+	file.close();
+	if(!file) {
+		message("can't save checkpoint - error while writing " + pPath);
+		return false;
+	}
+	return true;
+}
+
+/// \details The checkpoint is fully read and checked before any cell is modified : all the cells stored
+/// must exist in the layer with the same ID. The random engine set in the RandomEngineManager must be of
+/// the type saved. The Scheduler is not modified, use MASPlatform::resumeFrom with the returned info.
+/// \param pLayer The layer containing the cells to restore
+/// \param pPath The checkpoint file
+/// \param pInfo If not null, filled with the step counter and time of the checkpoint
+/// \return true if the checkpoint has been restored
+bool loadCheckpoint(Layer* pLayer, std::string const& pPath, CheckpointInfo* pInfo) {
+	assert(pLayer);
+	std::ifstream file(pPath, std::ios::binary);
+	if(!file.is_open()) {
+		message("can't load checkpoint - cannot open " + pPath);
+		return false;
+	}
+	BinaryReader reader(std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()));
+
+	char magic[sizeof(checkpoint_magic)] = {};
+	std::uint32_t version;
+	for(char& c : magic) {
+		if(!reader.get(c))
+			break;
+	}
+	if(std::memcmp(magic, checkpoint_magic, sizeof(magic)) != 0 || !reader.get(version) || version != checkpoint_version) {
+		message("can't load checkpoint - " + pPath + " is not a checkpoint of this version");
+		return false;
+	}
+
+	CheckpointInfo info;
+	std::uint64_t step;
+	std::uint64_t nbEngineWord;
+	if(!reader.get(step) || !reader.get(info.time) || !reader.get(nbEngineWord) || !reader.canHold(nbEngineWord, sizeof(std::uint64_t))) {
+		message("can't load checkpoint - truncated file " + pPath);
+		return false;
+	}
+	info.step = step;
+
+	std::vector<unsigned long> engineState;
+	engineState.reserve(nbEngineWord);
+	for(std::uint64_t iWord = 0; iWord < nbEngineWord; ++iWord) {
+		std::uint64_t word;
+		if(!reader.get(word)) {
+			message("can't load checkpoint - truncated file " + pPath);
+			return false;
+		}
+		engineState.push_back(static_cast<unsigned long>(word));
+	}
+
+	std::uint64_t nbCell;
+	// the counts are checked against the size of the file before allocating the records
+	if(!reader.get(nbCell) || !reader.canHold(nbCell, cell_min_size)) {
+		message("can't load checkpoint - truncated file " + pPath);
+		return false;
+	}
+	std::vector<CellRecord> records(nbCell);
+	for(auto& record : records) {
+		if(!readCell(reader, record)) {
+			message("can't load checkpoint - truncated file " + pPath);
+			return false;
+		}
+	}
+	if(!reader.atEnd()) {
+		message("can't load checkpoint - unexpected data at the end of " + pPath);
+		return false;
+	}
+	info.nbCell = nbCell;
+
+	// match the records with the cells of the layer
+	std::map<unsigned long int, t_Cell_3*> cellsByID;
+	for(auto* cell : getCells(pLayer))
+		cellsByID[cell->getID()] = cell;
+
+	std::vector<t_Cell_3*> cells;
+	cells.reserve(records.size());
+	for(auto const& record : records) {
+		auto itCell = cellsByID.find(record.id);
+		if(itCell == cellsByID.end()) {
+			message("can't load checkpoint - no cell of ID " + std::to_string(record.id) + " in the layer");
+			return false;
+		}
+		cells.push_back(itCell->second);
+	}
+
+	if(!engineState.empty()) {
+		auto* engine = RandomEngineManager::getInstance()->getEngine();
+		if(!engine || !engine->get(engineState)) {
+			message("can't load checkpoint - the random engine set is not the one saved in " + pPath);
+			return false;
+		}
+	}
+
+	for(std::size_t iCell = 0; iCell < records.size(); ++iCell)
+		applyCell(records[iCell], cells[iCell]);
+
+	if(pInfo)
+		*pInfo = info;
+	return true;
+}
+
+/// \param pLayer The layer to save
+/// \param pPath The checkpoint file
+/// \param pNbStep The number of steps between two checkpoints
+CheckpointAction::CheckpointAction(const Layer* pLayer, std::string pPath, unsigned long int pNbStep):
+	Action(EACH_END_ITERATION),
+	_layer(pLayer),
+	_path(std::move(pPath)),
+	_nbStep(std::max(1ul, pNbStep)),
+	_nbCheckpoint(0)
+{
+	assert(_layer);
+}
+
+/// \return false if the checkpoint can't be written, which stops the simulation
+bool CheckpointAction::exec() {
+	if(Scheduler::getInstance()->getNbStep() % _nbStep != 0)
+		return true;
+
+	std::string tmpPath = _path + ".tmp";
+	if(!saveCheckpoint(_layer, tmpPath))
+		return false;
+	if(std::rename(tmpPath.c_str(), _path.c_str()) != 0) {
+		message("can't save checkpoint - cannot rename " + tmpPath + " to " + _path);
+		return false;
+	}
+	++_nbCheckpoint;
+	return true;
+}
+
+}
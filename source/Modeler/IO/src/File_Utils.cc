@@ -1,11 +1,15 @@
 #include "File_Utils.hh"
 #include "RandomEngineManager.hh"
+#include "ThreadPool.hh"
 
+#include <QFile>
 #include <QStringList>
 #include <QTextStream>
+
+#include <charconv>
+#include <cstdio>
 #include <iostream>
 #include <fstream>
-#include <QFile>
 
 namespace IO {
 
@@ -57,4 +61,43 @@ CGAL::Color getRandomColor() {
 	};
 }
 
+/// \param pOut The string to append to
+/// \param pColor the color to export
+void appendColor(std::string& pOut, CGAL::Color pColor) {
+	pOut += std::to_string(pColor.red());
+	pOut += ' ';
+	pOut += std::to_string(pColor.green());
+	pOut += ' ';
+	pOut += std::to_string(pColor.blue());
+}
+
+/// \details same output as std::ostream::operator<<(double) with the default flags and precision (printf "%g")
+/// \param pOut The string to append to
+/// \param pValue The value to append
+void appendNumber(std::string& pOut, double pValue) {
+	char buffer[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+	auto result = std::to_chars(buffer, buffer + sizeof(buffer), pValue, std::chars_format::general, 6);
+	pOut.append(buffer, result.ptr);
+#else
+	int size = std::snprintf(buffer, sizeof(buffer), "%g", pValue);
+	pOut.append(buffer, static_cast<std::size_t>(size));
+#endif
+}
+
+/// \param pOut The string to append to
+/// \param pPoint The point to append
+void appendPoint(std::string& pOut, const Point_3& pPoint) {
+	appendNumber(pOut, pPoint.x());
+	pOut += ' ';
+	appendNumber(pOut, pPoint.y());
+	pOut += ' ';
+	appendNumber(pOut, pPoint.z());
+}
+
+/// \details the exporters use as many threads as the shared ThreadPool
+unsigned int getNbExportThread() {
+	return ThreadPool::getInstance()->getNbThread();
+}
+
 }
@@ -4,6 +4,7 @@
 #include "CGAL_Utils.hh"
 #include "CellSettings.hh"
 
+#include <algorithm>
 #include <fstream>
 
 #include <CGAL/convex_hull_3.h>
@@ -31,7 +32,7 @@ bool exportFacetToOff(Polyhedron_3::Facet_iterator itFacet, std::ofstream* toExp
 		<< " " << indexes[itFacet->halfedge()->next()->vertex()->point()]
 		<< " " << indexes[itFacet->halfedge()->next()->next()->vertex()->point()]
 		<< " " << color.toStdString()
-		<< std::endl;
+		<< '\n';
 
 	return true;
 }
@@ -45,8 +46,22 @@ bool exportFacetToOff(Polyhedron_3::Facet_iterator itFacet, std::ofstream* toExp
 /// \todo : mesh must be const
 bool exportSpheroidalCellToOff(SpheroidalCell* cell, std::ofstream* toExport, std::map<Point_3, unsigned long int, comparePoint_3>& indexes, std::vector< Polyhedron_3*> nucleusPoly) {
 	// export shape
-	if(!exportPolyhedronToOff(cell->getShape(), toExport, indexes, false, cell->getColor()))
+	if(cell->isMeshFrozen()) {
+		QString color = IO::exportColor(cell->getColor());
+		for(auto const& triangle : cell->getMembraneTriangles()) {
+			for(unsigned int iVertex = 0; iVertex < 3; ++iVertex)
+				indexes.emplace(triangle.vertex(iVertex), indexes.size());
+
+			*toExport << 3
+				<< " " << indexes[triangle.vertex(0)]
+				<< " " << indexes[triangle.vertex(1)]
+				<< " " << indexes[triangle.vertex(2)]
+				<< " " << color.toStdString()
+				<< '\n';
+		}
+	} else if(!exportPolyhedronToOff(cell->getShape(), toExport, indexes, false, cell->getColor())) {
 		return false;
+	}
 
 	// export nuclei
 	/// case know meshes
@@ -92,9 +107,9 @@ bool exportPolyhedronToOff(Polyhedron_3* poly, std::ofstream* toExport, std::map
 std::ofstream* createOffFileWithHeader(std::string pPath) {
 	/// \todo : check pPath exists and end with .off
 	auto* out  = new std::ofstream(pPath);
-	*out << "OFF" << std::endl;
+	*out << "OFF\n";
 	*out << "# cells meshes from cpop";
-	*out << std::endl;
+	*out << '\n';
 	return out;
 }
 
@@ -105,11 +120,11 @@ bool exportVerticesToOff(std::set<Point_3, comparePoint_3>& toExport, std::map<P
 	unsigned long int id = indexes.size();
 	for(const auto & it : toExport) {
 		indexes.insert(std::pair<Point_3, unsigned long int>(it, id));
-		*out << it << std::endl;
+		*out << it << '\n';
 		id++;
 	}
 
-	*out << std::endl;
+	*out << '\n';
 
 	return true;
 }
@@ -121,11 +136,11 @@ bool exportVerticesToOff(std::set<Point_2>& toExport, std::map<Point_2, unsigned
 	unsigned long int id  = indexes.size();
 	for(auto it : toExport) {
 		indexes.insert(std::pair<Point_2, unsigned long int>(it, id));
-		*out << it << " 0.0" <<  std::endl;
+		*out << it << " 0.0" << '\n';
 		id++;
 	}
 
-	*out << std::endl;
+	*out << '\n';
 
 	return true;
 }
@@ -141,10 +156,112 @@ bool exportVertices(std::map<Point_3, unsigned long int, comparePoint_3>& indexe
 
 	// then export
 	for(auto const& itSecondMap : secondMap)
-		*out << itSecondMap.second << std::endl;
-	*out << std::endl;
+		*out << itSecondMap.second << '\n';
+	*out << '\n';
 
 	return true;
 }
 
+void VertexIndex::build() {
+	// a stable sort keeps the first inserted of equal points, as std::set::insert does
+	std::stable_sort(_points.begin(), _points.end(), comparePoint_3());
+	_points.erase(std::unique(_points.begin(), _points.end()), _points.end());
+
+	_indexes.clear();
+	_indexes.reserve(_points.size());
+	for(std::size_t iPoint = 0; iPoint < _points.size(); ++iPoint)
+		_indexes.emplace(_points[iPoint], iPoint);
+}
+
+/// \param pPoints The points to compute the convex hull of
+/// \return the hull, its points are the given ones
+TriangleMesh getConvexHull(const std::vector<Point_3>& pPoints) {
+	TriangleMesh mesh;
+	mesh.points = pPoints;
+
+	Polyhedron_3 hull;
+	CGAL::convex_hull_3(pPoints.begin(), pPoints.end(), hull);
+
+	std::map<Point_3, std::uint32_t, comparePoint_3> localIndexes;
+	for(std::size_t iPoint = 0; iPoint < pPoints.size(); ++iPoint)
+		localIndexes.emplace(pPoints[iPoint], static_cast<std::uint32_t>(iPoint));
+
+	mesh.facets.reserve(hull.size_of_facets());
+	for(auto itFacet = hull.facets_begin(); itFacet != hull.facets_end(); ++itFacet) {
+		mesh.facets.push_back({
+			localIndexes[itFacet->halfedge()->vertex()->point()],
+			localIndexes[itFacet->halfedge()->next()->vertex()->point()],
+			localIndexes[itFacet->halfedge()->next()->next()->vertex()->point()]
+		});
+	}
+	return mesh;
+}
+
+/// \brief append a facet line
+static void appendFacet(std::string& pOut, unsigned long int i1, unsigned long int i2, unsigned long int i3, const std::string& pColor) {
+	pOut += "3 ";
+	pOut += std::to_string(i1);
+	pOut += ' ';
+	pOut += std::to_string(i2);
+	pOut += ' ';
+	pOut += std::to_string(i3);
+	pOut += ' ';
+	pOut += pColor;
+	pOut += '\n';
+}
+
+/// \param pOut The stream to write to
+/// \param pVertices The vertices of the file
+/// \param pNbFacets The number of facets of the file
+void writeHeaderAndVertices(std::ostream& pOut, const VertexIndex& pVertices, unsigned long int pNbFacets) {
+	pOut << "OFF\n# cells meshes from cpop\n";
+	pOut << pVertices.size() << " " << pNbFacets << " 0\n";
+
+	auto const& points = pVertices.points();
+	writeInParallel(pOut, points.size(), [&points](std::size_t iPoint, std::string& pBuffer) {
+		appendPoint(pBuffer, points[iPoint]);
+		pBuffer += '\n';
+	});
+	pOut << '\n';
+}
+
+/// \param pOut The string to append to
+/// \param pPoly The polyhedron to export
+/// \param pVertices The vertices of the file, must contain the polyhedron points
+/// \param pColor The color of the facets
+void appendPolyhedron(std::string& pOut, const Polyhedron_3& pPoly, const VertexIndex& pVertices, const std::string& pColor) {
+	for(auto itFacet = pPoly.facets_begin(); itFacet != pPoly.facets_end(); ++itFacet) {
+		appendFacet(pOut,
+			pVertices.index(itFacet->halfedge()->vertex()->point()),
+			pVertices.index(itFacet->halfedge()->next()->vertex()->point()),
+			pVertices.index(itFacet->halfedge()->next()->next()->vertex()->point()),
+			pColor
+		);
+	}
+}
+
+/// \param pOut The string to append to
+/// \param pTriangles The triangles to export
+/// \param pVertices The vertices of the file, must contain the triangle points
+/// \param pColor The color of the facets
+void appendTriangles(std::string& pOut, const std::vector<Triangle_3>& pTriangles, const VertexIndex& pVertices, const std::string& pColor) {
+	for(auto const& triangle : pTriangles)
+		appendFacet(pOut, pVertices.index(triangle.vertex(0)), pVertices.index(triangle.vertex(1)), pVertices.index(triangle.vertex(2)), pColor);
+}
+
+/// \param pOut The string to append to
+/// \param pMesh The mesh to export
+/// \param pVertices The vertices of the file, must contain the mesh points
+/// \param pColor The color of the facets
+void appendTriangleMesh(std::string& pOut, const TriangleMesh& pMesh, const VertexIndex& pVertices, const std::string& pColor) {
+	for(auto const& facet : pMesh.facets) {
+		appendFacet(pOut,
+			pVertices.index(pMesh.points[facet[0]]),
+			pVertices.index(pMesh.points[facet[1]]),
+			pVertices.index(pMesh.points[facet[2]]),
+			pColor
+		);
+	}
+}
+
 }
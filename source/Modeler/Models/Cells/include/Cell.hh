@@ -60,6 +60,8 @@ public:
 	[[nodiscard]] Dimension getDimension() const override;
 	/// \brief return a random point set on the requested Organelle
 	virtual Point getSpotOnOrganelle(Organelle) const;
+	/// \brief append n random points set on the requested Organelle
+	virtual void getSpotsOnOrganelle(Organelle, std::size_t, std::vector<Point>&) const;
 	/// \brief return a random point on/inside the membrane
 	virtual Point getSpotOnCellMembrane() const = 0;
 	/// \brief return a random point inside the cytoplasm, avoiding membrane and nucleus
@@ -71,7 +73,7 @@ public:
 	/// \brief return true if the point is inside the cell
 	virtual bool hasIn(Point) const = 0;
 	/// \brief nuclei getter
-	[[nodiscard]] std::vector<Nucleus<Kernel, Point, Vector>*> getNuclei() const { return _nuclei; }
+	[[nodiscard]] const std::vector<Nucleus<Kernel, Point, Vector>*>& getNuclei() const { return _nuclei; }
 	/// \brief return true if nuclei radius are coherent
 	[[nodiscard]] virtual bool checkNucleiRadius() const = 0;
 	/// \brief max ratio setter
@@ -94,6 +96,8 @@ public:
 	/// By default : no specifities.
 	/// \warning must be in correlation with the R treatment.
 	[[nodiscard]] std::string addStatsData() const override;
+	/// \brief the values of addStatsData, as numbers
+	[[nodiscard]] std::vector<double> getStatsValues() const override;
 	/// \brief inform about the statistics exported by the meitter
 	[[nodiscard]] std::string writeStatsHeader() const override;
 	/// \brief print cell information (used also to save the cell on a .txt file)
@@ -291,6 +295,16 @@ Point Cell<Kernel, Point, Vector>::getSpotOnOrganelle(Organelle Organelle) const
 	}
 }
 
+/// \param pOrganelle The targetted Organelle
+/// \param pNbSpot The number of spot to generate
+/// \param pSpots The vector to fill
+template<typename Kernel, typename Point, typename Vector>
+void Cell<Kernel, Point, Vector>::getSpotsOnOrganelle(Organelle pOrganelle, std::size_t pNbSpot, std::vector<Point>& pSpots) const {
+	pSpots.reserve(pSpots.size() + pNbSpot);
+	for(std::size_t iSpot = 0; iSpot < pNbSpot; ++iSpot)
+		pSpots.push_back(getSpotOnOrganelle(pOrganelle));
+}
+
 template<typename Kernel, typename Point, typename Vector>
 Dimension Cell<Kernel, Point, Vector>::getDimension() const {
 	return Unknow_D;
@@ -314,6 +328,21 @@ std::string Cell<Kernel, Point, Vector>::addStatsData() const {
 	);
 }
 
+template<typename Kernel, typename Point, typename Vector>
+std::vector<double> Cell<Kernel, Point, Vector>::getStatsValues() const {
+	std::vector<double> values = {
+		static_cast<double>(Agent::getID()),
+		static_cast<double>(_cellProperties->getCellType()),
+		static_cast<double>(_state),
+		static_cast<double>(_mass),
+		static_cast<double>(_age)
+	};
+	Point position = this->getPosition();
+	for(int iDim = 0; iDim < Point::Ambient_dimension::value; ++iDim)
+		values.push_back(static_cast<double>(position[iDim]));
+	return values;
+}
+
 template<typename Kernel, typename Point, typename Vector>
 std::string Cell<Kernel, Point, Vector>::writeStatsHeader() const {
 	return std::string(
@@ -330,8 +359,7 @@ std::string Cell<Kernel, Point, Vector>::writeStatsHeader() const {
 /// \return true if the point is in one of the nucleus
 template<typename Kernel, typename Point, typename Vector>
 bool Cell<Kernel, Point, Vector>::hasInNucleoplasm(Point pt) const {
-	auto const& lNuclei = getNuclei();
- 	for(auto const* nucleus: lNuclei) {
+	for(auto const* nucleus: _nuclei) {
 		if(nucleus->hasIn(pt))
 			return true;
 	}
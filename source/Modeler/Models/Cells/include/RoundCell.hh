@@ -29,6 +29,8 @@ public:
 
 	/// \brief will return cell mesh specificities for R.
 	[[nodiscard]] virtual std::string addStatsData() const;
+	/// \brief the values of addStatsData, as numbers
+	[[nodiscard]] virtual std::vector<double> getStatsValues() const;
 	/// \brief inform about the statistics exported by the meitter
 	[[nodiscard]] virtual std::string writeStatsHeader() const;
 
@@ -80,6 +82,13 @@ std::string RoundCell<Kernel, Point, Vector>::addStatsData() const {
 	return Cell<Kernel, Point, Vector>::addStatsData() + std::string("\t" + std::to_string(getRadius()));
 }
 
+template <typename Kernel, typename Point, typename Vector>
+std::vector<double> RoundCell<Kernel, Point, Vector>::getStatsValues() const {
+	std::vector<double> values = Cell<Kernel, Point, Vector>::getStatsValues();
+	values.push_back(static_cast<double>(getRadius()));
+	return values;
+}
+
 template <typename Kernel, typename Point, typename Vector>
 std::string RoundCell<Kernel, Point, Vector>::writeStatsHeader() const {
 	return Cell<Kernel, Point, Vector>::writeStatsHeader() + "\t" + Settings::Statistics::Cell_Radius_flag;
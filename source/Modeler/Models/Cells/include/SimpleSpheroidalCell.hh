@@ -25,14 +25,10 @@ public:
 	[[nodiscard]] bool checkNucleiRadius() const override { return _nucleus->getRadius() > 0; }
 	/// \brief return the cell description
 	[[nodiscard]] std::string getDescription() const override { return "SimpleSpheroidalCell"; }
-	/// \brief return a random point inside the cytoplasm, avoiding membrane and nucleus
-	// virtual Point_3 getSpotOnCytoplasm() const;
 	/// \brief return the round nucleus
 	[[nodiscard]] RoundNucleus<double, Point_3, Vector_3>* getNucleus() const { return _nucleus; }
-	/// \brief return a random point inside the cytoplasm, avoiding membrane and nucleus
-	[[nodiscard]] Point_3 getSpotOnCytoplasm() const override;
 
-	void exportNucleiToStream(std::ofstream& of) const override;
+	void exportNucleiToStream(std::ostream& of) const override;
 
 protected:
 	/// \brief max rattio getter
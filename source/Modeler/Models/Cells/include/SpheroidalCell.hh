@@ -4,11 +4,17 @@
 #include "RoundCell.hh"
 
 #include "CellSettings.hh"
+#include "ConvexVolumeSampler.hh"
+#include "FrozenConvexMesh.hh"
 #include "Mesh3DSettings.hh"
 #include "MeshOutFormats.hh"
 
 #include <map>
 
+#if defined(WITH_GEANT_4) || defined(WITH_GDML_EXPORT)
+class G4ShapeCache;
+#endif
+
 using namespace Settings::Geometry;
 using namespace Settings::Geometry::Mesh3D;
 using namespace Settings::nCell;
@@ -31,7 +37,14 @@ public:
 	/// \brief iterator to the shape point begin
 	shapePtIt shape_points_end() { return _shape->points_end(); }
 	/// \brief shape getter
+	/// \warning the polyhedron is empty once the mesh is frozen, use the getMembrane... accessors to read the mesh
 	Mesh3D::Polyhedron_3* getShape() { return _shape; }
+	/// \brief return the number of facets of the membrane mesh
+	[[nodiscard]] std::size_t getNbMembraneFacets() const;
+	/// \brief return the vertices of the membrane mesh
+	[[nodiscard]] std::vector<Point_3> getMembranePoints() const;
+	/// \brief return the facets of the membrane mesh
+	[[nodiscard]] std::vector<Triangle_3> getMembraneTriangles() const;
 
 	/// \brief shape facet begin getter
 	shapeFacetIt shape_facets_begin() { return _shape->facets_begin(); }
@@ -41,6 +54,8 @@ public:
 	[[nodiscard]] Point_3 getSpotOnCellMembrane() const override;
 	/// \brief return a random point inside the cytoplasm, avoiding membrane and nucleus
 	[[nodiscard]] Point_3 getSpotOnCytoplasm() const override;
+	/// \brief append n random points set on the requested organelle
+	void getSpotsOnOrganelle(Organelle, std::size_t, std::vector<Point_3>&) const override;
 	/// \brief return a random point on/inside the nucleus
 	[[nodiscard]] Point_3 getSpotOnNuclei() const override;
 	/// \brief return a random point on/inside the nucleus
@@ -57,10 +72,16 @@ public:
 	/// \brief return true if nuclei radius are coherent
 	[[nodiscard]] bool checkNucleiRadius() const override = 0;
 
-	virtual void exportNucleiToStream(std::ofstream&) const = 0;
+	virtual void exportNucleiToStream(std::ostream&) const = 0;
 
 	/// \brief reset the mesh
 	void resetMesh() override;
+	/// \brief replace the membrane polyhedron by its compact read only form
+	void freezeMesh();
+	/// \brief return true if the membrane mesh is frozen
+	[[nodiscard]] bool isMeshFrozen() const { return !_frozenMesh.empty(); }
+	/// \brief return the memory used by the membrane mesh and its sampling structures, in bytes
+	[[nodiscard]] std::size_t getMeshMemoryUsage() const;
 
 	/// \brief return the statistic about the current mesh
 	[[nodiscard]] std::string getMeshStats(MeshOutFormats::outputFormat meshType) const;
@@ -73,9 +94,11 @@ public:
 	/// \brief return the volume occupy by the nuclei meshes
 	[[nodiscard]] double getNucleiMeshesSumVolume(MeshOutFormats::outputFormat meshType) const;
 	/// \brief return the surface represented by the mesh
-	[[nodiscard]] double getMembraneMeshSurfaceArea() const { return _sumMembraneMeshArea; }
+	[[nodiscard]] double getMembraneMeshSurfaceArea() const;
 	/// \brief compute the mesh surface
 	void computeMembraneSurfaceArea();
+	/// \brief compute the tetrahedral decomposition used to pick spots in the cytoplasm
+	void computeVolumeSampler();
 	/// \brief return true if the cell own a mesh
 	[[nodiscard]] bool hasMesh() const override;
 
@@ -86,7 +109,7 @@ public:
 
 #if defined(WITH_GEANT_4) || defined(WITH_GDML_EXPORT)
 	/// \brief convert the membrane shape to a G4 entity
-	virtual G4LogicalVolume* convertMembraneToG4(std::string const&);
+	virtual G4LogicalVolume* convertMembraneToG4(std::string const&, G4ShapeCache* pShapeCache = nullptr);
 	/// \brief convert the cell geometries (including nuclei) to G4 geometries
 	virtual G4PVPlacement* convertToG4Structure(
 		G4LogicalVolume* pMother,
@@ -97,7 +120,8 @@ public:
 		double pDeltaWin,
 		std::map<const G4LogicalVolume*, const t_Cell_3*>* pCellMap = nullptr,
 		std::map<const G4LogicalVolume*, const t_Nucleus_3*>* pNucleiMap = nullptr,
-		bool pExportNuclei = true
+		bool pExportNuclei = true,
+		G4ShapeCache* pShapeCache = nullptr
 	);
 #endif
 
@@ -111,6 +135,14 @@ protected:
 
 	double _sumMembraneMeshArea; ///< \brief the membrane mesh surface ( sum of all facet surfaces )
 
+	/// \brief tetrahedral decomposition of the membrane mesh
+	/// used to obtain uniform spot in the cytoplasm.
+	Utils::Geometry::ConvexVolumeSampler _volumeSampler;
+
+	/// \brief compact copy of the membrane mesh, replacing _shape, areasToFacet and _volumeSampler
+	/// once the mesh is no more modified (cf. freezeMesh).
+	Utils::Geometry::FrozenConvexMesh _frozenMesh;
+
 };
 
 #endif
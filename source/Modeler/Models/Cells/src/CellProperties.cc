@@ -32,7 +32,8 @@ CellProperties::CellProperties(
 	_nucleiMaterials(std::move(pNucleiMaterials)),
 	_deformable(pDeformable)
 {
-	_id = IDManager::getInstance()->getSpecificIDFor(CellProperties_IDMapName);
+	static const IDManager::IDSpace cellPropertiesIDSpace = IDManager::getInstance()->registerIDSpace(CellProperties_IDMapName);
+	_id = IDManager::getInstance()->getID(cellPropertiesIDSpace);
 }
 
 void CellProperties::print() const {
@@ -34,6 +34,10 @@ Point_3 SimpleSpheroidalCell::getNucleusCenter(eNucleusPosType nucleusPositionTy
 		case BARYCENTER:
 		{
 			// The centroid is the barycenter with equal weight for each vertices from the polyhedron
+			if(isMeshFrozen()) {
+				auto const& points = getMembranePoints();
+				return CGAL::centroid(points.begin(), points.end(), CGAL::Dimension_tag<0>());
+			}
 			return CGAL::centroid(_shape->points_begin(), _shape->points_end(), CGAL::Dimension_tag<0>());
 		}
 		case NO_STANDARD:
@@ -87,39 +91,7 @@ void SimpleSpheroidalCell::resetMesh() {
 	/// nothing to do for the nucleus mesh
 }
 
-/// \return The random spot requested on the cytoplasm
-/// \details here we optimize the function because we have only one nucleus and we can speed up this process.
-Point_3 SimpleSpheroidalCell::getSpotOnCytoplasm() const {
-	//G4cout<< "\n\n\n getSpotOnCytoplasm" << G4endl;
-
-	// // pick a point on the membrane, then pick a point on the segment [MembranePoint/cellOrigin] Until we found one not on the nucleus
-	// // because shape is convex we are sure the picked point is on the cytoplsam (work until no other organ are defined)
-	// Point_3 cellMembraneSpot = getSpotOnCellMembrane();
-	// // as we are on a simple cell ( one nucleus, one cytoplasm ) we are sure that the resting space is empty.
-	// // in this case nucleus is a perfect sphere
-	// Point_3 projectedPtOnNucleus = Utils::Geometry::Sphere::getProjectionOnSphere(cellMembraneSpot, getNucleus()->getRadius(), getNucleus()->getOrigin());
-	//
-	// Vector_3 v( cellMembraneSpot - projectedPtOnNucleus);
-	// double x = RandomEngineManager::getInstance()->randd(0., 1.);
-	// Point_3 res = getPosition() + x*(v);
-	//
-	// return res;
-
-
-	Vector_3 v(getSpotOnCellMembrane() - getPosition());
-	double x = RandomEngineManager::getInstance()->randd(0., 1.);
-	Point_3 res = getPosition() + x*(v);
-
-	for(auto const& itNuc : _nuclei) {
-		// if point is on a nucleus, pick an other one
-		if(itNuc->hasIn(res))
-			return getSpotOnCytoplasm();
-	}
-
-	return res;
-}
-
-void SimpleSpheroidalCell::exportNucleiToStream(std::ofstream& of) const {
+void SimpleSpheroidalCell::exportNucleiToStream(std::ostream& of) const {
 	for(auto const* nucleus: _nuclei) {
 		nucleus->write(of);
 		of << '\n';
@@ -28,6 +28,7 @@ namespace fs = std::filesystem;
 	#include "G4PVPlacement.hh"
 	#include "UnitSystemManager.hh"
 	#include "Voronoi3DCellMeshSubThread.hh"
+	#include "G4ShapeCache.hh"
 #ifdef WITH_GEANT_4
 	#include "G4TriangularFacet.hh"
 	#include "G4TessellatedSolid.hh"
@@ -40,6 +41,7 @@ namespace fs = std::filesystem;
 
 static constexpr int maxTry = 7;	// The maximal number of iteration we are ready to made to made to remove overlaps
 static constexpr double stepSizeReductionPercent = 2.;	// at each iteration will reduce the size of cell each of stepSizeReductionPercent
+static constexpr unsigned int maxCytoplasmTry = 1000;	// The maximal number of spot drawn to find one outside nuclei
 
 #include <iostream>
 
@@ -65,6 +67,10 @@ SpheroidalCell::~SpheroidalCell() {
 
 /// \return the cytoplsam volume
 double SpheroidalCell::getCytoplasmVolume() const {
+	// the frozen mesh is convex, its volume is the one of the triangulation of its points
+	if(isMeshFrozen())
+		return _frozenMesh.getVolume();
+
 	/// create an estimable geometry
 	DT_3 triangulation;
 	Polyhedron_3 polyCopy = *_shape;
@@ -84,14 +90,87 @@ double SpheroidalCell::getCytoplasmVolume() const {
 
 void SpheroidalCell::resetMesh() {
 	areasToFacet.clear();
+	_volumeSampler.clear();
+	_frozenMesh.clear();
+	delete _shape;
+	_shape = new Mesh3D::Polyhedron_3;
+}
+
+/// \details the polyhedron, the facet areas and the volume sampler are released, the mesh can then only be
+/// read (hasIn, spots, volume, export...). Refining the cell again rebuilds the polyhedron.
+void SpheroidalCell::freezeMesh() {
+	assert(_shape);
+	if(_shape->empty())
+		return;
+
+	_frozenMesh.build(*_shape, getPosition());
 	delete _shape;
 	_shape = new Mesh3D::Polyhedron_3;
+	areasToFacet.clear();
+	_volumeSampler.clear();
+}
+
+/// \return the memory used by the polyhedron, the facet areas and the volume sampler or by the frozen mesh.
+/// \details the polyhedron memory is estimated from the size of its items, the allocator overhead is ignored.
+std::size_t SpheroidalCell::getMeshMemoryUsage() const {
+	// a red-black tree node holds three pointers and a color besides its value
+	static constexpr std::size_t mapNodeOverhead = 4*sizeof(void*);
+
+	std::size_t memory = _frozenMesh.getMemoryUsage() + _volumeSampler.getMemoryUsage();
+	memory += areasToFacet.size()*(sizeof(std::map<double, Triangle_3>::value_type) + mapNodeOverhead);
+	if(_shape) {
+		memory += sizeof(Mesh3D::Polyhedron_3);
+		memory += _shape->size_of_vertices()*sizeof(Mesh3D::Polyhedron_3::Vertex);
+		memory += _shape->size_of_halfedges()*sizeof(Mesh3D::Polyhedron_3::Halfedge);
+		memory += _shape->size_of_facets()*sizeof(Mesh3D::Polyhedron_3::Facet);
+	}
+	return memory;
+}
+
+/// \return the number of facets of the membrane mesh
+std::size_t SpheroidalCell::getNbMembraneFacets() const {
+	return isMeshFrozen() ? _frozenMesh.getNbFacet() : _shape->size_of_facets();
+}
+
+/// \return the vertices of the membrane mesh, in the polyhedron order
+std::vector<Point_3> SpheroidalCell::getMembranePoints() const {
+	std::vector<Point_3> points;
+	if(isMeshFrozen()) {
+		points.reserve(_frozenMesh.getNbVertex());
+		for(std::size_t iVertex = 0; iVertex < _frozenMesh.getNbVertex(); ++iVertex)
+			points.push_back(_frozenMesh.getVertex(iVertex));
+	} else {
+		points.assign(_shape->points_begin(), _shape->points_end());
+	}
+	return points;
+}
+
+/// \return the facets of the membrane mesh, in the polyhedron order
+std::vector<Triangle_3> SpheroidalCell::getMembraneTriangles() const {
+	std::vector<Triangle_3> triangles;
+	triangles.reserve(getNbMembraneFacets());
+	if(isMeshFrozen()) {
+		for(std::size_t iFacet = 0; iFacet < _frozenMesh.getNbFacet(); ++iFacet)
+			triangles.push_back(_frozenMesh.getTriangle(iFacet));
+	} else {
+		for(auto itFacet = _shape->facets_begin(); itFacet != _shape->facets_end(); ++itFacet) {
+			triangles.emplace_back(
+				itFacet->halfedge()->vertex()->point(),
+				itFacet->halfedge()->next()->vertex()->point(),
+				itFacet->halfedge()->next()->next()->vertex()->point()
+			);
+		}
+	}
+	return triangles;
 }
 
 #include <CGAL/intersections.h>
 
 /// \return A random spot requested on the cytoplasm
 Point_3 SpheroidalCell::getSpotOnCellMembrane() const {
+	if(isMeshFrozen())
+		return _frozenMesh.getSpotOnSurface(RandomEngineManager::getInstance()->getEngine());
+
 	if(_shape->size_of_facets() < 1) {
 		std::string mess = "Unvalid shape, unable to compute a spot on the membrane";
 		InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, mess, "SpheroidalCell");
@@ -142,24 +221,51 @@ Point_3 SpheroidalCell::getSpotOnCellMembrane() const {
 }
 
 /// \return A random spot requested on the cytoplasm
+/// \details the spot is uniformly distributed in the membrane mesh volume. Spots falling in a nucleus are
+/// rejected, at most maxCytoplasmTry times.
 Point_3 SpheroidalCell::getSpotOnCytoplasm() const {
-	// pick a point on the membrane, then pick a point on the segment [MembranePoint/cellOrigin] Until we found one not on the nucleus
-	// because shape is convex we are sure the picked point is on the cytoplasm (work until no other organ are defined)
-
-	Vector_3 v( getSpotOnCellMembrane() - getPosition());
-	double x = RandomEngineManager::getInstance()->randd(0., 1.);
-	Point_3 res = getPosition() + x*(v);
-
-	std::vector<Nucleus<double, Point_3, Vector_3> *>::const_iterator itNuc;
-	for(auto const& itNuc : _nuclei) {
-		// if point is on a nucleus, pick an other one
-		if(itNuc->hasIn(res))
-			return getSpotOnCytoplasm();
+	bool frozen = isMeshFrozen();
+	if(!frozen && _volumeSampler.empty()) {
+		std::string mess = "Unvalid shape, unable to compute a spot on the cytoplasm";
+		InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, mess, "SpheroidalCell");
+		return {0., 0., 0.};
 	}
 
+	auto* engine = RandomEngineManager::getInstance()->getEngine();
+	Point_3 res;
+	for(unsigned int iTry = 0; iTry < maxCytoplasmTry; ++iTry) {
+		res = frozen ? _frozenMesh.getSpot(engine) : _volumeSampler.getSpot(engine);
+		if(!hasInNucleoplasm(res))
+			return res;
+	}
+
+	std::string mess = "unable to find a spot outside nuclei for cell " + std::to_string(getID()) + ", returning a spot in a nucleus";
+	InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, mess, "SpheroidalCell");
 	return res;
 }
 
+/// \param pOrganelle The targetted Organelle
+/// \param pNbSpot The number of spot to generate
+/// \param pSpots The vector to fill
+void SpheroidalCell::getSpotsOnOrganelle(Organelle pOrganelle, std::size_t pNbSpot, std::vector<Point_3>& pSpots) const {
+	bool frozen = isMeshFrozen();
+	if(pOrganelle != _CYTOPLASM || (!frozen && _volumeSampler.empty())) {
+		RoundCell<double, Point_3, Vector_3>::getSpotsOnOrganelle(pOrganelle, pNbSpot, pSpots);
+		return;
+	}
+
+	std::size_t firstSpot = pSpots.size();
+	auto* engine = RandomEngineManager::getInstance()->getEngine();
+	if(frozen)
+		_frozenMesh.getSpots(pNbSpot, pSpots, engine);
+	else
+		_volumeSampler.getSpots(pNbSpot, pSpots, engine);
+	for(std::size_t iSpot = firstSpot; iSpot < pSpots.size(); ++iSpot) {
+		if(hasInNucleoplasm(pSpots[iSpot]))
+			pSpots[iSpot] = getSpotOnCytoplasm();
+	}
+}
+
 /// \return A random spot requested on a nuclei
 Point_3 SpheroidalCell::getSpotOnNuclei() const {
 	if(_nuclei.size() < 1) {
@@ -200,6 +306,9 @@ bool SpheroidalCell::hasIn(Point_3 ptToCheck) const {
 		return false;
 
 	// if is in the mesh
+	if(isMeshFrozen())
+		return _frozenMesh.hasIn(ptToCheck);
+
 	for(auto itFacet = _shape->facets_begin(); itFacet != _shape->facets_end(); ++itFacet) {
 		Plane_3 facetPlane(
 			itFacet->halfedge()->vertex()->point(),
@@ -251,6 +360,8 @@ double SpheroidalCell::getMeshVolume(MeshOutFormats::outputFormat meshFormat) co
 		case MeshOutFormats::GATE:
 		case MeshOutFormats::OFF:
 		{
+			if(isMeshFrozen())
+				return _frozenMesh.getVolume();
 			return Utils::myCGAL::getConvexPolyhedronVolume(_shape, getPosition());
 		}
 		case MeshOutFormats::Unknow:
@@ -265,23 +376,30 @@ double SpheroidalCell::getMeshVolume(MeshOutFormats::outputFormat meshFormat) co
 #if defined(WITH_GEANT_4) || defined(WITH_GDML_EXPORT)
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// \param pName The prefix name to give to the G4entities
-/// \return The G4LogicalVolume* representing the membrane
+/// \param pShapeCache The cache sharing solids between cells, nullptr to create a solid for this cell
+/// \return The G4LogicalVolume* representing the membrane, its solid is defined relatively to the cell origin
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-G4LogicalVolume* SpheroidalCell::convertMembraneToG4(std::string const& pName) {
+G4LogicalVolume* SpheroidalCell::convertMembraneToG4(std::string const& pName, G4ShapeCache* pShapeCache) {
 	auto convertToG4 = G4double(UnitSystemManager::getInstance()->getConversionToG4());
 
-	Polyhedron_3::Vertex_iterator itVertex;
-	// define the tesselated solid
-	auto* membraneSolid = new G4TessellatedSolid(pName);
-	membraneSolid->SetSolidClosed(false);
+	std::vector<G4ShapeCache::Facet> localFacets;
+	std::vector<G4ShapeCache::Facet>& facets = pShapeCache ? pShapeCache->facetBuffer() : localFacets;
+	facets.reserve(getNbMembraneFacets());
 
-	// add all external facets
+	// add all external facets, relative to the cell origin
 	Point_3 p1, p2, p3;
+	auto toG4 = [convertToG4, this](Point_3 const& p) {
+		return G4ThreeVector(
+			G4double(p.x() - getOrigin().x())*convertToG4,
+			G4double(p.y() - getOrigin().y())*convertToG4,
+			G4double(p.z() - getOrigin().z())*convertToG4
+		);
+	};
 	// export facets
-	for(auto itFacet = shape_facets_begin(); itFacet != shape_facets_end(); ++itFacet) {
-		p1 = itFacet->halfedge()->vertex()->point();
-		p2 = itFacet->halfedge()->next()->vertex()->point();
-		p3 = itFacet->halfedge()->next()->next()->vertex()->point();
+	for(auto const& triangle : getMembraneTriangles()) {
+		p1 = triangle.vertex(0);
+		p2 = triangle.vertex(1);
+		p3 = triangle.vertex(2);
 		// we only export external facets
 		assert(p1 != getOrigin());
 		assert(p2 != getOrigin());
@@ -297,45 +415,17 @@ G4LogicalVolume* SpheroidalCell::convertMembraneToG4(std::string const& pName) {
 
 		// check facet orientation
 		double determinant = CGAL::determinant(v1, v2, v3);
-		if(determinant < 0.f) {
-			Point_3 tmp = p1;
-			p1 = p2;
-			p2 = tmp;
-		}
-
-		auto* facet = new G4TriangularFacet(
-			G4ThreeVector(
-				G4double(p1.x())*convertToG4,
-				G4double(p1.y())*convertToG4,
-				G4double(p1.z())*convertToG4
-			),
-			G4ThreeVector(
-				G4double(p2.x())*convertToG4,
-				G4double(p2.y())*convertToG4,
-				G4double(p2.z())*convertToG4
-			),
-			G4ThreeVector(
-				G4double(p3.x())*convertToG4,
-				G4double(p3.y())*convertToG4,
-				G4double(p3.z())*convertToG4
-			),
-			ABSOLUTE
-		);
-
-		assert(facet);
-		assert(static_cast<G4VFacet*>(facet));
+		if(determinant < 0.f)
+			std::swap(p1, p2);
 
-		if(!membraneSolid->AddFacet(static_cast<G4VFacet*>(facet))) {
-			std::cout << "error during facet addition" << std::endl;
-			// return nullptr;
-		}
+		facets.push_back({toG4(p1), toG4(p2), toG4(p3)});
 	}
 
-	// very important command because otherwise, Geant4 will see this entity as boundless
-	membraneSolid->SetSolidClosed(true);
-	assert(membraneSolid);
+	G4TessellatedSolid* membraneSolid = pShapeCache ?
+		pShapeCache->getTessellatedSolid(pName, facets) :
+		G4ShapeCache::createTessellatedSolid(pName, facets);
 
-	if(membraneSolid->GetNumberOfFacets() < 4) {
+	if(!membraneSolid) {
 		std::cout << "error during creation, cannot create a tesselated solid without facets" << std::endl;
 		return nullptr;
 	}
@@ -359,6 +449,7 @@ G4LogicalVolume* SpheroidalCell::convertMembraneToG4(std::string const& pName) {
 /// \param pCellMap			The map containing relashionship between G4LogicalVolume and cell
 /// \param pNucleiMap		The map containing relashionship between G4LogicalVolume and nucleus
 /// \param pExportNuclei true if we want to export nuclei as well to G4
+/// \param pShapeCache		The cache sharing solids between cells, nullptr to create solids for this cell
 /// \return The G4Vplacement* generated for the G4ent
 // TODO : appeler ca convertToG3Entity
 G4PVPlacement* SpheroidalCell::convertToG4Structure(
@@ -370,25 +461,31 @@ G4PVPlacement* SpheroidalCell::convertToG4Structure(
 	double pDeltaWin,
 	std::map<const G4LogicalVolume*, const t_Cell_3*>* pCellMap,
 	std::map<const G4LogicalVolume*, const t_Nucleus_3*>* pNucleiMap,
-	bool pExportNuclei
+	bool pExportNuclei,
+	G4ShapeCache* pShapeCache
 	)
 {
 	assert(pMother);
 	assert(pNeighbourCells);
 
-	G4LogicalVolume* membraneLogicVol = convertMembraneToG4(pName);
+	G4LogicalVolume* membraneLogicVol = convertMembraneToG4(pName, pShapeCache);
+	if(!membraneLogicVol)
+		return nullptr;
+
+	auto convertToG4 = G4double(UnitSystemManager::getInstance()->getConversionToG4());
+	G4ThreeVector cellPosition(getOrigin().x()*convertToG4, getOrigin().y()*convertToG4, getOrigin().z()*convertToG4);
 
 	std::string physVolName = "PV_" + pName;
 	// std::cout << '\n' << " physVolName " << printf(physVolName.toStdString().c_str()) <<'\n';
 
 	auto* vpPalcement = new G4PVPlacement(
-		G4Transform3D(),  // no rotation
-		membraneLogicVol, // its logical volume
-		physVolName,      // its name
-		pMother,          // its mother  volume
-		false,            // no boolean operations
-		0                 // copy number
-		, true
+		G4Translate3D(cellPosition),      // no rotation, the membrane is defined relatively to the cell origin
+		membraneLogicVol,                 // its logical volume
+		physVolName,                      // its name
+		pMother,                          // its mother  volume
+		false,                            // no boolean operations
+		static_cast<G4int>(getID()),      // copy number : the cell ID, read back from the touchable
+		checkOverLaps                     // surface overlaps
 	);
 
 	std::string home_path = std::filesystem::current_path().string();
@@ -421,7 +518,7 @@ G4PVPlacement* SpheroidalCell::convertToG4Structure(
 			cellMeshSub.setSpaceBetweenCell( newStepSize);
 			cellMeshSub.reffineCell( this );
 
-			membraneLogicVol = this->convertMembraneToG4(pName);
+			membraneLogicVol = this->convertMembraneToG4(pName, pShapeCache);
 
 			try {
 				overlap = vpPalcement->CheckOverlaps( 1000, overlapToleranceForG4, false);
@@ -471,10 +568,12 @@ G4PVPlacement* SpheroidalCell::convertToG4Structure(
 
 		for(auto const& itNucleus : _nuclei) {
 			std::string nucleusName = nucleusNamePrefix + pName + std::to_string(iNucleus);
-			iNucleus++;
-			auto* nucPlacement = itNucleus->convertToG4Entity(nucleusName, membraneLogicVol, lNucleusMat, checkOverLaps);
+			auto* nucPlacement = itNucleus->convertToG4Entity(nucleusName, membraneLogicVol, lNucleusMat, checkOverLaps, pShapeCache, cellPosition);
 			// std::cout << "  Masse cell " << membraneLogicVol->GetMass()  <<'\n';
 			assert(nucPlacement);
+			// copy number : the nucleus index in the cell, read back from the touchable
+			nucPlacement->SetCopyNo(static_cast<G4int>(iNucleus));
+			iNucleus++;
 
 			// if we want to register nuclei on a map
 			if(pNucleiMap) {
@@ -506,6 +605,8 @@ G4PVPlacement* SpheroidalCell::convertToG4Structure(
 #endif
 
 void SpheroidalCell::computeMembraneSurfaceArea() {
+	// the polyhedron has been rebuilt, it replaces the frozen mesh
+	_frozenMesh.clear();
 	areasToFacet.clear();
 	// map<double, Polyhedron_3::Facet_const_iterator> areasToFacet;
 
@@ -526,10 +627,20 @@ void SpheroidalCell::computeMembraneSurfaceArea() {
 	}
 }
 
+void SpheroidalCell::computeVolumeSampler() {
+	// the cell origin is inside the convex membrane so the fan of tetrahedra covers the whole cell
+	_volumeSampler.build(_shape, getPosition());
+}
+
+/// \return the membrane mesh surface
+double SpheroidalCell::getMembraneMeshSurfaceArea() const {
+	return isMeshFrozen() ? _frozenMesh.getSurfaceArea() : _sumMembraneMeshArea;
+}
+
 /// \return true if the cell has a mesh
 bool SpheroidalCell::hasMesh() const {
 	assert(_shape);
-	return _shape && !_shape->empty();
+	return isMeshFrozen() || (_shape && !_shape->empty());
 }
 
 /// \param meshFormat the format of the mesh we want volume for
@@ -2,17 +2,63 @@
 #define CELL_SAMPLER_HH
 
 #include "CellSettings.hh"
-#include <set>
+#include "RandomEngineManager.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
 
 /// \brief interface for cell sampling
+/// \details Sampled cells are given by their dense index in the sampled population, sorted in increasing
+/// order : the result only depends on the random engine seed, not on cell addresses.
 /// @author Henri Payno
 template<typename CellType>
 class CellSampler {
 public:
 	virtual ~CellSampler() = default;
 
-	/// \brief function called to sample NCells;
-	virtual std::set<const CellType* > sampleNCells(unsigned int) const = 0;
+	/// \brief function called to sample NCells, return their sorted indices
+	virtual std::vector<std::size_t> sampleNCells(unsigned int) const = 0;
+
+	/// \brief return nbSample distinct indices in [0, nbItem) picked uniformly, sorted in increasing order
+	static std::vector<std::size_t> sampleSortedIndices(std::size_t nbItem, std::size_t nbSample);
 };
 
+/// \details Floyd's algorithm : one random number per sampled index and a bitset over the population,
+/// the bitset is then scanned to give the indices in order.
+/// \param nbItem The size of the population
+/// \param nbSample The number of indices to pick, must be lower or equal to nbItem
+/// \return the sorted indices picked
+template<typename CellType>
+std::vector<std::size_t> CellSampler<CellType>::sampleSortedIndices(std::size_t nbItem, std::size_t nbSample) {
+	assert(nbSample <= nbItem);
+	nbSample = std::min(nbSample, nbItem);
+
+	std::vector<std::size_t> indices;
+	indices.reserve(nbSample);
+	if(nbSample == nbItem) {
+		for(std::size_t iItem = 0; iItem < nbItem; ++iItem)
+			indices.push_back(iItem);
+		return indices;
+	}
+
+	std::vector<bool> picked(nbItem, false);
+	auto* engine = RandomEngineManager::getInstance()->getEngine();
+	for(std::size_t j = nbItem - nbSample; j < nbItem; ++j) {
+		// uniform in [0, j]
+		std::size_t t = std::min(static_cast<std::size_t>(engine->flat()*(j + 1)), j);
+		if(picked[t])
+			picked[j] = true;
+		else
+			picked[t] = true;
+	}
+
+	for(std::size_t iItem = 0; iItem < nbItem; ++iItem) {
+		if(picked[iItem])
+			indices.push_back(iItem);
+	}
+
+	return indices;
+}
+
 #endif
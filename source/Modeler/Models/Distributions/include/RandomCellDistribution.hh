@@ -8,6 +8,9 @@
 #include "RoundNucleus.hh"
 #include "RoundCellProperties.hh"
 
+#include <utility>
+#include <vector>
+
 /// \brief Define a random cell distribution inside a world.
 /// @author Henri Payno
 template <typename Kernel, typename Point, typename Vector>
@@ -19,19 +22,50 @@ public:
 	void distribute(SimulatedSubEnv<Kernel, Point, Vector>*, const CellProperties*, unsigned int, std::map<LifeCycles::LifeCycle, double>);
 	///\brief distribute a simple cell on the environment and set is parameters ( position, life cycle...)
 	void distribute(SimulatedSubEnv<Kernel, Point, Vector>*, Cell<Kernel, Point, Vector>*, std::map<LifeCycles::LifeCycle, double>);
+
+	/// \brief if true, positions are generated first and cells are added in one batch. Off by default
+	void setBulk(bool pBulk) { _bulk = pBulk; }
+	/// \brief return true if cells are distributed in bulk
+	[[nodiscard]] bool isBulk() const { return _bulk; }
+	/// \brief set the minimal distance between two cell centers. Only used in bulk mode for 3D cells, 0 to disable.
+	void setMinimalDistance(double pMinimalDistance) { _minimalDistance = pMinimalDistance; }
+	/// \brief return the minimal distance between two cell centers
+	[[nodiscard]] double getMinimalDistance() const { return _minimalDistance; }
+
+private:
+	/// \brief return the number of cells to create for each life cycle
+	std::vector<std::pair<LifeCycles::LifeCycle, unsigned int>> getNbCellPerLifeCycle(unsigned int, const std::map<LifeCycles::LifeCycle, double>&) const;
+	/// \brief create and add the cells one by one
+	void distributeOneByOne(SimulatedSubEnv<Kernel, Point, Vector>*, const CellProperties*, unsigned int, const std::map<LifeCycles::LifeCycle, double>&);
+	/// \brief generate all the positions, then create the cells and add them in one batch
+	void distributeBulk(SimulatedSubEnv<Kernel, Point, Vector>*, const CellProperties*, unsigned int, const std::map<LifeCycles::LifeCycle, double>&);
+	/// \brief generate the cell centers, respecting the minimal distance if any
+	bool generateSpots(const SpatialDelimitation<Kernel, Point, Vector>*, unsigned int, std::vector<Point>&) const;
+
+	bool _bulk;               ///< \brief true if the cells are distributed in bulk
+	double _minimalDistance;  ///< \brief minimal distance between two cell centers
 };
 
 ///////////////////////////////// FUNCTION DEFINITIONS ////////////////////////////////////////
 #define DEBUG_RANDOM_CELL_DISTRIB 0
 #include <cassert>
+#include <type_traits>
+#include <vector>
 
 #include "CellFactory.hh"
 #include "InformationSystemManager.hh"
 #include "DistributionType.hh"
+#include "GeometrySettings.hh"
+#include "MinimalDistanceGrid.hh"
+
+/// \brief maximal number of candidate positions drawn per cell when a minimal distance is set
+#define RANDOM_CELL_DISTRIB_MAX_ATTEMPTS_PER_CELL 30
 
 template <typename Kernel, typename Point, typename Vector>
 RandomCellDistribution<Kernel, Point, Vector>::RandomCellDistribution():
-	ADistribution<Kernel, Point, Vector>(Distribution::RANDOM)
+	ADistribution<Kernel, Point, Vector>(Distribution::RANDOM),
+	_bulk(false),
+	_minimalDistance(0.)
 {
 }
 
@@ -54,41 +88,148 @@ void RandomCellDistribution<Kernel, Point, Vector>::distribute(
 		InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, mess, "RandomCellDistribution");
 	}
 
-	int nbCellGenerated = 0;
+	if(_bulk)
+		distributeBulk(pSubEnv, pCellProperties, nbCell, pLifeCycles);
+	else
+		distributeOneByOne(pSubEnv, pCellProperties, nbCell, pLifeCycles);
+
+	if(DEBUG_RANDOM_CELL_DISTRIB) {
+		std::string message = "nb cell created : " + std::to_string(pSubEnv->getNbAgent());
+		InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, message, "Random distribution" );
+	}
+}
+
+/// \param nbCell The number of cell to distribute
+/// \param pLifeCycles the rates of each life cycle
+/// \return the number of cells of each life cycle, the last life cycle gets the remaining cells
+template <typename Kernel, typename Point, typename Vector>
+std::vector<std::pair<LifeCycles::LifeCycle, unsigned int>> RandomCellDistribution<Kernel, Point, Vector>::getNbCellPerLifeCycle(
+	unsigned int nbCell,
+	const std::map<LifeCycles::LifeCycle, double>& pLifeCycles) const
+{
+	std::vector<std::pair<LifeCycles::LifeCycle, unsigned int>> nbCellPerLifeCycle;
+	nbCellPerLifeCycle.reserve(pLifeCycles.size());
 
+	unsigned int nbCellAssigned = 0;
 	auto lastState = pLifeCycles.end();
 	lastState --;
 	for(auto itLSR = pLifeCycles.begin(); itLSR != pLifeCycles.end(); ++itLSR) {
 		int nbPopCellToStateN;
 		/// make sure we have the right number and no conversion approximation
 		if(itLSR == lastState) {
-			nbPopCellToStateN = nbCell - nbCellGenerated;
+			nbPopCellToStateN = nbCell - nbCellAssigned;
 		} else {
 			nbPopCellToStateN = itLSR->second * nbCell;
 		}
 
-		int lLocalGenerated = 0;
-		while(lLocalGenerated < nbPopCellToStateN) {
-			auto* newCell = CellFactory::getInstance()->produce<Kernel, Point, Vector>(pCellProperties, itLSR->first);
+		nbPopCellToStateN = std::max(nbPopCellToStateN, 0);
+		nbCellPerLifeCycle.emplace_back(itLSR->first, nbPopCellToStateN);
+		nbCellAssigned += nbPopCellToStateN;
+	}
+
+	return nbCellPerLifeCycle;
+}
+
+/// \param pSubEnv The world layer to insert the cells
+/// \param pCellProperties the properties to set to cells
+/// \param nbCell The number of cell we want to add to the subEnvironment
+/// \param pLifeCycles the rates of each life cycle to add to the sub environment
+template <typename Kernel, typename Point, typename Vector>
+void RandomCellDistribution<Kernel, Point, Vector>::distributeOneByOne(
+	SimulatedSubEnv<Kernel, Point, Vector>* pSubEnv,
+	const CellProperties* pCellProperties,
+	unsigned int nbCell,
+	const std::map<LifeCycles::LifeCycle, double>& pLifeCycles)
+{
+	for(auto const& [lifeCycle, nbPopCellToStateN] : getNbCellPerLifeCycle(nbCell, pLifeCycles)) {
+		for(unsigned int iCell = 0; iCell < nbPopCellToStateN; ++iCell) {
+			auto* newCell = CellFactory::getInstance()->produce<Kernel, Point, Vector>(pCellProperties, lifeCycle);
 
 			/// define the spot / position
 			Point spot = pSubEnv->getSpatialDelimitation()->getSpot(Distribution::RANDOM);
 			/// set position and orientation randomly
 			newCell->setPosition(spot);
 			/// \todo : set LifeCycle according to a specifique distribution...
-			newCell->setLifeCycle(itLSR->first);
+			newCell->setLifeCycle(lifeCycle);
 			pSubEnv->addAgent(newCell);
-
-			lLocalGenerated++;
 		}
+	}
+}
 
-		nbCellGenerated +=lLocalGenerated;
+/// \details The positions are all drawn first, so the spatial delimitation can generate them in batch
+/// and a minimal distance can be enforced with a uniform grid. The cells are then produced with their
+/// life cycle and nuclei in a second pass and added to the sub environment in one insertion.
+/// Without minimal distance the positions are independent and uniform as in the one by one mode.
+/// If the minimal distance prevents placing all the cells, the cells placed keep the life cycle rates.
+/// \param pSubEnv The world layer to insert the cells
+/// \param pCellProperties the properties to set to cells
+/// \param nbCell The number of cell we want to add to the subEnvironment
+/// \param pLifeCycles the rates of each life cycle to add to the sub environment
+template <typename Kernel, typename Point, typename Vector>
+void RandomCellDistribution<Kernel, Point, Vector>::distributeBulk(
+	SimulatedSubEnv<Kernel, Point, Vector>* pSubEnv,
+	const CellProperties* pCellProperties,
+	unsigned int nbCell,
+	const std::map<LifeCycles::LifeCycle, double>& pLifeCycles)
+{
+	std::vector<Point> spots;
+	if(!generateSpots(pSubEnv->getSpatialDelimitation(), nbCell, spots)) {
+		InformationSystemManager::getInstance()->LazyMessage(InformationSystemManager::CANT_PROCESS_MES, "RandomCellDistribution",
+			"unable to place ", nbCell, " cells with a minimal distance of ", _minimalDistance, ", only ", spots.size(), " cells placed");
 	}
 
-	if(DEBUG_RANDOM_CELL_DISTRIB) {
-		std::string message = "nb cell created : " + std::to_string(nbCellGenerated);
-		InformationSystemManager::getInstance()->Message(InformationSystemManager::DEBUG_MES, message, "Random distribution" );
+	std::vector<Cell<Kernel, Point, Vector>*> newCells;
+	newCells.reserve(spots.size());
+	auto itSpot = spots.begin();
+	for(auto const& [lifeCycle, nbPopCellToStateN] : getNbCellPerLifeCycle(static_cast<unsigned int>(spots.size()), pLifeCycles)) {
+		for(unsigned int iCell = 0; iCell < nbPopCellToStateN && itSpot != spots.end(); ++iCell, ++itSpot) {
+			auto* newCell = CellFactory::getInstance()->produce<Kernel, Point, Vector>(pCellProperties, lifeCycle);
+			newCell->setPosition(*itSpot);
+			newCell->setLifeCycle(lifeCycle);
+			newCells.push_back(newCell);
+		}
 	}
+
+	pSubEnv->addAgents(newCells.begin(), newCells.end());
+}
+
+/// \param pDelimitation The spatial delimitation to draw the positions from
+/// \param nbCell The number of positions to generate
+/// \param spots The vector filled with the positions
+/// \return false if the minimal distance prevented to place all the positions
+template <typename Kernel, typename Point, typename Vector>
+bool RandomCellDistribution<Kernel, Point, Vector>::generateSpots(
+	const SpatialDelimitation<Kernel, Point, Vector>* pDelimitation,
+	unsigned int nbCell,
+	std::vector<Point>& spots) const
+{
+	assert(pDelimitation);
+
+	if constexpr(std::is_same_v<Point, Settings::Geometry::Point_3>) {
+		if(_minimalDistance > 0.) {
+			Utils::Geometry::MinimalDistanceGrid grid(pDelimitation->getBoundingBox(), _minimalDistance, nbCell);
+
+			std::vector<Point> candidates;
+			std::size_t nbAttempt = 0;
+			const std::size_t maxNbAttempt = static_cast<std::size_t>(RANDOM_CELL_DISTRIB_MAX_ATTEMPTS_PER_CELL) * nbCell;
+			while(grid.size() < nbCell && nbAttempt < maxNbAttempt) {
+				// draw as many candidates as missing cells, rejected ones are drawn again in the next round
+				std::size_t nbCandidate = std::min<std::size_t>(nbCell - grid.size(), maxNbAttempt - nbAttempt);
+				candidates.clear();
+				pDelimitation->getSpots(Distribution::RANDOM, nbCandidate, candidates);
+				nbAttempt += nbCandidate;
+
+				for(auto const& candidate : candidates)
+					grid.tryInsert(candidate);
+			}
+
+			spots = grid.points();
+			return spots.size() == nbCell;
+		}
+	}
+
+	pDelimitation->getSpots(Distribution::RANDOM, nbCell, spots);
+	return true;
 }
 
 /// \param pSubEnv The sub environment ( world layer ) where to insert the cells
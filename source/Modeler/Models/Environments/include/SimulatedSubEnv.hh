@@ -159,8 +159,7 @@ void SimulatedSubEnv<Kernel, Point, Vector>::write(QXmlStreamWriter& writer) con
 	/// write Cell ID contained here
 	{
 		writer.writeStartElement(contained_agent_flag);
-		std::set<Agent*> lAgents = Layer::getAgents();
-		for(auto const& lAgent : lAgents)
+		for(auto const* lAgent : Layer::getAgents())
 			writer.writeTextElement(agent_ID_flag, QString::number(lAgent->getID()));
 		writer.writeEndElement(); // "contained_agent"
 	}
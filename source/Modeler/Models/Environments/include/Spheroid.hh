@@ -4,6 +4,7 @@
 #include "CellPopulation.hh"
 #include "CellSettings.hh"
 #include "CGAL_Utils.hh"
+#include "Delaunay_3D_SDS.hh"
 #include "DistributionFactory.hh"
 #include "EngineSettings.hh"
 #include "EnvironmentSettings.hh"
@@ -17,9 +18,6 @@
 #include "SimpleSpheroidalCell.hh"
 #include "Writable.hh"
 
-#include "OctreeSDS.hh"
-#include "OctreeNodeSDSForSpheroidalCell.hh"
-
 #include <iostream>
 #include <fstream>
 #include <utility>
@@ -58,7 +56,11 @@ public:
 	[[nodiscard]] BoundingBox<Point_3> getBoundingBox() const override;
 
 	/// \brief export stats of the spheroid meshes to a R readeable format.
-	[[nodiscard]] virtual bool exportMeshStats(QString name) const;
+	[[nodiscard]] virtual bool exportMeshStats(
+		QString name,
+		unsigned int pMetrics = Statistics::DEFAULT_METRICS,
+		Statistics::StatsFileFormat pFileFormat = Statistics::TEXT
+	) const;
 
 	/// \brief  export all information needed to sumarize the Writable
 	void write(QXmlStreamWriter&) const override;
@@ -153,7 +155,7 @@ Spheroid<Cell_type>::Spheroid(t_Environment_3* pEnv, t_SimulatedSubEnv_3* pSpher
 
 	// set cells composing the cell population
 	std::set<t_Cell_3*> lNewCells;
-	std::set<Agent*> lAgts = static_cast<Layer*>(pSpheroidSubEnv)->getAgents();
+	auto const& lAgts = static_cast<Layer*>(pSpheroidSubEnv)->getAgents();
 	for(auto const& lAgt : lAgts) {
 		if(dynamic_cast<t_Cell_3*>(lAgt))
 			lNewCells.insert(dynamic_cast<t_Cell_3*>(lAgt));
@@ -217,7 +219,7 @@ bool Spheroid<Cell_type>::distribute() {
 	delete distribution;
 
 	// insert all new cells distributed to the CellPopulation
-	std::set<Agent*> agents = static_cast<Layer*>(_spheroidSubEnvironment)->getAgents();
+	auto const& agents = static_cast<Layer*>(_spheroidSubEnvironment)->getAgents();
 	std::set<t_Cell_3*> lCells;
 	for(auto const& agent : agents)
 	{
@@ -294,24 +296,28 @@ template<>
 BoundingBox<Point_3> Spheroid<SimpleSpheroidalCell>::getBoundingBox() const;
 
 /// \param pName the common name of files to export statistics
+/// \param pMetrics the metrics to export (Statistics::MeshMetric flags)
+/// \param pFileFormat the layout of the statistic files
 /// \return true if succeded
 template <typename Cell_type>
-bool Spheroid<Cell_type>::exportMeshStats(QString pName) const {
+bool Spheroid<Cell_type>::exportMeshStats(QString pName, unsigned int pMetrics, Statistics::StatsFileFormat pFileFormat) const {
 	// todo : get only cells with a mesh
 	std::set<t_Cell_3*> lTmpCells = CellPopulation<double, Point_3, Vector_3>::getCells();
 	std::vector<const t_Cell_3*> lCells(lTmpCells.begin(), lTmpCells.end());
 	// create stats files
-	QString nucleiPathName = "Nuclei_" + pName + ".cpop.stats";
-	QString cellPathName = "Cell_" + pName + ".cpop.stats";
+	std::string extension = Statistics::getStatsFileExtension(pFileFormat);
+	std::ios_base::openmode mode = pFileFormat == Statistics::BINARY ? std::ios::out | std::ios::binary : std::ios::out;
+	std::ofstream nucleiOut(("Nuclei_" + pName).toStdString() + extension, mode);
+	std::ofstream cellOut(("Cell_" + pName).toStdString() + extension, mode);
 
-	Statistics::generateMeshStats(
+	return Statistics::generateMeshStats(
 		lCells,
 		MeshOutFormats::GEANT_4,
-		new std::ofstream(cellPathName.toStdString().c_str()),
-		new std::ofstream(nucleiPathName.toStdString().c_str())
+		&cellOut,
+		&nucleiOut,
+		pMetrics,
+		pFileFormat
 	);
-
-	return true;
 }
 
 /// \param pWriter QXmlStreamWriter to adress information
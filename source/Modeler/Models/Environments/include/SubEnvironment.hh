@@ -27,8 +27,8 @@ public:
 
 	/// \brief the parent getter, return the environement he is part of.
 	Environment<Kernel, Point, Vector>* getParent() const	{ return parent;};
-	/// \brief return the list of agent contained on the sub environment
-	[[nodiscard]] virtual std::set<Agent*> getAgents(GET_AGENT_OPTIONS o = WITHOUT_DELIMITATION) const;
+	/// \brief return a view on the agents contained on the sub environment
+	[[nodiscard]] virtual AgentRange getAgents(GET_AGENT_OPTIONS o = WITHOUT_DELIMITATION) const;
 	/// \brief draw the sub environement
 	virtual void draw() const;
 	/// \brief  export all information needed to sumarize the Writable
@@ -36,6 +36,10 @@ public:
 
 protected:
 	Environment<Kernel, Point, Vector>* parent; ///< \brief the environment he si part of.
+
+private:
+	/// \brief return true if the agent is not an active delimitation
+	static bool isNotDelimitation(const Agent* pAgent) { return !dynamic_cast<const ActiveDelimitation<Kernel, Point, Vector>*>(pAgent); }
 };
 
 //////////////////////// FUNCTION DEFINITION ////////////////
@@ -55,23 +59,14 @@ void SubEnvironment<Kernel, Point, Vector>::draw() const {
 }
 
 /// \param option which kind of Agent we want to get
+/// \return a view on the agents of the sub environment, valid as long as no agent is added or removed
 template<typename Kernel, typename Point, typename Vector>
-std::set<Agent*> SubEnvironment<Kernel, Point, Vector>::getAgents(GET_AGENT_OPTIONS option) const {
+AgentRange SubEnvironment<Kernel, Point, Vector>::getAgents(GET_AGENT_OPTIONS option) const {
 	switch(option) {
 		case WITH_DELIMITATION:
-		{
-			return Layer::getAgents();
-		}
+			return AgentRange({&Layer::_agents});
 		case WITHOUT_DELIMITATION:
-		{
-			std::set<Agent*> agentLessDelimitations;
-			for(auto itAgt = Layer::_agents.begin(); itAgt != Layer::_agents.end(); ++itAgt) {
-				assert(*itAgt);
-				if(!dynamic_cast<ActiveDelimitation<Kernel, Point, Vector>*>(*itAgt))
-					agentLessDelimitations.insert(*itAgt);
-			}
-			return agentLessDelimitations;
-		}
+			return AgentRange({&Layer::_agents}, &isNotDelimitation);
 		default:
 			return {};
 	}
@@ -11,6 +11,9 @@ static double default_ratio_to_stable_case = 0.75;
 
 #include <CGAL/centroid.h>
 
+#include <algorithm>
+#include <vector>
+
 /// \brief define an elastic force.
 /// @author Henri Payno
 template<typename Kernel, typename Point, typename Vector>
@@ -60,11 +63,14 @@ Kernel  ElasticForce<Kernel, Point, Vector>::getOptimalLength(const SpatialableA
 
 template<typename Kernel, typename Point, typename Vector>
 inline Vector ElasticForce<Kernel, Point, Vector>::computeForce() const {
-	std::set<const SpatialableAgent< Kernel,  Point,  Vector>* > agentToConsider = Force<Kernel, Point, Vector>::getConcernedAgent();
+	std::set<const SpatialableAgent< Kernel,  Point,  Vector>* > concernedAgent = Force<Kernel, Point, Vector>::getConcernedAgent();
+	// sum the contributions by neighbour ID : the set order depends on the agents addresses
+	std::vector<const SpatialableAgent< Kernel,  Point,  Vector>* > agentToConsider(concernedAgent.begin(), concernedAgent.end());
+	std::sort(agentToConsider.begin(), agentToConsider.end(), [](const auto* a, const auto* b) { return a->getID() < b->getID(); });
 
 	Point cellOrigin = Force< Kernel,  Point,  Vector>::_cell->getPosition();
 	// get neighbours from the SDSManager.
-	typename std::set<const SpatialableAgent< Kernel,  Point,  Vector>* >::const_iterator itNeighbour;
+	typename std::vector<const SpatialableAgent< Kernel,  Point,  Vector>* >::const_iterator itNeighbour;
 	Vector force;
 	
 	for(itNeighbour = agentToConsider.begin(); itNeighbour != agentToConsider.end(); ++itNeighbour) {
@@ -11,6 +11,8 @@
 #ifdef CONVERT_TO_G4
 	#include "G4PVPlacement.hh"
 	#include "G4Material.hh"
+
+	class G4ShapeCache;
 #endif
 
 #include "ENucleusPosType.hh"
@@ -45,6 +47,8 @@ public:
 	/// By default : no specifities.
 	/// \warning must be in correlation with the R treatment.
 	[[nodiscard]] std::string addStatsData() const override = 0;
+	/// \brief the values of addStatsData, as numbers
+	[[nodiscard]] std::vector<double> getStatsValues() const override = 0;
 	/// \brief inform about the statistics exported by the meitter
 	[[nodiscard]] std::string writeStatsHeader() const override = 0;
 	/// \todo : write nucleus shape
@@ -53,7 +57,7 @@ public:
 	/// \brief print cell information (used also to save the cell on a .txt file)
 	virtual void writeAttributes(QXmlStreamWriter&) const = 0;
 
-	virtual void write(std::ofstream&) const = 0;
+	virtual void write(std::ostream&) const = 0;
 
 	/// \brief pos type setter
 	void setPositionType(eNucleusPosType pType)	{ _posType = pType; }
@@ -63,10 +67,11 @@ public:
 	virtual bool hasIn(Point) const = 0;
 
 #ifdef CONVERT_TO_G4
+	/// \brief return the G4 entity corresponding, placed relatively to the mother position
+	virtual G4PVPlacement* convertToG4Entity(std::string const& name, G4LogicalVolume* motherVolume, G4Material* pNucleusMat, bool pCheckOverlapse = false,
+		G4ShapeCache* pShapeCache = nullptr, G4ThreeVector const& pMotherPosition = G4ThreeVector()) const = 0;
 	/// \brief return the G4 entity corresponding
-	virtual G4PVPlacement* convertToG4Entity(std::string const& name, G4LogicalVolume* motherVolume, G4Material* pNucleusMat, bool pCheckOverlapse = false) const = 0;
-	/// \brief return the G4 entity corresponding
-	virtual G4LogicalVolume* convertToG4LogicalVolume(std::string const& name, G4Material* pNucleusMat) const = 0;
+	virtual G4LogicalVolume* convertToG4LogicalVolume(std::string const& name, G4Material* pNucleusMat, G4ShapeCache* pShapeCache = nullptr) const = 0;
 #endif
 
 private:
@@ -49,12 +49,14 @@ public:
 	[[nodiscard]] Kernel getMeshVolume(MeshOutFormats::outputFormat meshType) const override;
 	/// \warning must be in correlation with the R treatment.
 	[[nodiscard]] std::string addStatsData() const override;
+	/// \brief the values of addStatsData, as numbers
+	[[nodiscard]] std::vector<double> getStatsValues() const override;
 	/// \brief inform about the statistics exported by the meitter
 	[[nodiscard]] std::string writeStatsHeader() const override;
 	/// \brief print cell information (used also to save the cell on a .txt file)
 	void writeAttributes(QXmlStreamWriter&) const override;
 
-	void write(std::ofstream& of) const override {
+	void write(std::ostream& of) const override {
 		of << _origin << " " << _radius;
 	}
 
@@ -63,9 +65,10 @@ public:
 
 #ifdef CONVERT_TO_G4
 	/// \brief return the G4 entity corresponding
-	G4PVPlacement* convertToG4Entity(std::string const& name, G4LogicalVolume* motherVolume, G4Material* pNucleusMat, bool pCheckOverlapse = false) const override;
+	G4PVPlacement* convertToG4Entity(std::string const& name, G4LogicalVolume* motherVolume, G4Material* pNucleusMat, bool pCheckOverlapse = false,
+		G4ShapeCache* pShapeCache = nullptr, G4ThreeVector const& pMotherPosition = G4ThreeVector()) const override;
 	/// \brief return the G4 entity corresponding
-	G4LogicalVolume* convertToG4LogicalVolume(std::string const& name, G4Material* pNucleusMat) const override;
+	G4LogicalVolume* convertToG4LogicalVolume(std::string const& name, G4Material* pNucleusMat, G4ShapeCache* pShapeCache = nullptr) const override;
 #endif
 
 private:
@@ -92,25 +95,25 @@ RoundNucleus<Kernel, Point, Vector>::RoundNucleus(double pRadius, Point pOrigin,
 /// \param motherVolume The mother volume is any
 /// \param pNucleusMat The material to set on the nucleus
 template <typename Kernel, typename Point, typename Vector>
-G4PVPlacement* RoundNucleus<Kernel, Point, Vector>::convertToG4Entity(std::string const&, G4LogicalVolume*, G4Material*, bool) const {
+G4PVPlacement* RoundNucleus<Kernel, Point, Vector>::convertToG4Entity(std::string const&, G4LogicalVolume*, G4Material*, bool, G4ShapeCache*, G4ThreeVector const&) const {
 	InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "convertor not created for this kind of template manager", "RoundNucleus");
 	return nullptr;
 }
 
 template<>
-G4PVPlacement* RoundNucleus<double, Point_3, Vector_3>::convertToG4Entity(std::string const& name, G4LogicalVolume* motherVolume, G4Material* pNucleusMat, bool) const;
+G4PVPlacement* RoundNucleus<double, Point_3, Vector_3>::convertToG4Entity(std::string const& name, G4LogicalVolume* motherVolume, G4Material* pNucleusMat, bool, G4ShapeCache*, G4ThreeVector const&) const;
 
 /// \param name The name to give to the G4 entities
 /// \param motherVolume The mother volume is any
 /// \param pNucleusMat The material to set on the nucleus
 template <typename Kernel, typename Point, typename Vector>
-G4LogicalVolume* RoundNucleus<Kernel, Point, Vector>::convertToG4LogicalVolume(std::string const&, G4Material*) const {
+G4LogicalVolume* RoundNucleus<Kernel, Point, Vector>::convertToG4LogicalVolume(std::string const&, G4Material*, G4ShapeCache*) const {
 	InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, "convertor not created for this kind of template manager", "RoundNucleus");
 	return nullptr;
 }
 
 template<>
-G4LogicalVolume* RoundNucleus<double, Point_3, Vector_3>::convertToG4LogicalVolume(std::string const& name, G4Material* pNucleusMat) const;
+G4LogicalVolume* RoundNucleus<double, Point_3, Vector_3>::convertToG4LogicalVolume(std::string const& name, G4Material* pNucleusMat, G4ShapeCache*) const;
 /// \endcond
 
 #endif
@@ -179,6 +182,13 @@ std::string RoundNucleus<Kernel, Point, Vector>::addStatsData() const {
 	return std::to_string(getRadius());
 }
 
+////////////////////////////////////////////////////// getStatsValues ///////////////////////////////////////////////////:
+/// \return the stats to add to the file, as numbers
+template <typename Kernel, typename Point, typename Vector>
+std::vector<double> RoundNucleus<Kernel, Point, Vector>::getStatsValues() const {
+	return {static_cast<double>(getRadius())};
+}
+
 ////////////////////////////////////////////////////// writeStatsHeader ///////////////////////////////////////////////////:
 /// \return the stats to add to the file
 template <typename Kernel, typename Point, typename Vector>
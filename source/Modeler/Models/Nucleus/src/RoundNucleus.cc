@@ -6,6 +6,10 @@
 #include "Geometry_Utils_Sphere.hh"
 #include "UnitSystemManager.hh"
 
+#ifdef CONVERT_TO_G4
+	#include "G4ShapeCache.hh"
+#endif
+
 #include <CGAL/convex_hull_3.h>
 
 #if ( defined(WIN32) || defined(WIN64) || defined(_WIN32) || defined(_WIN64) )
@@ -18,15 +22,17 @@
 /// \param name 			The name to set to the nucleus
 /// \param motherVolume 	The mother volume, NULL if none
 /// \param pNucleusMat 		The material to set to the nucleus
-/// \param checkOverLaps 	The material to set to the nucleus
+/// \param checkOverLaps 	true if we want to check geometry overlap by the G4 process
+/// \param pShapeCache 		The cache sharing solids between nuclei, nullptr to create a solid for this nucleus
+/// \param pMotherPosition 	The position of the mother volume origin in G4 unit
 template<>
-G4PVPlacement* RoundNucleus<double, Point_3, Vector_3>::convertToG4Entity(std::string const& name, G4LogicalVolume* motherVolume, G4Material* pNucleusMat, bool checkOverLaps) const {
+G4PVPlacement* RoundNucleus<double, Point_3, Vector_3>::convertToG4Entity(std::string const& name, G4LogicalVolume* motherVolume, G4Material* pNucleusMat, bool checkOverLaps, G4ShapeCache* pShapeCache, G4ThreeVector const& pMotherPosition) const {
 	auto convertToG4 = G4double(UnitSystemManager::getInstance()->getConversionToG4());
-	G4LogicalVolume* logicVol = convertToG4LogicalVolume(name, pNucleusMat);
+	G4LogicalVolume* logicVol = convertToG4LogicalVolume(name, pNucleusMat, pShapeCache);
 
 	std::string physVolName = "PV_" + name;
 	auto* physVol = new G4PVPlacement(
-		G4Translate3D(_origin.x()*convertToG4, _origin.y()*convertToG4, _origin.z()*convertToG4),	// no rotation
+		G4Translate3D(G4ThreeVector(_origin.x()*convertToG4, _origin.y()*convertToG4, _origin.z()*convertToG4) - pMotherPosition),	// no rotation
 		logicVol,                                                                                 // its logical volume
 		physVolName,                                                                              // its name
 		(motherVolume == nullptr ) ? nullptr : motherVolume,                                      // its mother  volume
@@ -40,13 +46,15 @@ G4PVPlacement* RoundNucleus<double, Point_3, Vector_3>::convertToG4Entity(std::s
 
 /// \param name 			The name to set to the nucleus
 /// \param pNucleusMat 		The material to set to the nucleus
-/// \param checkOverLaps 	The material to set to the nucleus
+/// \param pShapeCache 		The cache sharing solids between nuclei, nullptr to create a solid for this nucleus
 template<>
-G4LogicalVolume* RoundNucleus<double, Point_3, Vector_3>::convertToG4LogicalVolume(std::string const& name, G4Material* pNucleusMat) const {
+G4LogicalVolume* RoundNucleus<double, Point_3, Vector_3>::convertToG4LogicalVolume(std::string const& name, G4Material* pNucleusMat, G4ShapeCache* pShapeCache) const {
 	assert(pNucleusMat);
 
 	auto convertToG4 = G4double(UnitSystemManager::getInstance()->getConversionToG4());
-	auto* nucleusSolid = new G4Orb(name, getRadius()*convertToG4);
+	G4VSolid* nucleusSolid = pShapeCache ?
+		static_cast<G4VSolid*>(pShapeCache->getOrb(name, getRadius()*convertToG4)) :
+		static_cast<G4VSolid*>(new G4Orb(name, getRadius()*convertToG4));
 
 	assert(nucleusSolid);
 
@@ -14,6 +14,7 @@
 
 namespace cpop {
 
+class Population;
 class StepMax;
 class PhysicsListMessenger;
 
@@ -32,6 +33,9 @@ public:
 
 	StepMax *step_max_process();
 
+	/// \brief Set the population used by the step limits set per region or per organelle
+	void SetPopulation(const Population& population);
+
 	void SetElectronCut(G4double);
 
 	G4double fElectronCut;
@@ -43,6 +47,7 @@ private:
 	std::unique_ptr<G4VPhysicsConstructor> _physicsList;
 	G4String _name;
 	StepMax* _stepMaxProcess = nullptr; //Not sure whether G4 owns it or not
+	const Population* _population = nullptr;
 
 	G4VPhysicsConstructor* _decayList;
 
@@ -23,6 +23,12 @@ private:
 	/// \brief Select a eletromagnetic physics list
 	std::unique_ptr<G4UIcmdWithAString> _selectPhysics;
 	std::unique_ptr<G4UIcmdWithADoubleAndUnit> _stepMaxCmd;
+	/// \brief Set the max allowed step in a region of the spheroid
+	std::unique_ptr<G4UIcommand> _stepMaxInRegionCmd;
+	/// \brief Set the max allowed step in an organelle of the cells
+	std::unique_ptr<G4UIcommand> _stepMaxInOrganelleCmd;
+	/// \brief Set the max allowed step outside the spheroid
+	std::unique_ptr<G4UIcmdWithADoubleAndUnit> _stepMaxOutsideCmd;
 	std::unique_ptr<G4UIcmdWithADoubleAndUnit> _electronCutCmd;
 };
 
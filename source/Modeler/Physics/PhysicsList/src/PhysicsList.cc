@@ -19,6 +19,7 @@
 #include "G4ParticleDefinition.hh"
 #include "G4ProcessManager.hh"
 #include "StepMax.hh"
+#include <stdexcept>
 #include "G4SystemOfUnits.hh"
 // Geant4-DNA MODELS
 #include "G4DNAElastic.hh"
@@ -202,6 +203,9 @@ PhysicsListMessenger &PhysicsList::messenger() {
 }
 
 void PhysicsList::AddStepMax() {
+	if (_stepMaxProcess->HasSpecificLimits() && !_population)
+		throw std::runtime_error("Step limits are set per region, organelle or outside the spheroid but no population has been given to the physics list");
+
 	auto theParticleIterator = GetParticleIterator();
 	theParticleIterator->reset();
 	while ((*theParticleIterator)()) {
@@ -236,6 +240,11 @@ StepMax *PhysicsList::step_max_process() {
 	return _stepMaxProcess;
 }
 
+void PhysicsList::SetPopulation(const Population &population) {
+	_population = &population;
+	_stepMaxProcess->SetPopulation(&population);
+}
+
 void PhysicsList::SetElectronCut(G4double value) {
   fElectronCut = value;
   G4RunManager::GetRunManager()->PhysicsHasBeenModified();
@@ -5,6 +5,8 @@
 #include "StepMax.hh"
 #include "StepMaxMessenger.hh"
 
+#include <sstream>
+
 namespace cpop {
 
 PhysicsListMessenger::PhysicsListMessenger(PhysicsList *physics_list):
@@ -29,6 +31,39 @@ void PhysicsListMessenger::BuildCommands(G4String base) {
 	_stepMaxCmd->SetRange("mxStep>0.");
 	_stepMaxCmd->SetUnitCategory("Length");
 
+	cmd_base = base + "/stepMaxInRegion";
+	_stepMaxInRegionCmd = std::make_unique<G4UIcommand>(cmd_base, this);
+	_stepMaxInRegionCmd->SetGuidance("Set max allowed step length in a region of the spheroid (the population must be given to the physics list)");
+	auto* region = new G4UIparameter("region", 's', false);
+	region->SetParameterCandidates("Necrosis Intermediary External");
+	_stepMaxInRegionCmd->SetParameter(region);
+	auto* region_step = new G4UIparameter("mxStep", 'd', false);
+	region_step->SetParameterRange("mxStep>0.");
+	_stepMaxInRegionCmd->SetParameter(region_step);
+	auto* region_unit = new G4UIparameter("unit", 's', true);
+	region_unit->SetDefaultValue("mm");
+	_stepMaxInRegionCmd->SetParameter(region_unit);
+
+	cmd_base = base + "/stepMaxInOrganelle";
+	_stepMaxInOrganelleCmd = std::make_unique<G4UIcommand>(cmd_base, this);
+	_stepMaxInOrganelleCmd->SetGuidance("Set max allowed step length in the nuclei or the cytoplasms (the population must be given to the physics list)");
+	auto* organelle = new G4UIparameter("organelle", 's', false);
+	organelle->SetParameterCandidates("nucleus cytoplasm");
+	_stepMaxInOrganelleCmd->SetParameter(organelle);
+	auto* organelle_step = new G4UIparameter("mxStep", 'd', false);
+	organelle_step->SetParameterRange("mxStep>0.");
+	_stepMaxInOrganelleCmd->SetParameter(organelle_step);
+	auto* organelle_unit = new G4UIparameter("unit", 's', true);
+	organelle_unit->SetDefaultValue("mm");
+	_stepMaxInOrganelleCmd->SetParameter(organelle_unit);
+
+	cmd_base = base + "/stepMaxOutside";
+	_stepMaxOutsideCmd = std::make_unique<G4UIcmdWithADoubleAndUnit>(cmd_base, this);
+	_stepMaxOutsideCmd->SetGuidance("Set max allowed step length outside the spheroid (the population must be given to the physics list)");
+	_stepMaxOutsideCmd->SetParameterName("mxStep",false);
+	_stepMaxOutsideCmd->SetRange("mxStep>0.");
+	_stepMaxOutsideCmd->SetUnitCategory("Length");
+
 	cmd_base = base + "/electronCut";
 	_electronCutCmd = std::make_unique<G4UIcmdWithADoubleAndUnit>(cmd_base, this);
 	_electronCutCmd->SetGuidance("Set energy below which electrons are killed");
@@ -42,6 +77,20 @@ void PhysicsListMessenger::SetNewValue(G4UIcommand *command, G4String newValue)
 		_physicsList->AddPhysicsList(newValue);
 	} else if (command == _stepMaxCmd.get()) {
 		_physicsList->step_max_process()->SetMaxStep(_stepMaxCmd->GetNewDoubleValue(newValue));
+	} else if (command == _stepMaxInRegionCmd.get() || command == _stepMaxInOrganelleCmd.get()) {
+		G4String name;
+		G4double value;
+		G4String unit;
+		std::istringstream is(newValue.data());
+		is >> name >> value >> unit;
+		value *= G4UIcommand::ValueOf(unit);
+
+		if (command == _stepMaxInRegionCmd.get())
+			_physicsList->step_max_process()->SetMaxStepInRegion(name, value);
+		else
+			_physicsList->step_max_process()->SetMaxStepInOrganelle(name, value);
+	} else if (command == _stepMaxOutsideCmd.get()) {
+		_physicsList->step_max_process()->SetMaxStepOutside(_stepMaxOutsideCmd->GetNewDoubleValue(newValue));
 	} else if (command == _electronCutCmd.get()) {
 		_physicsList->SetElectronCut(_electronCutCmd->GetNewDoubleValue(newValue));
 	}
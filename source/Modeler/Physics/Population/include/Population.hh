@@ -2,19 +2,62 @@
 #define POPULATION_HH
 
 #include <CLHEP/Random/MTwistEngine.h>
+#include <cstdint>
 #include <ctime>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
 #include "UnitSystemManager.hh"
 #include "Mesh3DSettings.hh"
 #include "CellSettings.hh"
+#include "ECellComposition.hh"
 #include "SpheroidRegion.hh"
 
 #include "PopulationMessenger.hh"
 
+class G4LogicalVolume;
+class G4VTouchable;
+class SpheroidalCell;
+
 namespace cpop {
 
+/// \brief region and sampling state of a cell, computed once by Population::defineRegion()
+struct CellTag {
+	/// \brief region index of a cell outside all regions
+	static constexpr std::int8_t noRegion = -1;
+
+	std::int8_t region = noRegion; ///< \brief index of the cell region in Population::regions()
+	bool sampled = false;          ///< \brief true if the cell is sampled in its region
+};
+
+/// \brief location of a point in the cell population, computed by Population::locate()
+/// \details names are only given when writing outputs, cf. organelle_name() and Population::region_name()
+struct CellLocation {
+	/// \brief cell index of a point outside all cells
+	static constexpr std::size_t noCell = std::numeric_limits<std::size_t>::max();
+	/// \brief nucleus index of a point outside all nuclei
+	static constexpr std::int16_t noNucleus = -1;
+
+	std::size_t cell_index = noCell;                                        ///< \brief dense index of the cell, cf. Population::cells()
+	CellComposition::Organelle organelle = CellComposition::_CYTOPLASM;     ///< \brief organelle containing the point
+	std::int16_t nucleus_index = noNucleus;                                 ///< \brief index of the nucleus in the cell nuclei
+	std::int8_t region = CellTag::noRegion;                                 ///< \brief index of the cell region in Population::regions()
+
+	/// \brief return true if the point is in a cell
+	bool in_cell() const { return cell_index != noCell; }
+	/// \brief return true if the point is in a nucleus
+	bool in_nucleus() const { return nucleus_index != noNucleus; }
+	/// \brief return true if the point is in a cell but not in one of its nuclei
+	bool in_cytoplasm() const { return in_cell() && !in_nucleus(); }
+};
+
+/// \brief return the name of the organelle used in the outputs ("nucleus", "cytoplasm", ...)
+const std::string& organelle_name(CellComposition::Organelle organelle);
+
 class Population {
 public:
 	Population();
@@ -52,9 +95,26 @@ public:
 	void loadPopulation();
 	void printPopulationInfo();
 
+	/// \brief if true the cells are meshed on demand instead of by loadPopulation, cf. ensure_mesh
+	void setLazy_meshing(bool lazy_meshing) { _lazyMeshing = lazy_meshing; }
+	/// \brief return true if the cells are meshed on demand
+	bool lazy_meshing() const { return _lazyMeshing; }
+	/// \brief mesh the cell if it is not meshed yet and return true if it has a mesh. Thread safe, a cell is meshed only once.
+	bool ensure_mesh(const Settings::nCell::t_Cell_3* cell) const;
+	/// \brief mesh, in parallel, the given cells not meshed yet
+	void ensure_meshes(const std::vector<const Settings::nCell::t_Cell_3*>& cells) const;
+	/// \brief return the number of cells meshed on demand, including the ones failing to mesh
+	std::size_t nb_meshed_cells() const { return _nbMeshedCells; }
+	/// \brief return the time spent meshing cells on demand, summed over threads, in s
+	double meshing_duration() const { return static_cast<double>(_meshingNanoseconds)*1e-9; }
+	void printMeshingInfo() const;
+
 	void defineRegion();
 	void printRegionInfo();
 
+	/// \brief return the time spent by loadPopulation and defineRegion, in s
+	double loading_duration() const { return _loadingDuration; }
+
 	G4int calculateNumberOfCells_InXML_File();
 
 	void enableWritingInfoPrimariesTxt(G4String choice, G4String name_file);
@@ -66,7 +126,42 @@ public:
 
 	PopulationMessenger& messenger();
 
-	std::vector<SpheroidRegion> regions() const;
+	const std::vector<SpheroidRegion>& regions() const;
+
+	/// \brief return the dense index of the cell (its index in cells())
+	std::size_t cell_index(const Settings::nCell::t_Cell_3* cell) const;
+	/// \brief return the dense index of the cell with the given id, no_cell_index if there is none
+	std::size_t cell_index_by_id(unsigned long cell_id) const;
+	/// \brief return the region and sampling state of the cell at the given dense index
+	const CellTag& cell_tag(std::size_t cell_index) const { return _cellTags[cell_index]; }
+	/// \brief return the region containing the cell, nullptr if none
+	const SpheroidRegion* region(const Settings::nCell::t_Cell_3* cell) const;
+	/// \brief return the region containing the cell with the given id, nullptr if none
+	const SpheroidRegion* region_by_id(unsigned long cell_id) const;
+	/// \brief return true if the cell is sampled
+	bool is_sampled(const Settings::nCell::t_Cell_3* cell) const;
+	/// \brief return the name of the region at the given index, an empty name for CellTag::noRegion
+	const std::string& region_name(std::int8_t region) const;
+
+	/// \brief classify a point (in CPOP unit) of the given cell : cell, organelle, nucleus and region.
+	/// The point is assumed to be in the cell, cf. SpheroidalCell::hasIn
+	CellLocation locate(const Settings::nCell::t_Cell_3* cell, const Settings::Geometry::Point_3& point) const;
+	/// \brief classify a touchable of the Geant4 cell volumes, cf. placeCellsInG4. Empty location if not in a known cell
+	CellLocation locate(const G4VTouchable* touchable) const;
+
+	/// \brief dense index of an unknown cell
+	static constexpr std::size_t no_cell_index = std::numeric_limits<std::size_t>::max();
+
+	/// \brief place the cells and their nuclei as Geant4 volumes in the given mother volume
+	/// \details if release_meshes is true the (frozen) cell meshes are freed once converted, spots can then no longer be
+	/// picked in the cytoplasm or on the membrane. With lazy meshing, all cells not meshed yet are meshed first.
+	void placeCellsInG4(G4LogicalVolume* mother, int mother_depth = 0, bool check_overlaps = false, bool release_meshes = false);
+	/// \brief return true if the cells are placed as Geant4 volumes
+	bool has_g4_geometry() const { return _g4CellDepth >= 0; }
+	/// \brief return the touchable depth of the cell volumes, their copy number is the cell id. Nuclei are one level deeper.
+	int g4_cell_depth() const { return _g4CellDepth; }
+	/// \brief if true identical nuclei and membranes share their Geant4 solid when placing the cells
+	void setShare_g4_solids(bool share_g4_solids) { _shareG4Solids = share_g4_solids; }
 
 	G4int nbCellXml = 0;
 
@@ -110,6 +205,20 @@ private:
 	double _deltaReffinement = -1;
 	/// \brief File containing the population
 	std::string _populationFile = "";
+	/// \brief Time spent loading the population and defining the regions, in s
+	double _loadingDuration = 0;
+
+	// On demand meshing
+	/// \brief True if the cells are meshed on demand
+	bool _lazyMeshing = false;
+	/// \brief Cells to mesh, indexed by dense cell index
+	std::vector<SpheroidalCell*> _meshableCells;
+	/// \brief Flags meshing each cell once, indexed by dense cell index
+	std::unique_ptr<std::once_flag[]> _meshOnce;
+	/// \brief Number of cells meshed on demand
+	mutable std::atomic<std::size_t> _nbMeshedCells{0};
+	/// \brief Time spent meshing cells on demand, in ns
+	mutable std::atomic<long long> _meshingNanoseconds{0};
 
 	// Regions
 	/// \brief Region container : necrosis, intermediary and external regions
@@ -122,6 +231,24 @@ private:
 	double _numberSamplingCellPerRegion = -1;
 	/// \brief Sampled cells
 	std::vector<const Settings::nCell::t_Cell_3*> _sampledCells;
+	/// \brief Region and sampling state of each cell, indexed by dense cell index
+	std::vector<CellTag> _cellTags;
+	/// \brief Dense cell index, indexed by cell id - _firstCellID. Empty if the ids are too sparse
+	std::vector<std::size_t> _cellIndexFromID;
+	/// \brief Dense cell index by cell id, used instead of _cellIndexFromID when the ids are too sparse
+	std::unordered_map<unsigned long, std::size_t> _sparseCellIndexFromID;
+	/// \brief Smallest cell id
+	unsigned long _firstCellID = 0;
+
+	/// \brief Build the dense cell index from cell ids
+	void indexCells();
+	/// \brief Mesh the cell at the given dense index unless already done, cf. ensure_mesh
+	void meshCellOnce(std::size_t cell_index) const;
+
+	/// \brief Touchable depth of the cell volumes, -1 if the cells are not placed as Geant4 volumes
+	int _g4CellDepth = -1;
+	/// \brief True if identical shapes share their Geant4 solid
+	bool _shareG4Solids = true;
 
 	// Random engine (only used if not already set by the user
 	CLHEP::MTwistEngine _randomEngine = CLHEP::MTwistEngine(time(nullptr));
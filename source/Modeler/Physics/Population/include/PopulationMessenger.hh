@@ -39,6 +39,8 @@ private:
 	std::unique_ptr<G4UIcmdWithADouble> _intermediaryRatioCmd;
 	/// \brief Set number of sampling cell
 	std::unique_ptr<G4UIcmdWithAnInteger> _numberSamplingCmd;
+	/// \brief Mesh cells on demand instead of meshing the whole population
+	std::unique_ptr<G4UIcmdWithAnInteger> _lazyMeshingCmd;
 	/// \brief Initialize population and regions
 	std::unique_ptr<G4UIcmdWithoutParameter> _initCmd;
 	/// \brief Enable writing of infos about primaries in a .txt
@@ -1,9 +1,10 @@
 #ifndef SPHEROIDREGION_HH
 #define SPHEROIDREGION_HH
 
-#include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include "CellSampler.hh"
 #include "CellSettings.hh"
 
 namespace cpop {
@@ -11,7 +12,7 @@ namespace cpop {
 /*! \class SpheroidRegion
    * \brief Class representing a sphere region with an internal and external radius
    */
-class SpheroidRegion {
+class SpheroidRegion : public CellSampler<Settings::nCell::t_Cell_3> {
 public:
 	template <typename CellIt>
 	SpheroidRegion(
@@ -21,7 +22,11 @@ public:
 	bool isInRegion(const Settings::nCell::t_Cell_3* cell) const;
 
 	bool isSampled(const Settings::nCell::t_Cell_3* cell) const;
-	const std::unordered_set<const Settings::nCell::t_Cell_3*>& sample(int nSample = -1);
+	const std::vector<const Settings::nCell::t_Cell_3*>& sample(int nSample = -1);
+	/// \brief return the sorted indices in cells_in_region() of nSample cells, without keeping them
+	std::vector<std::size_t> sampleNCells(unsigned int nSample) const override;
+	/// \brief return the sorted indices in cells_in_region() of the sampled cells
+	const std::vector<std::size_t>& sampled_indices() const;
 
 	Settings::Geometry::Point_3 center() const;
 
@@ -29,7 +34,7 @@ public:
 
 	double external_radius() const;
 
-	std::string name() const;
+	const std::string& name() const;
 
 	std::vector<const Settings::nCell::t_Cell_3 *> const& cells_in_region() const;
 
@@ -40,7 +45,10 @@ private:
 	double _externalRadius; /*!< External radius in G4 unit of the region */
 
 	std::vector<const Settings::nCell::t_Cell_3*> _cellsInRegion; /*!< Cells contained in the region*/
-	std::unordered_set<const Settings::nCell::t_Cell_3*> _sampledCells;   /*!< Sampled cells in the region*/
+	std::vector<std::size_t> _sampledIndices; /*!< Sorted indices in _cellsInRegion of the sampled cells*/
+	std::vector<const Settings::nCell::t_Cell_3*> _sampledCells;   /*!< Sampled cells in the region, in _sampledIndices order*/
+	unsigned long _firstCellID = 0; /*!< Smallest id of the cells in the region*/
+	std::vector<bool> _sampledByID; /*!< Sampling flag of the cells in the region, indexed by id - _firstCellID*/
 };
 
 template<typename CellIt>
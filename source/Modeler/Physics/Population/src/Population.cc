@@ -1,4 +1,7 @@
 #include "Population.hh"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <stdexcept>
 
 #include "Voronoi_3D_Mesh.hh"
@@ -8,8 +11,14 @@
 #include "SpheroidalCellMesh.hh"
 #include "CPOP_Loader.hh"
 #include "CGAL_Utils.hh"
+#include "ThreadPool.hh"
 
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4Timer.hh"
 #include "G4UnitsTable.hh"
+#include "G4VTouchable.hh"
 
 #include "analysis.hh"
 #include "G4RunManager.hh"
@@ -17,6 +26,11 @@
 
 namespace cpop {
 
+const std::string& organelle_name(CellComposition::Organelle organelle) {
+	static const std::string names[] = {"cell_membrane", "cytoplasm", "nuclear_membrane", "nucleus"};
+	return names[organelle];
+}
+
 Population::Population():
 	_messenger(std::make_unique<PopulationMessenger>(this))
 {
@@ -105,6 +119,9 @@ G4int Population::calculateNumberOfCells_InXML_File() {
 }
 
 void Population::loadPopulation() {
+	G4Timer timer;
+	timer.Start();
+
 	if (number_max_facet_poly() <= 0)
 		throw std::runtime_error("nbMaxFacetPerPoly should be strictly positive. Current value : " + std::to_string(number_max_facet_poly()));
 
@@ -140,7 +157,7 @@ void Population::loadPopulation() {
 	assert(dynamic_cast<Settings::nEnvironment::t_SimulatedSubEnv_3*>(env->getFirstChild()));
 
 	assert(env->getFirstChild());
-	std::set<Agent*> lAgts = env->getFirstChild()->getAgents();
+	auto const& lAgts = env->getFirstChild()->getAgents();
 	// warning : this should be done before the meshing because only cell positions are modified, not their meshes
 	std::set<t_SpatialableAgent_3*> spaAgts;
 	// G4int int_test = 0 ;
@@ -165,21 +182,34 @@ void Population::loadPopulation() {
 		number_max_facet_poly(),
 		delta_reffinement()
 	);
-	dynamic_cast<SpheroidalCellMesh*>(_voronoiMesh)->generateMesh();
+	// order by id rather than by address so the dense cell indices are reproducible
+	auto byID = [](const Settings::nCell::t_Cell_3* a, const Settings::nCell::t_Cell_3* b) { return a->getID() < b->getID(); };
+
+	if(lazy_meshing()) {
+		// cells are meshed when first needed, cf. ensure_mesh. Neither the masses nor the STL files are written.
+		// Their nuclei are generated now and only the cells meshed in eager mode are kept, so both modes give the same population.
+		_meshableCells = dynamic_cast<SpheroidalCellMesh*>(_voronoiMesh)->prepareMesh();
+		std::sort(_meshableCells.begin(), _meshableCells.end(), byID);
+		_cells.assign(_meshableCells.begin(), _meshableCells.end());
+		_meshOnce = std::make_unique<std::once_flag[]>(_meshableCells.size());
+	} else {
+		dynamic_cast<SpheroidalCellMesh*>(_voronoiMesh)->generateMesh();
 
-	//Call of this function allow to write geometry informations in .gdml (HACKED FOR NOW)
-	//A sub call of SpheroidalCell:convertToG4Structure writes the masses of cells in a txt file
-	dynamic_cast<SpheroidalCellMesh*>(_voronoiMesh)->exportToFile("",MeshOutFormats::GDML , false);
+		//A sub call of SpheroidalCell:convertToG4Structure writes the masses of cells in a txt file
+		delete dynamic_cast<SpheroidalCellMesh*>(_voronoiMesh)->convertToG4World(false);
 
-	// TODO move
-	dynamic_cast<Voronoi_3D_Mesh*>(_voronoiMesh)->exportToFile("output_stl/cell", MeshOutFormats::STL, true);
+		// TODO move
+		dynamic_cast<Voronoi_3D_Mesh*>(_voronoiMesh)->exportToFile("output_stl/cell", MeshOutFormats::STL, true);
 
-	// create the vector of cells
-	{
+		// the meshes are no more refined, only their compact form is kept
+		dynamic_cast<SpheroidalCellMesh*>(_voronoiMesh)->freezeMeshes();
+
+		// create the vector of cells
 		auto lCells = _voronoiMesh->getCellsWithShape();
-		_cells.clear();
-		_cells.insert(_cells.begin(), lCells.begin(), lCells.end());
+		_cells.assign(lCells.begin(), lCells.end());
+		std::sort(_cells.begin(), _cells.end(), byID);
 	}
+	indexCells();
 
 	// compute spheroid radius from the farthest cell
 	double nearest, farthest;
@@ -194,6 +224,9 @@ void Population::loadPopulation() {
 		std::ofstream infos_primaries_file_to_write;
 		infos_primaries_file_to_write.open(nameFilePrimaries);
 	}
+
+	timer.Stop();
+	_loadingDuration = timer.GetRealElapsed();
 }
 
 void Population::printPopulationInfo() {
@@ -204,7 +237,50 @@ void Population::printPopulationInfo() {
 	std::cout << "Spheroid centroid = " << spheroid_centroid() << " radius of the spheroid = " << G4BestUnit(spheroid_radius(),"Length") << std::endl;
 }
 
+/// \details the cell is meshed by the first thread asking for it, the other ones wait until it is meshed.
+/// Nothing is done if the cells are not meshed on demand. A cell failing to mesh is reported once, callers skip it.
+/// \return true if the cell is meshed
+bool Population::ensure_mesh(const Settings::nCell::t_Cell_3* cell) const {
+	if(_meshOnce)
+		meshCellOnce(cell_index(cell));
+	return cell->hasMesh();
+}
+
+/// \details cells are meshed one by one by the thread pool, as their meshing time varies a lot
+void Population::ensure_meshes(const std::vector<const Settings::nCell::t_Cell_3*>& cells) const {
+	if(!_meshOnce)
+		return;
+
+	ThreadPool::getInstance()->parallelFor(cells.size(), [&](std::size_t pBegin, std::size_t pEnd) {
+		for(std::size_t iCell = pBegin; iCell < pEnd; ++iCell)
+			meshCellOnce(cell_index(cells[iCell]));
+	});
+}
+
+void Population::meshCellOnce(std::size_t cell_index) const {
+	std::call_once(_meshOnce[cell_index], [this, cell_index]() {
+		auto start = std::chrono::steady_clock::now();
+		if(!dynamic_cast<SpheroidalCellMesh*>(_voronoiMesh)->meshCell(_meshableCells[cell_index]))
+			G4cerr << "Failed to mesh cell " << _meshableCells[cell_index]->getID() << ", it is skipped" << G4endl;
+		_meshingNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		++_nbMeshedCells;
+	});
+}
+
+/// \details the time saved is extrapolated from the mean meshing time of the meshed cells
+void Population::printMeshingInfo() const {
+	std::size_t nbCell = _meshableCells.size();
+	std::size_t nbMeshed = nb_meshed_cells();
+	std::cout << "Meshed " << nbMeshed << " of " << nbCell << " cells on demand in " << meshing_duration() << " s";
+	if(nbMeshed > 0)
+		std::cout << ", about " << meshing_duration()/nbMeshed*(nbCell - nbMeshed) << " s saved";
+	std::cout << std::endl;
+}
+
 void Population::defineRegion() {
+	G4Timer timer;
+	timer.Start();
+
 	if (_internalLayerRatio < 0 || _internalLayerRatio > 1)
 		throw std::runtime_error("InternalLayerRatio should be in [0;1]. Current value : " + std::to_string(_internalLayerRatio));
 
@@ -221,12 +297,41 @@ void Population::defineRegion() {
 	_regions.emplace_back("External"    , _spheroidCentroid, intermediaryLayerRadius, spheroidRadius, _cells.begin(), _cells.end());
 
 	for(SpheroidRegion& region : _regions) {
-		auto samples = region.sample(_numberSamplingCellPerRegion);
+		auto const& samples = region.sample(_numberSamplingCellPerRegion);
 		_sampledCells.insert(_sampledCells.end(), samples.begin(), samples.end());
 	}
 
+	// tag each cell with its region : the first region containing it, or the first one sampling it
+	_cellTags.assign(_cells.size(), CellTag());
+	for(std::size_t iRegion = 0; iRegion < _regions.size(); ++iRegion) {
+		for(auto const* cell : _regions[iRegion].cells_in_region()) {
+			CellTag& tag = _cellTags[cell_index(cell)];
+			if(tag.region == CellTag::noRegion)
+				tag.region = static_cast<std::int8_t>(iRegion);
+		}
+	}
+
+	for(std::size_t iRegion = 0; iRegion < _regions.size(); ++iRegion) {
+		for(auto const* cell : _regions[iRegion].sample()) {
+			CellTag& tag = _cellTags[cell_index(cell)];
+			if(!tag.sampled) {
+				tag.sampled = true;
+				tag.region = static_cast<std::int8_t>(iRegion);
+			}
+		}
+	}
+
 	if(verbose_level() > 0)
 		printRegionInfo();
+
+	// only the scored cells are meshed now, the cells hosting sources are meshed by the sources
+	if(lazy_meshing()) {
+		ensure_meshes(_sampledCells);
+		printMeshingInfo();
+	}
+
+	timer.Stop();
+	_loadingDuration += timer.GetRealElapsed();
 }
 
 void Population::printRegionInfo() {
@@ -238,7 +343,7 @@ void Population::printRegionInfo() {
 	std::cout << "InternalLayerRadius " << G4BestUnit(internalLayerRadius,"Length") << std::endl;
 	std::cout << "Spheroid radius " << G4BestUnit(spheroidRadius,"Length") << std::endl;
 	for(SpheroidRegion& region : _regions) {
-		auto samples = region.sample();
+		auto const& samples = region.sample();
 		std::cout << "Region " << region.name() << " observes " << samples.size() << " cells" << std::endl;
 		if(_verboseLevel > 0) {
 			for(auto sample : samples)
@@ -267,10 +372,157 @@ double Population::number_sampling_cell_per_region() const {
 	return _numberSamplingCellPerRegion;
 }
 
-std::vector<SpheroidRegion> Population::regions() const {
+const std::vector<SpheroidRegion>& Population::regions() const {
 	return _regions;
 }
 
+void Population::indexCells() {
+	_cellIndexFromID.clear();
+	_sparseCellIndexFromID.clear();
+	if(_cells.empty())
+		return;
+
+	auto [minCell, maxCell] = std::minmax_element(
+		_cells.begin(), _cells.end(),
+		[](const Settings::nCell::t_Cell_3* a, const Settings::nCell::t_Cell_3* b) { return a->getID() < b->getID(); }
+	);
+
+	_firstCellID = (*minCell)->getID();
+	unsigned long idSpan = (*maxCell)->getID() - _firstCellID + 1;
+	// a table indexed by id only pays off if the ids are close to contiguous
+	if(idSpan > 4*_cells.size() + 1024) {
+		_sparseCellIndexFromID.reserve(_cells.size());
+		for(std::size_t iCell = 0; iCell < _cells.size(); ++iCell)
+			_sparseCellIndexFromID.emplace(_cells[iCell]->getID(), iCell);
+		return;
+	}
+
+	_cellIndexFromID.assign(idSpan, no_cell_index);
+	for(std::size_t iCell = 0; iCell < _cells.size(); ++iCell)
+		_cellIndexFromID[_cells[iCell]->getID() - _firstCellID] = iCell;
+}
+
+std::size_t Population::cell_index_by_id(unsigned long cell_id) const {
+	if(!_sparseCellIndexFromID.empty()) {
+		auto it = _sparseCellIndexFromID.find(cell_id);
+		return it == _sparseCellIndexFromID.end() ? no_cell_index : it->second;
+	}
+	if(cell_id < _firstCellID || cell_id - _firstCellID >= _cellIndexFromID.size())
+		return no_cell_index;
+	return _cellIndexFromID[cell_id - _firstCellID];
+}
+
+std::size_t Population::cell_index(const Settings::nCell::t_Cell_3* cell) const {
+	std::size_t index = cell_index_by_id(cell->getID());
+	assert(index != no_cell_index && _cells[index] == cell);
+	return index;
+}
+
+const SpheroidRegion* Population::region_by_id(unsigned long cell_id) const {
+	std::size_t index = cell_index_by_id(cell_id);
+	if(index == no_cell_index || index >= _cellTags.size() || _cellTags[index].region == CellTag::noRegion)
+		return nullptr;
+	return &_regions[_cellTags[index].region];
+}
+
+const SpheroidRegion* Population::region(const Settings::nCell::t_Cell_3* cell) const {
+	return region_by_id(cell->getID());
+}
+
+bool Population::is_sampled(const Settings::nCell::t_Cell_3* cell) const {
+	std::size_t index = cell_index_by_id(cell->getID());
+	return index != no_cell_index && index < _cellTags.size() && _cellTags[index].sampled;
+}
+
+const std::string& Population::region_name(std::int8_t region) const {
+	static const std::string noName;
+	return region == CellTag::noRegion ? noName : _regions[region].name();
+}
+
+/// \details a single pass on the cell nuclei, nothing is allocated
+CellLocation Population::locate(const Settings::nCell::t_Cell_3* cell, const Settings::Geometry::Point_3& point) const {
+	CellLocation location;
+	location.cell_index = cell_index(cell);
+	if(location.cell_index < _cellTags.size())
+		location.region = _cellTags[location.cell_index].region;
+
+	auto const& nuclei = cell->getNuclei();
+	for(std::size_t iNucleus = 0; iNucleus < nuclei.size(); ++iNucleus) {
+		if(nuclei[iNucleus]->hasIn(point)) {
+			location.organelle = CellComposition::_NUCLEOPLASM;
+			location.nucleus_index = static_cast<std::int16_t>(iNucleus);
+			break;
+		}
+	}
+	return location;
+}
+
+/// \details cell volumes have the cell id as copy number, nuclei are their daughters with their index as copy number
+CellLocation Population::locate(const G4VTouchable* touchable) const {
+	CellLocation location;
+	int depth = touchable->GetHistoryDepth();
+	if(depth < _g4CellDepth || _g4CellDepth < 0)
+		return location; // between cells
+
+	std::size_t index = cell_index_by_id(static_cast<unsigned long>(touchable->GetCopyNumber(depth - _g4CellDepth)));
+	if(index == no_cell_index)
+		return location;
+
+	location.cell_index = index;
+	if(index < _cellTags.size())
+		location.region = _cellTags[index].region;
+	if(depth > _g4CellDepth) {
+		location.organelle = CellComposition::_NUCLEOPLASM;
+		location.nucleus_index = static_cast<std::int16_t>(touchable->GetCopyNumber(depth - _g4CellDepth - 1));
+	}
+	return location;
+}
+
+/// \details The cells are placed in a box daughter of the mother volume, each cell is a tessellated solid
+/// whose copy number is the cell id and its nuclei are daughters of the cell, numbered by their index.
+/// Geant4 smart voxels are built on the box when the geometry is closed, so locating a step does not require any lookup in user code.
+/// Unless disabled, identical nuclei and membranes share their solid.
+/// If the regions are defined, the cell volumes are also attached to a G4Region of the same name.
+void Population::placeCellsInG4(G4LogicalVolume* mother, int mother_depth, bool check_overlaps, bool release_meshes) {
+	auto* mesh = dynamic_cast<SpheroidalCellMesh*>(_voronoiMesh);
+	if(!mesh)
+		throw std::runtime_error("Population must be loaded before placing cells in Geant4");
+
+	// Geant4 volumes need the mesh of every cell
+	ensure_meshes(_cells);
+
+	mesh->setShareG4Solids(_shareG4Solids);
+	mesh->setReleaseMeshAfterG4Conversion(release_meshes);
+	G4LogicalVolume* spheroidVolume = mesh->convertToG4Logical(mother, check_overlaps);
+	if(!spheroidVolume)
+		throw std::runtime_error("Failed to convert the cell population to Geant4 volumes");
+
+	// mother -> spheroid bounding box -> cells -> nuclei
+	_g4CellDepth = mother_depth + 2;
+
+	if(_cellTags.empty())
+		return;
+
+	std::vector<G4Region*> g4Regions;
+	g4Regions.reserve(_regions.size());
+	for(auto const& region : _regions) {
+		// a region of the same name may already exist, e.g. when the geometry is built again
+		G4Region* g4Region = G4RegionStore::GetInstance()->GetRegion(region.name(), false);
+		g4Regions.push_back(g4Region ? g4Region : new G4Region(region.name()));
+	}
+
+	for(std::size_t iVolume = 0; iVolume < spheroidVolume->GetNoDaughters(); ++iVolume) {
+		G4LogicalVolume* cellVolume = spheroidVolume->GetDaughter(iVolume)->GetLogicalVolume();
+		std::size_t index = cell_index_by_id(spheroidVolume->GetDaughter(iVolume)->GetCopyNo());
+		if(index == no_cell_index || _cellTags[index].region == CellTag::noRegion)
+			continue;
+
+		G4Region* g4Region = g4Regions[_cellTags[index].region];
+		cellVolume->SetRegion(g4Region);
+		g4Region->AddRootLogicalVolume(cellVolume);
+	}
+}
+
 void Population::setNumber_sampling_cell_per_region(double value) {
 	_numberSamplingCellPerRegion = value;
 }
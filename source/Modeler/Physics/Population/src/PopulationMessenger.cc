@@ -61,6 +61,14 @@ void PopulationMessenger::BuildCommands(G4String base) {
 	_numberSamplingCmd->SetDefaultValue(-1);
 	_numberSamplingCmd->AvailableForStates(G4State_PreInit);
 
+	cmd_name = cmd_base + "/lazyMeshing";
+	_lazyMeshingCmd = std::make_unique<G4UIcmdWithAnInteger>(cmd_name, this);
+	_lazyMeshingCmd->SetGuidance("Mesh only the sampled cells and the cells hosting sources, other cells are meshed when first needed. 0 (off) 1 (on)");
+	_lazyMeshingCmd->SetParameterName("LazyMeshing", true);
+	_lazyMeshingCmd->SetDefaultValue(1);
+	_lazyMeshingCmd->SetRange("LazyMeshing == 0 || LazyMeshing == 1");
+	_lazyMeshingCmd->AvailableForStates(G4State_PreInit);
+
 	cmd_name = cmd_base + "/init";
 	_initCmd = std::make_unique<G4UIcmdWithoutParameter>(cmd_name,this);
 	_initCmd->SetGuidance("Load population file and define regions");
@@ -106,6 +114,8 @@ void PopulationMessenger::SetNewValue(G4UIcommand *command, G4String newValue) {
 		_population->setIntermediary_layer_ratio(_intermediaryRatioCmd->GetNewDoubleValue(newValue));
 	} else if (command == _numberSamplingCmd.get()) {
 		_population->setNumber_sampling_cell_per_region(_numberSamplingCmd->GetNewIntValue(newValue));
+	} else if (command == _lazyMeshingCmd.get()) {
+		_population->setLazy_meshing(_lazyMeshingCmd->GetNewIntValue(newValue) != 0);
 	} else if (command == _initCmd.get()) {
 		_population->loadPopulation();
 		_population->defineRegion();
@@ -3,6 +3,9 @@
 #include "CGAL_Utils.hh"
 #include "RandomEngineManager.hh"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace cpop {
 
 bool SpheroidRegion::isInRegion(const Settings::nCell::t_Cell_3 *cell) const {
@@ -15,32 +18,51 @@ bool SpheroidRegion::isInRegion(const Settings::nCell::t_Cell_3 *cell) const {
 }
 
 bool SpheroidRegion::isSampled(const Settings::nCell::t_Cell_3 *cell) const {
-	auto found_cell = _sampledCells.find(cell);
-	return isInRegion(cell) && found_cell != _sampledCells.end();
+	unsigned long id = cell->getID();
+	return id >= _firstCellID && id - _firstCellID < _sampledByID.size() && _sampledByID[id - _firstCellID];
+}
+
+std::vector<std::size_t> SpheroidRegion::sampleNCells(unsigned int nSample) const {
+	std::size_t max_cells = _cellsInRegion.size();
+	if(nSample > max_cells) {
+		std::string msg = "Can not select " + std::to_string(nSample) + " cells because region contains " + std::to_string(max_cells) + " cells.\n";
+		throw std::runtime_error(msg.c_str());
+	}
+
+	return sampleSortedIndices(max_cells, nSample);
 }
 
-const std::unordered_set<const Settings::nCell::t_Cell_3 *> &SpheroidRegion::sample(int nSample) {
+const std::vector<const Settings::nCell::t_Cell_3 *> &SpheroidRegion::sample(int nSample) {
 	if(_sampledCells.empty()) {
-		if(nSample <= 0) { // No sampling : all cells are observed
-			_sampledCells.insert(_cellsInRegion.begin(), _cellsInRegion.end());
-		} else {
-			int max_cells = _cellsInRegion.size();
-			if(nSample > max_cells) {
-				std::string msg = "Can not select " + std::to_string(nSample) + " cells because region contains " + std::to_string(max_cells) + " cells.\n";
-				throw std::runtime_error(msg.c_str());
-			}
-
-			unsigned int indexCell = 0;
-			while(_sampledCells.size() < nSample) {
-				indexCell = RandomEngineManager::getInstance()->randi(0, max_cells -1);
-				_sampledCells.insert(_cellsInRegion[indexCell]);
-			}
+		if(nSample <= 0) // No sampling : all cells are observed
+			_sampledIndices = sampleSortedIndices(_cellsInRegion.size(), _cellsInRegion.size());
+		else
+			_sampledIndices = sampleNCells(nSample);
+
+		_sampledCells.reserve(_sampledIndices.size());
+		for(std::size_t index : _sampledIndices)
+			_sampledCells.push_back(_cellsInRegion[index]);
+
+		_sampledByID.clear();
+		if(!_sampledCells.empty()) {
+			auto [minCell, maxCell] = std::minmax_element(
+				_sampledCells.begin(), _sampledCells.end(),
+				[](const Settings::nCell::t_Cell_3* a, const Settings::nCell::t_Cell_3* b) { return a->getID() < b->getID(); }
+			);
+			_firstCellID = (*minCell)->getID();
+			_sampledByID.assign((*maxCell)->getID() - _firstCellID + 1, false);
+			for(auto const* cell : _sampledCells)
+				_sampledByID[cell->getID() - _firstCellID] = true;
 		}
 	}
 
 	return _sampledCells;
 }
 
+const std::vector<std::size_t>& SpheroidRegion::sampled_indices() const {
+	return _sampledIndices;
+}
+
 Settings::Geometry::Point_3 SpheroidRegion::center() const {
 	return _center;
 }
@@ -53,7 +75,7 @@ double SpheroidRegion::external_radius() const {
 	return _externalRadius;
 }
 
-std::string SpheroidRegion::name() const {
+const std::string& SpheroidRegion::name() const {
 	return _name;
 }
 
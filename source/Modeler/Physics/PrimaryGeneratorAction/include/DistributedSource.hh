@@ -1,9 +1,9 @@
 #ifndef DISTRIBUTEDSOURCE_HH
 #define DISTRIBUTEDSOURCE_HH
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
-#include <unordered_map>
 
 #include "CGAL_Utils.hh"
 #include "Source.hh"
@@ -23,57 +23,56 @@ namespace cpop {
 class SpheroidRegion;
 
 /// \brief This class is used to store particle source information for each cell
+/// \details positions are not owned : they are stored contiguously in the flat position array
+/// of the DistributedSource and referenced by a range.
 class SourceInfo {
 /// Victor Levrague : functions to allow random positions for each different particle generated on a cell ///
 
 public:
-	SourceInfo(const Settings::nCell::t_Cell_3* cell, int nb_source, int part_per_source, const OrganellesWeight& organelle_weight):
+	SourceInfo(const Settings::nCell::t_Cell_3* cell, int nb_source, int part_per_source):
 		_cell(cell),
 		_numberSource(nb_source),
 		_numberParticlesPerSource(part_per_source)
 	{
-		// Pick a random organelle
-		auto organelle = organelle_weight.getRandomOrganelle();
-
-		Point_3 pos = Utils::myCGAL::to_G4(_cell->getSpotOnOrganelle(organelle));
-		_positionInCell.emplace_back(pos.x(), pos.y(), pos.z());
 	}
 
 	[[nodiscard]] bool HasLeft() const { return _alreadyGenerated < totalSecondary(); }
 	void addDistributedSource(int inc = 1) { _numberSource += inc; }
-	void AddParticlePosition(OrganellesWeight& organelle_weight) {
-		auto organelle = organelle_weight.getRandomOrganelle();
-
-		Point_3 pos = Utils::myCGAL::to_G4(_cell->getSpotOnOrganelle(organelle));
-
-		_positionInCell.emplace_back(pos.x(), pos.y(), pos.z());
-	}
 
 	void Update() { ++_alreadyGenerated; }
-	int getID_SourceInfo() { return _cell->getID(); }
-
-	[[nodiscard]] std::vector<G4ThreeVector> GetPosition() const {
-		// G4cout<< "GetPosition called in NanoSource.hh" << G4endl;
-		// G4cout<< "position in cell x : " << position_in_cell_[0].getX() << G4endl;
-		// G4cout<< "position in cell y : " << position_in_cell_[0].getY() << G4endl;
-		// G4cout<< "position in cell z: " << position_in_cell_[0].getZ() << G4endl;
-		return _positionInCell;
+	[[nodiscard]] int getID_SourceInfo() const { return _cell->getID(); }
+	[[nodiscard]] const Settings::nCell::t_Cell_3* cell() const { return _cell; }
+	[[nodiscard]] int number_source() const { return _numberSource; }
+
+	/// \brief set the range of the positions of this cell in the flat position array
+	void setPositionRange(std::size_t first_position, std::size_t nb_position) {
+		assert(nb_position > 0);
+		_firstPosition = first_position;
+		_numberPosition = nb_position;
 	}
 
-	/// \brief Position in cell
-	std::vector<G4ThreeVector> _positionInCell;
+	/// \brief Index, in the flat position array, of the position of the current particle.
+	/// All particles of a source share the same position.
+	[[nodiscard]] std::size_t positionIndex() const {
+		std::size_t iSource = _alreadyGenerated / _numberParticlesPerSource;
+		return _firstPosition + std::min(iSource, _numberPosition - 1);
+	}
 
 private:
-    [[nodiscard]] int totalSecondary() const { return _numberSource*_numberParticlesPerSource; }
-
-    /// \brief Cell containing particle sources
-    const Settings::nCell::t_Cell_3* _cell;
-    /// \brief Number of source in the cell
-    int _numberSource = 0;
-    /// \brief Number of secondary particle to generate for one source
-    int _numberParticlesPerSource = 0;
-    /// \brief Number of secondary particle already generated
-    int _alreadyGenerated = 0;
+	[[nodiscard]] int totalSecondary() const { return _numberSource*_numberParticlesPerSource; }
+
+	/// \brief Cell containing particle sources
+	const Settings::nCell::t_Cell_3* _cell;
+	/// \brief Number of source in the cell
+	int _numberSource = 0;
+	/// \brief Number of secondary particle to generate for one source
+	int _numberParticlesPerSource = 0;
+	/// \brief Number of secondary particle already generated
+	int _alreadyGenerated = 0;
+	/// \brief Index of the first position of the cell in the flat position array
+	std::size_t _firstPosition = 0;
+	/// \brief Number of positions of the cell in the flat position array
+	std::size_t _numberPosition = 1;
 };
 
 class DistributedSource : public Source {
@@ -81,13 +80,15 @@ class DistributedSource : public Source {
 public:
 	DistributedSource(const std::string& name, const Population& population);
 
-	std::vector<G4ThreeVector> GetPosition() override;
+	G4ThreeVector GetPosition() override;
 	int getID_OfCell();
 	void Update() override;
 	bool HasLeft() override;
 
 	/// \brief Distribute all the particle sources in a cell
 	void Initialize() override;
+	/// \brief Remove the distributed sources and their positions, they are distributed again by Initialize
+	void Reset() override;
 
 	int number_distributed() const;
 	void setNumber_source(int number_source);
@@ -118,9 +119,12 @@ public:
 
 	int total_particle() const { return _numberSource*_numberParticlesPerSource; }
 
-	void eraseFront_position_cell() {
-		((_currentCell->second)._positionInCell).erase(((_currentCell->second)._positionInCell).begin());
-	}
+	/// \brief return the number of pre-generated positions
+	std::size_t number_position() const { return _positions.size(); }
+	/// \brief return the pre-generated position at the given index (in G4 unit)
+	const G4ThreeVector& position(std::size_t index) const { return _positions[index]; }
+	/// \brief return the particle sources of each cell
+	const std::vector<SourceInfo>& sources() const { return _sources; }
 
 	std::vector<const Settings::nCell::t_Cell_3*> chooseLabeledCells(
 		float cell_labeling_percentage, const SpheroidRegion &region
@@ -134,9 +138,6 @@ public:
 
 	std::vector<const Settings::nCell::t_Cell_3 *> labeledCells;
 
-	/// \brief particle source repartition in each cell
-	std::unordered_map<const Settings::nCell::t_Cell_3*, SourceInfo> cellSource;
-
 	double emissionInMembrane;
 	double emissionInNucleus;
 	double emissionInNucleusMembrane;
@@ -172,20 +173,19 @@ private:
 	/// \brief Return the number of particle source to distribute in region
 	int source_in_region(const SpheroidRegion& region) const;
 
-	/// \brief Distribute number_source particle sources inside region and update the unordered map
+	/// \brief Distribute number_source particle sources inside region and append the resulting sources
 	void distribute(int number_source, const SpheroidRegion& region);
 
 	/// \brief Distribute number_source particle sources inside cells, with a
-	/// maximum number per source and update the unordered map
+	/// maximum number per cell, and append the resulting sources
 	void distribute_in_cells_with_maximum_nb(
 		int total_nb_source,
-		int* nb_source_per_cell,
-		std::vector<const Settings::nCell::t_Cell_3*> labeled_cells,
-		std::vector<int> max_nb_part_per_cell
+		const std::vector<const Settings::nCell::t_Cell_3*>& labeled_cells,
+		const std::vector<int>& max_nb_part_per_cell
 	);
 
-	/// \brief Return a position in the cell in G4 unit according to the organelle_weight probablity
-	std::vector<G4ThreeVector> getPositionInCell() const;
+	/// \brief Generate the positions of all sources in the flat position array
+	void generatePositions();
 
 	/// \brief Number of particle sources to be simulated
 	int _numberSource = 0;
@@ -203,8 +203,12 @@ private:
 	int _numberSourceIntermediary = 0;
 	/// \brief Number of particle source in the external region
 	int _numberSourceExternal = 0;
-	/// \brief Current cell generating particle source
-	std::unordered_map<const Settings::nCell::t_Cell_3*, SourceInfo>::iterator _currentCell;
+	/// \brief particle source repartition in each cell
+	std::vector<SourceInfo> _sources;
+	/// \brief Positions of all sources (in G4 unit), contiguous per cell
+	std::vector<G4ThreeVector> _positions;
+	/// \brief Index of the current cell generating particle source
+	std::size_t _currentSource = 0;
 	/// \brief Secondary distribution in a cell
 	std::unique_ptr<OrganellesWeight> _organelleWeight;
 	/// \brief Cell labeling percentage, in necrosis region
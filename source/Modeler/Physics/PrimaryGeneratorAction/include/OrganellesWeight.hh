@@ -4,7 +4,7 @@
 #include "RandomEngineManager.hh"
 #include "Randomize.hh"
 
-#include <map>
+#include <array>
 #include "ECellComposition.hh"
 
 #include <cassert>
@@ -12,8 +12,15 @@
 using namespace CellComposition;
 
 /// \brief the ratio of each organelles.
+/// \details stored as a 4 entries cumulative distribution so picking an organelle is a short linear scan.
 struct OrganellesWeight {
-	std::map<double, Organelle> organelleRatios;
+	/// \brief number of organelles which can be weighted
+	static constexpr std::size_t nbOrganelles = 4;
+
+	/// \brief organelles, in the order of the cumulative distribution
+	std::array<Organelle, nbOrganelles> organelles = {_CELL_MEMBRANE, _NUCLEOPLASM, _CYTOPLASM, _NUCLEAR_MEMBRANE};
+	/// \brief cumulative ratio of each organelle
+	std::array<double, nbOrganelles> cumulativeRatios = {0., 0., 0., 1.};
 
 	OrganellesWeight(
 		double pCellMembrane,
@@ -21,38 +28,42 @@ struct OrganellesWeight {
 		double pNuclearMembrane,
 		double pCytoplasm
 	) {
+		std::array<double, nbOrganelles> weights = {pCellMembrane, pNucleoplasm, pCytoplasm, pNuclearMembrane};
 		double lSum = pCellMembrane + pNucleoplasm + pNuclearMembrane + pCytoplasm;
-		double weight = pCellMembrane;
-		//G4cout << "/n/n/n weight CELL_MEMBRANE Ratios : " <<  weight/lSum << G4endl;
-		organelleRatios.insert(std::make_pair(weight/lSum, _CELL_MEMBRANE));
-		weight += pNucleoplasm;
-		//G4cout << "/n/n/n weight NUCLEOPLASM Ratios : " <<  weight/lSum << G4endl;
-		organelleRatios.insert(std::make_pair(weight/lSum, _NUCLEOPLASM));
-		weight += pCytoplasm;
-		//G4cout << "/n/n/n weight CYTOPLASM  Ratios : " <<  weight/lSum << G4endl;
-		organelleRatios.insert(std::make_pair(weight/lSum, _CYTOPLASM));
-		weight += pNuclearMembrane;
-		//G4cout << "/n/n/n weight NUCLEAR_MEMBRANE Ratios : " <<  weight/lSum << G4endl;
-		organelleRatios.insert(std::make_pair(weight/lSum, _NUCLEAR_MEMBRANE));
+
+		double weight = 0.;
+		std::size_t lastWeighted = 0;
+		for(std::size_t iOrg = 0; iOrg < nbOrganelles; ++iOrg) {
+			weight += weights[iOrg];
+			cumulativeRatios[iOrg] = weight/lSum;
+			if(weights[iOrg] > 0.)
+				lastWeighted = iOrg;
+		}
+
+		// avoid rounding errors to give a chance to an organelle without weight
+		for(std::size_t iOrg = lastWeighted; iOrg < nbOrganelles; ++iOrg)
+			cumulativeRatios[iOrg] = 1.;
 	}
 
-	/// \brief return the organelle corresponding to the given probability
-	[[nodiscard]] Organelle getOrganelle(double pProba) const {
+	/// \brief return the index of the organelle corresponding to the given probability
+	[[nodiscard]] std::size_t getOrganelleIndex(double pProba) const {
 		assert(pProba >= 0);
 		assert(pProba <= 1);
-		auto itOrg = organelleRatios.lower_bound(pProba);
-		assert(itOrg != organelleRatios.end());
-		return itOrg->second;
+		std::size_t iOrg = 0;
+		while(iOrg < nbOrganelles - 1 && pProba > cumulativeRatios[iOrg])
+			++iOrg;
+
+		return iOrg;
+	}
+
+	/// \brief return the organelle corresponding to the given probability
+	[[nodiscard]] Organelle getOrganelle(double pProba) const {
+		return organelles[getOrganelleIndex(pProba)];
 	}
 
 	/// \brief return a random organelle using a uniform distribution
 	[[nodiscard]] Organelle getRandomOrganelle() const {
-		std::map<double, Organelle>::const_iterator itOrg;
-		do {
-			itOrg = organelleRatios.lower_bound(G4UniformRand());
-		} while(itOrg == organelleRatios.end());
-
-		return itOrg->second;
+		return getOrganelle(G4UniformRand());
 	}
 };
 
@@ -21,8 +21,7 @@
 #include "UniformSource.hh"
 #include "DistributedSource.hh"
 
-#include "Octree.hh"
-#include "OctreeNodeForSpheroidalCell.hh"
+#include "LinearOctree.hh"
 
 namespace cpop {
 
@@ -44,6 +43,9 @@ public:
 	[[nodiscard]] bool HasSource() const;
 	[[nodiscard]] int TotalEvent() const;
 	void Initialize();
+	/// \brief Reset the sources so that they can be set up and initialized again (see Source::Reset).
+	/// The population and the octree of the sampled cells are kept.
+	void reset();
 
 	const Settings::nCell::t_Cell_3 *findCell(const Settings::Geometry::Point_3& point);
 
@@ -101,8 +103,6 @@ public:
 		double diffusion_distance
 	);
 
-	std::string findOrganelle(const Settings::nCell::t_Cell_3* cell, const Settings::Geometry::Point_3& point);
-
 	/// \brief Select a source between the uniform source and the distributed one
 	[[nodiscard]] Source *selectSource() const;
 
@@ -146,7 +146,7 @@ public:
 
 private:
 	/// \brief Octree containing SAMPLED cells
-	std::unique_ptr<Octree<OctreeNodeForSpheroidalCell>> _octree;
+	std::unique_ptr<LinearOctree> _octree;
 
 	const Population* _population;
 
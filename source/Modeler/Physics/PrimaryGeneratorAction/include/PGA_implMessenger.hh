@@ -19,6 +19,9 @@ public:
 	void BuildCommands(G4String base) override;
 	void SetNewValue(G4UIcommand * command , G4String newValue) override;
 
+	/// \brief return the directory of the commands, set by BuildCommands
+	[[nodiscard]] const G4String& base() const { return _base; }
+
 private:
 	PGA_impl* _pgaImpl;
 
@@ -38,6 +41,8 @@ private:
 	std::unique_ptr<G4UIcmdWithAString> _li7BNCTCmd;
 	/// \brief Initialize the sources
 	std::unique_ptr<G4UIcmdWithoutParameter> _initCmd;
+	/// \brief Reset the sources to run them again on the same population
+	std::unique_ptr<G4UIcmdWithoutParameter> _resetCmd;
 };
 
 }
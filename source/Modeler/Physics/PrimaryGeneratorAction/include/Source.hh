@@ -39,11 +39,13 @@ public:
 
 	/// \brief Initialize the object
 	virtual void Initialize() {}
+	/// \brief Forget what has been generated, the source can then be initialized again. Parameters are kept.
+	virtual void Reset() { lineNumberPositionsDirectionsFile = 1; }
 
 	// Pure virtual methods
 	// Not const to let the user change object state (eg keep track of what has been generated)
 	/// \brief Generate a random position (in G4 unit)
-	virtual std::vector<G4ThreeVector> GetPosition() = 0;
+	virtual G4ThreeVector GetPosition() = 0;
 	/// \brief Called at the end of GeneratePrimaries
 	virtual void Update() = 0;
 	/// \brief Tell if the source has generated all its particles
@@ -15,9 +15,10 @@ public:
 	[[nodiscard]] int total_particle() const;
 	void setTotal_particle(int total_particle);
 
-	std::vector<G4ThreeVector> GetPosition() override;
+	G4ThreeVector GetPosition() override;
 	void Update() override;
 	bool HasLeft() override;
+	void Reset() override;
 
 	[[nodiscard]] int already_generated() const;
 
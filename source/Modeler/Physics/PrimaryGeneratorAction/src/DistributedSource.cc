@@ -6,14 +6,19 @@
 
 #include "G4RunManager.hh"
 #include "G4Run.hh"
+#include "G4Timer.hh"
 #include "analysis.hh"
 
+#include <algorithm>
+#include <array>
 #include <cstdio>
 #include <cstdlib>
 
 #include <iostream>
+#include <iterator>
 #include <vector>
 #include <cmath>
+#include <numeric>
 
 
 namespace cpop {
@@ -24,26 +29,29 @@ DistributedSource::DistributedSource(const std::string &name, const Population &
 {
 }
 
-std::vector<G4ThreeVector> DistributedSource::GetPosition() {
+G4ThreeVector DistributedSource::GetPosition() {
 	// If this method is called, we know we have something to generate
 	// because a source is only selected if HasLeft() returned true
-	return getPositionInCell();
+	return _positions[_sources[_currentSource].positionIndex()];
 }
 
 void DistributedSource::Update() {
-	_currentCell->second.Update();
+	_sources[_currentSource].Update();
 	// Check if we need to go to the next cell
-	if(!_currentCell->second.HasLeft())
-		++_currentCell;
+	if(!_sources[_currentSource].HasLeft())
+		++_currentSource;
 }
 
 bool DistributedSource::HasLeft() {
 	if (!_isInitialized) return false;
-	return _currentCell != cellSource.end();
+	return _currentSource < _sources.size();
 }
 
 void DistributedSource::Initialize() {
 	if(!_isInitialized) {
+		G4Timer timer;
+		timer.Start();
+
 		auto const* population = DistributedSource::population();
 		auto const& regions = population->regions();
 
@@ -55,12 +63,49 @@ void DistributedSource::Initialize() {
 			distribute(number_source, region);
 		}
 
-		_currentCell = cellSource.begin();
+		// with lazy meshing, the cells hosting sources are only meshed now
+		if(population->lazy_meshing()) {
+			std::vector<const Settings::nCell::t_Cell_3*> source_cells;
+			source_cells.reserve(_sources.size());
+			for(auto const& source : _sources)
+				source_cells.push_back(source.cell());
+			population->ensure_meshes(source_cells);
+			population->printMeshingInfo();
+
+			// no spot can be picked in a cell failing to mesh
+			auto itDropped = std::stable_partition(_sources.begin(), _sources.end(), [](const auto& source) {
+				return source.cell()->hasMesh();
+			});
+			if(itDropped != _sources.end()) {
+				long long nb_dropped_source = 0;
+				for(auto it = itDropped; it != _sources.end(); ++it)
+					nb_dropped_source += it->number_source();
+				std::cerr << "Warning: " << nb_dropped_source << " sources of " << std::distance(itDropped, _sources.end())
+				          << " labeled cells failing to mesh are not generated" << std::endl;
+				_sources.erase(itDropped, _sources.end());
+			}
+		}
+
+		generatePositions();
+		_currentSource = 0;
 		_isInitialized = true;
-		std::cout << "In initialized of is_initialized : " << std::boolalpha << _isInitialized << '\n';
+
+		timer.Stop();
+		std::cout << "Distributed source " << source_name() << " initialized in " << timer.GetRealElapsed() << " s ("
+		          << _sources.size() << " labeled cells with sources, " << _positions.size() << " positions)" << '\n';
 	}
 }
 
+void DistributedSource::Reset() {
+	Source::Reset();
+	_sources.clear();
+	_positions.clear();
+	labeledCells.clear();
+	maxNbPartPerCell.clear();
+	_currentSource = 0;
+	_isInitialized = false;
+}
+
 int DistributedSource::source_in_region(const SpheroidRegion &region) const {
 	int res = 0;
 	if (region.name() == "Necrosis")
@@ -95,21 +140,17 @@ void DistributedSource::distribute(int number_source, const SpheroidRegion &regi
 
 	labeledCells = chooseLabeledCells(cell_labeling_percentage, region);
 
-	if(max_number_source_per_cell*cells_in_region.size()*cell_labeling_percentage < number_source) {
-		throw std::invalid_argument("Number of particles > Max number of particles per cell * Number of cells labeled.");
-	}
-
-	int nb_source_per_cell[cells_in_region_size];
-	memset(nb_source_per_cell, 0, cells_in_region_size*sizeof(int));
-
-	std::vector<float> randomNumbers(cells_in_region_size);
-
 	maxNbPartPerCell = applyMethodDistributionNbParticlesInCells(
 		labeledCells,
 		number_source, max_number_source_per_cell
 	);
 
-	distribute_in_cells_with_maximum_nb(number_source, nb_source_per_cell, labeledCells, maxNbPartPerCell);
+	long long capacity = std::accumulate(maxNbPartPerCell.begin(), maxNbPartPerCell.end(), 0LL);
+	if(capacity < number_source) {
+		throw std::invalid_argument("Number of particles > Max number of particles per cell * Number of cells labeled.");
+	}
+
+	distribute_in_cells_with_maximum_nb(number_source, labeledCells, maxNbPartPerCell);
 
 	std::cout << " Number of labeled cells in region " << region.name() << " = " << labeledCells.size()  <<'\n';
 
@@ -120,48 +161,99 @@ void DistributedSource::distribute(int number_source, const SpheroidRegion &regi
 	}
 }
 
+/// \details Each source goes to a cell picked uniformly among the labeled cells not full yet.
+/// Cells which are not full are kept packed at the beginning of an index array, so a cell is
+/// picked with a single random number and removed in O(1) once it reaches its maximum.
 void DistributedSource::distribute_in_cells_with_maximum_nb(
 	int total_nb_source,
-	int* nb_source_per_cell,
-	std::vector<const Settings::nCell::t_Cell_3*> labeled_cells,
-	std::vector<int> max_nb_part_per_cell
+	const std::vector<const Settings::nCell::t_Cell_3*>& labeled_cells,
+	const std::vector<int>& max_nb_part_per_cell
 )
 {
-	int indexCell = 0;
-	for(int i = 0 ; i < total_nb_source; ++i) {
-		// TODO bad rand
-		indexCell = rand() % (labeled_cells.size());
-		while (nb_source_per_cell[indexCell]>=max_nb_part_per_cell[indexCell]) {
-			indexCell = rand() % (labeled_cells.size());
-		}
+	assert(labeled_cells.size() == max_nb_part_per_cell.size());
+	auto* engine = RandomEngineManager::getInstance()->getEngine();
+
+	std::vector<int> nb_source_per_cell(labeled_cells.size(), 0);
+	std::vector<std::size_t> available_cells;
+	available_cells.reserve(labeled_cells.size());
+	for(std::size_t iCell = 0; iCell < labeled_cells.size(); ++iCell) {
+		if(max_nb_part_per_cell[iCell] > 0)
+			available_cells.push_back(iCell);
+	}
 
-		const Settings::nCell::t_Cell_3 * selected_cell = labeled_cells[indexCell];
-
-		auto already_selected = cellSource.find(selected_cell);
-		if (already_selected == cellSource.end()) {
-			if (population()->verbose_level() > 0)
-					std::cout << "  Inserting particle source in cell with id " << selected_cell->getID()  <<'\n';
-
-			cellSource.insert({selected_cell, {selected_cell, 1, _numberParticlesPerSource, *_organelleWeight}});
-			nb_source_per_cell[indexCell] +=1 ;
-		} else {
-			if (this->population()->verbose_level() > 0)
-				std::cout << "  Adding particle source to cell with id  " << selected_cell->getID() << '\n';
-			already_selected->second.addDistributedSource();
-			if (onlyOnePositionForAllParticlesOnACell == 0) {
-				already_selected->second.AddParticlePosition(*_organelleWeight);
+	static constexpr int chunkSize = 1024;
+	double randomNumbers[chunkSize];
+	for(int iSource = 0; iSource < total_nb_source; iSource += chunkSize) {
+		int nbSource = std::min(chunkSize, total_nb_source - iSource);
+		engine->flatArray(nbSource, randomNumbers);
+
+		for(int iRand = 0; iRand < nbSource; ++iRand) {
+			assert(!available_cells.empty());
+			auto index = std::min(
+				static_cast<std::size_t>(randomNumbers[iRand]*available_cells.size()),
+				available_cells.size() - 1
+			);
+
+			std::size_t indexCell = available_cells[index];
+			if(++nb_source_per_cell[indexCell] >= max_nb_part_per_cell[indexCell]) {
+				available_cells[index] = available_cells.back();
+				available_cells.pop_back();
 			}
-			nb_source_per_cell[indexCell] += 1;
 		}
 	}
+
+	for(std::size_t iCell = 0; iCell < labeled_cells.size(); ++iCell) {
+		if(nb_source_per_cell[iCell] == 0)
+			continue;
+
+		if (population()->verbose_level() > 0)
+			std::cout << "  Inserting " << nb_source_per_cell[iCell] << " particle sources in cell with id " << labeled_cells[iCell]->getID() << '\n';
+
+		_sources.emplace_back(labeled_cells[iCell], nb_source_per_cell[iCell], _numberParticlesPerSource);
+	}
 }
 
-std::vector<G4ThreeVector> DistributedSource::getPositionInCell() const {
-	return _currentCell->second.GetPosition();
+void DistributedSource::generatePositions() {
+	std::size_t nbPosition = 0;
+	for(auto& source : _sources) {
+		std::size_t nbCellPosition = onlyOnePositionForAllParticlesOnACell == 0 ? source.number_source() : 1;
+		source.setPositionRange(nbPosition, nbCellPosition);
+		nbPosition += nbCellPosition;
+	}
+
+	_positions.clear();
+	_positions.reserve(nbPosition);
+
+	// positions of a cell are drawn organelle by organelle, so the cell can batch its sampling,
+	// then put back in the order the organelles were drawn
+	std::vector<std::size_t> organelleIndex;
+	std::array<std::vector<Point_3>, OrganellesWeight::nbOrganelles> spots;
+	for(auto const& source : _sources) {
+		std::size_t nbCellPosition = onlyOnePositionForAllParticlesOnACell == 0 ? source.number_source() : 1;
+
+		std::array<std::size_t, OrganellesWeight::nbOrganelles> nbSpots{};
+		organelleIndex.resize(nbCellPosition);
+		for(auto& iOrg : organelleIndex) {
+			iOrg = _organelleWeight->getOrganelleIndex(G4UniformRand());
+			++nbSpots[iOrg];
+		}
+
+		for(std::size_t iOrg = 0; iOrg < OrganellesWeight::nbOrganelles; ++iOrg) {
+			spots[iOrg].clear();
+			if(nbSpots[iOrg] > 0)
+				source.cell()->getSpotsOnOrganelle(_organelleWeight->organelles[iOrg], nbSpots[iOrg], spots[iOrg]);
+		}
+
+		nbSpots.fill(0);
+		for(auto iOrg : organelleIndex) {
+			Point_3 pos = Utils::myCGAL::to_G4(spots[iOrg][nbSpots[iOrg]++]);
+			_positions.emplace_back(pos.x(), pos.y(), pos.z());
+		}
+	}
 }
 
 int DistributedSource::getID_OfCell() {
-  return _currentCell->second.getID_SourceInfo();
+  return _sources[_currentSource].getID_SourceInfo();
 }
 
 int DistributedSource::number_source_external() const {
@@ -264,44 +356,45 @@ std::vector<int> DistributedSource::inverse_cdf_log_normal_distribution(
 	return results;
 }
 
+/// \details labeled cells are the first cells of a partial Fisher-Yates shuffle of the region cells
 std::vector<const Settings::nCell::t_Cell_3 *> DistributedSource::chooseLabeledCells(
 	float cell_labeling_percentage, const SpheroidRegion &region
 ) {
-  if ((cell_labeling_percentage != 1.0) and (cell_labeling_percentage != 0.0)) {
-    int cells_in_region_size = region.cells_in_region().size();
-		std::vector<const Settings::nCell::t_Cell_3*> labeled_cells = {};
-		std::vector<int> available_cells_id(cells_in_region_size);
-    iota(available_cells_id.begin(), available_cells_id.end(), 1); //contains 1 to available_cells_id.size()
-    for(int i = 0 ; i < int(cell_labeling_percentage * cells_in_region_size); ++i) {
-			int indexCell = available_cells_id[rand() % available_cells_id.size()] - 1;
-			labeled_cells.push_back(region.cells_in_region()[indexCell]);
-			remove(available_cells_id.begin(),available_cells_id.end(),indexCell);
+	if ((cell_labeling_percentage != 1.0) and (cell_labeling_percentage != 0.0)) {
+		std::vector<const Settings::nCell::t_Cell_3*> labeled_cells = region.cells_in_region();
+		std::size_t cells_in_region_size = labeled_cells.size();
+		auto nb_labeled_cells = static_cast<std::size_t>(cell_labeling_percentage * cells_in_region_size);
+
+		auto* engine = RandomEngineManager::getInstance()->getEngine();
+		for(std::size_t i = 0; i < nb_labeled_cells; ++i) {
+			std::size_t remaining = cells_in_region_size - i;
+			std::size_t indexCell = i + std::min(static_cast<std::size_t>(engine->flat()*remaining), remaining - 1);
+			std::swap(labeled_cells[i], labeled_cells[indexCell]);
 		}
+		labeled_cells.resize(nb_labeled_cells);
 
-    return labeled_cells;
-  }
+		return labeled_cells;
+	}
 
-  return region.cells_in_region();
+	return region.cells_in_region();
 }
 
 std::vector<int> DistributedSource::applyMethodDistributionNbParticlesInCells(
 	std::vector<const Settings::nCell::t_Cell_3 *> labeled_cells, int number_source, int max_number_source_per_cell
 ) {
-  std::random_device rd;  // Will be used to obtain a seed for the random number engine
-  std::mt19937 gen(rd()); // Standard mersenne_twister_engine seeded with rd()
-  std::uniform_real_distribution<> uniform_distribution(0.0, 1.0);
+  auto* engine = RandomEngineManager::getInstance()->getEngine();
   int labeled_cells_size = labeled_cells.size(); //Should be equal to labeling_percentage * nb_cells
 
   if (isLogNormDistribution) {
 		std::vector<int> log_norm_distrib_particles;
 		std::vector<float> randomNumbers(labeled_cells_size);
 		for (int i = 0; i < labeled_cells_size; ++i)
-			randomNumbers[i] = uniform_distribution(gen);
+			randomNumbers[i] = engine->flat();
 
 		log_norm_distrib_particles = inverse_cdf_log_normal_distribution(randomNumbers, shapeFactor, meanPPC);
 		while ((sum_array(log_norm_distrib_particles)/nb_elements_array(log_norm_distrib_particles)) != meanPPC) {
 			for (int i = 0; i < labeled_cells_size; ++i)
-				randomNumbers[i] = uniform_distribution(gen);
+				randomNumbers[i] = engine->flat();
 			log_norm_distrib_particles = inverse_cdf_log_normal_distribution(randomNumbers, shapeFactor, meanPPC);
 		}
 
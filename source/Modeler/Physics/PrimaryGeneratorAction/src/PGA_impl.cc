@@ -80,7 +80,7 @@ void PGA_impl::GeneratePrimaries(G4Event *event) {
 	}
 
 	particleEnergy = source->GetEnergy();
-	g4ParticlePosition = (source->GetPosition()).front();
+	g4ParticlePosition = source->GetPosition();
 
 	//TODO : debug the (source->GetPosition()) call when multiple sources are used in one simulation
 	//(source->GetPosition()) value is well attributed in DistributedSource GetPosition(), but the call is PGA_impl.cc fails.
@@ -89,9 +89,6 @@ void PGA_impl::GeneratePrimaries(G4Event *event) {
 		labeledCells = _distributedSource->labeledCells;
 		_population->set_labeled_cells(labeledCells);
 
-		if (_distributedSource->onlyOnePositionForAllParticlesOnACell == 0)
-			_distributedSource->eraseFront_position_cell();
-
 		G4String name_radionuclide = "At211"; //TODO : create a macro command with radionuclide name and associate corresponding energies
 
 		if (name_radionuclide.compare("At211")==0) {
@@ -283,16 +280,31 @@ void PGA_impl::Initialize() {
 	}
 }
 
+void PGA_impl::reset() {
+	{
+		std::lock_guard<std::mutex> lock(_generatePrimariesMutex);
+		if (_uniformSource) _uniformSource->Reset();
+		if (_distributedSource) _distributedSource->Reset();
+		labeledCells.clear();
+		_population->set_labeled_cells(labeledCells);
+		_isChecked = false;
+		nbUniform = 0;
+		nbDistributed = 0;
+	}
+
+	std::lock_guard<std::mutex> lock(_initializeMutex);
+	_isInit = false;
+}
+
 const Settings::nCell::t_Cell_3* PGA_impl::findCell(const Point_3 &point) {
 	if(!_isInitialized) {
 		std::vector<const Settings::nCell::t_Cell_3*> sampled_cells = _population->sampled_cells();
 		std::vector<const Settings::nAgent::t_SpatialableAgent_3*> spatialables(sampled_cells.begin(), sampled_cells.end());
 
-		int nbCellPerNode = 2000;
-		_octree = std::make_unique<Octree<OctreeNodeForSpheroidalCell>>(
-			Utils::getBoundingBox(spatialables.begin(), spatialables.end()),
-			&spatialables,
-			nbCellPerNode);
+		// built by each Geant4 worker thread, not on the shared ThreadPool
+		_octree = std::make_unique<LinearOctree>();
+		_octree->setParallel(false);
+		_octree->build(spatialables.begin(), spatialables.end());
 		_isInitialized = true;
 	}
 	auto const* lNearestAgent = _octree->getNearestSpatialableAgent(point);
@@ -475,16 +487,4 @@ G4ThreeVector PGA_impl::GenerateNewPositionAfterDiffusion(G4ThreeVector previous
   return (newG4ParticlePosition);
 }
 
-std::string PGA_impl::findOrganelle(const Settings::nCell::t_Cell_3 *cell, const Point_3 &point) {
-	std::vector<Settings::nCell::t_Nucleus_3*> nuclei = cell->getNuclei();
-
-	for(auto const& itNuclei : nuclei) {
-		if(itNuclei->hasIn(point) )
-			return "nucleus";
-	}
-
-	// If the point is not in the nucleus, it is in the cytoplasm
-	return "cytoplasm";
-}
-
 }
@@ -57,6 +57,13 @@ void PGA_implMessenger::BuildCommands(G4String base) {
 	cmd_base = base + "/init";
 	_initCmd = std::make_unique<G4UIcmdWithoutParameter>(cmd_base, this);
 	_initCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+	cmd_base = base + "/reset";
+	_resetCmd = std::make_unique<G4UIcmdWithoutParameter>(cmd_base, this);
+	_resetCmd->SetGuidance("Reset the sources, they can then be set up and initialized again");
+	_resetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	// the sources are shared by the worker threads, they must not replay the reset
+	_resetCmd->SetToBeBroadcasted(false);
 }
 
 void PGA_implMessenger::SetNewValue(G4UIcommand *command, G4String newValue) {
@@ -76,6 +83,8 @@ void PGA_implMessenger::SetNewValue(G4UIcommand *command, G4String newValue) {
 		_pgaImpl->ActivateDiffusion(bool_diffusion, half_life);
 	} else if (command == _initCmd.get()) {
 		_pgaImpl->Initialize();
+	} else if (command == _resetCmd.get()) {
+		_pgaImpl->reset();
 	} else if (command == _posiDirecTxtCmd.get()) {
 		G4String name_file;
 		G4String name_method;
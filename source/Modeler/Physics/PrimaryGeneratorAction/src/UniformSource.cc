@@ -19,7 +19,7 @@ void UniformSource::setTotal_particle(int total_particle) {
 	_totalParticle = total_particle;
 }
 
-std::vector<G4ThreeVector> UniformSource::GetPosition() {
+G4ThreeVector UniformSource::GetPosition() {
 	G4double spheroid_radius = this->population()->spheroid_radius();
 
 	Settings::Geometry::Point_3 center = this->population()->spheroid_centroid();
@@ -33,9 +33,7 @@ std::vector<G4ThreeVector> UniformSource::GetPosition() {
 	position_0 *= radius;
 	position_0 += spheroid_centroid;
 
-	std::vector<G4ThreeVector> position = {position_0};
-
-	return position;
+	return position_0;
 }
 
 void UniformSource::Update() {
@@ -46,6 +44,11 @@ bool UniformSource::HasLeft() {
 	return _alreadyGenerated < _totalParticle;
 }
 
+void UniformSource::Reset() {
+	Source::Reset();
+	_alreadyGenerated = 0;
+}
+
 int UniformSource::already_generated() const {
 	return _alreadyGenerated;
 }
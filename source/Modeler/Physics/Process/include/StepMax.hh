@@ -1,12 +1,27 @@
 #ifndef STEPMAX_HH
 #define STEPMAX_HH
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "G4VDiscreteProcess.hh"
 
+#include "CellSettings.hh"
+
 namespace cpop {
 
+class Population;
 class StepMaxMessenger;
+class StepMaxCellLookup;
 
+/// \brief Limit the step of charged particles.
+/// \details Without population the same limit is applied in every volume but the world. Once a population
+/// is given, limits can also be set per region of the spheroid, per organelle (nucleus or cytoplasm) and
+/// outside the spheroid. The most specific limit applies : organelle, then region, then the default one.
+/// When the cells are not placed as Geant4 volumes, a step never goes further than the finest limit
+/// into a zone with a finer limit (region, spheroid or nucleus).
 class StepMax : public G4VDiscreteProcess {
 public:
 	StepMax(const G4String& processName = "UserMaxStep");
@@ -17,6 +32,17 @@ public:
 
 	G4double GetMaxStep() { return _maxChargedStep; }
 
+	/// \brief Set the population used to resolve the region and organelle limits
+	void SetPopulation(const Population* population);
+	/// \brief Set the limit in the cells and between the cells of a region (Necrosis, Intermediary or External)
+	void SetMaxStepInRegion(const std::string& region, G4double step);
+	/// \brief Set the limit in an organelle of every cell (nucleus or cytoplasm)
+	void SetMaxStepInOrganelle(const std::string& organelle, G4double step);
+	/// \brief Set the limit outside the spheroid
+	void SetMaxStepOutside(G4double step);
+	/// \brief return true if a region, organelle or outside limit has been set
+	[[nodiscard]] bool HasSpecificLimits() const;
+
 	G4double PostStepGetPhysicalInteractionLength(
 		const G4Track& aTrack, G4double previousStepSize, G4ForceCondition* condition
 	) override;
@@ -28,8 +54,40 @@ public:
 	}
 
 private:
+	/// \brief return the limit at the track position, in G4 unit, when a population is set
+	G4double GetLimitInPopulation(const G4Track& aTrack);
+	/// \brief return the cell containing the track, nullptr if none
+	const Settings::nCell::t_Cell_3* FindCell(const G4Track& aTrack, bool& inNucleus);
+	/// \brief resolve the region limits by region index, once the regions are defined
+	void ResolveRegionLimits();
+
 	G4double _maxChargedStep;
 	//std::unique_ptr<StepMaxMessenger> messenger_;
+
+	/// \brief Cell population, nullptr if the limits do not depend on the position
+	const Population* _population = nullptr;
+	/// \brief Limit of each region, by name. A negative value means no specific limit
+	std::map<std::string, G4double> _regionLimits;
+	/// \brief Limit in the nuclei, negative if none
+	G4double _nucleusLimit = -1;
+	/// \brief Limit in the cytoplasms, negative if none
+	G4double _cytoplasmLimit = -1;
+	/// \brief Limit outside the spheroid, negative if none
+	G4double _outsideLimit = -1;
+
+	/// \brief Limit of each region, by index in Population::regions(). Resolved at the first step
+	std::vector<G4double> _regionLimitByIndex;
+	/// \brief Smallest limit inside the spheroid
+	G4double _finestLimit = DBL_MAX;
+	/// \brief True once the region limits are resolved
+	bool _isResolved = false;
+	/// \brief True if the limits depend on the position in the population
+	bool _hasSpecificLimits = false;
+
+	/// \brief Octree of all the cells, shared by the copies of the process
+	std::shared_ptr<StepMaxCellLookup> _cellLookup;
+	/// \brief The last cell where a step started, avoids the octree search
+	const Settings::nCell::t_Cell_3* _lastCell = nullptr;
 };
 
 }
@@ -1,9 +1,48 @@
 #include "StepMax.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+#include "G4Track.hh"
+#include "G4VTouchable.hh"
+
+#include "CGAL_Utils.hh"
+#include "LinearOctree.hh"
+#include "Population.hh"
+#include "RoundNucleus.hh"
 #include "StepMaxMessenger.hh"
+#include "UnitSystemManager.hh"
 
 namespace cpop {
 
+/// \brief Octree of all the cells of the population, built at the first search.
+/// Shared by the copies of StepMax, one per particle and per thread.
+class StepMaxCellLookup {
+public:
+	explicit StepMaxCellLookup(const Population& population):
+		_population(&population)
+	{
+		// built by the first Geant4 worker thread searching a cell, not on the shared ThreadPool
+		_octree.setParallel(false);
+	}
+
+	/// \brief point in CPOP unit
+	const Settings::nCell::t_Cell_3* nearestCell(const Point_3& point) {
+		std::call_once(_built, [this]() {
+			auto const& cells = _population->cells();
+			_octree.build(cells.begin(), cells.end());
+		});
+		return dynamic_cast<const Settings::nCell::t_Cell_3*>(_octree.getNearestSpatialableAgent(point));
+	}
+
+private:
+	const Population* _population;
+	std::once_flag _built;
+	LinearOctree _octree;
+};
+
 StepMax::StepMax(const G4String &processName):
 	G4VDiscreteProcess(processName),
 	_maxChargedStep(DBL_MAX)
@@ -17,23 +56,192 @@ G4bool StepMax::IsApplicable(const G4ParticleDefinition & particle) {
 
 void StepMax::SetMaxStep(G4double step) {
 	_maxChargedStep = step;
+	_isResolved = false;
+}
+
+void StepMax::SetPopulation(const Population *population) {
+	_population = population;
+	_cellLookup = population ? std::make_shared<StepMaxCellLookup>(*population) : nullptr;
+	_lastCell = nullptr;
+	_isResolved = false;
+}
+
+void StepMax::SetMaxStepInRegion(const std::string &region, G4double step) {
+	_regionLimits[region] = step;
+	_isResolved = false;
+}
+
+void StepMax::SetMaxStepInOrganelle(const std::string &organelle, G4double step) {
+	if (organelle == "nucleus")
+		_nucleusLimit = step;
+	else if (organelle == "cytoplasm")
+		_cytoplasmLimit = step;
+	else
+		throw std::runtime_error("Unknown organelle " + organelle + " for the step limit, expected nucleus or cytoplasm");
+	_isResolved = false;
+}
+
+void StepMax::SetMaxStepOutside(G4double step) {
+	_outsideLimit = step;
+	_isResolved = false;
+}
+
+bool StepMax::HasSpecificLimits() const {
+	bool has_region_limit = std::any_of(_regionLimits.begin(), _regionLimits.end(),
+		[](auto const& region_limit) { return region_limit.second > 0.; }
+	);
+	return has_region_limit || _nucleusLimit > 0. || _cytoplasmLimit > 0. || _outsideLimit > 0.;
+}
+
+void StepMax::ResolveRegionLimits() {
+	_hasSpecificLimits = HasSpecificLimits();
+	_isResolved = true;
+	if (!_hasSpecificLimits)
+		return;
+
+	auto const& regions = _population->regions();
+	_regionLimitByIndex.assign(regions.size(), -1.);
+	for(auto const& [name, limit] : _regionLimits) {
+		auto region = std::find_if(regions.begin(), regions.end(),
+			[&name = name](const SpheroidRegion& r) { return r.name() == name; }
+		);
+		if (region == regions.end())
+			throw std::runtime_error("Step limit set in the region " + name + " which is not defined in the population");
+		_regionLimitByIndex[std::distance(regions.begin(), region)] = limit;
+	}
+
+	_finestLimit = DBL_MAX;
+	for(G4double limit : {_maxChargedStep, _nucleusLimit, _cytoplasmLimit}) {
+		if (limit > 0.)
+			_finestLimit = std::min(_finestLimit, limit);
+	}
+	for(G4double limit : _regionLimitByIndex) {
+		if (limit > 0.)
+			_finestLimit = std::min(_finestLimit, limit);
+	}
 }
 
 G4double StepMax::PostStepGetPhysicalInteractionLength(const G4Track &aTrack, G4double, G4ForceCondition *condition) {
 	// condition is set to "Not Forced"
 	*condition = NotForced;
 
+	if (aTrack.GetVolume() == nullptr)
+		return DBL_MAX;
+
+	if (_population) {
+		if (!_isResolved)
+			ResolveRegionLimits();
+		if (_hasSpecificLimits)
+			return GetLimitInPopulation(aTrack);
+	}
+
 	G4double ProposedStep = DBL_MAX;
 
 	if((_maxChargedStep > 0.) &&
-		 (aTrack.GetVolume() != nullptr)
-		 && (aTrack.GetVolume()->GetName() != "World")
+		 (aTrack.GetVolume()->GetName() != "World")
 	)
 		ProposedStep = _maxChargedStep;
 
 	return ProposedStep;
 }
 
+/// \details The region is given by the distance to the spheroid center, or by the cell containing the
+/// track when organelle limits are set. The step is shortened so that it does not go further than the
+/// finest limit into the next region or outside the spheroid.
+G4double StepMax::GetLimitInPopulation(const G4Track &aTrack) {
+	G4ThreeVector position = aTrack.GetPosition();
+	Point_3 center = _population->spheroid_centroid();
+	double distToCenter = (position - G4ThreeVector(center.x(), center.y(), center.z())).mag();
+	double spheroidRadius = _population->spheroid_radius();
+
+	G4double defaultLimit = DBL_MAX;
+	if (_maxChargedStep > 0. && aTrack.GetVolume()->GetName() != "World")
+		defaultLimit = _maxChargedStep;
+
+	if (distToCenter >= spheroidRadius) {
+		G4double limit = _outsideLimit > 0. ? _outsideLimit : defaultLimit;
+		return std::min(limit, std::max(distToCenter - spheroidRadius, _finestLimit));
+	}
+
+	// region from the distance to the center
+	auto const& regions = _population->regions();
+	int iRegion = CellTag::noRegion;
+	double distToBoundary = spheroidRadius - distToCenter;
+	for(std::size_t i = 0; i < regions.size(); ++i) {
+		if (distToCenter >= regions[i].internal_radius() && distToCenter < regions[i].external_radius()) {
+			iRegion = static_cast<int>(i);
+			distToBoundary = std::min(distToCenter - regions[i].internal_radius(), regions[i].external_radius() - distToCenter);
+			break;
+		}
+	}
+
+	// cell and organelle, only searched if an organelle limit is set
+	bool inNucleus = false;
+	const Settings::nCell::t_Cell_3* cell = nullptr;
+	if (_nucleusLimit > 0. || _cytoplasmLimit > 0.) {
+		cell = FindCell(aTrack, inNucleus);
+		if (cell) {
+			int cellRegion = _population->cell_tag(_population->cell_index(cell)).region;
+			if (cellRegion != CellTag::noRegion)
+				iRegion = cellRegion;
+		}
+	}
+
+	G4double limit = defaultLimit;
+	if (iRegion != CellTag::noRegion && _regionLimitByIndex[iRegion] > 0.)
+		limit = _regionLimitByIndex[iRegion];
+	if (cell) {
+		G4double organelleLimit = inNucleus ? _nucleusLimit : _cytoplasmLimit;
+		if (organelleLimit > 0.)
+			limit = organelleLimit;
+	}
+
+	G4double step = std::min(limit, std::max(distToBoundary, _finestLimit));
+
+	// without Geant4 volumes nothing stops the step at the nucleus surface
+	if (cell && !inNucleus && !_population->has_g4_geometry() && _nucleusLimit > 0. && _nucleusLimit < step) {
+		double conversionToG4 = UnitSystemManager::getInstance()->getConversionToG4();
+		Point_3 point = Utils::myCGAL::to_CPOP(position);
+		for(auto const* nucleus : cell->getNuclei()) {
+			auto const* roundNucleus = dynamic_cast<const RoundNucleus<double, Point_3, Vector_3>*>(nucleus);
+			if (!roundNucleus)
+				continue;
+			double distToNucleus = std::sqrt(CGAL::squared_distance(point, roundNucleus->getOrigin())) - roundNucleus->getRadius();
+			step = std::min(step, std::max(distToNucleus*conversionToG4, _nucleusLimit));
+		}
+	}
+
+	return step;
+}
+
+/// \details If the cells are placed as Geant4 volumes the cell is read from the touchable, as done when
+/// scoring. Otherwise the nearest cell is searched in the octree, the last cell found being tested first.
+const Settings::nCell::t_Cell_3 *StepMax::FindCell(const G4Track &aTrack, bool &inNucleus) {
+	inNucleus = false;
+
+	if (_population->has_g4_geometry()) {
+		CellLocation location = _population->locate(aTrack.GetTouchable());
+		if (!location.in_cell())
+			return nullptr;
+		inNucleus = location.in_nucleus();
+		return _population->cells()[location.cell_index];
+	}
+
+	Point_3 point = Utils::myCGAL::to_CPOP(aTrack.GetPosition());
+	if (!_lastCell || !_lastCell->hasIn(point)) {
+		auto const* cell = _cellLookup->nearestCell(point);
+		if (!cell)
+			return nullptr;
+		// with lazy meshing the cell may be reached before being meshed
+		if (!_population->ensure_mesh(cell) || !cell->hasIn(point))
+			return nullptr;
+		_lastCell = cell;
+	}
+
+	inNucleus = _population->locate(_lastCell, point).in_nucleus();
+	return _lastCell;
+}
+
 G4VParticleChange *StepMax::PostStepDoIt(const G4Track & aTrack, const G4Step &) {
 	// do nothing
 	aParticleChange.Initialize(aTrack);
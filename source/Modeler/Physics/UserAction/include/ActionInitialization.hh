@@ -18,6 +18,9 @@ public:
 	void BuildForMaster() const override;
 	void Build() const override;
 
+	/// \brief return the messenger of the sources shared by all primary generators
+	[[nodiscard]] const PGA_implMessenger& source_messenger() const { return _pgaImpl->messenger(); }
+
 private:
 	// PGA_impl shared by all primary generators.
 	// Only owned by the ActionInitialization class
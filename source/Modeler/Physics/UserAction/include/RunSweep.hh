@@ -0,0 +1,60 @@
+#ifndef RUNSWEEP_HH
+#define RUNSWEEP_HH
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cpop {
+
+class PGA_implMessenger;
+class Population;
+
+/// \brief Run several source configurations on a population loaded once.
+/// \details Each configuration is a macro defining the sources and starting the run with /run/beamOn.
+/// Between two runs only the sources are reset (reset command of the sources messenger, /cpop/source/reset
+/// in the examples) : the population, its meshes, the
+/// regions, the Geant4 geometry and the physics tables are reused. The output file of the run i is
+/// <output_base>_run<i> (set with /analysis/setFileName).
+class RunSweep {
+public:
+	RunSweep(const Population& population, const PGA_implMessenger& source_messenger, std::string output_base);
+
+	/// \brief Add a macro to run
+	void addConfiguration(const std::string& macro);
+	/// \brief Add the macros listed in a file, one per line. Empty lines and lines starting with '#' are ignored.
+	void readList(const std::string& list_file);
+
+	/// \brief Set the time spent setting up the simulation (population, geometry, physics) before the sweep, in s
+	void setSetup_duration(double setup_duration) { _setupDuration = setup_duration; }
+
+	/// \brief Run all the configurations
+	void run();
+
+	/// \brief Print the duration of each run and an estimate of the time saved compared to starting each run from scratch
+	void printReport(std::ostream& out) const;
+
+	[[nodiscard]] const std::vector<std::string>& configurations() const { return _configurations; }
+	/// \brief return the duration of each run, in s
+	[[nodiscard]] const std::vector<double>& run_durations() const { return _runDurations; }
+	/// \brief return the output file of the run
+	[[nodiscard]] std::string output_file(std::size_t run) const;
+
+private:
+	const Population* _population;
+	/// \brief Messenger of the sources, its directory holds the reset command
+	const PGA_implMessenger* _sourceMessenger;
+
+	/// \brief Base name of the output files
+	std::string _outputBase;
+	/// \brief Macro of each run
+	std::vector<std::string> _configurations;
+	/// \brief Duration of each run, in s
+	std::vector<double> _runDurations;
+	/// \brief Time spent setting up the simulation before the sweep, in s
+	double _setupDuration = 0;
+};
+
+}
+
+#endif
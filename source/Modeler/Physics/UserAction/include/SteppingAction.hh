@@ -5,8 +5,7 @@
 
 #include "G4UserSteppingAction.hh"
 
-#include "Octree.hh"
-#include "OctreeNodeForSpheroidalCell.hh"
+#include "LinearOctree.hh"
 #include "Population.hh"
 #include "Cell_Utils.hh"
 
@@ -20,23 +19,25 @@ public:
 
 	/// \brief point in CPOP unit
 	const Settings::nCell::t_Cell_3 *findCell(const Settings::Geometry::Point_3& point);
-	std::string findOrganelle(const Settings::nCell::t_Cell_3* cell, const Settings::Geometry::Point_3& point);
-	std::string findRegion(const Settings::nCell::t_Cell_3* cell);
+	/// \brief return the location of the point (in CPOP unit) if it is in a sampled cell, the last one being tested first
+	CellLocation locate(const Settings::Geometry::Point_3& point);
 
 private:
+	/// \brief read the cell and organelle from the touchable when cells are Geant4 volumes
+	void UserSteppingActionFromTouchable(const G4Step*);
+
 	/// \brief Octree containing SAMPLED cells
-	std::unique_ptr<Octree<OctreeNodeForSpheroidalCell>> _octree;
+	std::unique_ptr<LinearOctree> _octree;
 	/// \brief Cell population
 	const Population* _population;
 	/// \brief The last sampled cell where a step occured
 	const Settings::nCell::t_Cell_3* _lastCell = nullptr;
-	/// \brief The region containing the last sampled cell
-	std::string _lastRegion = "";
 
 	bool _isInitialized = false;
 };
 
-void addTupleRow(const G4Step* step, int cellID, const std::string& organelle, const std::string& region);
+/// \brief write the step, the names of the organelle and of the region are only given here
+void addTupleRow(const G4Step* step, const Population& population, const CellLocation& location);
 
 }
 
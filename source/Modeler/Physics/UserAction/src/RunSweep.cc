@@ -0,0 +1,88 @@
+#include "RunSweep.hh"
+
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "G4Timer.hh"
+#include "G4UImanager.hh"
+
+#include "PGA_implMessenger.hh"
+#include "Population.hh"
+
+namespace cpop {
+
+RunSweep::RunSweep(const Population &population, const PGA_implMessenger &source_messenger, std::string output_base):
+	_population(&population),
+	_sourceMessenger(&source_messenger),
+	_outputBase(std::move(output_base))
+{
+}
+
+void RunSweep::addConfiguration(const std::string &macro) {
+	_configurations.push_back(macro);
+}
+
+void RunSweep::readList(const std::string &list_file) {
+	std::ifstream file(list_file);
+	if(!file)
+		throw std::runtime_error("Unable to open the sweep list " + list_file);
+
+	std::string line;
+	while(std::getline(file, line)) {
+		auto first = line.find_first_not_of(" \t\r");
+		if(first == std::string::npos || line[first] == '#')
+			continue;
+		auto last = line.find_last_not_of(" \t\r");
+		addConfiguration(line.substr(first, last - first + 1));
+	}
+}
+
+std::string RunSweep::output_file(std::size_t run) const {
+	return _outputBase + "_run" + std::to_string(run);
+}
+
+void RunSweep::run() {
+	auto* ui_manager = G4UImanager::GetUIpointer();
+	G4String reset_command = _sourceMessenger->base() + "/reset";
+	_runDurations.clear();
+
+	for(std::size_t iRun = 0; iRun < _configurations.size(); ++iRun) {
+		G4Timer timer;
+		timer.Start();
+
+		// sources of the previous configuration are reset, the population is kept
+		ui_manager->ApplyCommand(reset_command);
+		ui_manager->ApplyCommand("/analysis/setFileName " + output_file(iRun));
+		ui_manager->ApplyCommand("/control/execute " + _configurations[iRun]);
+
+		timer.Stop();
+		_runDurations.push_back(timer.GetRealElapsed());
+
+		if(_population->verbose_level() > 0)
+			std::cout << "Run " << iRun << " (" << _configurations[iRun] << ") done in " << _runDurations.back() << " s\n";
+	}
+}
+
+/// \details The time saved is not measured : a cold start would set up the simulation again before each
+/// run, the saving is estimated as the setup duration for every run but the first one. The estimate is a
+/// lower bound since the first run also builds the physics tables.
+void RunSweep::printReport(std::ostream &out) const {
+	out << "Sweep of " << _runDurations.size() << " runs\n";
+	out << "  setup : " << _setupDuration << " s (population loading : " << _population->loading_duration() << " s)\n";
+	for(std::size_t iRun = 0; iRun < _runDurations.size(); ++iRun) {
+		out << "  run " << iRun << " : " << _runDurations[iRun] << " s, output " << output_file(iRun)
+		    << ", estimated saving " << (iRun > 0 ? _setupDuration : 0.) << " s\n";
+	}
+
+	double total = std::accumulate(_runDurations.begin(), _runDurations.end(), _setupDuration);
+	double saved = _runDurations.empty() ? 0. : (_runDurations.size() - 1)*_setupDuration;
+	out << "  total : " << total << " s, estimated saving compared to cold starts : " << saved << " s";
+	if(total + saved > 0)
+		out << " (" << 100.*saved/(total + saved) << " %)";
+	out << '\n';
+}
+
+}
@@ -22,37 +22,34 @@ SteppingAction::SteppingAction(const Population &population):
 void SteppingAction::UserSteppingAction(const G4Step * step) {
 	double edep = step->GetTotalEnergyDeposit();
 
-	if(edep > 0) {
+	if(edep > 0 && _population->has_g4_geometry()) {
+		UserSteppingActionFromTouchable(step);
+	} else if(edep > 0) {
 		G4ThreeVector pEdepPos = step->GetPreStepPoint()->GetPosition();
 
-		Point_3 edep_pos = Utils::myCGAL::to_CPOP(pEdepPos);
-		std::string organelle("");
-
-		if(_lastCell != nullptr && _lastCell->hasIn(edep_pos)) { // Avoid region search and findCell
-			organelle = findOrganelle(_lastCell, edep_pos);
-			addTupleRow(step, _lastCell->getID(), organelle, _lastRegion);
-		} else {
-			auto cell = findCell(edep_pos);
-			if(cell && cell->hasIn(edep_pos)) {
-				_lastCell = cell;
-				_lastRegion = findRegion(_lastCell);
-				organelle = findOrganelle(cell, edep_pos);
-				addTupleRow(step, _lastCell->getID(), organelle, _lastRegion);
-			}
-		}
+		CellLocation location = locate(Utils::myCGAL::to_CPOP(pEdepPos));
+		if(location.in_cell())
+			addTupleRow(step, *_population, location);
 	}
 }
 
+void SteppingAction::UserSteppingActionFromTouchable(const G4Step* step) {
+	CellLocation location = _population->locate(step->GetPreStepPoint()->GetTouchable());
+	if(!location.in_cell() || !_population->cell_tag(location.cell_index).sampled)
+		return;
+
+	addTupleRow(step, *_population, location);
+}
+
 const Settings::nCell::t_Cell_3* SteppingAction::findCell(const Point_3 &point) {
 	if(!_isInitialized) {
 		std::vector<const Settings::nCell::t_Cell_3*> sampled_cells = _population->sampled_cells();
 		std::vector<const Settings::nAgent::t_SpatialableAgent_3*> spatialables(sampled_cells.begin(), sampled_cells.end());
 
-		int nbCellPerNode = 2000;
-		_octree = std::make_unique<Octree<OctreeNodeForSpheroidalCell>>(
-			Utils::getBoundingBox(spatialables.begin(), spatialables.end()),
-			&spatialables,
-			nbCellPerNode);
+		// built by each Geant4 worker thread, not on the shared ThreadPool
+		_octree = std::make_unique<LinearOctree>();
+		_octree->setParallel(false);
+		_octree->build(spatialables.begin(), spatialables.end());
 		_isInitialized = true;
 	}
 	const t_SpatialableAgent_3* lNearestAgent = _octree->getNearestSpatialableAgent(point);
@@ -60,31 +57,18 @@ const Settings::nCell::t_Cell_3* SteppingAction::findCell(const Point_3 &point)
 	return dynamic_cast<const Settings::nCell::t_Cell_3*>(lNearestAgent);
 }
 
-std::string SteppingAction::findOrganelle(const Settings::nCell::t_Cell_3 *cell, const Point_3 &point) {
-	std::vector<Settings::nCell::t_Nucleus_3*> nuclei = cell->getNuclei();
-	for(auto const& itNuclei : nuclei) {
-		if(itNuclei->hasIn(point))
-			return "nucleus";
-	}
-
-	// If the point is not in the nucleus, it is in the cytoplasm
-	return "cytoplasm";
-}
-
-std::string SteppingAction::findRegion(const Settings::nCell::t_Cell_3 *cell) {
-	std::vector<SpheroidRegion> regions = _population->regions();
-	for(auto& region : regions) {
-		const std::unordered_set<const Settings::nCell::t_Cell_3*>& samples = region.sample();
-		auto found = samples.find(cell);
-
-		if(found != samples.end())
-			return region.name();
+CellLocation SteppingAction::locate(const Point_3 &point) {
+	if(_lastCell == nullptr || !_lastCell->hasIn(point)) { // Avoid findCell
+		auto cell = findCell(point);
+		if(!cell || !cell->hasIn(point))
+			return {};
+		_lastCell = cell;
 	}
 
-	throw "TODO";
+	return _population->locate(_lastCell, point);
 }
 
-void addTupleRow(const G4Step *step, int cellID, const std::string &organelle, const std::string &region) {
+void addTupleRow(const G4Step *step, const Population& population, const CellLocation& location) {
 	G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
 	double edep = step->GetTotalEnergyDeposit();
 	G4StepPoint* preStepPoint = step->GetPreStepPoint();
@@ -98,9 +82,9 @@ void addTupleRow(const G4Step *step, int cellID, const std::string &organelle, c
 	analysisManager->FillNtupleDColumn(4, momDir.y());
 	analysisManager->FillNtupleDColumn(5, momDir.z());
 	analysisManager->FillNtupleDColumn(6, edep);
-	analysisManager->FillNtupleIColumn(7, cellID);
-	analysisManager->FillNtupleSColumn(8, organelle);
-	analysisManager->FillNtupleSColumn(9, region);
+	analysisManager->FillNtupleIColumn(7, population.cells()[location.cell_index]->getID());
+	analysisManager->FillNtupleSColumn(8, organelle_name(location.organelle));
+	analysisManager->FillNtupleSColumn(9, population.region_name(location.region));
 	analysisManager->AddNtupleRow();
 }
 
@@ -18,6 +18,7 @@ static const std::string nucleusNamePrefix			= "nucleus_";
 static constexpr bool USE_THREAD_FOR_MESH_SUBDVN 	= true;   /// \brief do we want to use thread for subdivision. To optimize must be set to true, but for some profiler must be set to false.
 
 static const double overlapToleranceForG4 		= 0.00004;    // 40 nanometre. In G4
+static const double shapeSharingToleranceForG4 	= 0.000001;   // 1 nanometre. In G4. Two solids closer than this share the same G4 solid
 
 // \brief define the priority of the thread used for subdivision
 static const QThread::Priority MESHING_THREAD_PRIORITY = QThread::LowPriority;
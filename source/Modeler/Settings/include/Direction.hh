@@ -1,3 +1,6 @@
+#ifndef DIRECTION_HH
+#define DIRECTION_HH
+
 /// \brief Direction definition
 enum Direction {
 	LEFT,   ///< \brief x -
@@ -7,3 +10,5 @@ enum Direction {
 	BOTTOM, ///< \brief z -
 	TOP     ///< \brief z +
 };
+
+#endif
@@ -4,6 +4,9 @@
 #include "CellSettings.hh"
 #include "MeshOutFormats.hh"
 
+#include <cstdint>
+#include <ostream>
+#include <string>
 #include <vector>
 
 using namespace Settings::nCell;
@@ -13,12 +16,81 @@ using namespace Settings::nCell;
 /// @author Henri Payno
 namespace Statistics {
 
-/// \brief export cell meshes statistics to the given ofstream
-bool generateMeshStats(std::vector<const t_Cell_3*> pCells, MeshOutFormats::outputFormat pFormat, std::ofstream* pCellOut=nullptr, std::ofstream* pNucleiOut=nullptr);
+/// \brief the metrics which can be exported, to combine as flags
+enum MeshMetric : unsigned int {
+	CELL_DESCRIPTION		= 1 << 0,	///< \brief cell stats data (ID, type, state, mass, age, position...)
+	CELL_MESH_VOLUME		= 1 << 1,	///< \brief volume of the membrane mesh
+	CYTOPLASM_MESH_VOLUME	= 1 << 2,	///< \brief volume of the membrane mesh minus the nuclei mesh volumes
+	CELL_MESH_SURFACE		= 1 << 3,	///< \brief area of the membrane mesh (spheroidal cells only, -1 otherwise)
+	NB_NUCLEI				= 1 << 4,	///< \brief number of nuclei of the cell
+	NUCLEUS_DESCRIPTION		= 1 << 5,	///< \brief nucleus stats data (radius...)
+	NUCLEUS_MESH_VOLUME		= 1 << 6,	///< \brief volume of the nucleus mesh
+
+	/// \brief the metrics of the cell file
+	CELL_METRICS = CELL_DESCRIPTION | CELL_MESH_VOLUME | CYTOPLASM_MESH_VOLUME | CELL_MESH_SURFACE | NB_NUCLEI,
+	/// \brief the metrics of the nuclei file
+	NUCLEUS_METRICS = NUCLEUS_DESCRIPTION | NUCLEUS_MESH_VOLUME,
+	/// \brief the columns historically exported
+	DEFAULT_METRICS = CELL_DESCRIPTION | CELL_MESH_VOLUME | CYTOPLASM_MESH_VOLUME | NUCLEUS_DESCRIPTION | NUCLEUS_MESH_VOLUME,
+	ALL_METRICS = CELL_METRICS | NUCLEUS_METRICS
+};
+
+/// \brief the layout of the statistic files
+enum StatsFileFormat {
+	TEXT,	///< \brief tab separated values, headers starting with "###"
+	CSV,	///< \brief comma separated values, a single header line
+	BINARY	///< \brief column major binary file, cf. writeBinaryStats
+};
+
+/// \brief per cell and per nucleus metrics, stored by column.
+/// \details Only the columns of the requested metrics are filled. The nuclei of the cell i are the rows
+/// [nucleiOffsets[i], nucleiOffsets[i+1]) of the nucleus columns. The descriptions are kept as text and as one
+/// column of values per field of their header.
+struct MeshStatsTable {
+	unsigned int metrics = 0;						///< \brief the metrics computed
+	std::string cellDescriptionHeader;				///< \brief names of the cell description fields, tab separated
+	std::string nucleusDescriptionHeader;			///< \brief names of the nucleus description fields, tab separated
+
+	std::vector<std::uint64_t> cellIDs;				///< \brief ID of each cell
+	std::vector<std::string> cellDescriptions;		///< \brief description of each cell, tab separated
+	std::vector<std::vector<double>> cellDescriptionValues;	///< \brief values of the cell descriptions, by field
+	std::vector<double> cellMeshVolumes;			///< \brief membrane mesh volume of each cell
+	std::vector<double> cytoplasmMeshVolumes;		///< \brief cytoplasm mesh volume of each cell
+	std::vector<double> cellMeshSurfaces;			///< \brief membrane mesh area of each cell
+	std::vector<std::size_t> nucleiOffsets;			///< \brief index of the first nucleus of each cell, plus the total
+
+	std::vector<std::uint64_t> nucleusCellIDs;		///< \brief ID of the cell owning each nucleus
+	std::vector<std::string> nucleusDescriptions;	///< \brief description of each nucleus, tab separated
+	std::vector<std::vector<double>> nucleusDescriptionValues;	///< \brief values of the nucleus descriptions, by field
+	std::vector<double> nucleusMeshVolumes;			///< \brief mesh volume of each nucleus
+
+	/// \brief return the number of cells
+	[[nodiscard]] std::size_t getNbCell() const { return cellIDs.size(); }
+	/// \brief return the number of nuclei
+	[[nodiscard]] std::size_t getNbNucleus() const { return nucleusCellIDs.size(); }
+};
+
+/// \brief compute the requested metrics of the cells, in parallel
+MeshStatsTable computeMeshStats(const std::vector<const t_Cell_3*>& pCells, MeshOutFormats::outputFormat pFormat, unsigned int pMetrics = DEFAULT_METRICS);
+/// \brief export cell meshes statistics to the given streams
+bool generateMeshStats(
+	const std::vector<const t_Cell_3*>& pCells,
+	MeshOutFormats::outputFormat pFormat,
+	std::ostream* pCellOut = nullptr,
+	std::ostream* pNucleiOut = nullptr,
+	unsigned int pMetrics = DEFAULT_METRICS,
+	StatsFileFormat pFileFormat = TEXT
+);
+/// \brief write the cell columns of the table
+bool writeCellStats(const MeshStatsTable&, MeshOutFormats::outputFormat pFormat, StatsFileFormat pFileFormat, std::ostream& pOut);
+/// \brief write the nucleus columns of the table
+bool writeNucleiStats(const MeshStatsTable&, MeshOutFormats::outputFormat pFormat, StatsFileFormat pFileFormat, std::ostream& pOut);
 /// \brief create header fot the cell statistic file
-void writeCellStatsHeader(MeshOutFormats::outputFormat pFormat, std::ofstream* pOut);
+void writeCellStatsHeader(MeshOutFormats::outputFormat pFormat, std::ostream* pOut);
 /// \brief create header fot the cell nuclei statistic file
-void writeCellNucleiStatsHeader(MeshOutFormats::outputFormat pFormat, std::ofstream* pOut);
+void writeCellNucleiStatsHeader(MeshOutFormats::outputFormat pFormat, std::ostream* pOut);
+/// \brief return the extension of the statistic files for the given layout
+std::string getStatsFileExtension(StatsFileFormat);
 }
 
 #endif
@@ -2,6 +2,7 @@
 #define STATS_DATA_EMITTER_HH
 
 #include <string>
+#include <vector>
 
 /// \brief The StatsDataEmitter interface
 /// This is implemented by statistical "informer". That mean thaht the daughter
@@ -13,6 +14,8 @@ public:
 
 	/// \brief define importante data to be treated
 	[[nodiscard]] virtual std::string addStatsData() const = 0;
+	/// \brief the values of addStatsData, as numbers
+	[[nodiscard]] virtual std::vector<double> getStatsValues() const = 0;
 	/// \brief inform about the statistics exported by the meitter
 	[[nodiscard]] virtual std::string writeStatsHeader() const = 0;
 };
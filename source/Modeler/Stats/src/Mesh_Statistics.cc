@@ -1,22 +1,288 @@
 #include "Mesh_Statistics.hh"
 
+#include "File_Utils.hh"
 #include "InformationSystemManager.hh"
-#include "SimpleSpheroidalCell.hh"
+#include "SpheroidalCell.hh"
 #include "StatsDataEmitter.hh"
+#include "StatsSettings.hh"
+#include "ThreadPool.hh"
 
-#include <fstream>	// needed to call the << operator on ofstream
+#include <algorithm>
+#include <cassert>
+#include <limits>
 
 namespace Statistics {
 
+namespace {
+
+/// \brief minimal number of cells computed by a block of parallelFor
+constexpr std::size_t MIN_NB_CELL_PER_STATS_BLOCK = 16;
+/// \brief first bytes of a binary statistic file
+constexpr char stats_magic[8] = {'C', 'P', 'O', 'P', 'S', 'T', 'A', 'T'};
+/// \brief version of the binary layout, to increment on each change
+constexpr std::uint32_t stats_version = 1;
+
+/// \brief a column of the table to write, exactly one of ids, values and texts is set
+struct Column {
+	std::string name;									///< \brief name of the column, tab separated names for descriptions
+	const std::vector<std::uint64_t>* ids = nullptr;	///< \brief integer values
+	const std::vector<double>* values = nullptr;		///< \brief real values
+	const std::vector<std::string>* texts = nullptr;	///< \brief tab separated descriptions
+	const std::vector<std::vector<double>>* fields = nullptr;	///< \brief values of the descriptions, by field
+};
+
+void message(std::string const& pMessage) {
+	InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES, pMessage, "Statistics::generateMeshStats");
+}
+
+/// \brief split the tab separated fields, spaces around the fields are removed
+std::vector<std::string> splitFields(std::string const& pText) {
+	std::vector<std::string> fields;
+	std::size_t begin = 0;
+	while(true) {
+		std::size_t end = pText.find('\t', begin);
+		std::string field = pText.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+		std::size_t first = field.find_first_not_of(' ');
+		std::size_t last = field.find_last_not_of(' ');
+		fields.push_back(first == std::string::npos ? std::string() : field.substr(first, last - first + 1));
+		if(end == std::string::npos)
+			return fields;
+		begin = end + 1;
+	}
+}
+
+/// \brief append the names of the columns, descriptions expanded, with the given separator
+void appendNames(std::vector<Column> const& pColumns, char pSeparator, std::string& pBuffer) {
+	for(std::size_t iColumn = 0; iColumn < pColumns.size(); ++iColumn) {
+		if(iColumn > 0)
+			pBuffer += pSeparator;
+		if(pSeparator == '\t') {
+			pBuffer += pColumns[iColumn].name;
+			continue;
+		}
+		auto const& names = splitFields(pColumns[iColumn].name);
+		for(std::size_t iName = 0; iName < names.size(); ++iName) {
+			if(iName > 0)
+				pBuffer += pSeparator;
+			pBuffer += names[iName];
+		}
+	}
+	pBuffer += '\n';
+}
+
+/// \brief append a row of the columns with the given separator
+void appendRow(std::vector<Column> const& pColumns, std::size_t pRow, char pSeparator, std::string& pBuffer) {
+	for(std::size_t iColumn = 0; iColumn < pColumns.size(); ++iColumn) {
+		if(iColumn > 0)
+			pBuffer += pSeparator;
+		auto const& column = pColumns[iColumn];
+		if(column.ids) {
+			pBuffer += std::to_string((*column.ids)[pRow]);
+		} else if(column.values) {
+			IO::appendNumber(pBuffer, (*column.values)[pRow]);
+		} else {
+			std::size_t begin = pBuffer.size();
+			pBuffer += (*column.texts)[pRow];
+			if(pSeparator != '\t')
+				std::replace(pBuffer.begin() + static_cast<std::ptrdiff_t>(begin), pBuffer.end(), '\t', pSeparator);
+		}
+	}
+	pBuffer += '\n';
+}
+
+/// \brief write the columns as text, rows are serialized in parallel
+void writeText(std::vector<Column> const& pColumns, std::size_t pNbRow, char pSeparator, std::ostream& pOut) {
+	std::string names = pSeparator == '\t' ? "###" : "";
+	appendNames(pColumns, pSeparator, names);
+	pOut << names;
+	IO::writeInParallel(pOut, pNbRow, [&](std::size_t pRow, std::string& pBuffer) {
+		appendRow(pColumns, pRow, pSeparator, pBuffer);
+	});
+}
+
+/// \brief write the columns in the binary layout
+/// \details the layout, in the native byte order, is :
+/// - "CPOPSTAT", the version (uint32), the mesh format (uint32), the number of rows (uint64) and of columns (uint32);
+/// - for each column : the length of its name (uint32), the name and the type of its values (uint8, 0 : uint64, 1 : double);
+/// - the values of each column, column after column.
+/// Each field of the descriptions is a double column.
+bool writeBinary(std::vector<Column> const& pColumns, std::size_t pNbRow, MeshOutFormats::outputFormat pFormat, std::ostream& pOut) {
+	std::vector<std::string> names;
+	std::vector<std::uint8_t> types;
+	std::vector<const void*> data;
+	for(auto const& column : pColumns) {
+		if(column.ids || column.values) {
+			names.push_back(column.name);
+			types.push_back(column.ids ? 0 : 1);
+			data.push_back(column.ids ? static_cast<const void*>(column.ids->data()) : column.values->data());
+			continue;
+		}
+
+		auto const& fieldNames = splitFields(column.name);
+		if(!column.fields || column.fields->size() != fieldNames.size()) {
+			message("the descriptions do not match their header, unable to write binary statistics");
+			return false;
+		}
+		for(std::size_t iField = 0; iField < fieldNames.size(); ++iField) {
+			assert((*column.fields)[iField].size() == pNbRow);
+			names.push_back(fieldNames[iField]);
+			types.push_back(1);
+			data.push_back((*column.fields)[iField].data());
+		}
+	}
+
+	std::string buffer;
+	auto put = [&buffer](auto const& pValue) {
+		buffer.append(reinterpret_cast<const char*>(&pValue), sizeof(pValue));
+	};
+	buffer.reserve(64 + names.size()*(16 + pNbRow*sizeof(double)));
+	buffer.append(stats_magic, sizeof(stats_magic));
+	put(stats_version);
+	put(static_cast<std::uint32_t>(pFormat));
+	put(static_cast<std::uint64_t>(pNbRow));
+	put(static_cast<std::uint32_t>(names.size()));
+	for(std::size_t iColumn = 0; iColumn < names.size(); ++iColumn) {
+		put(static_cast<std::uint32_t>(names[iColumn].size()));
+		buffer += names[iColumn];
+		put(types[iColumn]);
+	}
+	// uint64 and double have the same size
+	for(auto const* values : data)
+		buffer.append(static_cast<const char*>(values), pNbRow*sizeof(double));
+
+	pOut.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	return static_cast<bool>(pOut);
+}
+
+/// \brief store the values of a description in the row of the field columns, missing values are NaN
+void setDescriptionValues(std::vector<double> const& pValues, std::size_t pRow, std::vector<std::vector<double>>& pFields) {
+	for(std::size_t iField = 0; iField < pFields.size(); ++iField)
+		pFields[iField][pRow] = iField < pValues.size() ? pValues[iField] : std::numeric_limits<double>::quiet_NaN();
+}
+
+/// \brief write the columns with the requested layout
+bool writeColumns(std::vector<Column> const& pColumns, std::size_t pNbRow, MeshOutFormats::outputFormat pFormat, StatsFileFormat pFileFormat, std::ostream& pOut) {
+	switch(pFileFormat) {
+		case TEXT:
+			writeText(pColumns, pNbRow, '\t', pOut);
+			return static_cast<bool>(pOut);
+		case CSV:
+			writeText(pColumns, pNbRow, ',', pOut);
+			return static_cast<bool>(pOut);
+		case BINARY:
+			return writeBinary(pColumns, pNbRow, pFormat, pOut);
+		default:
+			message("Unknown statistic file format");
+			return false;
+	}
+}
+
+}
+
+/// \param pCells The cells we want the metrics for
+/// \param pFormat The mesh format we want the stats for
+/// \param pMetrics The metrics to compute (MeshMetric flags)
+/// \details The cells are computed by blocks in parallel, each cell writing its own rows of the columns. Each volume
+/// is computed once even if used by several metrics, the costly metrics not requested are not computed.
+/// \return The table of the metrics, in the order of the cells
+MeshStatsTable computeMeshStats(const std::vector<const t_Cell_3*>& pCells, MeshOutFormats::outputFormat pFormat, unsigned int pMetrics) {
+	MeshStatsTable table;
+	table.metrics = pMetrics;
+
+	std::size_t nbCell = pCells.size();
+	table.cellIDs.resize(nbCell);
+	table.nucleiOffsets.assign(nbCell + 1, 0);
+	for(std::size_t iCell = 0; iCell < nbCell; ++iCell) {
+		assert(pCells[iCell]);
+		auto const& nuclei = pCells[iCell]->getNuclei();
+		table.nucleiOffsets[iCell + 1] = table.nucleiOffsets[iCell] + nuclei.size();
+		if(table.nucleusDescriptionHeader.empty() && !nuclei.empty())
+			table.nucleusDescriptionHeader = nuclei.front()->writeStatsHeader();
+	}
+	std::size_t nbNucleus = table.nucleiOffsets.back();
+	table.nucleusCellIDs.resize(nbNucleus);
+	if(nbCell > 0)
+		table.cellDescriptionHeader = pCells.front()->writeStatsHeader();
+
+	bool needCellVolume = pMetrics & (CELL_MESH_VOLUME | CYTOPLASM_MESH_VOLUME);
+	bool needNucleusVolume = pMetrics & (NUCLEUS_MESH_VOLUME | CYTOPLASM_MESH_VOLUME);
+	if(pMetrics & CELL_DESCRIPTION) {
+		table.cellDescriptions.resize(nbCell);
+		table.cellDescriptionValues.assign(splitFields(table.cellDescriptionHeader).size(), std::vector<double>(nbCell));
+	}
+	if(needCellVolume)
+		table.cellMeshVolumes.resize(nbCell);
+	if(pMetrics & CYTOPLASM_MESH_VOLUME)
+		table.cytoplasmMeshVolumes.resize(nbCell);
+	if(pMetrics & CELL_MESH_SURFACE)
+		table.cellMeshSurfaces.resize(nbCell);
+	if(pMetrics & NUCLEUS_DESCRIPTION) {
+		table.nucleusDescriptions.resize(nbNucleus);
+		if(!table.nucleusDescriptionHeader.empty())
+			table.nucleusDescriptionValues.assign(splitFields(table.nucleusDescriptionHeader).size(), std::vector<double>(nbNucleus));
+	}
+	if(needNucleusVolume)
+		table.nucleusMeshVolumes.resize(nbNucleus);
+
+	ThreadPool::getInstance()->parallelFor(nbCell, [&](std::size_t pBegin, std::size_t pEnd) {
+		for(std::size_t iCell = pBegin; iCell < pEnd; ++iCell) {
+			const t_Cell_3* cell = pCells[iCell];
+			std::uint64_t lID = cell->getID();
+			table.cellIDs[iCell] = lID;
+			if(pMetrics & CELL_DESCRIPTION) {
+				table.cellDescriptions[iCell] = cell->addStatsData();
+				setDescriptionValues(cell->getStatsValues(), iCell, table.cellDescriptionValues);
+			}
+			// the volume is dependant of the mesh type
+			if(needCellVolume)
+				table.cellMeshVolumes[iCell] = cell->getMeshVolume(pFormat);
+			if(pMetrics & CELL_MESH_SURFACE) {
+				auto const* spheroidalCell = dynamic_cast<const SpheroidalCell*>(cell);
+				table.cellMeshSurfaces[iCell] = spheroidalCell ? spheroidalCell->getMembraneMeshSurfaceArea() : -1.;
+			}
+
+			double nucleiVolume = 0.;
+			std::size_t iNucleus = table.nucleiOffsets[iCell];
+			for(auto const* nucleus : cell->getNuclei()) {
+				table.nucleusCellIDs[iNucleus] = lID;
+				if(pMetrics & NUCLEUS_DESCRIPTION) {
+					table.nucleusDescriptions[iNucleus] = nucleus->addStatsData();
+					setDescriptionValues(nucleus->getStatsValues(), iNucleus, table.nucleusDescriptionValues);
+				}
+				if(needNucleusVolume) {
+					table.nucleusMeshVolumes[iNucleus] = nucleus->getMeshVolume(pFormat);
+					nucleiVolume += table.nucleusMeshVolumes[iNucleus];
+				}
+				++iNucleus;
+			}
+
+			// cytoplasm mesh volume = cell mesh volume - nuclei mesh volume
+			if(pMetrics & CYTOPLASM_MESH_VOLUME)
+				table.cytoplasmMeshVolumes[iCell] = table.cellMeshVolumes[iCell] - nucleiVolume;
+		}
+	}, MIN_NB_CELL_PER_STATS_BLOCK);
+
+	return table;
+}
+
 /// \param pCells The cells we want to export the stats for
 /// \param pFormat The mesh format we want the stats for (needed bacause can changed from a format to an other
 /// 						(specially external format, the one we dont keep a copy for, cf Geant4) )
 /// \param pCellOut The stats output target for cell
 /// \param pNucleiOut The stats output target for cell nuclei
+/// \param pMetrics The metrics to export (MeshMetric flags), the ones of a missing output are not computed
+/// \param pFileFormat The layout of the output files
 /// \warning this data exporter start from principal that each cell will export the same type of data ( == all cells are the same type : spheroidal...)
 /// \return True if sucess
-bool generateMeshStats(std::vector<const t_Cell_3*> pCells, MeshOutFormats::outputFormat pFormat, std::ofstream* pCellOut, std::ofstream* pNucleiOut) {
-	if(pCells.size() == 0)
+bool generateMeshStats(
+	const std::vector<const t_Cell_3*>& pCells,
+	MeshOutFormats::outputFormat pFormat,
+	std::ostream* pCellOut,
+	std::ostream* pNucleiOut,
+	unsigned int pMetrics,
+	StatsFileFormat pFileFormat
+) {
+	if(pCells.empty())
 		return true;
 
 	if(pFormat > MeshOutFormats::Unknow) {
@@ -28,64 +294,95 @@ bool generateMeshStats(std::vector<const t_Cell_3*> pCells, MeshOutFormats::outp
 		return false;
 	}
 
-	/// write cell header
-	if(pCellOut) {
-		writeCellStatsHeader(pFormat, pCellOut);
-		*pCellOut << "###" << (*pCells.begin())->writeStatsHeader() << "\tcellMeshVolume\tcytoplasmMeshVolume" << std::endl;
-	}
-
-	/// write cell nuclei header
-	if(pNucleiOut) {
-		writeCellNucleiStatsHeader(pFormat, pNucleiOut);
-		if(dynamic_cast<const SimpleSpheroidalCell*>(*pCells.begin()))
-			*pNucleiOut << "###" << "CellID\t" << dynamic_cast<const SimpleSpheroidalCell*>(*pCells.begin())->getNucleus()->writeStatsHeader() << "\tmeshVolume" << std::endl;
-	}
-
-	/// then write statistic for cell and is nucleus
-	for(auto const& pCell : pCells) {
-		assert(pCell);
-		// print cell mesh stats
-		if(pCellOut) {
-			*pCellOut << pCell->addStatsData()  << "\t"
-				// cell volume mesh
-				<< pCell->getMeshVolume(pFormat) << "\t"; // add the volume here because is dependant of the mesh type
-		}
+	if(!pCellOut)
+		pMetrics &= ~static_cast<unsigned int>(CELL_METRICS);
+	if(!pNucleiOut)
+		pMetrics &= ~static_cast<unsigned int>(NUCLEUS_METRICS);
 
-		unsigned long int lID = pCell->getID();
-		auto const& nuclei = pCell->getNuclei();
+	MeshStatsTable table = computeMeshStats(pCells, pFormat, pMetrics);
 
-		double nucleiVolume = 0.;
+	bool succeed = true;
+	if(pCellOut)
+		succeed = writeCellStats(table, pFormat, pFileFormat, *pCellOut) && succeed;
+	if(pNucleiOut)
+		succeed = writeNucleiStats(table, pFormat, pFileFormat, *pNucleiOut) && succeed;
+	return succeed;
+}
 
-		for(auto const& itNucleus : nuclei) {
-			// print nuclei mesh stats
-			if(pNucleiOut) {
-				*pNucleiOut	<< lID << "\t"
-					<< itNucleus->addStatsData() << "\t"
-					<< itNucleus->getMeshVolume(pFormat) << std::endl;
-			}
+/// \param pTable The computed metrics
+/// \param pFormat The mesh format the metrics have been computed for
+/// \param pFileFormat The layout of the file
+/// \param pOut Where to write the statistics
+/// \details The cell ID is always exported, as part of the cell description or as first column.
+/// \return True if sucess
+bool writeCellStats(const MeshStatsTable& pTable, MeshOutFormats::outputFormat pFormat, StatsFileFormat pFileFormat, std::ostream& pOut) {
+	std::vector<std::uint64_t> nbNuclei;
+	std::vector<Column> columns;
+	if(pTable.metrics & CELL_DESCRIPTION)
+		columns.push_back({pTable.cellDescriptionHeader, nullptr, nullptr, &pTable.cellDescriptions, &pTable.cellDescriptionValues});
+	else
+		columns.push_back({Settings::Statistics::Cell_ID_flag, &pTable.cellIDs, nullptr, nullptr});
+	if(pTable.metrics & CELL_MESH_VOLUME)
+		columns.push_back({"cellMeshVolume", nullptr, &pTable.cellMeshVolumes, nullptr});
+	if(pTable.metrics & CYTOPLASM_MESH_VOLUME)
+		columns.push_back({"cytoplasmMeshVolume", nullptr, &pTable.cytoplasmMeshVolumes, nullptr});
+	if(pTable.metrics & CELL_MESH_SURFACE)
+		columns.push_back({"cellMeshSurface", nullptr, &pTable.cellMeshSurfaces, nullptr});
+	if(pTable.metrics & NB_NUCLEI) {
+		nbNuclei.resize(pTable.getNbCell());
+		for(std::size_t iCell = 0; iCell < nbNuclei.size(); ++iCell)
+			nbNuclei[iCell] = pTable.nucleiOffsets[iCell + 1] - pTable.nucleiOffsets[iCell];
+		columns.push_back({"nbNuclei", &nbNuclei, nullptr, nullptr});
+	}
 
-			nucleiVolume += itNucleus->getMeshVolume(pFormat);
-		}
+	if(pFileFormat == TEXT)
+		writeCellStatsHeader(pFormat, &pOut);
+	return writeColumns(columns, pTable.getNbCell(), pFormat, pFileFormat, pOut);
+}
 
-		if(pCellOut) {
-			// cytoplasm mesh volume - nuclei mesh volume
-			*pCellOut << ( pCell->getMeshVolume(pFormat) - nucleiVolume ) << std::endl;
-		}
-	}
+/// \param pTable The computed metrics
+/// \param pFormat The mesh format the metrics have been computed for
+/// \param pFileFormat The layout of the file
+/// \param pOut Where to write the statistics
+/// \details The ID of the cell owning the nucleus is always exported as first column.
+/// \return True if sucess
+bool writeNucleiStats(const MeshStatsTable& pTable, MeshOutFormats::outputFormat pFormat, StatsFileFormat pFileFormat, std::ostream& pOut) {
+	std::vector<Column> columns;
+	columns.push_back({"CellID", &pTable.nucleusCellIDs, nullptr, nullptr});
+	if((pTable.metrics & NUCLEUS_DESCRIPTION) && !pTable.nucleusDescriptionHeader.empty())
+		columns.push_back({pTable.nucleusDescriptionHeader, nullptr, nullptr, &pTable.nucleusDescriptions, &pTable.nucleusDescriptionValues});
+	if(pTable.metrics & NUCLEUS_MESH_VOLUME)
+		columns.push_back({"meshVolume", nullptr, &pTable.nucleusMeshVolumes, nullptr});
 
-	return true;
+	if(pFileFormat == TEXT)
+		writeCellNucleiStatsHeader(pFormat, &pOut);
+	return writeColumns(columns, pTable.getNbNucleus(), pFormat, pFileFormat, pOut);
 }
 
 /// \param pFormat the format for which we want to export stats
 /// \param pOut where to redirect statistics
-void writeCellStatsHeader(MeshOutFormats::outputFormat pFormat, std::ofstream* pOut) {
+void writeCellStatsHeader(MeshOutFormats::outputFormat pFormat, std::ostream* pOut) {
 	*pOut << "### file generated by cpop for cell meshes statistics. Unit is micro meter. Mesh format is : " << getFormatName(pFormat).toStdString() << "### \n";
 }
 
 /// \param pFormat the format for which we want to export stats
 /// \param pOut where to redirect statistics
-void writeCellNucleiStatsHeader(MeshOutFormats::outputFormat pFormat, std::ofstream* pOut) {
+void writeCellNucleiStatsHeader(MeshOutFormats::outputFormat pFormat, std::ostream* pOut) {
 	*pOut << "### file generated by cpop for cell Nuclei meshes statistics. Unit is micro meter. Mesh format is : " << getFormatName(pFormat).toStdString() << "### \n";
 }
 
+/// \param pFileFormat the layout of the files
+/// \return the extension of the files, ".cpop.stats" for the text layout
+std::string getStatsFileExtension(StatsFileFormat pFileFormat) {
+	switch(pFileFormat) {
+		case CSV:
+			return ".cpop.stats.csv";
+		case BINARY:
+			return ".cpop.stats.bin";
+		case TEXT:
+		default:
+			return ".cpop.stats";
+	}
+}
+
 }
@@ -0,0 +1,63 @@
+#ifndef SLICER_HH
+#define SLICER_HH
+
+#include "CellSettings.hh"
+#include "Direction.hh"
+#include "SpheroidalCell.hh"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Settings::Geometry;
+using namespace Settings::nCell;
+
+/// \brief Slicer_3 class produces 2D sections of meshed spheroidal cells by planes orthogonal to an axis.
+/// \details Cells are sorted by their extent along the axis, only the cells crossing a plane are cut.
+/// Cells are cut in parallel, a stack of equally spaced slices is produced in one sweep along the axis.
+/// Sections are given in the plane coordinates : (y, z) for the x axis, (x, z) for y and (x, y) for z.
+class Slicer_3 {
+public:
+	/// \brief the section of a cell by a plane
+	struct CellSection {
+		unsigned long int cellID;                                      ///< \brief the ID of the cut cell
+		std::vector<std::pair<Point_2, Point_2>> membrane;             ///< \brief the segments of the membrane section
+		std::vector<std::pair<Point_2, double>> nuclei;                ///< \brief the nuclei sections, center and radius
+	};
+
+	/// \param pCells The meshed cells to slice
+	/// \param pDirection The slicing axis, LEFT and RIGHT give x, BACK and FRONT y, BOTTOM and TOP z
+	Slicer_3(std::vector<SpheroidalCell*> pCells, Direction pDirection);
+
+	/// \brief return the section of all cells crossing the plane at the given value of the axis
+	[[nodiscard]] std::vector<CellSection> cut(double) const;
+	/// \brief write pNbSlice equally spaced slices between the two values, one file per slice
+	unsigned int exportSlices(std::string const& pPath, double pFirst, double pLast, unsigned int pNbSlice) const;
+
+	/// \brief set the number of threads cutting the cells
+	void setNbThread(unsigned int pNbThread) { _nbThread = std::max(1u, pNbThread); }
+	/// \brief the smallest value of the axis reached by a cell
+	[[nodiscard]] double getMin() const;
+	/// \brief the largest value of the axis reached by a cell
+	[[nodiscard]] double getMax() const;
+
+	/// \brief return the section of a cell by the plane at the given value of the axis
+	[[nodiscard]] static CellSection getSection(SpheroidalCell*, unsigned int pAxis, double pValue);
+	/// \brief append the section to a buffer, as written in the slice files
+	static void appendSection(std::string&, const CellSection&);
+
+private:
+	/// \brief a cell and its extent along the axis
+	struct Extent {
+		double min;          ///< \brief smallest value of the axis reached by the cell membrane
+		double max;          ///< \brief largest value of the axis reached by the cell membrane
+		SpheroidalCell* cell; ///< \brief the cell
+	};
+
+	std::vector<Extent> _extents;   ///< \brief the cells sorted by their smallest value along the axis
+	unsigned int _axis;             ///< \brief index of the slicing axis (0 : x, 1 : y, 2 : z)
+	unsigned int _nbThread;         ///< \brief number of threads cutting the cells
+};
+
+#endif // SLICER_HH
@@ -0,0 +1,232 @@
+#include "Slicer_3.hh"
+
+#include "File_Utils.hh"
+#include "InformationSystemManager.hh"
+#include "RoundNucleus.hh"
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+namespace {
+
+/// \brief return the index of the axis orthogonal to the slices
+unsigned int getAxis(Direction pDirection) {
+	switch(pDirection) {
+		case LEFT:
+		case RIGHT:
+			return 0;
+		case BACK:
+		case FRONT:
+			return 1;
+		default:
+			return 2;
+	}
+}
+
+/// \brief project a point on the slicing plane
+Point_2 project(const Point_3& pPoint, unsigned int pAxis) {
+	switch(pAxis) {
+		case 0:
+			return {pPoint.y(), pPoint.z()};
+		case 1:
+			return {pPoint.x(), pPoint.z()};
+		default:
+			return {pPoint.x(), pPoint.y()};
+	}
+}
+
+/// \brief return the intersection of the segment [a, b] with the plane, da and db are the signed distances to it
+Point_2 interpolate(const Point_3& a, const Point_3& b, double da, double db, unsigned int pAxis) {
+	double t = da / (da - db);
+	return project(a + t*(b - a), pAxis);
+}
+
+}
+
+Slicer_3::Slicer_3(std::vector<SpheroidalCell*> pCells, Direction pDirection):
+	_axis(getAxis(pDirection)),
+	_nbThread(IO::getNbExportThread())
+{
+	_extents.reserve(pCells.size());
+	for(auto* cell : pCells) {
+		if(!cell->hasMesh()) {
+			InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES,
+				"cell " + std::to_string(cell->getID()) + " has no mesh, it will not be sliced", "Slicer_3");
+			continue;
+		}
+
+		Extent extent{std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(), cell};
+		for(auto const& point : cell->getMembranePoints()) {
+			extent.min = std::min(extent.min, point.cartesian(static_cast<int>(_axis)));
+			extent.max = std::max(extent.max, point.cartesian(static_cast<int>(_axis)));
+		}
+		_extents.push_back(extent);
+	}
+
+	std::stable_sort(_extents.begin(), _extents.end(), [](const Extent& a, const Extent& b) { return a.min < b.min; });
+}
+
+double Slicer_3::getMin() const {
+	return _extents.empty() ? 0. : _extents.front().min;
+}
+
+double Slicer_3::getMax() const {
+	auto itMax = std::max_element(_extents.begin(), _extents.end(), [](const Extent& a, const Extent& b) { return a.max < b.max; });
+	return itMax == _extents.end() ? 0. : itMax->max;
+}
+
+/// \param pCell The cell to cut, must be meshed
+/// \param pAxis The index of the axis orthogonal to the plane
+/// \param pValue The position of the plane on the axis
+/// \return the section, empty if the plane does not cross the cell
+Slicer_3::CellSection Slicer_3::getSection(SpheroidalCell* pCell, unsigned int pAxis, double pValue) {
+	CellSection section{pCell->getID(), {}, {}};
+	auto axis = static_cast<int>(pAxis);
+
+	for(auto const& triangle : pCell->getMembraneTriangles()) {
+		const Point_3& p0 = triangle.vertex(0);
+		const Point_3& p1 = triangle.vertex(1);
+		const Point_3& p2 = triangle.vertex(2);
+		double d0 = p0.cartesian(axis) - pValue;
+		double d1 = p1.cartesian(axis) - pValue;
+		double d2 = p2.cartesian(axis) - pValue;
+
+		// vertices on the plane are considered above it, a facet is crossed by exactly two of its edges
+		bool s0 = d0 >= 0.;
+		bool s1 = d1 >= 0.;
+		bool s2 = d2 >= 0.;
+		if(s0 == s1 && s1 == s2)
+			continue;
+
+		if(s0 == s1)
+			section.membrane.emplace_back(interpolate(p1, p2, d1, d2, pAxis), interpolate(p2, p0, d2, d0, pAxis));
+		else if(s1 == s2)
+			section.membrane.emplace_back(interpolate(p0, p1, d0, d1, pAxis), interpolate(p2, p0, d2, d0, pAxis));
+		else
+			section.membrane.emplace_back(interpolate(p0, p1, d0, d1, pAxis), interpolate(p1, p2, d1, d2, pAxis));
+	}
+
+	for(auto const* nucleus : pCell->getNuclei()) {
+		auto const* roundNucleus = dynamic_cast<const t_RoundNucleus_3*>(nucleus);
+		if(!roundNucleus)
+			continue;
+
+		double distance = roundNucleus->getOrigin().cartesian(axis) - pValue;
+		double radius = roundNucleus->getRadius();
+		if(std::abs(distance) < radius)
+			section.nuclei.emplace_back(project(roundNucleus->getOrigin(), pAxis), std::sqrt(radius*radius - distance*distance));
+	}
+
+	return section;
+}
+
+/// \details The section is written as :
+/// cell <ID>
+/// m <x1> <y1> <x2> <y2>	(for each segment of the membrane)
+/// n <x> <y> <radius>		(for each nucleus)
+/// \param pOut The string to append to
+/// \param pSection The section to append
+void Slicer_3::appendSection(std::string& pOut, const CellSection& pSection) {
+	pOut += "cell ";
+	pOut += std::to_string(pSection.cellID);
+	pOut += '\n';
+
+	for(auto const& segment : pSection.membrane) {
+		pOut += "m ";
+		IO::appendNumber(pOut, segment.first.x());
+		pOut += ' ';
+		IO::appendNumber(pOut, segment.first.y());
+		pOut += ' ';
+		IO::appendNumber(pOut, segment.second.x());
+		pOut += ' ';
+		IO::appendNumber(pOut, segment.second.y());
+		pOut += '\n';
+	}
+
+	for(auto const& nucleus : pSection.nuclei) {
+		pOut += "n ";
+		IO::appendNumber(pOut, nucleus.first.x());
+		pOut += ' ';
+		IO::appendNumber(pOut, nucleus.first.y());
+		pOut += ' ';
+		IO::appendNumber(pOut, nucleus.second);
+		pOut += '\n';
+	}
+}
+
+/// \param pValue The position of the plane on the axis
+/// \return the sections of the cells crossing the plane, ordered by the smallest value of the cells along the axis
+std::vector<Slicer_3::CellSection> Slicer_3::cut(double pValue) const {
+	// cells are sorted by their min, the ones after the first min above the value can't be crossed
+	auto end = std::upper_bound(_extents.begin(), _extents.end(), pValue,
+		[](double value, const Extent& extent) { return value < extent.min; });
+
+	std::vector<const Extent*> crossed;
+	for(auto itExtent = _extents.begin(); itExtent != end; ++itExtent) {
+		if(itExtent->max >= pValue)
+			crossed.push_back(&*itExtent);
+	}
+
+	std::vector<CellSection> sections(crossed.size());
+	std::vector<std::thread> threads;
+	for(unsigned int iThread = 0; iThread < _nbThread; ++iThread) {
+		threads.emplace_back([&, iThread]() {
+			for(std::size_t iCell = iThread; iCell < crossed.size(); iCell += _nbThread)
+				sections[iCell] = getSection(crossed[iCell]->cell, _axis, pValue);
+		});
+	}
+	for(auto& thread : threads)
+		thread.join();
+
+	return sections;
+}
+
+/// \details The slices are processed in increasing order, the cells crossed by the current slice are kept
+/// between two slices : each cell enters and leaves this set once. The slice i is written to
+/// <pPath>_slice_<i>.txt, starting by its position on the axis.
+/// \param pPath The path prefix of the slice files
+/// \param pFirst The position of the first slice on the axis
+/// \param pLast The position of the last slice on the axis
+/// \param pNbSlice The number of slices
+/// \return the number of slices written
+unsigned int Slicer_3::exportSlices(std::string const& pPath, double pFirst, double pLast, unsigned int pNbSlice) const {
+	if(pFirst > pLast)
+		std::swap(pFirst, pLast);
+	double step = pNbSlice > 1 ? (pLast - pFirst)/(pNbSlice - 1) : 0.;
+
+	std::vector<const Extent*> crossed;
+	std::size_t nextExtent = 0;
+	unsigned int nbWritten = 0;
+	for(unsigned int iSlice = 0; iSlice < pNbSlice; ++iSlice) {
+		double value = pFirst + iSlice*step;
+
+		// add the cells starting before the plane, remove the ones ending before it
+		for(; nextExtent < _extents.size() && _extents[nextExtent].min <= value; ++nextExtent)
+			crossed.push_back(&_extents[nextExtent]);
+		crossed.erase(
+			std::remove_if(crossed.begin(), crossed.end(), [value](const Extent* extent) { return extent->max < value; }),
+			crossed.end()
+		);
+
+		std::ofstream out(pPath + "_slice_" + std::to_string(iSlice) + ".txt", std::ios::trunc | std::ios::binary);
+		std::string header = "# slice ";
+		IO::appendNumber(header, value);
+		header += '\n';
+		out << header;
+
+		IO::writeInParallel(out, crossed.size(), [&](std::size_t iCell, std::string& pBuffer) {
+			appendSection(pBuffer, getSection(crossed[iCell]->cell, _axis, value));
+		}, _nbThread);
+
+		if(out.good()) {
+			++nbWritten;
+		} else {
+			InformationSystemManager::getInstance()->Message(InformationSystemManager::CANT_PROCESS_MES,
+				"failed to write the slice " + std::to_string(iSlice), "Slicer_3");
+		}
+	}
+
+	return nbWritten;
+}
@@ -0,0 +1,67 @@
+#ifndef CONVEX_VOLUME_SAMPLER_HH
+#define CONVEX_VOLUME_SAMPLER_HH
+
+#include "Mesh3DSettings.hh"
+
+#include <CLHEP/Random/RandomEngine.h>
+
+#include <vector>
+
+/// \brief geometric utils for volume sampling
+namespace Utils::Geometry {
+
+using namespace Settings::Geometry;
+using namespace Settings::Geometry::Mesh3D;
+
+/// \brief build the alias table (Vose's method) of the given cumulative weights, for an O(1) weighted draw
+void buildAliasTable(const std::vector<double>& pCumulativeWeights, std::vector<double>& pProbabilities, std::vector<unsigned int>& pAliases);
+/// \brief fold three uniform numbers of the unit cube on the unit tetrahedron (Rocchini & Cignoni)
+void foldToUnitTetrahedron(double& s, double& t, double& u);
+
+/// \brief Uniform volume sampler for a convex polyhedron.
+/// \details The polyhedron is decomposed in a fan of tetrahedra sharing an internal apex
+/// (the cell origin for cells). A tetrahedron is picked in O(1) from an alias table built
+/// on the tetrahedra volumes, then a point is drawn uniformly inside it.
+/// Each spot costs four random numbers, whatever the number of facets.
+class ConvexVolumeSampler {
+public:
+	/// \brief build the tetrahedral decomposition of the given convex polyhedron
+	void build(const Polyhedron_3* pShape, const Point_3& pApex);
+	/// \brief remove the decomposition
+	void clear();
+
+	/// \brief return true if no decomposition has been built
+	[[nodiscard]] bool empty() const { return _tetrahedra.empty(); }
+	/// \brief return the number of tetrahedra of the decomposition
+	[[nodiscard]] std::size_t size() const { return _tetrahedra.size(); }
+	/// \brief return the volume of the decomposed polyhedron
+	[[nodiscard]] double getVolume() const { return _cumulativeVolumes.empty() ? 0. : _cumulativeVolumes.back(); }
+	/// \brief return the memory used by the decomposition, in bytes
+	[[nodiscard]] std::size_t getMemoryUsage() const;
+
+	/// \brief return a random spot uniformly distributed inside the polyhedron
+	Point_3 getSpot(CLHEP::HepRandomEngine* pEngine) const;
+	/// \brief append pNbSpot random spots uniformly distributed inside the polyhedron
+	void getSpots(std::size_t pNbSpot, std::vector<Point_3>& pSpots, CLHEP::HepRandomEngine* pEngine) const;
+
+private:
+	/// \brief a tetrahedron of the fan, defined by its three edges from the apex
+	struct Tetrahedron {
+		Vector_3 ab; ///< \brief first edge from the apex
+		Vector_3 ac; ///< \brief second edge from the apex
+		Vector_3 ad; ///< \brief third edge from the apex
+	};
+
+	/// \brief return the spot matching the four given uniform numbers
+	Point_3 getSpot(const double* pRand) const;
+
+	Point_3 _apex;                              ///< \brief the apex shared by all tetrahedra
+	std::vector<Tetrahedron> _tetrahedra;       ///< \brief the tetrahedral decomposition
+	std::vector<double> _cumulativeVolumes;     ///< \brief cumulative volume of the tetrahedra
+	std::vector<double> _aliasProbabilities;    ///< \brief probability to keep the drawn tetrahedron
+	std::vector<unsigned int> _aliases;         ///< \brief tetrahedron to use otherwise
+};
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef FROZEN_CONVEX_MESH_HH
+#define FROZEN_CONVEX_MESH_HH
+
+#include "Mesh3DSettings.hh"
+
+#include <CLHEP/Random/RandomEngine.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// \brief geometric utils for volume sampling
+namespace Utils::Geometry {
+
+using namespace Settings::Geometry;
+using namespace Settings::Geometry::Mesh3D;
+
+/// \brief Compact read only copy of a convex polyhedron, to keep once the polyhedron is no more modified.
+/// \details The vertices (float coordinates), the triangles (vertex indices), the facet planes and the tables
+/// used to sample the surface and the volume are stored in a single arena of 4 bytes words : a vertex costs
+/// 12 bytes and a facet 40 bytes, instead of the half-edge nodes of a Polyhedron_3 and the sampling structures.
+/// The vertices and the facets keep the order of the polyhedron. Planes and volume tetrahedra are defined
+/// relatively to an internal apex (the cell origin for cells).
+/// \warning the coordinates are rounded to float, as the STL export does.
+class FrozenConvexMesh {
+public:
+	FrozenConvexMesh() = default;
+	FrozenConvexMesh(const FrozenConvexMesh&) = delete;
+	FrozenConvexMesh& operator=(const FrozenConvexMesh&) = delete;
+
+	/// \brief copy the given convex polyhedron, made of triangles
+	void build(const Polyhedron_3& pShape, const Point_3& pApex);
+	/// \brief release the mesh
+	void clear();
+
+	/// \brief return true if no mesh has been built
+	[[nodiscard]] bool empty() const { return _nbFacet == 0; }
+	/// \brief return the number of vertices
+	[[nodiscard]] std::size_t getNbVertex() const { return _nbVertex; }
+	/// \brief return the number of facets
+	[[nodiscard]] std::size_t getNbFacet() const { return _nbFacet; }
+	/// \brief return the vertex at the given index
+	[[nodiscard]] Point_3 getVertex(std::size_t) const;
+	/// \brief return the vertex indices of the facet at the given index
+	[[nodiscard]] std::array<std::uint32_t, 3> getFacet(std::size_t) const;
+	/// \brief return the facet at the given index as a triangle
+	[[nodiscard]] Triangle_3 getTriangle(std::size_t) const;
+	/// \brief return the volume of the mesh
+	[[nodiscard]] double getVolume() const { return _volume; }
+	/// \brief return the surface area of the mesh
+	[[nodiscard]] double getSurfaceArea() const { return _surfaceArea; }
+	/// \brief return the memory used by the mesh, in bytes
+	[[nodiscard]] std::size_t getMemoryUsage() const;
+
+	/// \brief return true if the point is inside the mesh or on its boundary
+	[[nodiscard]] bool hasIn(const Point_3&) const;
+	/// \brief return a random spot uniformly distributed on the mesh surface
+	Point_3 getSpotOnSurface(CLHEP::HepRandomEngine* pEngine) const;
+	/// \brief return a random spot uniformly distributed inside the mesh
+	Point_3 getSpot(CLHEP::HepRandomEngine* pEngine) const;
+	/// \brief append pNbSpot random spots uniformly distributed inside the mesh
+	void getSpots(std::size_t pNbSpot, std::vector<Point_3>& pSpots, CLHEP::HepRandomEngine* pEngine) const;
+
+private:
+	/// \brief a word of the arena, a real or an index depending on its section
+	union Word {
+		float real;
+		std::uint32_t index;
+	};
+
+	/// \brief first word of the vertices : x, y, z
+	[[nodiscard]] const Word* vertices() const { return _arena.get(); }
+	/// \brief first word of the triangles : 3 vertex indices
+	[[nodiscard]] const Word* triangles() const { return vertices() + 3*_nbVertex; }
+	/// \brief first word of the facet planes : unit outward normal and distance to the apex
+	[[nodiscard]] const Word* planes() const { return triangles() + 3*_nbFacet; }
+	/// \brief first word of the cumulative facet areas, divided by the total area
+	[[nodiscard]] const Word* cumulativeAreas() const { return planes() + 4*_nbFacet; }
+	/// \brief first word of the volume alias probabilities
+	[[nodiscard]] const Word* aliasProbabilities() const { return cumulativeAreas() + _nbFacet; }
+	/// \brief first word of the volume aliases
+	[[nodiscard]] const Word* aliases() const { return aliasProbabilities() + _nbFacet; }
+	/// \brief return the number of words of the arena
+	[[nodiscard]] std::size_t getNbWord() const { return 3*_nbVertex + 10*_nbFacet; }
+	/// \brief return the vertex relatively to the apex
+	[[nodiscard]] Vector_3 getRelativeVertex(std::uint32_t) const;
+	/// \brief return the spot inside the mesh matching the four given uniform numbers
+	Point_3 getSpot(const double* pRand) const;
+
+	Point_3 _apex;						///< \brief the internal point the planes and tetrahedra refer to
+	std::size_t _nbVertex = 0;			///< \brief number of vertices
+	std::size_t _nbFacet = 0;			///< \brief number of facets
+	double _volume = 0.;				///< \brief volume of the mesh
+	double _surfaceArea = 0.;			///< \brief surface area of the mesh
+	std::unique_ptr<Word[]> _arena;		///< \brief vertices, triangles, planes and sampling tables
+};
+
+}
+
+#endif
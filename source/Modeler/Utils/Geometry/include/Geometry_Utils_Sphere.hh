@@ -28,6 +28,10 @@ int segmentSphereIntersection(Segment_3 seg, Point_3 sphereCenter, double sphere
 int planeSphereIntersection(Point_3 sphereCenter, double sphereRadius, Plane_3 plane, Point_3& projectionOfSphereCenter, double& circleRadius);
 /// \brief return a random spot included on the sphere
 Point_3 getSpotOnSphere(double radius, Point_3 origin, double internalRadius = 0.);
+/// \brief return the spot included on the sphere matching the three given uniform numbers
+Point_3 getSpotOnSphere(double radius, Point_3 origin, double internalRadius, const double* rand);
+/// \brief append n random spots included on the sphere
+void getSpotsOnSphere(std::size_t nbSpot, double radius, Point_3 origin, std::vector<Point_3>& spots, double internalRadius = 0.);
 
 }
 
@@ -0,0 +1,49 @@
+#ifndef MINIMAL_DISTANCE_GRID_HH
+#define MINIMAL_DISTANCE_GRID_HH
+
+#include "BoundingBox.hh"
+#include "GeometrySettings.hh"
+
+#include <vector>
+
+namespace Utils::Geometry {
+
+using namespace Settings::Geometry;
+
+/// \brief Uniform grid used to reject points closer than a minimal distance (Poisson-disk sampling).
+/// \details The grid cells are at least as large as the minimal distance, so a point can only
+/// conflict with points of the 27 cells around it. Points of a grid cell are chained in a flat
+/// array, no allocation is done per point once the grid is built.
+class MinimalDistanceGrid {
+public:
+	MinimalDistanceGrid(const BoundingBox<Point_3>& pBox, double pMinimalDistance, std::size_t pExpectedNbPoint);
+
+	/// \brief insert the point if no point already inserted is closer than the minimal distance
+	bool tryInsert(const Point_3& pPoint);
+	/// \brief return true if a point already inserted is closer than the minimal distance
+	[[nodiscard]] bool hasNeighbour(const Point_3& pPoint) const;
+
+	/// \brief return the inserted points
+	[[nodiscard]] const std::vector<Point_3>& points() const { return _points; }
+	/// \brief return the number of inserted points
+	[[nodiscard]] std::size_t size() const { return _points.size(); }
+
+private:
+	/// \brief return the coordinate of the grid cell containing the value along one axis
+	[[nodiscard]] int cellCoordinate(double pValue, int pAxis) const;
+
+	static constexpr int noPoint = -1;
+
+	Point_3 _origin;                ///< \brief bottom left corner of the grid
+	double _squaredMinimalDistance; ///< \brief squared minimal distance between two points
+	double _cellSize;               ///< \brief size of a grid cell
+	int _dims[3];                   ///< \brief number of grid cells along each axis
+
+	std::vector<int> _cellHead;     ///< \brief first point of each grid cell
+	std::vector<int> _next;         ///< \brief next point in the same grid cell
+	std::vector<Point_3> _points;   ///< \brief inserted points
+};
+
+}
+
+#endif
@@ -0,0 +1,165 @@
+#include "ConvexVolumeSampler.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Utils::Geometry {
+
+/// \param pCumulativeWeights the cumulative weight of the items, increasing
+/// \param pProbabilities the probability to keep the drawn item
+/// \param pAliases the item to use otherwise
+void buildAliasTable(const std::vector<double>& pCumulativeWeights, std::vector<double>& pProbabilities, std::vector<unsigned int>& pAliases) {
+	const std::size_t nbItem = pCumulativeWeights.size();
+	pProbabilities.resize(nbItem);
+	pAliases.resize(nbItem);
+	if(nbItem == 0)
+		return;
+
+	double sumWeight = pCumulativeWeights.back();
+	std::vector<unsigned int> small, large;
+	double previous = 0.;
+	for(std::size_t iItem = 0; iItem < nbItem; ++iItem) {
+		pProbabilities[iItem] = (pCumulativeWeights[iItem] - previous) * nbItem / sumWeight;
+		previous = pCumulativeWeights[iItem];
+		pAliases[iItem] = iItem;
+		if(pProbabilities[iItem] < 1.)
+			small.push_back(iItem);
+		else
+			large.push_back(iItem);
+	}
+
+	while(!small.empty() && !large.empty()) {
+		unsigned int lSmall = small.back();
+		small.pop_back();
+		unsigned int lLarge = large.back();
+
+		pAliases[lSmall] = lLarge;
+		pProbabilities[lLarge] -= (1. - pProbabilities[lSmall]);
+		if(pProbabilities[lLarge] < 1.) {
+			large.pop_back();
+			small.push_back(lLarge);
+		}
+	}
+
+	// remaining entries are only due to rounding errors
+	for(auto const& iItem : small) pProbabilities[iItem] = 1.;
+	for(auto const& iItem : large) pProbabilities[iItem] = 1.;
+}
+
+/// \param s first uniform number in [0, 1], replaced by the first barycentric coordinate
+/// \param t second uniform number in [0, 1], replaced by the second barycentric coordinate
+/// \param u third uniform number in [0, 1], replaced by the third barycentric coordinate
+void foldToUnitTetrahedron(double& s, double& t, double& u) {
+	if(s + t > 1.) {
+		s = 1. - s;
+		t = 1. - t;
+	}
+
+	if(t + u > 1.) {
+		double tmp = u;
+		u = 1. - s - t;
+		t = 1. - tmp;
+	} else if(s + t + u > 1.) {
+		double tmp = u;
+		u = s + t + u - 1.;
+		s = 1. - t - tmp;
+	}
+}
+
+/// \param pShape the convex polyhedron to decompose
+/// \param pApex a point inside the polyhedron, shared by all tetrahedra
+void ConvexVolumeSampler::build(const Polyhedron_3* pShape, const Point_3& pApex) {
+	assert(pShape);
+	clear();
+
+	_apex = pApex;
+	_tetrahedra.reserve(pShape->size_of_facets());
+	_cumulativeVolumes.reserve(pShape->size_of_facets());
+
+	double sumVolume = 0.;
+	for(auto itFacet = pShape->facets_begin(); itFacet != pShape->facets_end(); ++itFacet) {
+		Tetrahedron lTet{
+			itFacet->halfedge()->vertex()->point() - _apex,
+			itFacet->halfedge()->next()->vertex()->point() - _apex,
+			itFacet->halfedge()->next()->next()->vertex()->point() - _apex
+		};
+
+		// facet orientation is not guaranteed, only the absolute value matters here
+		double volume = std::fabs(CGAL::determinant(lTet.ab, lTet.ac, lTet.ad)) / 6.;
+		if(volume <= 0.)
+			continue;
+
+		sumVolume += volume;
+		_tetrahedra.push_back(lTet);
+		_cumulativeVolumes.push_back(sumVolume);
+	}
+
+	buildAliasTable(_cumulativeVolumes, _aliasProbabilities, _aliases);
+}
+
+/// \details the memory of the decomposition is released
+void ConvexVolumeSampler::clear() {
+	std::vector<Tetrahedron>().swap(_tetrahedra);
+	std::vector<double>().swap(_cumulativeVolumes);
+	std::vector<double>().swap(_aliasProbabilities);
+	std::vector<unsigned int>().swap(_aliases);
+}
+
+/// \return the memory used by the decomposition, in bytes
+std::size_t ConvexVolumeSampler::getMemoryUsage() const {
+	return _tetrahedra.capacity()*sizeof(Tetrahedron)
+		+ _cumulativeVolumes.capacity()*sizeof(double)
+		+ _aliasProbabilities.capacity()*sizeof(double)
+		+ _aliases.capacity()*sizeof(unsigned int);
+}
+
+/// \param pRand four uniform numbers in ]0, 1[
+/// \return the spot matching the given numbers
+Point_3 ConvexVolumeSampler::getSpot(const double* pRand) const {
+	assert(!empty());
+
+	// pick the tetrahedron from the alias table
+	double x = pRand[0] * _tetrahedra.size();
+	auto iTet = std::min(static_cast<std::size_t>(x), _tetrahedra.size() - 1);
+	if((x - iTet) >= _aliasProbabilities[iTet])
+		iTet = _aliases[iTet];
+
+	double s = pRand[1];
+	double t = pRand[2];
+	double u = pRand[3];
+	foldToUnitTetrahedron(s, t, u);
+
+	const Tetrahedron& lTet = _tetrahedra[iTet];
+	return _apex + s*lTet.ab + t*lTet.ac + u*lTet.ad;
+}
+
+/// \param pEngine the random engine to use
+/// \return a random spot inside the polyhedron
+Point_3 ConvexVolumeSampler::getSpot(CLHEP::HepRandomEngine* pEngine) const {
+	assert(pEngine);
+	double lRand[4];
+	pEngine->flatArray(4, lRand);
+	return getSpot(lRand);
+}
+
+/// \param pNbSpot the number of spot to generate
+/// \param pSpots the vector to fill
+/// \param pEngine the random engine to use
+void ConvexVolumeSampler::getSpots(std::size_t pNbSpot, std::vector<Point_3>& pSpots, CLHEP::HepRandomEngine* pEngine) const {
+	assert(pEngine);
+	static constexpr std::size_t chunkSize = 256;
+	double lRand[4*chunkSize];
+
+	pSpots.reserve(pSpots.size() + pNbSpot);
+	while(pNbSpot > 0) {
+		std::size_t nbSpot = std::min(pNbSpot, chunkSize);
+		pEngine->flatArray(static_cast<int>(4*nbSpot), lRand);
+		for(std::size_t iSpot = 0; iSpot < nbSpot; ++iSpot)
+			pSpots.push_back(getSpot(&lRand[4*iSpot]));
+
+		pNbSpot -= nbSpot;
+	}
+}
+
+}
@@ -0,0 +1,228 @@
+#include "FrozenConvexMesh.hh"
+
+#include "ConvexVolumeSampler.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <unordered_map>
+
+namespace Utils::Geometry {
+
+/// \param pShape the convex polyhedron to copy, its facets must be triangles
+/// \param pApex a point inside the polyhedron
+void FrozenConvexMesh::build(const Polyhedron_3& pShape, const Point_3& pApex) {
+	clear();
+	if(pShape.size_of_facets() == 0)
+		return;
+
+	_apex = pApex;
+	_nbVertex = pShape.size_of_vertices();
+	_nbFacet = pShape.size_of_facets();
+	_arena = std::make_unique<Word[]>(getNbWord());
+
+	Word* lVertices = _arena.get();
+	Word* lTriangles = lVertices + 3*_nbVertex;
+	Word* lPlanes = lTriangles + 3*_nbFacet;
+	Word* lAreas = lPlanes + 4*_nbFacet;
+	Word* lProbabilities = lAreas + _nbFacet;
+	Word* lAliases = lProbabilities + _nbFacet;
+
+	std::unordered_map<const Polyhedron_3::Vertex*, std::uint32_t> indexes;
+	indexes.reserve(_nbVertex);
+	std::uint32_t iVertex = 0;
+	for(auto itVertex = pShape.vertices_begin(); itVertex != pShape.vertices_end(); ++itVertex, ++iVertex) {
+		indexes.emplace(&*itVertex, iVertex);
+		lVertices[3*iVertex].real = static_cast<float>(itVertex->point().x());
+		lVertices[3*iVertex + 1].real = static_cast<float>(itVertex->point().y());
+		lVertices[3*iVertex + 2].real = static_cast<float>(itVertex->point().z());
+	}
+
+	// planes and sampling tables are computed from the rounded vertices, to match the stored mesh
+	std::vector<double> cumulativeAreas;
+	std::vector<double> cumulativeVolumes;
+	cumulativeAreas.reserve(_nbFacet);
+	cumulativeVolumes.reserve(_nbFacet);
+	std::size_t iFacet = 0;
+	for(auto itFacet = pShape.facets_begin(); itFacet != pShape.facets_end(); ++itFacet, ++iFacet) {
+		assert(itFacet->is_triangle());
+		std::uint32_t lFacet[3] = {
+			indexes.at(&*itFacet->halfedge()->vertex()),
+			indexes.at(&*itFacet->halfedge()->next()->vertex()),
+			indexes.at(&*itFacet->halfedge()->next()->next()->vertex())
+		};
+		for(unsigned int iCorner = 0; iCorner < 3; ++iCorner)
+			lTriangles[3*iFacet + iCorner].index = lFacet[iCorner];
+
+		Vector_3 a = getRelativeVertex(lFacet[0]);
+		Vector_3 b = getRelativeVertex(lFacet[1]);
+		Vector_3 c = getRelativeVertex(lFacet[2]);
+
+		// facet orientation is not guaranteed, the normal is turned away from the apex
+		double determinant = CGAL::determinant(a, b, c);
+		Vector_3 normal = CGAL::cross_product(b - a, c - a);
+		if(determinant < 0.)
+			normal = -normal;
+		double norm = std::sqrt(normal.squared_length());
+		if(norm > 0.)
+			normal = normal/norm;
+
+		lPlanes[4*iFacet].real = static_cast<float>(normal.x());
+		lPlanes[4*iFacet + 1].real = static_cast<float>(normal.y());
+		lPlanes[4*iFacet + 2].real = static_cast<float>(normal.z());
+		lPlanes[4*iFacet + 3].real = static_cast<float>(normal*a);
+
+		_surfaceArea += norm/2.;
+		_volume += std::fabs(determinant)/6.;
+		cumulativeAreas.push_back(_surfaceArea);
+		cumulativeVolumes.push_back(_volume);
+	}
+
+	for(iFacet = 0; iFacet < _nbFacet; ++iFacet)
+		lAreas[iFacet].real = _surfaceArea > 0. ? static_cast<float>(cumulativeAreas[iFacet]/_surfaceArea) : 1.f;
+	lAreas[_nbFacet - 1].real = 1.f;
+
+	std::vector<double> probabilities;
+	std::vector<unsigned int> aliases;
+	if(_volume > 0.)
+		buildAliasTable(cumulativeVolumes, probabilities, aliases);
+	for(iFacet = 0; iFacet < _nbFacet; ++iFacet) {
+		lProbabilities[iFacet].real = probabilities.empty() ? 1.f : static_cast<float>(probabilities[iFacet]);
+		lAliases[iFacet].index = aliases.empty() ? static_cast<std::uint32_t>(iFacet) : aliases[iFacet];
+	}
+}
+
+void FrozenConvexMesh::clear() {
+	_arena.reset();
+	_nbVertex = 0;
+	_nbFacet = 0;
+	_volume = 0.;
+	_surfaceArea = 0.;
+}
+
+/// \param pIndex the index of the vertex
+/// \return the vertex
+Point_3 FrozenConvexMesh::getVertex(std::size_t pIndex) const {
+	assert(pIndex < _nbVertex);
+	const Word* lVertex = vertices() + 3*pIndex;
+	return {lVertex[0].real, lVertex[1].real, lVertex[2].real};
+}
+
+/// \param pIndex the index of the facet
+/// \return the indices of the facet vertices, in the polyhedron order
+std::array<std::uint32_t, 3> FrozenConvexMesh::getFacet(std::size_t pIndex) const {
+	assert(pIndex < _nbFacet);
+	const Word* lTriangle = triangles() + 3*pIndex;
+	return {lTriangle[0].index, lTriangle[1].index, lTriangle[2].index};
+}
+
+/// \param pIndex the index of the facet
+/// \return the facet, in the polyhedron order
+Triangle_3 FrozenConvexMesh::getTriangle(std::size_t pIndex) const {
+	auto const& lFacet = getFacet(pIndex);
+	return {getVertex(lFacet[0]), getVertex(lFacet[1]), getVertex(lFacet[2])};
+}
+
+/// \return the memory used by the mesh, in bytes
+std::size_t FrozenConvexMesh::getMemoryUsage() const {
+	return _arena ? getNbWord()*sizeof(Word) : 0;
+}
+
+/// \param pIndex the index of the vertex
+/// \return the vector from the apex to the vertex
+Vector_3 FrozenConvexMesh::getRelativeVertex(std::uint32_t pIndex) const {
+	return getVertex(pIndex) - _apex;
+}
+
+/// \param pPoint the point to check
+/// \return true if the point is on the inner side of all facet planes
+bool FrozenConvexMesh::hasIn(const Point_3& pPoint) const {
+	if(empty())
+		return false;
+
+	double x = pPoint.x() - _apex.x();
+	double y = pPoint.y() - _apex.y();
+	double z = pPoint.z() - _apex.z();
+	const Word* lPlane = planes();
+	for(std::size_t iFacet = 0; iFacet < _nbFacet; ++iFacet, lPlane += 4) {
+		if(lPlane[0].real*x + lPlane[1].real*y + lPlane[2].real*z > lPlane[3].real)
+			return false;
+	}
+	return true;
+}
+
+/// \param pEngine the random engine to use
+/// \return a random spot on the surface, facets are picked according to their area
+Point_3 FrozenConvexMesh::getSpotOnSurface(CLHEP::HepRandomEngine* pEngine) const {
+	assert(pEngine);
+	assert(!empty());
+	double lRand[3];
+	pEngine->flatArray(3, lRand);
+
+	const Word* lAreas = cumulativeAreas();
+	auto iFacet = static_cast<std::size_t>(std::lower_bound(lAreas, lAreas + _nbFacet, lRand[0], [](const Word& pArea, double pValue) {
+		return pArea.real < pValue;
+	}) - lAreas);
+	iFacet = std::min(iFacet, _nbFacet - 1);
+
+	double s = lRand[1];
+	double t = lRand[2];
+	if(s + t > 1.) {
+		s = 1. - s;
+		t = 1. - t;
+	}
+
+	auto const& lFacet = getFacet(iFacet);
+	Point_3 a = getVertex(lFacet[0]);
+	return a + s*(getVertex(lFacet[1]) - a) + t*(getVertex(lFacet[2]) - a);
+}
+
+/// \param pRand four uniform numbers in ]0, 1[
+/// \return the spot matching the given numbers
+Point_3 FrozenConvexMesh::getSpot(const double* pRand) const {
+	assert(!empty());
+
+	// pick the tetrahedron (apex, facet) from the alias table
+	double x = pRand[0] * _nbFacet;
+	auto iFacet = std::min(static_cast<std::size_t>(x), _nbFacet - 1);
+	if((x - iFacet) >= aliasProbabilities()[iFacet].real)
+		iFacet = aliases()[iFacet].index;
+
+	double s = pRand[1];
+	double t = pRand[2];
+	double u = pRand[3];
+	foldToUnitTetrahedron(s, t, u);
+
+	auto const& lFacet = getFacet(iFacet);
+	return _apex + s*getRelativeVertex(lFacet[0]) + t*getRelativeVertex(lFacet[1]) + u*getRelativeVertex(lFacet[2]);
+}
+
+/// \param pEngine the random engine to use
+/// \return a random spot inside the mesh
+Point_3 FrozenConvexMesh::getSpot(CLHEP::HepRandomEngine* pEngine) const {
+	assert(pEngine);
+	double lRand[4];
+	pEngine->flatArray(4, lRand);
+	return getSpot(lRand);
+}
+
+/// \param pNbSpot the number of spot to generate
+/// \param pSpots the vector to fill
+/// \param pEngine the random engine to use
+void FrozenConvexMesh::getSpots(std::size_t pNbSpot, std::vector<Point_3>& pSpots, CLHEP::HepRandomEngine* pEngine) const {
+	assert(pEngine);
+	static constexpr std::size_t chunkSize = 256;
+	double lRand[4*chunkSize];
+
+	pSpots.reserve(pSpots.size() + pNbSpot);
+	while(pNbSpot > 0) {
+		std::size_t nbSpot = std::min(pNbSpot, chunkSize);
+		pEngine->flatArray(static_cast<int>(4*nbSpot), lRand);
+		for(std::size_t iSpot = 0; iSpot < nbSpot; ++iSpot)
+			pSpots.push_back(getSpot(&lRand[4*iSpot]));
+
+		pNbSpot -= nbSpot;
+	}
+}
+
+}
@@ -2,6 +2,9 @@
 #include "CGAL_Utils.hh"
 #include "RandomEngineManager.hh"
 
+#include <algorithm>
+#include <cmath>
+
 #if ( defined(WIN32) || defined(WIN64) || defined(_WIN32) || defined(_WIN64) )
 	#define _USE_MATH_DEFINES
 	#include <math.h>
@@ -159,23 +162,51 @@ int planeSphereIntersection(Point_3 sphereCenter, double sphereRadius, Plane_3 p
 /// \param center The center of the sphere
 /// \param internalRadius The internal radius of the sphere
 Point_3 getSpotOnSphere(double radius, Point_3 center, double internalRadius) {
-	Point_3 p =	 Point_3(	RandomEngineManager::getInstance()->randd( -radius, radius),
-												RandomEngineManager::getInstance()->randd( -radius, radius),
-												RandomEngineManager::getInstance()->randd( -radius, radius) );
-
-	double nucleusSquareR = radius * radius;
-	double internalSqrRadius = internalRadius * internalRadius;
-	double squaredLength =  p.x()*p.x() + p.y()*p.y() + p.z()*p.z();
+	double lRand[3];
+	RandomEngineManager::getInstance()->getEngine()->flatArray(3, lRand);
+	return getSpotOnSphere(radius, center, internalRadius, lRand);
+}
 
-	while((squaredLength > nucleusSquareR) || (squaredLength < internalSqrRadius)) {
-		p = Point_3( 	RandomEngineManager::getInstance()->randd( -radius, radius),
-									RandomEngineManager::getInstance()->randd( -radius, radius),
-									RandomEngineManager::getInstance()->randd( -radius, radius) );
+/// \return The spot requested inside the sphere
+/// \param radius The (external) radius of the sphere
+/// \param center The center of the sphere
+/// \param internalRadius The internal radius of the sphere
+/// \param pRand three uniform numbers in [0, 1]
+/// \details the radius is drawn by inverting the radial CDF r^3 and the direction uniformly on the unit sphere,
+/// so no rejection is needed.
+Point_3 getSpotOnSphere(double radius, Point_3 center, double internalRadius, const double* pRand) {
+	double internalCube = internalRadius * internalRadius * internalRadius;
+	double r = std::cbrt(internalCube + pRand[0] * (radius * radius * radius - internalCube));
+	double cosTheta = 1. - 2. * pRand[1];
+	double sinTheta = std::sqrt(std::max(0., 1. - cosTheta * cosTheta));
+	double phi = 2. * M_PI * pRand[2];
+
+	return {
+		center.x() + r * sinTheta * std::cos(phi),
+		center.y() + r * sinTheta * std::sin(phi),
+		center.z() + r * cosTheta
+	};
+}
 
-		squaredLength =  p.x()*p.x() + p.y()*p.y() + p.z()*p.z();
+/// \param nbSpot The number of spot to generate
+/// \param radius The (external) radius of the sphere
+/// \param center The center of the sphere
+/// \param spots The vector to fill
+/// \param internalRadius The internal radius of the sphere
+void getSpotsOnSphere(std::size_t nbSpot, double radius, Point_3 center, std::vector<Point_3>& spots, double internalRadius) {
+	static constexpr std::size_t chunkSize = 256;
+	double lRand[3*chunkSize];
+
+	auto* engine = RandomEngineManager::getInstance()->getEngine();
+	spots.reserve(spots.size() + nbSpot);
+	while(nbSpot > 0) {
+		std::size_t lNbSpot = std::min(nbSpot, chunkSize);
+		engine->flatArray(static_cast<int>(3*lNbSpot), lRand);
+		for(std::size_t iSpot = 0; iSpot < lNbSpot; ++iSpot)
+			spots.push_back(getSpotOnSphere(radius, center, internalRadius, &lRand[3*iSpot]));
+
+		nbSpot -= lNbSpot;
 	}
-
-	return {p.x()+center.x(), p.y()+center.y(), p.z()+center.z()};
 }
 
 }
@@ -0,0 +1,90 @@
+#include "MinimalDistanceGrid.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Utils::Geometry {
+
+/// \brief maximal number of grid cells per expected point, the cells are enlarged above
+static constexpr double maxCellsPerPoint = 8.;
+
+/// \param pBox the box containing all the points
+/// \param pMinimalDistance the minimal distance between two points
+/// \param pExpectedNbPoint the number of points expected, used to bound the grid size
+MinimalDistanceGrid::MinimalDistanceGrid(const BoundingBox<Point_3>& pBox, double pMinimalDistance, std::size_t pExpectedNbPoint):
+	_origin(pBox.getBottomLeft()),
+	_squaredMinimalDistance(pMinimalDistance*pMinimalDistance)
+{
+	assert(pMinimalDistance > 0.);
+	const Point_3 topRight = pBox.getTopRight();
+	const double extent[3] = {
+		std::max(topRight.x() - _origin.x(), pMinimalDistance),
+		std::max(topRight.y() - _origin.y(), pMinimalDistance),
+		std::max(topRight.z() - _origin.z(), pMinimalDistance)
+	};
+
+	// cells smaller than the minimal distance would require a larger neighbourhood
+	_cellSize = pMinimalDistance;
+	double maxNbCell = std::max(1., maxCellsPerPoint * pExpectedNbPoint);
+	double nbCell = (extent[0]/_cellSize) * (extent[1]/_cellSize) * (extent[2]/_cellSize);
+	if(nbCell > maxNbCell)
+		_cellSize *= std::cbrt(nbCell / maxNbCell);
+
+	for(int iAxis = 0; iAxis < 3; ++iAxis)
+		_dims[iAxis] = std::max(1, static_cast<int>(std::ceil(extent[iAxis]/_cellSize)));
+
+	_cellHead.assign(static_cast<std::size_t>(_dims[0]) * _dims[1] * _dims[2], noPoint);
+	_next.reserve(pExpectedNbPoint);
+	_points.reserve(pExpectedNbPoint);
+}
+
+int MinimalDistanceGrid::cellCoordinate(double pValue, int pAxis) const {
+	auto coordinate = static_cast<int>(std::floor(pValue/_cellSize));
+	return std::clamp(coordinate, 0, _dims[pAxis] - 1);
+}
+
+/// \param pPoint the point to check
+/// \return true if an inserted point is strictly closer than the minimal distance
+bool MinimalDistanceGrid::hasNeighbour(const Point_3& pPoint) const {
+	const int cx = cellCoordinate(pPoint.x() - _origin.x(), 0);
+	const int cy = cellCoordinate(pPoint.y() - _origin.y(), 1);
+	const int cz = cellCoordinate(pPoint.z() - _origin.z(), 2);
+
+	for(int iz = std::max(cz - 1, 0); iz <= std::min(cz + 1, _dims[2] - 1); ++iz) {
+		for(int iy = std::max(cy - 1, 0); iy <= std::min(cy + 1, _dims[1] - 1); ++iy) {
+			for(int ix = std::max(cx - 1, 0); ix <= std::min(cx + 1, _dims[0] - 1); ++ix) {
+				std::size_t iCell = (static_cast<std::size_t>(iz) * _dims[1] + iy) * _dims[0] + ix;
+				for(int iPoint = _cellHead[iCell]; iPoint != noPoint; iPoint = _next[iPoint]) {
+					const Point_3& other = _points[iPoint];
+					double dx = other.x() - pPoint.x();
+					double dy = other.y() - pPoint.y();
+					double dz = other.z() - pPoint.z();
+					if(dx*dx + dy*dy + dz*dz < _squaredMinimalDistance)
+						return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+/// \param pPoint the point to insert
+/// \return true if the point has been inserted
+bool MinimalDistanceGrid::tryInsert(const Point_3& pPoint) {
+	if(hasNeighbour(pPoint))
+		return false;
+
+	const int cx = cellCoordinate(pPoint.x() - _origin.x(), 0);
+	const int cy = cellCoordinate(pPoint.y() - _origin.y(), 1);
+	const int cz = cellCoordinate(pPoint.z() - _origin.z(), 2);
+	std::size_t iCell = (static_cast<std::size_t>(cz) * _dims[1] + cy) * _dims[0] + cx;
+
+	_next.push_back(_cellHead[iCell]);
+	_cellHead[iCell] = static_cast<int>(_points.size());
+	_points.push_back(pPoint);
+	return true;
+}
+
+}
@@ -0,0 +1,172 @@
+#include "catch.hpp"
+
+#include "CPOP_Loader.hh"
+#include "Delaunay_3D_SDS.hh"
+#include "ElasticForce.hh"
+#include "File_CPOP_Checkpoint.hh"
+#include "IDManager.hh"
+#include "MASPlatform.hh"
+#include "MeshFactory.hh"
+#include "RandomEngineManager.hh"
+#include "Scheduler.hh"
+
+#include <CLHEP/Random/MTwistEngine.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace Settings::nCell;
+using namespace Settings::nEnvironment;
+
+namespace {
+
+constexpr double step_duration = 1.;
+constexpr unsigned long int nb_step = 4;
+
+/// \brief state of a cell compared between two runs
+struct CellState {
+	Point_3 position;
+	double radius;
+};
+
+/// \brief the population loaded from population.xml with elastic forces, ready to be simulated
+t_SimulatedSubEnv_3* loadPopulation(CLHEP::MTwistEngine& pEngine) {
+	IDManager::getInstance()->reset();
+	pEngine.setSeed(1234567, 0);
+
+	CPOP_Loader loader;
+	auto* env = loader.load3DEnvironment("population.xml", true);
+	REQUIRE(env);
+	auto* subEnv = dynamic_cast<t_SimulatedSubEnv_3*>(env->getFirstChild());
+	REQUIRE(subEnv);
+
+	int error;
+	t_Mesh_3* mesh = MeshFactory::getInstance()->create_3DMesh(&error, subEnv, MeshTypes::Round_Cell_Tesselation, 100, 0);
+	REQUIRE(mesh);
+	for(auto* cell : mesh->getCells())
+		cell->addForce(new ElasticForce<double, Point_3, Vector_3>(cell, 0.002, 0.7));
+	delete mesh;
+	return subEnv;
+}
+
+/// \brief simulate the layer until pDuration, from the step and time of pCheckpoint if given
+void simulate(t_SimulatedSubEnv_3* pLayer, double pDuration, std::string const& pCheckpoint = "") {
+	auto* platform = new MASPlatform();
+	platform->setLayerToSimulate(pLayer);
+	platform->setStepDuration(step_duration);
+	platform->setDuration(pDuration);
+	platform->setDisplacementThreshold(0.5);
+	platform->setDeterministic(true);
+	pLayer->addSpatialDataStructure(new Delaunay_3D_SDS("checkpoint test SDS"));
+
+	if(!pCheckpoint.empty()) {
+		IO::CPOP::CheckpointInfo info;
+		REQUIRE(IO::CPOP::loadCheckpoint(pLayer, pCheckpoint, &info));
+		REQUIRE(info.step == nb_step);
+		REQUIRE(info.time == Approx(nb_step*step_duration));
+		platform->resumeFrom(info.step, info.time);
+	}
+
+	REQUIRE(platform->startSimulation() == 0);
+	// also deletes the spatial data structure
+	delete platform;
+}
+
+std::map<unsigned long int, CellState> getStates(t_SimulatedSubEnv_3* pLayer) {
+	std::map<unsigned long int, CellState> states;
+	for(auto* agent : pLayer->getUniqueAgentsAndSubAgents()) {
+		if(auto* cell = dynamic_cast<t_RoundCell_3*>(agent))
+			states[cell->getID()] = {cell->getPosition(), cell->getRadius()};
+	}
+	return states;
+}
+
+}
+
+TEST_CASE("Restarting from a checkpoint gives the uninterrupted run", "[Checkpoint]") {
+	CLHEP::MTwistEngine engine;
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	// uninterrupted run of 2k steps
+	t_SimulatedSubEnv_3* uninterrupted = loadPopulation(engine);
+	std::map<unsigned long int, CellState> initialStates = getStates(uninterrupted);
+	simulate(uninterrupted, 2*nb_step*step_duration);
+	std::map<unsigned long int, CellState> expectedStates = getStates(uninterrupted);
+
+	// the first k steps, checkpointed by the action at the end of the last one
+	t_SimulatedSubEnv_3* interrupted = loadPopulation(engine);
+	{
+		IO::CPOP::CheckpointAction checkpointAction(interrupted, "run.ckpt", nb_step);
+		simulate(interrupted, nb_step*step_duration);
+		REQUIRE(checkpointAction.getNbCheckpoint() == 1);
+	}
+
+	// the last k steps, from the population regenerated then restored from the checkpoint
+	t_SimulatedSubEnv_3* restarted = loadPopulation(engine);
+	simulate(restarted, 2*nb_step*step_duration, "run.ckpt");
+	std::map<unsigned long int, CellState> restartedStates = getStates(restarted);
+
+	REQUIRE(expectedStates.size() == initialStates.size());
+	REQUIRE(restartedStates.size() == expectedStates.size());
+	bool moved = false;
+	for(auto const& [id, expected] : expectedStates) {
+		CellState const& restored = restartedStates.at(id);
+		REQUIRE(restored.position.x() == Approx(expected.position.x()).margin(1e-9));
+		REQUIRE(restored.position.y() == Approx(expected.position.y()).margin(1e-9));
+		REQUIRE(restored.position.z() == Approx(expected.position.z()).margin(1e-9));
+		REQUIRE(restored.radius == Approx(expected.radius));
+		moved = moved || expected.position != initialStates.at(id).position;
+	}
+	// the comparison is meaningless if the simulation did not move any cell
+	REQUIRE(moved);
+}
+
+TEST_CASE("A deleted action is no longer scheduled", "[Checkpoint]") {
+	CLHEP::MTwistEngine engine;
+	RandomEngineManager::getInstance()->setEngine(&engine);
+	t_SimulatedSubEnv_3* layer = loadPopulation(engine);
+
+	auto* checkpointAction = new IO::CPOP::CheckpointAction(layer, "deleted.ckpt", 1);
+	delete checkpointAction;
+	// the scheduler would call the deleted action at the end of each step
+	simulate(layer, 2*step_duration);
+
+	// and deleting an action once the scheduler has been deleted with the platform is safe
+	checkpointAction = new IO::CPOP::CheckpointAction(layer, "deleted.ckpt", 1);
+	delete Scheduler::getInstance();
+	REQUIRE(!Scheduler::hasInstance());
+	delete checkpointAction;
+}
+
+TEST_CASE("A checkpoint with a forged cell count is rejected", "[Checkpoint]") {
+	CLHEP::MTwistEngine engine;
+	RandomEngineManager::getInstance()->setEngine(&engine);
+	t_SimulatedSubEnv_3* layer = loadPopulation(engine);
+	REQUIRE(IO::CPOP::saveCheckpoint(layer, "forged.ckpt"));
+
+	std::vector<char> bytes;
+	{
+		std::ifstream file("forged.ckpt", std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	// the header is followed by the engine state then the number of cells
+	constexpr std::size_t engineSizeOffset = 8 + sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(double);
+	REQUIRE(bytes.size() > engineSizeOffset + sizeof(std::uint64_t));
+	std::uint64_t nbEngineWord;
+	std::memcpy(&nbEngineWord, bytes.data() + engineSizeOffset, sizeof(nbEngineWord));
+	std::size_t nbCellOffset = engineSizeOffset + (1 + nbEngineWord)*sizeof(std::uint64_t);
+	REQUIRE(bytes.size() > nbCellOffset + sizeof(std::uint64_t));
+
+	std::uint64_t nbCell = std::uint64_t(1) << 60;
+	std::memcpy(bytes.data() + nbCellOffset, &nbCell, sizeof(nbCell));
+	{
+		std::ofstream file("forged.ckpt", std::ios::binary | std::ios::trunc);
+		file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+	REQUIRE(!IO::CPOP::loadCheckpoint(layer, "forged.ckpt"));
+}
@@ -0,0 +1,154 @@
+#include "catch.hpp"
+
+#include "CPOP_Loader.hh"
+#include "File_Utils_GDML.hh"
+#include "MaterialManager.hh"
+#include "MeshFactory.hh"
+#include "MyGDML_Parser.hh"
+#include "RandomEngineManager.hh"
+#include "RoundNucleus.hh"
+#include "SpheroidalCellMesh.hh"
+#include "UnitSystemManager.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Orb.hh"
+#include "G4TessellatedSolid.hh"
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string readFile(std::string const& path) {
+	std::ifstream in(path, std::ios::binary);
+	std::stringstream content;
+	content << in.rdbuf();
+	return content.str();
+}
+
+/// \brief return the values of the attribute starting with pPrefix, in the order of the file
+std::vector<std::string> attributeValues(std::string const& content, std::string const& pPrefix) {
+	std::vector<std::string> values;
+	for(auto pos = content.find(pPrefix); pos != std::string::npos; pos = content.find(pPrefix, pos)) {
+		pos += pPrefix.size();
+		values.push_back(content.substr(pos, content.find('"', pos) - pos));
+	}
+	return values;
+}
+
+}
+
+TEST_CASE("GDML export test", "[GDML]") {
+	CLHEP::MTwistEngine defaultEngineCPOP(1234567);
+	RandomEngineManager::getInstance()->setEngine(&defaultEngineCPOP);
+
+	CPOP_Loader loader;
+	auto* env = loader.load3DEnvironment("population.xml", true);
+	REQUIRE(env);
+
+	int error;
+	auto* mesh = dynamic_cast<SpheroidalCellMesh*>(MeshFactory::getInstance()->create_3DMesh(
+		&error,
+		dynamic_cast<t_SimulatedSubEnv_3*>(env->getFirstChild()),
+		MeshTypes::Round_Cell_Tesselation,
+		100,
+		0
+	));
+	REQUIRE(mesh);
+
+	auto cells = mesh->generateMesh();
+	REQUIRE(!cells.empty());
+
+	SECTION("Round trip through the GDML parser") {
+		REQUIRE(IO::GDML::exportSpheroidalCells("population.gdml", cells, nullptr, 4));
+
+		MyGDML_Parser parser;
+		G4VPhysicalVolume* world = parser.read("population.gdml");
+		REQUIRE(world);
+		REQUIRE(world->GetLogicalVolume()->GetNoDaughters() == 1);
+
+		G4VPhysicalVolume* spheroid = world->GetLogicalVolume()->GetDaughter(0);
+		REQUIRE(spheroid->GetLogicalVolume()->GetNoDaughters() == cells.size());
+
+		std::map<unsigned long int, SpheroidalCell*> cellsByID;
+		for(auto* cell : cells)
+			cellsByID[cell->getID()] = cell;
+
+		double convertToG4 = UnitSystemManager::getInstance()->getConversionToG4();
+		for(std::size_t iCell = 0; iCell < spheroid->GetLogicalVolume()->GetNoDaughters(); ++iCell) {
+			G4VPhysicalVolume* cellVolume = spheroid->GetLogicalVolume()->GetDaughter(iCell);
+			auto itCell = cellsByID.find(static_cast<unsigned long int>(cellVolume->GetCopyNo()));
+			REQUIRE(itCell != cellsByID.end());
+			SpheroidalCell* cell = itCell->second;
+
+			auto* solid = dynamic_cast<G4TessellatedSolid*>(cellVolume->GetLogicalVolume()->GetSolid());
+			REQUIRE(solid);
+			REQUIRE(static_cast<std::size_t>(solid->GetNumberOfFacets()) == cell->getShape()->size_of_facets());
+
+			G4ThreeVector position = spheroid->GetTranslation() + cellVolume->GetTranslation();
+			REQUIRE(position.x() == Approx(cell->getOrigin().x()*convertToG4).margin(1e-8));
+			REQUIRE(position.y() == Approx(cell->getOrigin().y()*convertToG4).margin(1e-8));
+			REQUIRE(position.z() == Approx(cell->getOrigin().z()*convertToG4).margin(1e-8));
+
+			REQUIRE(cellVolume->GetLogicalVolume()->GetNoDaughters() == cell->getNuclei().size());
+			auto const* nucleus = dynamic_cast<const RoundNucleus<double, Point_3, Vector_3>*>(cell->getNuclei().front());
+			auto* orb = dynamic_cast<G4Orb*>(cellVolume->GetLogicalVolume()->GetDaughter(0)->GetLogicalVolume()->GetSolid());
+			REQUIRE(orb);
+			REQUIRE(orb->GetRadius() == Approx(nucleus->getRadius()*convertToG4).margin(1e-8));
+		}
+	}
+
+	SECTION("Output does not depend on the number of threads") {
+		REQUIRE(IO::GDML::exportSpheroidalCells("population_1.gdml", cells, nullptr, 1));
+		REQUIRE(IO::GDML::exportSpheroidalCells("population_4.gdml", cells, nullptr, 4));
+		REQUIRE(readFile("population_1.gdml") == readFile("population_4.gdml"));
+	}
+
+	SECTION("Materials are written once and every reference is defined") {
+		REQUIRE(IO::GDML::exportSpheroidalCells("population.gdml", cells));
+		std::string content = readFile("population.gdml");
+
+		// the world material and the materials of the cells
+		std::set<std::string> expectedMaterials{MaterialManager::getInstance()->getDefaultMaterial()->GetName()};
+		for(auto* cell : cells) {
+			for(const G4Material* material : {
+				cell->getCellProperties()->getCytoplasmMaterial(cell->getLifeCycle()),
+				cell->getCellProperties()->getNucleusMaterial(cell->getLifeCycle())
+			}) {
+				if(material)
+					expectedMaterials.insert(material->GetName());
+			}
+		}
+
+		std::vector<std::string> materials = attributeValues(content, "<material name=\"");
+		REQUIRE(std::set<std::string>(materials.begin(), materials.end()) == expectedMaterials);
+		REQUIRE(materials.size() == expectedMaterials.size());
+
+		std::vector<std::string> materialRefs = attributeValues(content, "<materialref ref=\"");
+		REQUIRE(std::set<std::string>(materialRefs.begin(), materialRefs.end()) == expectedMaterials);
+
+		// solids and volumes are defined once and every reference points to a definition
+		std::set<std::string> solids;
+		for(std::string const& tag : {"<tessellated name=\"", "<orb name=\"", "<box name=\""}) {
+			for(auto const& name : attributeValues(content, tag))
+				REQUIRE(solids.insert(name).second);
+		}
+		for(auto const& ref : attributeValues(content, "<solidref ref=\""))
+			REQUIRE(solids.count(ref) == 1);
+
+		std::set<std::string> volumes;
+		for(auto const& name : attributeValues(content, "<volume name=\""))
+			REQUIRE(volumes.insert(name).second);
+		for(auto const& ref : attributeValues(content, "<volumeref ref=\""))
+			REQUIRE(volumes.count(ref) == 1);
+		for(auto const& ref : attributeValues(content, "<world ref=\""))
+			REQUIRE(volumes.count(ref) == 1);
+	}
+
+	delete mesh;
+}
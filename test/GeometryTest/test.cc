@@ -0,0 +1,285 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <CGAL/convex_hull_3.h>
+#include <CLHEP/Random/MTwistEngine.h>
+
+#include "BoundingBox.hh"
+#include "CellSettings.hh"
+#include "EnvironmentSettings.hh"
+#include "GeometrySettings.hh"
+#include "LinearOctree.hh"
+#include "MinimalDistanceGrid.hh"
+#include "RandomCellDistribution.hh"
+#include "RandomEngineManager.hh"
+#include "RoundCellProperties.hh"
+#include "SimpleSpheroidalCell.hh"
+#include "Slicer_3.hh"
+#include "SpheresSDelimitation.hh"
+#include "ThreadPool.hh"
+
+using Settings::Geometry::Point_2;
+using Settings::Geometry::Point_3;
+using Settings::Geometry::Vector_3;
+using Settings::nCell::t_Cell_3;
+using Settings::nEnvironment::t_Environment_3;
+using Settings::nEnvironment::t_SimulatedSubEnv_3;
+
+namespace {
+
+/// \brief return true if a point of pPoints is strictly closer than pDistance to pPoint
+bool bruteForceHasNeighbour(const std::vector<Point_3>& pPoints, const Point_3& pPoint, double pDistance) {
+	for(const Point_3& other : pPoints) {
+		if(CGAL::squared_distance(other, pPoint) < pDistance*pDistance)
+			return true;
+	}
+	return false;
+}
+
+/// \brief return the area of the convex polygon made of the given segments, in any order and orientation
+double convexSectionArea(const std::vector<std::pair<Point_2, Point_2>>& pSegments) {
+	std::vector<Point_2> points;
+	for(auto const& segment : pSegments) {
+		points.push_back(segment.first);
+		points.push_back(segment.second);
+	}
+
+	double cx = 0., cy = 0.;
+	for(auto const& point : points) {
+		cx += point.x();
+		cy += point.y();
+	}
+	cx /= static_cast<double>(points.size());
+	cy /= static_cast<double>(points.size());
+
+	std::sort(points.begin(), points.end(), [cx, cy](const Point_2& a, const Point_2& b) {
+		return std::atan2(a.y() - cy, a.x() - cx) < std::atan2(b.y() - cy, b.x() - cx);
+	});
+
+	double area = 0.;
+	for(std::size_t iPoint = 0; iPoint < points.size(); ++iPoint) {
+		const Point_2& a = points[iPoint];
+		const Point_2& b = points[(iPoint + 1) % points.size()];
+		area += a.x()*b.y() - b.x()*a.y();
+	}
+	return std::abs(area)/2.;
+}
+
+}
+
+TEST_CASE("Minimal distance grid", "[Geometry]") {
+	std::mt19937 generator(1234567);
+	// a few points are drawn outside the box to check the clamping at the grid border
+	std::uniform_real_distribution<double> coordinate(-11., 11.);
+	BoundingBox<Point_3> box(Point_3(-10., -10., -10.), Point_3(10., 10., 10.));
+
+	for(double minimalDistance : {0.5, 2., 7.}) {
+		Utils::Geometry::MinimalDistanceGrid grid(box, minimalDistance, 500);
+		std::vector<Point_3> inserted;
+		for(int iPoint = 0; iPoint < 2000; ++iPoint) {
+			Point_3 point(coordinate(generator), coordinate(generator), coordinate(generator));
+			bool expected = !bruteForceHasNeighbour(inserted, point, minimalDistance);
+			REQUIRE(grid.hasNeighbour(point) == !expected);
+			REQUIRE(grid.tryInsert(point) == expected);
+			if(expected)
+				inserted.push_back(point);
+		}
+
+		REQUIRE(grid.size() == inserted.size());
+		REQUIRE(grid.points() == inserted);
+	}
+}
+
+TEST_CASE("Bulk cell distribution keeps the life cycle rates", "[Geometry]") {
+	CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	RoundCellProperties properties;
+	properties.automaticFill(CellVariableAttribute<double>(4., 4.), CellVariableAttribute<double>(1., 1.), CellVariableAttribute<double>(2., 2.));
+	const std::map<LifeCycles::LifeCycle, double> rates = {{LifeCycles::G1, 0.5}, {LifeCycles::S, 0.25}, {LifeCycles::G2, 0.25}};
+
+	// distribute 1000 cells in a sphere and return the positions of the cells of each life cycle
+	auto distribute = [&](double pSphereRadius, double pMinimalDistance) {
+		auto* env = new t_Environment_3("bulk test environment");
+		auto* subEnv = new t_SimulatedSubEnv_3(env, "bulk test sub environment", new SpheresSDelimitation(0., pSphereRadius));
+
+		RandomCellDistribution<double, Point_3, Vector_3> distribution;
+		distribution.setBulk(true);
+		distribution.setMinimalDistance(pMinimalDistance);
+		distribution.distribute(subEnv, &properties, 1000, rates);
+
+		std::map<LifeCycles::LifeCycle, std::vector<Point_3>> positions;
+		for(auto const* agent : subEnv->getUniqueAgentsAndSubAgents()) {
+			if(auto const* cell = dynamic_cast<const t_Cell_3*>(agent))
+				positions[cell->getLifeCycle()].push_back(cell->getPosition());
+		}
+		delete env;
+		return positions;
+	};
+
+	SECTION("All the cells are placed") {
+		auto positions = distribute(100., 0.);
+		REQUIRE(positions[LifeCycles::G1].size() == 500);
+		REQUIRE(positions[LifeCycles::S].size() == 250);
+		REQUIRE(positions[LifeCycles::G2].size() == 250);
+	}
+
+	SECTION("The minimal distance can't be respected for all the cells") {
+		// balls of radius 5 around the cells do not overlap and stay in a sphere of radius 35 : at most (35/5)^3 = 343 cells
+		const double minimalDistance = 10.;
+		auto positions = distribute(30., minimalDistance);
+
+		std::vector<Point_3> all;
+		for(auto const& [lifeCycle, lifeCyclePositions] : positions)
+			all.insert(all.end(), lifeCyclePositions.begin(), lifeCyclePositions.end());
+		REQUIRE(all.size() > 0);
+		REQUIRE(all.size() < 1000);
+		for(std::size_t iPoint = 0; iPoint < all.size(); ++iPoint) {
+			for(std::size_t jPoint = iPoint + 1; jPoint < all.size(); ++jPoint)
+				REQUIRE(CGAL::squared_distance(all[iPoint], all[jPoint]) >= minimalDistance*minimalDistance);
+		}
+
+		// the missing cells are spread over the life cycles
+		for(auto const& [lifeCycle, rate] : rates)
+			REQUIRE(std::abs(static_cast<double>(positions[lifeCycle].size()) - rate*all.size()) <= 1.);
+	}
+}
+
+TEST_CASE("Slicer of a cubic cell", "[Geometry]") {
+	// a cell whose membrane is the cube [-1, 1]^3, with a nucleus of radius 0.5 at its origin
+	std::vector<Point_3> corners;
+	for(double x : {-1., 1.})
+		for(double y : {-1., 1.})
+			for(double z : {-1., 1.})
+				corners.emplace_back(x, y, z);
+	Mesh3D::Polyhedron_3 cube;
+	CGAL::convex_hull_3(corners.begin(), corners.end(), cube);
+	REQUIRE(cube.size_of_facets() == 12);
+
+	RoundCellProperties properties;
+	SimpleSpheroidalCell cell(&properties, Point_3(0., 0., 0.), 2., 0.5, ORIGIN, 1., cube);
+	cell.setNucleusCenter();
+
+	Slicer_3 slicer({&cell}, TOP);
+	REQUIRE(slicer.getMin() == Approx(-1.));
+	REQUIRE(slicer.getMax() == Approx(1.));
+	REQUIRE(slicer.cut(1.5).empty());
+
+	auto sections = slicer.cut(0.3);
+	REQUIRE(sections.size() == 1);
+	auto const& section = sections.front();
+	REQUIRE(section.cellID == cell.getID());
+
+	// each of the 8 side triangles is crossed once, the top and bottom ones are not crossed
+	REQUIRE(section.membrane.size() == 8);
+	bool corner[2][2] = {{false, false}, {false, false}};
+	for(auto const& segment : section.membrane) {
+		for(const Point_2& point : {segment.first, segment.second}) {
+			// the section is the square [-1, 1]^2
+			REQUIRE(std::max(std::abs(point.x()), std::abs(point.y())) == Approx(1.));
+			if(std::abs(std::abs(point.x()) - 1.) < 1e-12 && std::abs(std::abs(point.y()) - 1.) < 1e-12)
+				corner[point.x() > 0.][point.y() > 0.] = true;
+		}
+	}
+	REQUIRE(corner[0][0]);
+	REQUIRE(corner[0][1]);
+	REQUIRE(corner[1][0]);
+	REQUIRE(corner[1][1]);
+	REQUIRE(convexSectionArea(section.membrane) == Approx(4.));
+
+	REQUIRE(section.nuclei.size() == 1);
+	REQUIRE(section.nuclei.front().first.x() == Approx(0.).margin(1e-12));
+	REQUIRE(section.nuclei.front().first.y() == Approx(0.).margin(1e-12));
+	REQUIRE(section.nuclei.front().second == Approx(0.4));
+
+	// the x axis gives (y, z) sections
+	Slicer_3 xSlicer({&cell}, RIGHT);
+	auto xSections = xSlicer.cut(-0.5);
+	REQUIRE(xSections.size() == 1);
+	REQUIRE(convexSectionArea(xSections.front().membrane) == Approx(4.));
+	REQUIRE(xSections.front().nuclei.size() == 0);
+}
+
+TEST_CASE("Linear octree queries", "[Geometry]") {
+	std::mt19937 generator(1234567);
+	std::uniform_real_distribution<double> coordinate(-100., 100.);
+	std::uniform_real_distribution<double> radius(1., 8.);
+
+	// enough cells for the rebuild to be split in several chunks
+	RoundCellProperties properties;
+	std::vector<std::unique_ptr<SimpleSpheroidalCell>> cells;
+	std::vector<const t_SpatialableAgent_3*> agents;
+	for(int iCell = 0; iCell < 40000; ++iCell) {
+		double cellRadius = radius(generator);
+		cells.push_back(std::make_unique<SimpleSpheroidalCell>(
+			&properties, Point_3(coordinate(generator), coordinate(generator), coordinate(generator)), cellRadius, 0.5*cellRadius
+		));
+		agents.push_back(cells.back().get());
+	}
+
+	auto checkQueries = [&](const LinearOctree& octree) {
+		REQUIRE(octree.size() == cells.size());
+
+		for(int iQuery = 0; iQuery < 200; ++iQuery) {
+			Point_3 point(coordinate(generator), coordinate(generator), coordinate(generator));
+			double minDistance = std::numeric_limits<double>::max();
+			for(auto const* agent : agents)
+				minDistance = std::min(minDistance, CGAL::squared_distance(point, agent->getPosition()));
+			auto const* nearest = octree.getNearestSpatialableAgent(point);
+			REQUIRE(nearest);
+			REQUIRE(CGAL::squared_distance(point, nearest->getPosition()) == minDistance);
+
+			double sphereRadius = 20.*radius(generator);
+			std::set<const t_SpatialableAgent_3*> expected;
+			for(auto const* agent : agents) {
+				if(CGAL::squared_distance(point, agent->getPosition()) <= sphereRadius*sphereRadius)
+					expected.insert(agent);
+			}
+			std::vector<const t_SpatialableAgent_3*> inSphere;
+			octree.getAgentsInSphere(point, sphereRadius, inSphere);
+			REQUIRE(inSphere.size() == expected.size());
+			REQUIRE(std::set<const t_SpatialableAgent_3*>(inSphere.begin(), inSphere.end()) == expected);
+		}
+
+		for(std::size_t iCell = 0; iCell < cells.size(); iCell += 997) {
+			auto const* cell = cells[iCell].get();
+			std::set<const t_SpatialableAgent_3*> expected;
+			for(auto const& other : cells) {
+				if(other.get() != cell && CGAL::squared_distance(cell->getPosition(), other->getPosition()) <= std::max(cell->getSquareRadius(), other->getSquareRadius()))
+					expected.insert(other.get());
+			}
+			REQUIRE(octree.getNeighbours(cell) == expected);
+		}
+	};
+
+	unsigned int nbThreadBefore = ThreadPool::getInstance()->getNbThread();
+	for(unsigned int nbThread : {1u, 4u}) {
+		ThreadPool::getInstance()->setNbThread(nbThread);
+		LinearOctree octree;
+		octree.build(agents.begin(), agents.end());
+		checkQueries(octree);
+
+		// small moves refit the octree, large ones rebuild it
+		for(auto& cell : cells)
+			cell->setPosition(Point_3(cell->getPosition().x() + 0.5, cell->getPosition().y(), cell->getPosition().z()));
+		REQUIRE(!octree.update());
+		checkQueries(octree);
+
+		for(auto& cell : cells)
+			cell->setPosition(Point_3(cell->getPosition().x() - 0.5, cell->getPosition().y() + 20., cell->getPosition().z()));
+		REQUIRE(octree.update());
+		checkQueries(octree);
+
+		for(auto& cell : cells)
+			cell->setPosition(Point_3(cell->getPosition().x(), cell->getPosition().y() - 20., cell->getPosition().z()));
+	}
+	ThreadPool::getInstance()->setNbThread(nbThreadBefore);
+}
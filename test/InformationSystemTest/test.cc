@@ -0,0 +1,157 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "InformationSystemManager.hh"
+#include "MessageRingBuffer.hh"
+
+namespace {
+
+/// \brief redirect std::cout to a string for the lifetime of the object
+class CoutCapture {
+public:
+	CoutCapture(): _previous(std::cout.rdbuf(_stream.rdbuf())) {}
+	~CoutCapture() { std::cout.rdbuf(_previous); }
+
+	std::string str() const { return _stream.str(); }
+
+private:
+	std::ostringstream _stream;
+	std::streambuf* _previous;
+};
+
+std::size_t countLines(const std::string& pText, const std::string& pPattern) {
+	std::size_t nbLines = 0;
+	std::istringstream stream(pText);
+	for(std::string line; std::getline(stream, line);)
+		nbLines += line.find(pPattern) != std::string::npos;
+	return nbLines;
+}
+
+}
+
+TEST_CASE("Message ring buffer", "[InformationSystem]") {
+	SECTION("Capacity is rounded to a power of two") {
+		MessageRingBuffer buffer(5);
+		REQUIRE(buffer.capacity() == 8);
+	}
+
+	SECTION("Full buffer") {
+		MessageRingBuffer buffer(4);
+		for(int i = 0; i < 4; ++i)
+			REQUIRE(buffer.push(std::to_string(i)));
+
+		std::string message = "rejected";
+		REQUIRE(!buffer.push(std::move(message)));
+		// the message is only moved on success
+		REQUIRE(message == "rejected");
+
+		std::string line;
+		REQUIRE(buffer.pop(line));
+		REQUIRE(line == "0");
+		REQUIRE(buffer.push(std::move(message)));
+	}
+
+	SECTION("Wrap around") {
+		MessageRingBuffer buffer(4);
+		std::string line;
+		for(int i = 0; i < 100; ++i) {
+			REQUIRE(buffer.push(std::to_string(2*i)));
+			REQUIRE(buffer.push(std::to_string(2*i + 1)));
+			REQUIRE(buffer.pop(line));
+			REQUIRE(line == std::to_string(2*i));
+			REQUIRE(buffer.pop(line));
+			REQUIRE(line == std::to_string(2*i + 1));
+		}
+		REQUIRE(!buffer.pop(line));
+	}
+
+	SECTION("Several producers") {
+		constexpr int nbProducer = 4;
+		constexpr int nbMessagePerProducer = 10000;
+		MessageRingBuffer buffer(64);
+
+		std::vector<std::thread> producers;
+		for(int iProducer = 0; iProducer < nbProducer; ++iProducer) {
+			producers.emplace_back([&buffer, iProducer] {
+				for(int iMessage = 0; iMessage < nbMessagePerProducer; ++iMessage) {
+					std::string message = std::to_string(iProducer) + " " + std::to_string(iMessage);
+					while(!buffer.push(std::move(message)))
+						std::this_thread::yield();
+				}
+			});
+		}
+
+		// messages of a producer are read in the order they were pushed
+		std::vector<int> nextMessage(nbProducer, 0);
+		std::string line;
+		for(int nbRead = 0; nbRead < nbProducer*nbMessagePerProducer;) {
+			if(!buffer.pop(line)) {
+				std::this_thread::yield();
+				continue;
+			}
+			std::istringstream stream(line);
+			int iProducer, iMessage;
+			stream >> iProducer >> iMessage;
+			REQUIRE(iMessage == nextMessage[iProducer]);
+			++nextMessage[iProducer];
+			++nbRead;
+		}
+
+		for(auto& producer : producers)
+			producer.join();
+		REQUIRE(!buffer.pop(line));
+		REQUIRE(std::all_of(nextMessage.begin(), nextMessage.end(), [](int pNext) { return pNext == nbMessagePerProducer; }));
+	}
+}
+
+TEST_CASE("Message rate limit", "[InformationSystem]") {
+	// the rate is counted per thread : use a new thread so no window is open yet
+	auto sendMessages = [](InformationSystemManager& pManager, int pNbMessage) {
+		std::thread([&pManager, pNbMessage] {
+			for(int i = 0; i < pNbMessage; ++i)
+				pManager.Message(InformationSystemManager::INFORMATION_MES, "message " + std::to_string(i), "test");
+		}).join();
+	};
+
+	SECTION("No limit by default") {
+		CoutCapture capture;
+		{
+			InformationSystemManager manager;
+			manager.setAsynchronous(false);
+			sendMessages(manager, 2000);
+		}
+		REQUIRE(countLines(capture.str(), "@@@ test") == 2000);
+		REQUIRE(countLines(capture.str(), "suppressed") == 0);
+	}
+
+	SECTION("Suppressed messages are reported when the writer stops") {
+		CoutCapture capture;
+		{
+			InformationSystemManager manager;
+			manager.setAsynchronous(false);
+			manager.setMaxMessagesPerSecond(5);
+			sendMessages(manager, 20);
+			REQUIRE(countLines(capture.str(), "@@@ test") == 5);
+		}
+		REQUIRE(countLines(capture.str(), "15 message(s) suppressed by the rate limit") == 1);
+	}
+
+	SECTION("Fatal errors are never suppressed") {
+		CoutCapture capture;
+		{
+			InformationSystemManager manager;
+			manager.setMaxMessagesPerSecond(1);
+			std::thread([&manager] {
+				for(int i = 0; i < 10; ++i)
+					manager.Message(InformationSystemManager::FATAL_ERROR_MES, "fatal", "test");
+			}).join();
+		}
+		REQUIRE(countLines(capture.str(), "@@@ test") == 10);
+	}
+}
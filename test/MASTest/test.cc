@@ -0,0 +1,391 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AgentRegistry.hh"
+#include "AgentSettings.hh"
+#include "IDManager.hh"
+#include "SimulationProfiler.hh"
+#include "SpatialConflictSolver.hh"
+#include "ThreadPool.hh"
+
+using namespace Settings::nAgent;
+
+namespace {
+
+using t_Agents = std::vector<std::unique_ptr<t_DynamicAgent_3>>;
+
+/// \brief return the position of the agent at the end of the step
+Point_3 getNextPosition(const t_DynamicAgent_3& pAgent) {
+	return pAgent.isRequiringNewPos() ? pAgent.getRequestedPosition() : pAgent.getPosition();
+}
+
+/// \brief request the given moves, solve the conflicts with the agents given in a random order and return the next positions
+std::vector<Point_3> solve(const SpatialConflictSolver<double, Point_3, Vector_3>& pSolver, const t_Agents& pAgents, const std::vector<Vector_3>& pMoves, unsigned int pSeed) {
+	std::vector<Agent*> agents;
+	for(std::size_t iAgent = 0; iAgent < pAgents.size(); ++iAgent) {
+		pAgents[iAgent]->setRequestedPosition(pAgents[iAgent]->getPosition() + pMoves[iAgent]);
+		pAgents[iAgent]->setIsRequiringNewPos(pMoves[iAgent] != CGAL::NULL_VECTOR);
+		agents.push_back(pAgents[iAgent].get());
+	}
+	std::mt19937 generator(pSeed);
+	std::shuffle(agents.begin(), agents.end(), generator);
+	REQUIRE(pSolver.solveConflict(agents));
+
+	std::vector<Point_3> positions;
+	for(auto const& agent : pAgents)
+		positions.push_back(getNextPosition(*agent));
+	return positions;
+}
+
+}
+
+TEST_CASE("ID manager", "[MAS]") {
+	IDManager::getInstance()->destroyInstance();
+	IDManager* manager = IDManager::getInstance();
+
+	SECTION("IDs start at 1 in each ID space") {
+		REQUIRE(manager->getID() == 1);
+		REQUIRE(manager->getID() == 2);
+
+		IDManager::IDSpace space = manager->registerIDSpace("test_IDsMap");
+		REQUIRE(space != IDManager::agentIDSpace);
+		REQUIRE(manager->registerIDSpace("test_IDsMap") == space);
+		REQUIRE(manager->getID(space) == 1);
+		REQUIRE(manager->getSpecificIDFor("test_IDsMap") == 2);
+		REQUIRE(manager->getID() == 3);
+		REQUIRE(manager->registerIDSpace("agent_IDsMap") == IDManager::agentIDSpace);
+	}
+
+	SECTION("Reset restarts the IDs and keeps the handles") {
+		IDManager::IDSpace space = manager->registerIDSpace("test_IDsMap");
+		manager->getID();
+		manager->getID(space);
+		manager->reset();
+		REQUIRE(manager->registerIDSpace("test_IDsMap") == space);
+		REQUIRE(manager->getID() == 1);
+		REQUIRE(manager->getID(space) == 1);
+	}
+
+	SECTION("Handles survive the destruction of the instance") {
+		IDManager::IDSpace first = manager->registerIDSpace("first_IDsMap");
+		IDManager::IDSpace second = manager->registerIDSpace("second_IDsMap");
+		manager->getID(second);
+		manager->getID(second);
+
+		manager->destroyInstance();
+		manager = IDManager::getInstance();
+
+		// a cached handle still addresses its own space, restarted from the first ID
+		REQUIRE(manager->registerIDSpace("second_IDsMap") == second);
+		REQUIRE(manager->registerIDSpace("first_IDsMap") == first);
+		REQUIRE(manager->getID(second) == 1);
+		REQUIRE(manager->getID(first) == 1);
+		REQUIRE(manager->getSpecificIDFor("second_IDsMap") == 2);
+	}
+
+	SECTION("Reserved ranges") {
+		manager->getID();
+		IDRange range = manager->reserveIDs(10);
+		REQUIRE(range.first == 2);
+		REQUIRE(range.size() == 10);
+		REQUIRE(manager->getID() == 12);
+
+		// an ID was given since the reservation, the range can't be given back
+		REQUIRE(!manager->unreserveIDs(range));
+		IDRange last = manager->reserveIDs(5);
+		REQUIRE(manager->unreserveIDs(last));
+		REQUIRE(manager->getID() == 13);
+
+		// agents take their IDs from the installed range, then from the shared counter once it is empty
+		IDRange agentIDs = manager->reserveIDs(2);
+		{
+			IDManager::ScopedIDRange scopedIDs(&agentIDs);
+			t_DynamicAgent_3 first(nullptr, Point_3(0., 0., 0.));
+			t_DynamicAgent_3 second(nullptr, Point_3(0., 0., 0.));
+			t_DynamicAgent_3 third(nullptr, Point_3(0., 0., 0.));
+			REQUIRE(first.getID() == 14);
+			REQUIRE(second.getID() == 15);
+			REQUIRE(third.getID() == 16);
+			REQUIRE(agentIDs.empty());
+		}
+		t_DynamicAgent_3 outside(nullptr, Point_3(0., 0., 0.));
+		REQUIRE(outside.getID() == 17);
+	}
+
+	SECTION("Reserved ranges give the same IDs on 1 and 4 threads") {
+		// item i creates i%3 agents, from a range reserved per item in item order
+		constexpr std::size_t nbItem = 200;
+		constexpr unsigned long int nbIDPerItem = 4;
+		auto createAgents = [manager, nbItem]() {
+			IDRange reserved = manager->reserveIDs(nbItem*nbIDPerItem);
+			std::vector<IDRange> itemIDs(nbItem);
+			for(std::size_t iItem = 0; iItem < nbItem; ++iItem)
+				itemIDs[iItem] = {reserved.first + iItem*nbIDPerItem, reserved.first + (iItem + 1)*nbIDPerItem};
+
+			std::vector<std::vector<unsigned long int>> ids(nbItem);
+			ThreadPool::getInstance()->parallelFor(nbItem, [&](std::size_t pBegin, std::size_t pEnd) {
+				for(std::size_t iItem = pBegin; iItem < pEnd; ++iItem) {
+					IDManager::ScopedIDRange scopedIDs(&itemIDs[iItem]);
+					for(std::size_t iAgent = 0; iAgent < iItem%3; ++iAgent)
+						ids[iItem].push_back(t_DynamicAgent_3(nullptr, Point_3(0., 0., 0.)).getID());
+				}
+			});
+			return ids;
+		};
+
+		unsigned int nbThreadBefore = ThreadPool::getInstance()->getNbThread();
+		ThreadPool::getInstance()->setNbThread(1);
+		manager->reset();
+		auto sequentialIDs = createAgents();
+		ThreadPool::getInstance()->setNbThread(4);
+		manager->reset();
+		auto parallelIDs = createAgents();
+		ThreadPool::getInstance()->setNbThread(nbThreadBefore);
+
+		REQUIRE(parallelIDs == sequentialIDs);
+		REQUIRE(sequentialIDs[2] == std::vector<unsigned long int>{9, 10});
+	}
+
+	SECTION("IDs are unique across threads") {
+		constexpr int nbThread = 8;
+		constexpr int nbIDPerThread = 10000;
+		std::vector<std::vector<unsigned long int>> threadIDs(nbThread);
+		std::vector<std::thread> threads;
+		for(int iThread = 0; iThread < nbThread; ++iThread) {
+			threads.emplace_back([manager, &ids = threadIDs[iThread]] {
+				for(int iID = 0; iID < nbIDPerThread; ++iID)
+					ids.push_back(manager->getID());
+			});
+		}
+		for(auto& thread : threads)
+			thread.join();
+
+		std::vector<unsigned long int> ids;
+		for(auto const& lThreadIDs : threadIDs)
+			ids.insert(ids.end(), lThreadIDs.begin(), lThreadIDs.end());
+		std::sort(ids.begin(), ids.end());
+		REQUIRE(ids.front() == 1);
+		REQUIRE(ids.back() == nbThread*nbIDPerThread);
+		REQUIRE(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+	}
+
+	manager->destroyInstance();
+}
+
+TEST_CASE("Spatial conflict solver", "[MAS]") {
+	constexpr double radius = 1.;
+	constexpr double tolerance = 0.2;
+	SpatialConflictSolver<double, Point_3, Vector_3> solver(radius, tolerance);
+	double minDistance = 2*radius - tolerance;
+
+	SECTION("Agents moving toward each other do not overlap and the result does not depend on threads nor order") {
+		// agents on a grid, not overlapping, all moving toward the center. Some of them stay still.
+		std::mt19937 generator(1234567);
+		std::uniform_real_distribution<double> length(0., 3.*radius);
+		t_Agents agents;
+		std::vector<Vector_3> moves;
+		for(int x = -5; x <= 5; ++x) {
+			for(int y = -5; y <= 5; ++y) {
+				for(int z = -2; z <= 2; ++z) {
+					Point_3 position(2.5*radius*x, 2.5*radius*y, 2.5*radius*z);
+					agents.push_back(std::make_unique<t_DynamicAgent_3>(nullptr, position));
+					Vector_3 toCenter = CGAL::ORIGIN - position;
+					double distance = std::sqrt(toCenter.squared_length());
+					moves.push_back((distance > 0. && (x + y + z) % 4 != 0) ? toCenter*(length(generator)/distance) : CGAL::NULL_VECTOR);
+				}
+			}
+		}
+
+		unsigned int nbThreadBefore = ThreadPool::getInstance()->getNbThread();
+		ThreadPool::getInstance()->setNbThread(1);
+		std::vector<Point_3> positions = solve(solver, agents, moves, 1);
+		REQUIRE(solver.getNbConflictLastCall() > 0);
+		unsigned int nbConflict = solver.getNbConflictLastCall();
+
+		for(std::size_t iAgent = 0; iAgent < positions.size(); ++iAgent) {
+			for(std::size_t iOther = iAgent + 1; iOther < positions.size(); ++iOther)
+				REQUIRE(CGAL::squared_distance(positions[iAgent], positions[iOther]) >= Approx(minDistance*minDistance));
+		}
+
+		ThreadPool::getInstance()->setNbThread(4);
+		for(unsigned int seed : {2u, 3u}) {
+			REQUIRE(solve(solver, agents, moves, seed) == positions);
+			REQUIRE(solver.getNbConflictLastCall() == nbConflict);
+		}
+		ThreadPool::getInstance()->setNbThread(nbThreadBefore);
+	}
+
+	SECTION("A move which can't be solved is cancelled") {
+		// the moving agent already overlaps the still one, any part of its move keeps the overlap
+		t_Agents agents;
+		agents.push_back(std::make_unique<t_DynamicAgent_3>(nullptr, Point_3(0., 0., 0.)));
+		agents.push_back(std::make_unique<t_DynamicAgent_3>(nullptr, Point_3(radius, 0., 0.)));
+		std::vector<Point_3> positions = solve(solver, agents, {CGAL::NULL_VECTOR, Vector_3(0.5*radius, 0., 0.)}, 1);
+
+		REQUIRE(solver.getNbConflictLastCall() == 1);
+		REQUIRE(solver.getNbCancelledMoveLastCall() == 1);
+		REQUIRE(positions[1] == agents[1]->getPosition());
+	}
+
+	SECTION("A move solved before the maximal number of iterations is kept in part") {
+		t_Agents agents;
+		agents.push_back(std::make_unique<t_DynamicAgent_3>(nullptr, Point_3(0., 0., 0.)));
+		agents.push_back(std::make_unique<t_DynamicAgent_3>(nullptr, Point_3(4.*radius, 0., 0.)));
+		std::vector<Point_3> positions = solve(solver, agents, {CGAL::NULL_VECTOR, Vector_3(-3.*radius, 0., 0.)}, 1);
+
+		REQUIRE(solver.getNbConflictLastCall() == 1);
+		REQUIRE(solver.getNbCancelledMoveLastCall() == 0);
+		REQUIRE(positions[1].x() < agents[1]->getPosition().x());
+		REQUIRE(positions[1].x() >= minDistance);
+	}
+}
+
+TEST_CASE("Agent registry", "[MAS]") {
+	std::vector<std::unique_ptr<t_SpatialableAgent_3>> agents;
+	for(int iAgent = 0; iAgent < 5; ++iAgent)
+		agents.push_back(std::make_unique<t_SpatialableAgent_3>(nullptr));
+	auto agent = [&agents](int pIndex) -> Agent* { return agents[pIndex].get(); };
+
+	AgentRegistry registry;
+	for(int iAgent = 0; iAgent < 4; ++iAgent)
+		REQUIRE(registry.insert(agent(iAgent)));
+
+	SECTION("Agents keep the insertion order") {
+		REQUIRE(registry.size() == 4);
+		for(int iAgent = 0; iAgent < 4; ++iAgent) {
+			REQUIRE(registry[iAgent] == agent(iAgent));
+			REQUIRE(registry.indexOf(agent(iAgent)) == static_cast<std::size_t>(iAgent));
+		}
+		REQUIRE(!registry.contains(agent(4)));
+		REQUIRE(registry.indexOf(agent(4)) == registry.size());
+	}
+
+	SECTION("Adding an agent twice keeps one entry") {
+		REQUIRE(!registry.insert(agent(2)));
+		std::vector<Agent*> toAdd = {agent(1), agent(4), agent(4)};
+		registry.insert(toAdd.begin(), toAdd.end());
+		REQUIRE(registry.size() == 5);
+		REQUIRE(registry.indexOf(agent(4)) == 4);
+	}
+
+	SECTION("Removing an agent moves the last one at its place") {
+		REQUIRE(registry.erase(agent(1)));
+		REQUIRE(registry.size() == 3);
+		REQUIRE(!registry.contains(agent(1)));
+		REQUIRE(registry[1] == agent(3));
+		REQUIRE(registry.indexOf(agent(3)) == 1);
+		REQUIRE(registry.indexOf(agent(0)) == 0);
+		REQUIRE(registry.indexOf(agent(2)) == 2);
+
+		// the last agent itself
+		REQUIRE(registry.erase(agent(2)));
+		REQUIRE(registry.getAgents() == std::vector<Agent*>({agent(0), agent(3)}));
+		REQUIRE(registry.indexOf(agent(3)) == 1);
+
+		// the moved agent can still be removed
+		REQUIRE(registry.erase(agent(3)));
+		REQUIRE(registry.getAgents() == std::vector<Agent*>({agent(0)}));
+		REQUIRE(registry.insert(agent(1)));
+		REQUIRE(registry.indexOf(agent(1)) == 1);
+	}
+
+	SECTION("Removing a missing agent does nothing") {
+		REQUIRE(!registry.erase(agent(4)));
+		REQUIRE(registry.erase(agent(0)));
+		REQUIRE(!registry.erase(agent(0)));
+		REQUIRE(registry.size() == 3);
+		for(auto* registered : registry)
+			REQUIRE(registry[registry.indexOf(registered)] == registered);
+	}
+
+	SECTION("A range visits each agent once") {
+		AgentRegistry other;
+		other.insert(agent(2));
+		other.insert(agent(4));
+		other.insert(agent(0));
+		AgentRegistry empty;
+
+		AgentRange range({&empty, &registry, &empty, &other});
+		std::vector<Agent*> visited(range.begin(), range.end());
+		REQUIRE(visited == std::vector<Agent*>({agent(0), agent(1), agent(2), agent(3), agent(4)}));
+		REQUIRE(range.size() == 5);
+		REQUIRE(range.contains(agent(4)));
+
+		AgentRange filtered({&registry, &other}, [](const Agent* pAgent) { return pAgent->getID() % 2 == 0; });
+		for(auto* viewed : filtered)
+			REQUIRE(viewed->getID() % 2 == 0);
+		std::size_t nbEven = std::count_if(agents.begin(), agents.end(), [](auto const& a) { return a->getID() % 2 == 0; });
+		REQUIRE(filtered.size() == nbEven);
+
+		REQUIRE(AgentRange({&empty}).empty());
+		REQUIRE(AgentRange().empty());
+	}
+}
+
+TEST_CASE("Simulation profiler", "[MAS]") {
+	// step i lasts i ms in the agents phase, with i agents executed and moved and i conflicts
+	auto record = [](SimulationProfiler& pProfiler, unsigned int pNbStep) {
+		for(unsigned int iStep = 0; iStep < pNbStep; ++iStep) {
+			pProfiler.beginStep(0.5);
+			pProfiler.addPhaseDuration(SimulationProfiler::AGENTS, std::chrono::milliseconds(iStep));
+			pProfiler.addThreadBusy(std::chrono::milliseconds(iStep));
+			pProfiler.setAgentCounters(iStep, iStep);
+			pProfiler.addConflicts(iStep);
+		}
+	};
+
+	SimulationProfiler profiler(3);
+	REQUIRE(profiler.getSteps().empty());
+
+	SECTION("The ring buffer keeps the last steps, from the oldest to the newest") {
+		record(profiler, 5);
+		REQUIRE(profiler.getNbStepRecorded() == 5);
+		std::vector<SimulationProfiler::StepProfile> steps = profiler.getSteps();
+		REQUIRE(steps.size() == 3);
+		for(unsigned int iStep = 0; iStep < steps.size(); ++iStep) {
+			REQUIRE(steps[iStep].step == iStep + 2);
+			REQUIRE(steps[iStep].phases[SimulationProfiler::AGENTS] == Approx(1e-3*(iStep + 2)));
+			REQUIRE(steps[iStep].getDuration() == Approx(1e-3*(iStep + 2)));
+			REQUIRE(steps[iStep].threadBusy.size() == 1);
+			REQUIRE(steps[iStep].nbAgentExecuted == iStep + 2);
+			REQUIRE(steps[iStep].nbConflict == iStep + 2);
+		}
+	}
+
+	SECTION("Changing the capacity resets the recorded steps") {
+		record(profiler, 2);
+		profiler.setCapacity(2);
+		REQUIRE(profiler.getNbStepRecorded() == 0);
+		REQUIRE(profiler.getSteps().empty());
+
+		record(profiler, 3);
+		std::vector<SimulationProfiler::StepProfile> steps = profiler.getSteps();
+		REQUIRE(steps.size() == 2);
+		REQUIRE(steps[0].step == 1);
+		REQUIRE(steps[1].step == 2);
+	}
+
+	SECTION("The CSV export has a header and one row per kept step") {
+		record(profiler, 4);
+		REQUIRE(profiler.exportToCSV("profiler.csv"));
+
+		std::ifstream in("profiler.csv");
+		std::vector<std::string> lines;
+		for(std::string line; std::getline(in, line);)
+			lines.push_back(line);
+		REQUIRE(lines.size() == 4);
+		REQUIRE(lines[0].rfind("step,step_duration,pre_actions,agents,", 0) == 0);
+		for(unsigned int iRow = 1; iRow < lines.size(); ++iRow) {
+			REQUIRE(lines[iRow].rfind(std::to_string(iRow) + ",0.5,", 0) == 0);
+			REQUIRE(std::count(lines[iRow].begin(), lines[iRow].end(), ',') == std::count(lines[0].begin(), lines[0].end(), ','));
+		}
+	}
+}
@@ -0,0 +1,516 @@
+#include "catch.hpp"
+
+#include "CGAL_Utils.hh"
+#include "CPOP_Loader.hh"
+#include "Delaunay_3D_SDS.hh"
+#include "ElasticForce.hh"
+#include "File_CPOP_Data.hh"
+#include "File_Utils_OFF.hh"
+#include "IDManager.hh"
+#include "MASPlatform.hh"
+#include "MeshFactory.hh"
+#include "Mesh_Statistics.hh"
+#include "RandomEngineManager.hh"
+#include "SpheroidalCellMesh.hh"
+#include "ThreadPool.hh"
+
+#include <CGAL/convex_hull_3.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+
+using namespace Settings::nCell;
+using namespace Settings::nEnvironment;
+
+namespace {
+
+std::string readFile(std::string const& path) {
+	std::ifstream in(path, std::ios::binary);
+	std::stringstream content;
+	content << in.rdbuf();
+	return content.str();
+}
+
+/// \brief return the text without its surrounding spaces, as the names of the statistic columns
+std::string trim(std::string const& pText) {
+	std::size_t first = pText.find_first_not_of(' ');
+	return first == std::string::npos ? std::string() : pText.substr(first, pText.find_last_not_of(' ') - first + 1);
+}
+
+/// \brief split a CSV line
+std::vector<std::string> splitCSV(std::string const& pLine) {
+	std::vector<std::string> fields;
+	std::stringstream line(pLine);
+	std::string field;
+	while(std::getline(line, field, ','))
+		fields.push_back(field);
+	return fields;
+}
+
+/// \brief columns read back from a statistic file, by name
+struct StatsColumns {
+	std::vector<std::string> names;						///< \brief names of the columns, in the file order
+	std::map<std::string, std::vector<double>> values;	///< \brief values of each column
+	std::size_t nbRow = 0;								///< \brief number of rows
+};
+
+/// \brief read a CSV statistic file
+StatsColumns readStatsCSV(std::string const& pContent) {
+	StatsColumns columns;
+	std::stringstream in(pContent);
+	std::string line;
+	REQUIRE(std::getline(in, line));
+	columns.names = splitCSV(line);
+	while(std::getline(in, line)) {
+		auto const& fields = splitCSV(line);
+		REQUIRE(fields.size() == columns.names.size());
+		for(std::size_t iField = 0; iField < fields.size(); ++iField)
+			columns.values[columns.names[iField]].push_back(std::strtod(fields[iField].c_str(), nullptr));
+		++columns.nbRow;
+	}
+	return columns;
+}
+
+/// \brief read a binary statistic file, cf. Statistics::writeBinary for the layout
+StatsColumns readStatsBinary(std::string const& pContent, MeshOutFormats::outputFormat pFormat) {
+	std::size_t offset = 0;
+	auto get = [&pContent, &offset](auto& pValue) {
+		REQUIRE(offset + sizeof(pValue) <= pContent.size());
+		std::memcpy(&pValue, pContent.data() + offset, sizeof(pValue));
+		offset += sizeof(pValue);
+	};
+
+	REQUIRE(pContent.compare(0, 8, "CPOPSTAT") == 0);
+	offset = 8;
+	std::uint32_t version, format, nbColumn;
+	std::uint64_t nbRow;
+	get(version);
+	get(format);
+	get(nbRow);
+	get(nbColumn);
+	REQUIRE(version == 1);
+	REQUIRE(format == static_cast<std::uint32_t>(pFormat));
+
+	StatsColumns columns;
+	columns.nbRow = nbRow;
+	std::vector<std::uint8_t> types;
+	for(std::uint32_t iColumn = 0; iColumn < nbColumn; ++iColumn) {
+		std::uint32_t nameLength;
+		get(nameLength);
+		REQUIRE(offset + nameLength <= pContent.size());
+		columns.names.push_back(pContent.substr(offset, nameLength));
+		offset += nameLength;
+		std::uint8_t type;
+		get(type);
+		REQUIRE(type <= 1);
+		types.push_back(type);
+	}
+	for(std::uint32_t iColumn = 0; iColumn < nbColumn; ++iColumn) {
+		auto& values = columns.values[columns.names[iColumn]];
+		for(std::uint64_t iRow = 0; iRow < nbRow; ++iRow) {
+			if(types[iColumn] == 0) {
+				std::uint64_t value;
+				get(value);
+				values.push_back(static_cast<double>(value));
+			} else {
+				double value;
+				get(value);
+				values.push_back(value);
+			}
+		}
+	}
+	REQUIRE(offset == pContent.size());
+	return columns;
+}
+
+/// \brief return the signed distance from the point to the surface of the convex polyhedron, negative inside
+double signedDistance(const Polyhedron_3& pShape, const Point_3& pInner, const Point_3& pPoint) {
+	double distance = -std::numeric_limits<double>::max();
+	for(auto itFacet = pShape.facets_begin(); itFacet != pShape.facets_end(); ++itFacet) {
+		Plane_3 plane(
+			itFacet->halfedge()->vertex()->point(),
+			itFacet->halfedge()->next()->vertex()->point(),
+			itFacet->halfedge()->next()->next()->vertex()->point()
+		);
+		double facetDistance = std::sqrt(CGAL::squared_distance(plane, pPoint));
+		distance = std::max(distance, plane.oriented_side(pPoint) == plane.oriented_side(pInner) ? -facetDistance : facetDistance);
+	}
+	return distance;
+}
+
+/// \brief gives access to the exporters working on already meshed cells
+class ExportedMesh : public SpheroidalCellMesh {
+public:
+	using SpheroidalCellMesh::SpheroidalCellMesh;
+	using SpheroidalCellMesh::exportToFileOff_undivided;
+	using Voronoi_3D_Mesh::exportToFileSTL_undivided;
+};
+
+/// \brief the .off export as written before the buffered exporters
+void referenceExportOff(std::string const& pPath, std::vector<SpheroidalCell*> const& pCells) {
+	unsigned long int nbFacets = 0;
+	std::set<Point_3, comparePoint_3> points;
+	std::map<Point_3, unsigned long int, comparePoint_3> indexes;
+	std::ofstream* out = IO::OFF::createOffFileWithHeader(pPath + ".off");
+
+	for(auto* cell : pCells) {
+		points.insert(cell->shape_points_begin(), cell->shape_points_end());
+		nbFacets += Utils::myCGAL::getNumberOfFacets(cell->getShape());
+
+		for(auto const* nucleus : cell->getNuclei()) {
+			std::vector<Point_3> nucleusPoints = nucleus->getShapePoints();
+			points.insert(nucleusPoints.begin(), nucleusPoints.end());
+			Polyhedron_3 polyNucleus;
+			CGAL::convex_hull_3(nucleusPoints.begin(), nucleusPoints.end(), polyNucleus);
+			nbFacets += Utils::myCGAL::getNumberOfFacets(&polyNucleus);
+		}
+	}
+
+	*out << points.size() << " " << nbFacets << " 0" << std::endl;
+	IO::OFF::exportVerticesToOff(points, indexes, out);
+	for(auto* cell : pCells)
+		IO::OFF::exportSpheroidalCellToOff(cell, out, indexes);
+
+	out->close();
+	delete out;
+}
+
+/// \brief the .stl export as written before the buffered exporters
+void referenceExportSTL(std::string const& pPath, std::vector<SpheroidalCell*> const& pCells) {
+	std::uint32_t nbFacets = 0;
+	for(auto* cell : pCells)
+		nbFacets += Utils::myCGAL::getNumberOfFacets(cell->getShape());
+
+	std::ofstream of(pPath + ".stl", std::ios::trunc | std::ios::binary);
+	for(int i = 0; i < 80; ++i) of.write("*", 1);
+	of.write(reinterpret_cast<char*>(&nbFacets), sizeof nbFacets);
+
+	for(auto* cell : pCells) {
+		auto const* shape = cell->getShape();
+		for(auto it = shape->facets_begin(); it != shape->facets_end(); ++it) {
+			auto const& facetPoints = {
+				it->halfedge()->vertex()->point(),
+				it->halfedge()->next()->vertex()->point(),
+				it->halfedge()->next()->next()->vertex()->point()
+			};
+
+			float nx = 0, ny = 0, nz = 0;
+			of.write(reinterpret_cast<char*>(&nx), sizeof nx);
+			of.write(reinterpret_cast<char*>(&ny), sizeof ny);
+			of.write(reinterpret_cast<char*>(&nz), sizeof nz);
+
+			for(auto const& point : facetPoints) {
+				float x = point.x(), y = point.y(), z = point.z();
+				of.write(reinterpret_cast<char*>(&x), sizeof x);
+				of.write(reinterpret_cast<char*>(&y), sizeof y);
+				of.write(reinterpret_cast<char*>(&z), sizeof z);
+			}
+
+			std::uint16_t zero = 0;
+			of.write(reinterpret_cast<char*>(&zero), sizeof zero);
+		}
+	}
+}
+
+/// \brief the nuclei .txt export as written before the buffered exporters
+void referenceExportNuclei(std::string const& pPath, std::vector<SpheroidalCell*> const& pCells) {
+	std::ofstream of(pPath, std::ios::trunc);
+	for(auto* cell : pCells)
+		cell->exportNucleiToStream(of);
+}
+
+}
+
+TEST_CASE("Mesh exporters golden output", "[MeshExport]") {
+	CLHEP::MTwistEngine defaultEngineCPOP(1234567);
+	RandomEngineManager::getInstance()->setEngine(&defaultEngineCPOP);
+
+	CPOP_Loader loader;
+	auto* env = loader.load3DEnvironment("population.xml", true);
+	REQUIRE(env);
+
+	std::set<t_Cell_3*> lCells;
+	for(auto* agent : dynamic_cast<t_SimulatedSubEnv_3*>(env->getFirstChild())->getAgents(WITHOUT_DELIMITATION)) {
+		if(auto* cell = dynamic_cast<t_Cell_3*>(agent))
+			lCells.insert(cell);
+	}
+	REQUIRE(!lCells.empty());
+
+	ExportedMesh mesh(100, 0, lCells);
+	auto cells = mesh.generateMesh();
+	REQUIRE(!cells.empty());
+
+	SECTION("OFF") {
+		referenceExportOff("reference", cells);
+		REQUIRE(mesh.exportToFileOff_undivided("buffered", cells) == 0);
+		REQUIRE(readFile("buffered.off") == readFile("reference.off"));
+	}
+
+	SECTION("STL") {
+		referenceExportSTL("reference", cells);
+		REQUIRE(mesh.exportToFileSTL_undivided("buffered", cells) == 0);
+		REQUIRE(readFile("buffered.stl") == readFile("reference.stl"));
+	}
+
+	SECTION("Nuclei") {
+		referenceExportNuclei("reference_nuclei.txt", cells);
+		REQUIRE(SpheroidalCellMesh::exportNucleiToFile("buffered_nuclei.txt", cells));
+		REQUIRE(readFile("buffered_nuclei.txt") == readFile("reference_nuclei.txt"));
+	}
+}
+
+TEST_CASE("Output does not depend on the number of threads", "[MeshExport]") {
+	unsigned int nbThreadBefore = ThreadPool::getInstance()->getNbThread();
+	CLHEP::MTwistEngine engine;
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	// load, mesh and export the same population from scratch, meshing and exporting on pNbThread threads
+	auto exportPopulation = [&engine](unsigned int pNbThread) {
+		ThreadPool::getInstance()->setNbThread(pNbThread);
+		IDManager::getInstance()->reset();
+		engine.setSeed(1234567, 0);
+
+		CPOP_Loader loader;
+		auto* env = loader.load3DEnvironment("population.xml", true);
+		REQUIRE(env);
+
+		int error;
+		auto* mesh = dynamic_cast<SpheroidalCellMesh*>(MeshFactory::getInstance()->create_3DMesh(
+			&error,
+			dynamic_cast<t_SimulatedSubEnv_3*>(env->getFirstChild()),
+			MeshTypes::Round_Cell_Tesselation,
+			100,
+			0
+		));
+		REQUIRE(mesh);
+
+		std::string prefix = "threads_" + std::to_string(pNbThread);
+		REQUIRE(mesh->exportToFile(prefix, MeshOutFormats::OFF) == 0);
+		IO::CPOP::save(static_cast<Writable*>(env), QString::fromStdString(prefix + ".xml"));
+		delete mesh;
+	};
+
+	exportPopulation(1);
+	exportPopulation(4);
+	ThreadPool::getInstance()->setNbThread(nbThreadBefore);
+
+	for(std::string const& suffix : {".off", "_nuclei.txt", ".xml"}) {
+		std::string reference = readFile("threads_1" + suffix);
+		REQUIRE(!reference.empty());
+		REQUIRE(readFile("threads_4" + suffix) == reference);
+	}
+}
+
+TEST_CASE("Deterministic simulation steps do not depend on the number of threads", "[MeshExport]") {
+	unsigned int nbThreadBefore = ThreadPool::getInstance()->getNbThread();
+	CLHEP::MTwistEngine engine;
+	RandomEngineManager::getInstance()->setEngine(&engine);
+
+	// load the population, give its cells elastic forces, run a few deterministic steps on pNbThread threads and save it
+	auto simulatePopulation = [&engine](unsigned int pNbThread) {
+		ThreadPool::getInstance()->setNbThread(pNbThread);
+		IDManager::getInstance()->reset();
+		engine.setSeed(1234567, 0);
+
+		CPOP_Loader loader;
+		auto* env = loader.load3DEnvironment("population.xml", true);
+		REQUIRE(env);
+		auto* subEnv = dynamic_cast<t_SimulatedSubEnv_3*>(env->getFirstChild());
+		REQUIRE(subEnv);
+
+		int error;
+		t_Mesh_3* mesh = MeshFactory::getInstance()->create_3DMesh(&error, subEnv, MeshTypes::Round_Cell_Tesselation, 100, 0);
+		REQUIRE(mesh);
+		for(auto* cell : mesh->getCells())
+			cell->addForce(new ElasticForce<double, Point_3, Vector_3>(cell, 0.002, 0.7));
+		delete mesh;
+
+		std::string prefix = "steps_threads_" + std::to_string(pNbThread);
+		IO::CPOP::save(static_cast<Writable*>(env), QString::fromStdString(prefix + "_initial.xml"));
+
+		auto* platform = new MASPlatform();
+		platform->setLayerToSimulate(subEnv);
+		platform->setStepDuration(1.);
+		platform->setDuration(4.);
+		platform->setDisplacementThreshold(0.5);
+		platform->setDeterministic(true);
+		subEnv->addSpatialDataStructure(new Delaunay_3D_SDS("deterministic test SDS"));
+		REQUIRE(platform->startSimulation() == 0);
+		// also deletes the spatial data structure
+		delete platform;
+
+		IO::CPOP::save(static_cast<Writable*>(env), QString::fromStdString(prefix + ".xml"));
+	};
+
+	simulatePopulation(1);
+	simulatePopulation(4);
+	ThreadPool::getInstance()->setNbThread(nbThreadBefore);
+
+	std::string reference = readFile("steps_threads_1.xml");
+	REQUIRE(!reference.empty());
+	REQUIRE(readFile("steps_threads_4.xml") == reference);
+	// the comparison is meaningless if the steps did not move any cell
+	REQUIRE(readFile("steps_threads_1_initial.xml") != reference);
+	REQUIRE(readFile("steps_threads_4_initial.xml") == readFile("steps_threads_1_initial.xml"));
+}
+
+TEST_CASE("Mesh statistics read back from CSV and binary files", "[MeshExport]") {
+	CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+	IDManager::getInstance()->reset();
+
+	CPOP_Loader loader;
+	auto* env = loader.load3DEnvironment("population.xml", true);
+	REQUIRE(env);
+	int error;
+	auto* mesh = MeshFactory::getInstance()->create_3DMesh(&error, dynamic_cast<t_SimulatedSubEnv_3*>(env->getFirstChild()), MeshTypes::Round_Cell_Tesselation, 100, 0);
+	REQUIRE(mesh);
+
+	// a few cells of the population are enough
+	std::vector<const t_Cell_3*> cells;
+	for(auto const* cell : mesh->getCellsWithShape()) {
+		cells.push_back(cell);
+		if(cells.size() == 10)
+			break;
+	}
+	REQUIRE(cells.size() == 10);
+
+	Statistics::MeshStatsTable table = Statistics::computeMeshStats(cells, MeshOutFormats::OFF, Statistics::ALL_METRICS);
+	REQUIRE(table.getNbNucleus() > 0);
+	REQUIRE(!table.cellDescriptionValues.empty());
+	REQUIRE(!table.nucleusDescriptionValues.empty());
+
+	std::map<std::string, std::vector<double>> cellValues = {
+		{"cellMeshVolume", table.cellMeshVolumes},
+		{"cytoplasmMeshVolume", table.cytoplasmMeshVolumes},
+		{"cellMeshSurface", table.cellMeshSurfaces},
+		{"nbNuclei", {}}
+	};
+	for(std::size_t iCell = 0; iCell < table.getNbCell(); ++iCell)
+		cellValues["nbNuclei"].push_back(static_cast<double>(table.nucleiOffsets[iCell + 1] - table.nucleiOffsets[iCell]));
+	std::map<std::string, std::vector<double>> nucleusValues = {{"meshVolume", table.nucleusMeshVolumes}, {"CellID", {}}};
+	for(auto id : table.nucleusCellIDs)
+		nucleusValues["CellID"].push_back(static_cast<double>(id));
+
+	std::vector<std::string> cellNames;
+	std::stringstream cellHeader(table.cellDescriptionHeader);
+	for(std::string name; std::getline(cellHeader, name, '\t');)
+		cellNames.push_back(trim(name));
+	REQUIRE(cellNames.size() == table.cellDescriptionValues.size());
+	for(std::size_t iField = 0; iField < cellNames.size(); ++iField)
+		cellValues[cellNames[iField]] = table.cellDescriptionValues[iField];
+	REQUIRE(table.nucleusDescriptionValues.size() == 1);
+	nucleusValues[trim(table.nucleusDescriptionHeader)] = table.nucleusDescriptionValues.front();
+
+	// the CSV keeps 6 significant digits, the binary file the computed values
+	auto check = [](StatsColumns const& pColumns, std::map<std::string, std::vector<double>> const& pExpected, std::size_t pNbRow, bool pExact) {
+		REQUIRE(pColumns.nbRow == pNbRow);
+		REQUIRE(pColumns.names.size() == pExpected.size());
+		for(auto const& [name, expected] : pExpected) {
+			INFO("column " << name);
+			REQUIRE(pColumns.values.count(name) == 1);
+			auto const& values = pColumns.values.at(name);
+			REQUIRE(values.size() == pNbRow);
+			for(std::size_t iRow = 0; iRow < pNbRow; ++iRow) {
+				if(pExact)
+					REQUIRE(values[iRow] == expected[iRow]);
+				else
+					REQUIRE(values[iRow] == Approx(expected[iRow]).epsilon(1e-5).margin(1e-6));
+			}
+		}
+	};
+
+	std::stringstream cellCSV, nucleiCSV, cellBinary, nucleiBinary;
+	REQUIRE(Statistics::writeCellStats(table, MeshOutFormats::OFF, Statistics::CSV, cellCSV));
+	REQUIRE(Statistics::writeNucleiStats(table, MeshOutFormats::OFF, Statistics::CSV, nucleiCSV));
+	REQUIRE(Statistics::writeCellStats(table, MeshOutFormats::OFF, Statistics::BINARY, cellBinary));
+	REQUIRE(Statistics::writeNucleiStats(table, MeshOutFormats::OFF, Statistics::BINARY, nucleiBinary));
+
+	StatsColumns cellColumns = readStatsCSV(cellCSV.str());
+	check(cellColumns, cellValues, table.getNbCell(), false);
+	check(readStatsCSV(nucleiCSV.str()), nucleusValues, table.getNbNucleus(), false);
+	StatsColumns cellBinaryColumns = readStatsBinary(cellBinary.str(), MeshOutFormats::OFF);
+	check(cellBinaryColumns, cellValues, table.getNbCell(), true);
+	check(readStatsBinary(nucleiBinary.str(), MeshOutFormats::OFF), nucleusValues, table.getNbNucleus(), true);
+
+	// both files have the same columns, the cell IDs are exact in both
+	REQUIRE(cellBinaryColumns.names == cellColumns.names);
+	for(std::size_t iCell = 0; iCell < table.getNbCell(); ++iCell) {
+		REQUIRE(cellColumns.values.at(cellNames.front())[iCell] == static_cast<double>(table.cellIDs[iCell]));
+		REQUIRE(cellBinaryColumns.values.at(cellNames.front())[iCell] == static_cast<double>(table.cellIDs[iCell]));
+	}
+
+	delete mesh;
+}
+
+TEST_CASE("Frozen meshes give the polyhedron geometry", "[MeshExport]") {
+	CLHEP::MTwistEngine engine(1234567);
+	RandomEngineManager::getInstance()->setEngine(&engine);
+	IDManager::getInstance()->reset();
+
+	CPOP_Loader loader;
+	auto* env = loader.load3DEnvironment("population.xml", true);
+	REQUIRE(env);
+	int error;
+	auto* mesh = MeshFactory::getInstance()->create_3DMesh(&error, dynamic_cast<t_SimulatedSubEnv_3*>(env->getFirstChild()), MeshTypes::Round_Cell_Tesselation, 100, 0);
+	REQUIRE(mesh);
+
+	std::mt19937 generator(1234567);
+	std::size_t nbTested = 0;
+	for(auto* meshedCell : mesh->getCellsWithShape()) {
+		auto* cell = dynamic_cast<SpheroidalCell*>(meshedCell);
+		REQUIRE(cell);
+		REQUIRE(!cell->isMeshFrozen());
+
+		// the polyhedron path, before freezing
+		Polyhedron_3 shape = *cell->getShape();
+		Point_3 origin = cell->getPosition();
+		double radius = cell->getRadius();
+		double volume = cell->getMeshVolume(MeshOutFormats::OFF);
+		double surface = cell->getMembraneMeshSurfaceArea();
+		std::uniform_real_distribution<double> coordinate(-radius, radius);
+		std::vector<Point_3> points;
+		std::vector<bool> polyhedronHasIn;
+		for(int iPoint = 0; iPoint < 1000; ++iPoint) {
+			points.emplace_back(origin.x() + coordinate(generator), origin.y() + coordinate(generator), origin.z() + coordinate(generator));
+			polyhedronHasIn.push_back(cell->hasIn(points.back()));
+		}
+
+		cell->freezeMesh();
+		REQUIRE(cell->isMeshFrozen());
+
+		// the vertices are rounded to float
+		double tolerance = 1e-5*(radius + std::sqrt(CGAL::squared_distance(origin, CGAL::ORIGIN)));
+		REQUIRE(cell->getMeshVolume(MeshOutFormats::OFF) == Approx(volume).epsilon(1e-4));
+		REQUIRE(cell->getMembraneMeshSurfaceArea() == Approx(surface).epsilon(1e-4));
+
+		for(std::size_t iPoint = 0; iPoint < points.size(); ++iPoint) {
+			if(cell->hasIn(points[iPoint]) != polyhedronHasIn[iPoint])
+				REQUIRE(std::abs(signedDistance(shape, origin, points[iPoint])) < tolerance);
+		}
+
+		std::vector<Point_3> spots;
+		cell->getSpotsOnOrganelle(_CYTOPLASM, 100, spots);
+		for(int iSpot = 0; iSpot < 100; ++iSpot)
+			spots.push_back(cell->getSpotOnCytoplasm());
+		for(auto const& spot : spots)
+			REQUIRE(signedDistance(shape, origin, spot) < tolerance);
+		for(int iSpot = 0; iSpot < 100; ++iSpot)
+			REQUIRE(std::abs(signedDistance(shape, origin, cell->getSpotOnCellMembrane())) < tolerance);
+
+		if(++nbTested == 20)
+			break;
+	}
+	REQUIRE(nbTested == 20);
+
+	delete mesh;
+}
@@ -1,10 +1,39 @@
 #include "catch.hpp"
 
+#include <algorithm>
+#include <set>
+
 #include "G4UImanager.hh"
 
+#include "DistributedSource.hh"
 #include "Population.hh"
 #include "SpheroidRegion.hh"
 #include "RandomEngineManager.hh"
+#include "RoundNucleus.hh"
+
+namespace {
+
+/// \brief load population.xml, meshed on demand or not, and define its regions
+void loadPopulation(cpop::Population& population, bool lazy_meshing) {
+	population.setPopulation_file("population.xml");
+	population.setVerbose_level(0);
+	population.setNumber_max_facet_poly(100);
+	population.setDelta_reffinement(0);
+	population.setLazy_meshing(lazy_meshing);
+	population.loadPopulation();
+	population.setInternal_layer_ratio(0.25);
+	population.setIntermediary_layer_ratio(0.75);
+	population.setNumber_sampling_cell_per_region(10);
+	population.defineRegion();
+}
+
+const RoundNucleus<double, Point_3, Vector_3>* getNucleus(const Settings::nCell::t_Cell_3* cell) {
+	auto const* nucleus = dynamic_cast<const RoundNucleus<double, Point_3, Vector_3>*>(cell->getNuclei().front());
+	REQUIRE(nucleus);
+	return nucleus;
+}
+
+}
 
 TEST_CASE("Population test", "[Population]") {
 	CLHEP::MTwistEngine defaultEngineCPOP(1234567);
@@ -98,6 +127,36 @@ TEST_CASE("Spheroid region test", "[Population]") {
 		REQUIRE(sampled_cells.size() == 10);
 	}
 
+	SECTION("Sampling. sorted indices") {
+		auto const& sampled_cells = necrosis.sample(10);
+		auto const& indices = necrosis.sampled_indices();
+		REQUIRE(indices.size() == 10);
+		REQUIRE(std::is_sorted(indices.begin(), indices.end()));
+		REQUIRE(std::adjacent_find(indices.begin(), indices.end()) == indices.end());
+		for(std::size_t i = 0; i < indices.size(); ++i) {
+			REQUIRE(sampled_cells[i] == necrosis.cells_in_region()[indices[i]]);
+			REQUIRE(necrosis.isSampled(sampled_cells[i]));
+		}
+	}
+
+	SECTION("Sampling. reproducible") {
+		CLHEP::MTwistEngine engine(42);
+		RandomEngineManager::getInstance()->setEngine(&engine);
+		auto first = necrosis.sampleNCells(10);
+		engine.setSeed(42, 0);
+		auto second = necrosis.sampleNCells(10);
+		REQUIRE(first == second);
+		RandomEngineManager::getInstance()->setEngine(&defaultEngineCPOP);
+	}
+
+	SECTION("Sampling. large population") {
+		auto indices = cpop::SpheroidRegion::sampleSortedIndices(1000000, 100000);
+		REQUIRE(indices.size() == 100000);
+		REQUIRE(std::is_sorted(indices.begin(), indices.end()));
+		REQUIRE(std::adjacent_find(indices.begin(), indices.end()) == indices.end());
+		REQUIRE(indices.back() < 1000000);
+	}
+
 	SECTION("Sampling. No sampling") {
 		auto sampled_cells = necrosis.sample();
 		REQUIRE(sampled_cells.size() == 14);
@@ -152,9 +211,251 @@ TEST_CASE("Spheroid region in population", "[Population]")  {
 		auto sampled_cells = population.sampled_cells();
 		REQUIRE(sampled_cells.size() == 30);
 	}
+
+	SECTION("Region. Cell tags") {
+		population.setInternal_layer_ratio(0.25);
+		population.setIntermediary_layer_ratio(0.75);
+		population.setNumber_sampling_cell_per_region(10);
+		REQUIRE_NOTHROW(population.defineRegion());
+
+		auto const& regions = population.regions();
+		for(auto const* cell : population.sampled_cells()) {
+			REQUIRE(population.is_sampled(cell));
+			const cpop::SpheroidRegion* region = population.region(cell);
+			REQUIRE(region != nullptr);
+			REQUIRE(region->isInRegion(cell));
+			REQUIRE(region->isSampled(cell));
+		}
+
+		std::size_t nbSampled = 0;
+		for(auto const* cell : population.cells()) {
+			const cpop::SpheroidRegion* region = population.region(cell);
+			if(region)
+				REQUIRE(region == &regions[population.cell_tag(population.cell_index(cell)).region]);
+			nbSampled += population.is_sampled(cell);
+		}
+		REQUIRE(nbSampled == population.sampled_cells().size());
+	}
 }
 
 
+TEST_CASE("Cytoplasm sampling", "[Population]") {
+	CLHEP::MTwistEngine defaultEngineCPOP(1234567);
+	RandomEngineManager::getInstance()->setEngine(&defaultEngineCPOP);
+
+	cpop::Population population;
+	population.setPopulation_file("population.xml");
+	population.setVerbose_level(0);
+	population.setNumber_max_facet_poly(100);
+	population.setDelta_reffinement(0);
+	population.loadPopulation();
+
+	auto const& cells = population.cells();
+	REQUIRE(!cells.empty());
+
+	SECTION("Spots are in the cytoplasm") {
+		for(auto const* cell : cells) {
+			for(int i = 0; i < 100; ++i) {
+				auto spot = cell->getSpotOnOrganelle(CellComposition::_CYTOPLASM);
+				REQUIRE(cell->hasIn(spot));
+				REQUIRE(!cell->hasInNucleoplasm(spot));
+			}
+		}
+	}
+
+	SECTION("Batch generation") {
+		std::vector<Settings::Geometry::Point_3> spots;
+		cells.front()->getSpotsOnOrganelle(CellComposition::_CYTOPLASM, 1000, spots);
+		REQUIRE(spots.size() == 1000);
+		for(auto const& spot : spots) {
+			REQUIRE(cells.front()->hasIn(spot));
+			REQUIRE(!cells.front()->hasInNucleoplasm(spot));
+		}
+	}
+}
+
+TEST_CASE("Cell location", "[Population]") {
+	CLHEP::MTwistEngine defaultEngineCPOP(1234567);
+	RandomEngineManager::getInstance()->setEngine(&defaultEngineCPOP);
+
+	cpop::Population population;
+	loadPopulation(population, false);
+
+	SECTION("Empty location") {
+		cpop::CellLocation location;
+		REQUIRE(!location.in_cell());
+		REQUIRE(!location.in_nucleus());
+		REQUIRE(!location.in_cytoplasm());
+		REQUIRE(population.region_name(location.region).empty());
+	}
+
+	SECTION("Organelle names") {
+		REQUIRE(cpop::organelle_name(CellComposition::_NUCLEOPLASM) == "nucleus");
+		REQUIRE(cpop::organelle_name(CellComposition::_CYTOPLASM) == "cytoplasm");
+	}
+
+	SECTION("Nucleus and cytoplasm of the sampled cells") {
+		std::vector<Settings::Geometry::Point_3> spots;
+		for(auto const* cell : population.sampled_cells()) {
+			std::size_t index = population.cell_index(cell);
+			REQUIRE(population.cells()[index] == cell);
+
+			cpop::CellLocation inNucleus = population.locate(cell, getNucleus(cell)->getOrigin());
+			REQUIRE(inNucleus.cell_index == index);
+			REQUIRE(inNucleus.in_nucleus());
+			REQUIRE(!inNucleus.in_cytoplasm());
+			REQUIRE(inNucleus.nucleus_index == 0);
+			REQUIRE(inNucleus.organelle == CellComposition::_NUCLEOPLASM);
+			REQUIRE(inNucleus.region == population.cell_tag(index).region);
+			REQUIRE(population.region_name(inNucleus.region) == population.region(cell)->name());
+
+			spots.clear();
+			cell->getSpotsOnOrganelle(CellComposition::_CYTOPLASM, 20, spots);
+			for(auto const& spot : spots) {
+				cpop::CellLocation inCytoplasm = population.locate(cell, spot);
+				REQUIRE(inCytoplasm.cell_index == index);
+				REQUIRE(inCytoplasm.in_cytoplasm());
+				REQUIRE(inCytoplasm.nucleus_index == cpop::CellLocation::noNucleus);
+				REQUIRE(inCytoplasm.organelle == CellComposition::_CYTOPLASM);
+				REQUIRE(inCytoplasm.region == inNucleus.region);
+			}
+		}
+	}
+}
+
+TEST_CASE("Lazy meshing gives the eager population", "[Population]") {
+	CLHEP::MTwistEngine defaultEngineCPOP(1234567);
+	RandomEngineManager::getInstance()->setEngine(&defaultEngineCPOP);
+	cpop::Population eager;
+	loadPopulation(eager, false);
+
+	// cell ids differ between two loads but not their order, cells are compared by index
+	defaultEngineCPOP.setSeed(1234567, 0);
+	cpop::Population lazy;
+	loadPopulation(lazy, true);
+
+	auto const& eagerCells = eager.cells();
+	auto const& lazyCells = lazy.cells();
+	REQUIRE(lazy.lazy_meshing());
+	REQUIRE(lazyCells.size() == eagerCells.size());
+	REQUIRE(lazy.spheroid_radius() == Approx(eager.spheroid_radius()));
+
+	SECTION("Same cells and nuclei") {
+		for(std::size_t iCell = 0; iCell < eagerCells.size(); ++iCell) {
+			REQUIRE(lazyCells[iCell]->getPosition() == eagerCells[iCell]->getPosition());
+			auto const* eagerNucleus = getNucleus(eagerCells[iCell]);
+			auto const* lazyNucleus = getNucleus(lazyCells[iCell]);
+			REQUIRE(lazyNucleus->getRadius() == Approx(eagerNucleus->getRadius()));
+			REQUIRE(CGAL::squared_distance(lazyNucleus->getOrigin(), eagerNucleus->getOrigin()) == Approx(0.).margin(1e-12));
+		}
+	}
+
+	SECTION("Same regions and sampling") {
+		REQUIRE(lazy.regions().size() == eager.regions().size());
+		for(std::size_t iRegion = 0; iRegion < eager.regions().size(); ++iRegion) {
+			REQUIRE(lazy.regions()[iRegion].name() == eager.regions()[iRegion].name());
+			REQUIRE(lazy.regions()[iRegion].cells_in_region().size() == eager.regions()[iRegion].cells_in_region().size());
+		}
+
+		for(std::size_t iCell = 0; iCell < eagerCells.size(); ++iCell) {
+			REQUIRE(lazy.cell_tag(iCell).region == eager.cell_tag(iCell).region);
+			REQUIRE(lazy.cell_tag(iCell).sampled == eager.cell_tag(iCell).sampled);
+		}
+
+		REQUIRE(lazy.sampled_cells().size() == eager.sampled_cells().size());
+		for(std::size_t iSampled = 0; iSampled < eager.sampled_cells().size(); ++iSampled)
+			REQUIRE(lazy.cell_index(lazy.sampled_cells()[iSampled]) == eager.cell_index(eager.sampled_cells()[iSampled]));
+	}
+
+	SECTION("Only the sampled cells are meshed") {
+		std::size_t nbSampled = 0;
+		for(auto const* cell : lazyCells) {
+			REQUIRE(cell->hasMesh() == lazy.is_sampled(cell));
+			nbSampled += lazy.is_sampled(cell);
+		}
+		REQUIRE(lazy.nb_meshed_cells() == nbSampled);
+		REQUIRE(lazy.ensure_mesh(lazyCells.front()));
+		REQUIRE(lazyCells.front()->hasMesh());
+	}
+
+	SECTION("Same location of points in the sampled cells") {
+		std::vector<Settings::Geometry::Point_3> spots;
+		for(auto const* eagerCell : eager.sampled_cells()) {
+			std::size_t index = eager.cell_index(eagerCell);
+			auto const* lazyCell = lazyCells[index];
+
+			spots.clear();
+			eagerCell->getSpotsOnOrganelle(CellComposition::_CYTOPLASM, 20, spots);
+			spots.push_back(getNucleus(eagerCell)->getOrigin());
+			for(auto const& spot : spots) {
+				REQUIRE(lazyCell->hasIn(spot) == eagerCell->hasIn(spot));
+				cpop::CellLocation eagerLocation = eager.locate(eagerCell, spot);
+				cpop::CellLocation lazyLocation = lazy.locate(lazyCell, spot);
+				REQUIRE(lazyLocation.cell_index == eagerLocation.cell_index);
+				REQUIRE(lazyLocation.organelle == eagerLocation.organelle);
+				REQUIRE(lazyLocation.nucleus_index == eagerLocation.nucleus_index);
+				REQUIRE(lazyLocation.region == eagerLocation.region);
+			}
+		}
+	}
+}
+
+TEST_CASE("Labeled cells and sources per cell", "[Population]") {
+	CLHEP::MTwistEngine defaultEngineCPOP(1234567);
+	RandomEngineManager::getInstance()->setEngine(&defaultEngineCPOP);
+
+	cpop::Population population;
+	loadPopulation(population, false);
+	cpop::DistributedSource source("source", population);
+
+	SECTION("Labeled cells are distinct cells of the region") {
+		for(auto const& region : population.regions()) {
+			auto const& cells_in_region = region.cells_in_region();
+			auto labeled_cells = source.chooseLabeledCells(0.5f, region);
+			REQUIRE(labeled_cells.size() == static_cast<std::size_t>(0.5f*cells_in_region.size()));
+			REQUIRE(std::set<const Settings::nCell::t_Cell_3*>(labeled_cells.begin(), labeled_cells.end()).size() == labeled_cells.size());
+			for(auto const* cell : labeled_cells)
+				REQUIRE(region.isInRegion(cell));
+
+			REQUIRE(source.chooseLabeledCells(1.f, region) == cells_in_region);
+		}
+	}
+
+	SECTION("Sources respect the maximum number per cell") {
+		auto const& regions = population.regions();
+		auto external = std::find_if(regions.begin(), regions.end(), [](const cpop::SpheroidRegion& region) { return region.name() == "External"; });
+		REQUIRE(external != regions.end());
+		std::size_t nb_labeled_cells = external->cells_in_region().size()/2;
+		REQUIRE(nb_labeled_cells > 0);
+
+		// two sources per labeled cell on average, at most three in a cell
+		const int max_source_per_cell = 3;
+		const int nb_source = static_cast<int>(2*nb_labeled_cells);
+		source.setNumber_source_necrosis(0);
+		source.setNumber_source_intermediary(0);
+		source.setNumber_source_external(nb_source);
+		source.setCell_Labeling_Percentage_necrosis(0);
+		source.setCell_Labeling_Percentage_intermediary(0);
+		source.setCell_Labeling_Percentage_external(50);
+		source.setMax_number_source_per_cell_external(max_source_per_cell);
+		source.setNumber_particles_per_source(1);
+		source.setOrganelle_weight(0., 1., 0., 0.);
+		source.Initialize();
+
+		int nb_distributed = 0;
+		std::set<const Settings::nCell::t_Cell_3*> source_cells;
+		for(auto const& cell_sources : source.sources()) {
+			REQUIRE(cell_sources.number_source() > 0);
+			REQUIRE(cell_sources.number_source() <= max_source_per_cell);
+			REQUIRE(external->isInRegion(cell_sources.cell()));
+			REQUIRE(source_cells.insert(cell_sources.cell()).second);
+			nb_distributed += cell_sources.number_source();
+		}
+		REQUIRE(nb_distributed == nb_source);
+		REQUIRE(source_cells.size() <= nb_labeled_cells);
+	}
+}
+
 TEST_CASE("Population messenger", "[Population]") {
 	CLHEP::MTwistEngine defaultEngineCPOP(1234567);
 	RandomEngineManager::getInstance()->setEngine(&defaultEngineCPOP);
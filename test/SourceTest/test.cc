@@ -85,7 +85,7 @@ TEST_CASE("Uniform source", "[source]") {
 
         G4ThreeVector point;
         for(int i = 0; i < number_particle; ++i) {
-            point = (source.GetPosition()).front();
+            point = source.GetPosition();
             file << point.x() << " " << point.y() << " " << point.z() << "\n";
             source.Update();
 
@@ -191,7 +191,7 @@ TEST_CASE("Distributed source, [source]") {
         REQUIRE(source.HasLeft());
         G4ThreeVector point;
         for(int i = 0; i < totalSecondaries; ++i) {
-            point = (source.GetPosition()).front();
+            point = source.GetPosition();
             file << point.x() << " " << point.y() << " " << point.z() << "\n";
             source.Update();
 
@@ -202,4 +202,38 @@ TEST_CASE("Distributed source, [source]") {
         file.close();
 
     }
+
+    SECTION("Positions") {
+        cpop::Population population;
+        std::string base_name = "/cpop";
+        population.messenger().BuildCommands(base_name);
+
+        cpop::DistributedSource source{"gadolinium", population};
+        G4String base = "/cpop/source/" + source.source_name();
+        source.messenger().BuildCommands(base);
+
+        std::string macro = "nanoparticle2.mac";
+        G4UImanager* UImanager = G4UImanager::GetUIpointer();
+        G4String command = "/control/execute ";
+        UImanager->ApplyCommand(command+macro);
+
+        source.Initialize();
+
+        // one position per source, shared by all the particles of the source
+        int number_source = 0;
+        for(auto const& info : source.sources())
+            number_source += info.number_source();
+        REQUIRE(source.number_position() == static_cast<std::size_t>(number_source));
+
+        for(auto const& info : source.sources()) {
+            std::size_t index = info.positionIndex();
+            REQUIRE(index < source.number_position());
+            REQUIRE(source.position(index) == source.GetPosition());
+
+            for(int i = 0; i < info.number_source()*source.number_particles_per_source(); ++i)
+                source.Update();
+        }
+
+        REQUIRE(!source.HasLeft());
+    }
 }
@@ -0,0 +1,166 @@
+#include "catch.hpp"
+
+#include "G4Box.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Electron.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TouchableHistory.hh"
+#include "G4Track.hh"
+
+#include "CGAL_Utils.hh"
+#include "Population.hh"
+#include "RandomEngineManager.hh"
+#include "RoundNucleus.hh"
+#include "StepMax.hh"
+
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+constexpr double default_limit = 10.*um;
+constexpr double region_limit = 1.*um;
+constexpr double nucleus_limit = 2.*um;
+constexpr double cytoplasm_limit = 0.5*um;
+constexpr double outside_limit = 5.*um;
+
+/// \brief a world holding an envelope around the spheroid, gives tracks a touchable as during a run
+class Geometry {
+public:
+	Geometry() {
+		G4Material* water = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
+		_worldBox = std::make_unique<G4Box>("World", 1.*m, 1.*m, 1.*m);
+		_worldLogical = std::make_unique<G4LogicalVolume>(_worldBox.get(), water, "World");
+		_world = std::make_unique<G4PVPlacement>(nullptr, G4ThreeVector(), _worldLogical.get(), "World", nullptr, false, 0);
+		_envelopeBox = std::make_unique<G4Box>("Envelope", 1.*mm, 1.*mm, 1.*mm);
+		_envelopeLogical = std::make_unique<G4LogicalVolume>(_envelopeBox.get(), water, "Envelope");
+		_envelope = std::make_unique<G4PVPlacement>(nullptr, G4ThreeVector(), _envelopeLogical.get(), "Envelope", _worldLogical.get(), false, 0);
+		_navigator.SetWorldVolume(_world.get());
+	}
+
+	/// \brief return the limit proposed by the process to an electron at the position, in G4 unit
+	G4double proposedStep(cpop::StepMax& process, const G4ThreeVector& position) {
+		_navigator.LocateGlobalPointAndSetup(position);
+		G4Track track(new G4DynamicParticle(G4Electron::Definition(), G4ThreeVector(1., 0., 0.), 1.*MeV), 0., position);
+		track.SetTouchableHandle(G4TouchableHandle(_navigator.CreateTouchableHistory()));
+
+		G4ForceCondition condition;
+		return process.PostStepGetPhysicalInteractionLength(track, 0., &condition);
+	}
+
+private:
+	std::unique_ptr<G4Box> _worldBox;
+	std::unique_ptr<G4LogicalVolume> _worldLogical;
+	std::unique_ptr<G4PVPlacement> _world;
+	std::unique_ptr<G4Box> _envelopeBox;
+	std::unique_ptr<G4LogicalVolume> _envelopeLogical;
+	std::unique_ptr<G4PVPlacement> _envelope;
+	G4Navigator _navigator;
+};
+
+const cpop::SpheroidRegion& findRegion(const cpop::Population& population, const std::string& name) {
+	auto const& regions = population.regions();
+	auto region = std::find_if(regions.begin(), regions.end(), [&name](const cpop::SpheroidRegion& r) { return r.name() == name; });
+	REQUIRE(region != regions.end());
+	return *region;
+}
+
+G4ThreeVector toG4Vector(const Point_3& point) {
+	Point_3 g4Point = Utils::myCGAL::to_G4(point);
+	return G4ThreeVector(g4Point.x(), g4Point.y(), g4Point.z());
+}
+
+/// \brief point at the given distance from the spheroid centroid, along x
+G4ThreeVector atDistance(const cpop::Population& population, double distance) {
+	auto centroid = population.spheroid_centroid();
+	return G4ThreeVector(centroid.x() + distance, centroid.y(), centroid.z());
+}
+
+}
+
+TEST_CASE("Step limits in the population", "[StepMax]") {
+	CLHEP::MTwistEngine defaultEngineCPOP(1234567);
+	RandomEngineManager::getInstance()->setEngine(&defaultEngineCPOP);
+
+	cpop::Population population;
+	population.setPopulation_file("population.xml");
+	population.setVerbose_level(0);
+	population.setNumber_max_facet_poly(100);
+	population.setDelta_reffinement(0);
+	population.loadPopulation();
+	population.setInternal_layer_ratio(0.25);
+	population.setIntermediary_layer_ratio(0.75);
+	population.setNumber_sampling_cell_per_region(10);
+	population.defineRegion();
+
+	const cpop::SpheroidRegion& intermediary = findRegion(population, "Intermediary");
+	const cpop::SpheroidRegion& external = findRegion(population, "External");
+	double spheroidRadius = population.spheroid_radius();
+
+	Geometry geometry;
+	cpop::StepMax process;
+	process.SetMaxStep(default_limit);
+	process.SetPopulation(&population);
+	process.SetMaxStepInRegion("External", region_limit);
+
+	SECTION("Region beats default") {
+		// far from the region boundaries, the limit is not clamped
+		double middleExternal = 0.5*(external.internal_radius() + external.external_radius());
+		REQUIRE(geometry.proposedStep(process, atDistance(population, middleExternal)) == Approx(region_limit));
+
+		double middleIntermediary = 0.5*(intermediary.internal_radius() + intermediary.external_radius());
+		REQUIRE(geometry.proposedStep(process, atDistance(population, middleIntermediary)) == Approx(default_limit));
+	}
+
+	SECTION("Outside limit") {
+		process.SetMaxStepOutside(outside_limit);
+		REQUIRE(geometry.proposedStep(process, atDistance(population, spheroidRadius + 100.*um)) == Approx(outside_limit));
+		// close to the spheroid, the step stops at the surface
+		REQUIRE(geometry.proposedStep(process, atDistance(population, spheroidRadius + 3.*um)) == Approx(3.*um));
+	}
+
+	SECTION("Steps are clamped to the distance to the next region, not below the finest limit") {
+		// the finest limit is the region one
+		double boundary = intermediary.external_radius();
+		REQUIRE(geometry.proposedStep(process, atDistance(population, boundary - 3.*um)) == Approx(3.*um));
+		REQUIRE(geometry.proposedStep(process, atDistance(population, boundary - 0.3*um)) == Approx(region_limit));
+
+		process.SetMaxStepOutside(outside_limit);
+		REQUIRE(geometry.proposedStep(process, atDistance(population, spheroidRadius + 0.3*um)) == Approx(region_limit));
+	}
+
+	SECTION("Organelle beats region") {
+		// the nucleus limit is larger than the region one, the cytoplasm limit is the finest one
+		process.SetMaxStepInOrganelle("nucleus", nucleus_limit);
+		process.SetMaxStepInOrganelle("cytoplasm", cytoplasm_limit);
+
+		Point_3 centroid = population.spheroid_centroid();
+		G4ThreeVector spheroidCenter(centroid.x(), centroid.y(), centroid.z());
+		std::size_t nbTested = 0;
+		for(auto const* cell : population.sampled_cells()) {
+			if(population.region(cell) != &external)
+				continue;
+
+			auto const* nucleus = dynamic_cast<const RoundNucleus<double, Point_3, Vector_3>*>(cell->getNuclei().front());
+			REQUIRE(nucleus);
+			G4ThreeVector nucleusCenter = toG4Vector(nucleus->getOrigin());
+			// the step would be clamped by the distance to the region boundary
+			double distToCenter = (nucleusCenter - spheroidCenter).mag();
+			if(distToCenter - external.internal_radius() < nucleus_limit || external.external_radius() - distToCenter < nucleus_limit)
+				continue;
+			REQUIRE(geometry.proposedStep(process, nucleusCenter) == Approx(nucleus_limit));
+
+			// just outside the nucleus, much closer to this cell than to its neighbors
+			Point_3 nucleusSurface = nucleus->getOrigin() + Vector_3(nucleus->getRadius(), 0., 0.);
+			G4ThreeVector inCytoplasm = toG4Vector(nucleusSurface) + G4ThreeVector(0.5*um, 0., 0.);
+			REQUIRE(population.locate(cell, Utils::myCGAL::to_CPOP(inCytoplasm)).in_cytoplasm());
+			REQUIRE(geometry.proposedStep(process, inCytoplasm) == Approx(cytoplasm_limit));
+			++nbTested;
+		}
+		REQUIRE(nbTested > 0);
+	}
+}
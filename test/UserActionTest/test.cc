@@ -1,6 +1,4 @@
-#include "Cell_Utils.hh"
-#include "Octree.hh"
-#include "OctreeNodeForSpheroidalCell.hh"
+#include "LinearOctree.hh"
 #include "catch.hpp"
 
 #include <chrono>
@@ -42,11 +40,9 @@ TEST_CASE("Stepping action", "[UserAction]") {
 		std::vector<const Settings::nCell::t_Cell_3*> sampled_cells = population.sampled_cells();
 		std::vector<const Settings::nAgent::t_SpatialableAgent_3*> spatialables(sampled_cells.begin(), sampled_cells.end());
 
-		int nbCellPerNode = 2000;
-		auto octree = std::make_unique<Octree<OctreeNodeForSpheroidalCell>>(
-			Utils::getBoundingBox(spatialables.begin(), spatialables.end()),
-			&spatialables,
-			nbCellPerNode);
+		// as built by SteppingAction
+		auto octree = std::make_unique<LinearOctree>();
+		octree->build(spatialables.begin(), spatialables.end());
 
 		int number_particle = 1000000;
 		source.setTotal_particle(number_particle);
@@ -58,7 +54,7 @@ TEST_CASE("Stepping action", "[UserAction]") {
 		auto start = std::chrono::system_clock::now();
 		G4ThreeVector pt;
 		for(int i = 0; i < number_particle; ++i) {
-			pt = (source.GetPosition()).front();
+			pt = source.GetPosition();
 			source.Update();
 			Point_3 point = Utils::myCGAL::to_CPOP(pt);
 			const t_SpatialableAgent_3* lNearestAgent = octree->getNearestSpatialableAgent(point);
@@ -89,11 +85,9 @@ TEST_CASE("Stepping action", "[UserAction]") {
 		std::vector<const Settings::nCell::t_Cell_3*> sampled_cells = population.sampled_cells();
 		std::vector<const Settings::nAgent::t_SpatialableAgent_3*> spatialables(sampled_cells.begin(), sampled_cells.end());
 
-		int nbCellPerNode = 2000;
-		auto octree = std::make_unique<Octree<OctreeNodeForSpheroidalCell>>(
-			Utils::getBoundingBox(spatialables.begin(), spatialables.end()),
-			&spatialables,
-			nbCellPerNode);
+		// as built by SteppingAction
+		auto octree = std::make_unique<LinearOctree>();
+		octree->build(spatialables.begin(), spatialables.end());
 
 		int number_particle = 1000000;
 		source.setTotal_particle(number_particle);
@@ -108,7 +102,7 @@ TEST_CASE("Stepping action", "[UserAction]") {
 		std::cout << "Starting simulation" << std::endl;
 		auto start = std::chrono::system_clock::now();
 		for(int i = 0; i < number_particle; ++i) {
-			pt = (source.GetPosition()).front();
+			pt = source.GetPosition();
 			source.Update();
 			Point_3 point = Utils::myCGAL::to_CPOP(pt);
 
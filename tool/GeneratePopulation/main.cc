@@ -22,6 +22,7 @@ See LICENSE.md for further details
 
 // Header containing everything required to create a population
 #include "simulationEnvironment.hh"
+#include "ThreadPool.hh"
 
 using namespace zz;
 
@@ -38,6 +39,21 @@ int main(int argc, char** argv) {
 	std::string input;
 	auto inputArg = argparser.add_opt_value('f', "", input, std::string("input_filename.cfg"), "configuration file", "file").require();
 	
+	// Run every stage on a shared pool of threads. Specify option --threads <n>. This is optional.
+	// The generated population is the same whatever the number of threads.
+	int nbThread;
+	argparser.add_opt_value(-1, "threads", nbThread, 0, "number of threads of the deterministic parallel mode", "int");
+	
+	// Write a binary checkpoint every n steps of the simulation. Specify options --checkpoint <file> --checkpoint-every <n>.
+	// A simulation stopped before its end can be restarted from the last checkpoint with --restart <file>,
+	// using the same configuration file. This is optional.
+	std::string checkpoint;
+	argparser.add_opt_value(-1, "checkpoint", checkpoint, std::string(""), "checkpoint file written during the simulation", "file");
+	int checkpointEvery;
+	argparser.add_opt_value(-1, "checkpoint-every", checkpointEvery, 100, "number of steps between two checkpoints", "int");
+	std::string restart;
+	argparser.add_opt_value(-1, "restart", restart, std::string(""), "checkpoint to restart the simulation from", "file");
+	
 	//Retrieve arguments from command line
 	argparser.parse(argc, argv);
 	
@@ -73,6 +89,10 @@ int main(int argc, char** argv) {
 	 * delete reader;
 	 * delete myObject;
 	 */
+	// The thread pool is shared by all the stages, so it is set before parsing
+	if (nbThread > 0)
+		ThreadPool::getInstance()->setNbThread(static_cast<unsigned int>(nbThread));
+	
 	conf::ConfigReader<SimulationEnvironment>* reader = new conf::ConfigReader<SimulationEnvironment>();
     reader->addSection<UnitSection>();
     reader->addSection<CellSection>();
@@ -86,22 +106,36 @@ int main(int argc, char** argv) {
 	// SimulationEnvironment contains everything required to create a cell population
 	// (documentation in simulationEnvironment.hh and simulationEnvironment.cc)
     SimulationEnvironment* simulationEnv = reader->parse(input.c_str());
+    if (nbThread > 0)
+		simulationEnv->setParallel(static_cast<unsigned int>(nbThread));
+    
+    if (!checkpoint.empty() && checkpointEvery > 0)
+		simulationEnv->setCheckpoint(checkpoint, static_cast<unsigned long int>(checkpointEvery));
+    if (!restart.empty())
+		simulationEnv->setRestart(restart);
     
     // Start the simulation to apply elastic force
-    simulationEnv->startSimulation();
+    if (!simulationEnv->startSimulation()) {
+		std::cout << "Failed to restart from " << restart << std::endl;
+		delete reader;
+		delete simulationEnv;
+		exit(-1);
+	}
     
     // Save the generated cell population in an xml file
     std::string outputPop = basename + ".xml";
-    simulationEnv->savePopulation(outputPop.c_str());
+    simulationEnv->savePopulation(outputPop);
     std::cout << "Generated : "<< outputPop << std::endl;
     
     // If vis flag is used, create an off file
     if (vis) {
 		std::string outputOff = basename + ".off";
-		simulationEnv->exportToVis(basename.c_str());
+		simulationEnv->exportToVis(basename);
 		std::cout << "Generated : "<< outputOff << std::endl;
 	}
     
+    simulationEnv->printTimingReport(std::cout);
+    
     
     delete reader;
     delete simulationEnv;
@@ -1,6 +1,9 @@
 #include "simulationEnvironment.hh"
 #include "Delaunay_3D_SDS.hh"
 #include "MaterialManager.hh"
+#include "ThreadPool.hh"
+
+#include <iomanip>
 
 SimulationEnvironment::SimulationEnvironment() {
 
@@ -19,11 +22,15 @@ SimulationEnvironment::SimulationEnvironment() {
 
 	// simulation
 	platform = nullptr;
+	deterministic = false;
+	checkpointAction = nullptr;
+	checkpointNbStep = 0;
 
 }
 
 SimulationEnvironment::~SimulationEnvironment() {
 
+	if (checkpointAction) delete checkpointAction;
 	if (cellProperties) delete cellProperties;
 	if (env)            delete env;
 	if (platform)       delete platform;
@@ -78,7 +85,8 @@ void SimulationEnvironment::setCellProperties(double minRadiusNucleus, double ma
 
 }
 
-void SimulationEnvironment::setSpheroidProperties(double internalRadius, double externalRadius, int nbCell) {
+void SimulationEnvironment::setSpheroidProperties(double internalRadius, double externalRadius, int nbCell,
+												  bool bulkDistribution, double minimalDistance) {
 	// setup the main environment
 	env = new t_Environment_3("main Environment");
 	Point_3 center(0., 0., 0.);
@@ -88,15 +96,23 @@ void SimulationEnvironment::setSpheroidProperties(double internalRadius, double
 	simulatedEnv = new t_SimulatedSubEnv_3(env, "MySimulatedSubEnv", static_cast<t_SpatialDelimitation_3*>(subEnvSD));
 
 	// generate cells
-	CLHEP::MTwistEngine defaultEngine(1234567);
+	// the engine is still used by the simulation, the random draws stay sequential to keep them reproducible
+	static CLHEP::MTwistEngine defaultEngine(1234567);
 	RandomEngineManager::getInstance()->setEngine(&defaultEngine);
 
+	auto start = std::chrono::steady_clock::now();
+
 	std::map<LifeCycles::LifeCycle, double> rates = Utils::generateUniformLifeCycle();
 	/// 3.1 get the distribution
 	ADistribution<double, Point_3, Vector_3>* distribution = DistributionFactory::getInstance()->getDistribution<double, Point_3, Vector_3>(Distribution::RANDOM);
+	if (auto* randomDistribution = dynamic_cast<RandomCellDistribution<double, Point_3, Vector_3>*>(distribution)) {
+		randomDistribution->setBulk(bulkDistribution);
+		randomDistribution->setMinimalDistance(minimalDistance*metricSystem);
+	}
 	/// 3.2 distribute
 	distribution->distribute(simulatedEnv, cellProperties, nbCell, rates);
 	delete distribution;
+	addStageDuration("distribution", start);
 }
 
 void SimulationEnvironment::setMeshProperties(int nOfFacetPerCell) {
@@ -105,6 +121,7 @@ void SimulationEnvironment::setMeshProperties(int nOfFacetPerCell) {
 }
 
 void SimulationEnvironment::setForceProperties(double ratioToStableLength, double rigidity) {
+	auto start = std::chrono::steady_clock::now();
 	int error;
 	// get the generated cells
 	t_Mesh_3* voronoiMesh = MeshFactory::getInstance()->create_3DMesh(&error, simulatedEnv, MeshTypes::Round_Cell_Tesselation, numberOfFacetPerCell);
@@ -117,6 +134,7 @@ void SimulationEnvironment::setForceProperties(double ratioToStableLength, doubl
 		auto* elasForce = new t_ElasticForce_3(lCell, rigidity, ratioToStableLength);
 		lCell->addForce(elasForce);
 	}
+	addStageDuration("forces", start);
 }
 
 void SimulationEnvironment::setSimulationProperties(double duration, int numberOfAgentToExecute,
@@ -133,23 +151,84 @@ void SimulationEnvironment::setSimulationProperties(double duration, int numberO
 	platform->setDuration(duration);
 	platform->setDisplacementThreshold(displacementThreshold);
 	platform->limiteNbAgentToSimulate(numberOfAgentToExecute);
+	platform->setDeterministic(deterministic);
+
+}
+
+void SimulationEnvironment::setParallel(unsigned int nbThread) {
+	ThreadPool::getInstance()->setNbThread(nbThread);
+	deterministic = true;
+	if (platform) platform->setDeterministic(true);
+}
+
+void SimulationEnvironment::setCheckpoint(const std::string& filename, unsigned long int nbStep) {
+	checkpointFile = filename;
+	checkpointNbStep = nbStep;
+}
 
+void SimulationEnvironment::setRestart(const std::string& filename) {
+	restartFile = filename;
 }
 
-void SimulationEnvironment::startSimulation() {
+bool SimulationEnvironment::startSimulation() {
 	/// 4.3 set the adapted spatial data structure permitting agent to know their neighbors)
 	simulatedEnv->addSpatialDataStructure(new Delaunay_3D_SDS( " my spatial data structure"));
 
+	// the population has been regenerated from the configuration file, the checkpoint replaces its state
+	// and the one of the random engine
+	if (!restartFile.empty()) {
+		auto start = std::chrono::steady_clock::now();
+		IO::CPOP::CheckpointInfo info;
+		if (!IO::CPOP::loadCheckpoint(simulatedEnv, restartFile, &info))
+			return false;
+		platform->resumeFrom(info.step, info.time);
+		std::cout << "Restarting from step " << info.step << " (" << info.time << " s)" << std::endl;
+		addStageDuration("restart", start);
+	}
+
+	if (!checkpointFile.empty() && checkpointNbStep > 0 && !checkpointAction)
+		checkpointAction = new IO::CPOP::CheckpointAction(simulatedEnv, checkpointFile, checkpointNbStep);
+
+	auto start = std::chrono::steady_clock::now();
 	platform->startSimulation();
+	addStageDuration("simulation", start);
+	return true;
 }
 
 void SimulationEnvironment::savePopulation(std::string const& filename) {
+	auto start = std::chrono::steady_clock::now();
 	IO::CPOP::save(static_cast<Writable*>(env), filename.c_str());
+	addStageDuration("save", start);
 }
 
 void SimulationEnvironment::exportToVis(std::string const& filename) {
+	auto start = std::chrono::steady_clock::now();
 	int error;
 	t_Mesh_3* voronoiMesh = MeshFactory::getInstance()->create_3DMesh(&error, simulatedEnv, MeshTypes::Round_Cell_Tesselation, numberOfFacetPerCell);
+	addStageDuration("meshing", start);
+
+	start = std::chrono::steady_clock::now();
 	voronoiMesh->exportToFile(filename, MeshOutFormats::OFF);
 	delete voronoiMesh;
+	addStageDuration("export", start);
+}
+
+void SimulationEnvironment::addStageDuration(const std::string& stage, std::chrono::steady_clock::time_point start) {
+	std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+	stageDurations.emplace_back(stage, duration.count());
+}
+
+void SimulationEnvironment::printTimingReport(std::ostream& out) const {
+	// the caller's formatting is restored once the report is written
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	double total = 0.;
+	out << "Timing report (" << ThreadPool::getInstance()->getNbThread() << " thread(s)" << (deterministic ? ", deterministic" : "") << ")" << std::endl;
+	for(auto const& stage : stageDurations) {
+		out << "  " << std::left << std::setw(14) << stage.first << std::right << std::fixed << std::setprecision(3) << stage.second << " s" << std::endl;
+		total += stage.second;
+	}
+	out << "  " << std::left << std::setw(14) << "total" << std::right << std::fixed << std::setprecision(3) << total << " s" << std::endl;
+	out.flags(flags);
+	out.precision(precision);
 }
@@ -17,6 +17,7 @@ See LICENSE.md for further details
 #include <DistributionFactory.hh>	// used to distribute cell inside the sub environment
 #include <ElasticForce.hh>			// The type of force we want to apply
 #include <MASPlatform.hh>			// THe platform used to manage agent ( cell ) execution
+#include <File_CPOP_Checkpoint.hh>	// binary checkpoints of the simulation
 #include <File_CPOP_Data.hh>		// CPOP tools for saving files
 #include <MeshFactory.hh>			// used to get the reuested mesh
 #include <RandomEngineManager.hh>	// manager used to generate Random numbers
@@ -26,8 +27,12 @@ See LICENSE.md for further details
 
 #include <CLHEP/Random/MTwistEngine.h>
 
+#include <chrono>
 #include <map>
+#include <ostream>
 #include <set>
+#include <utility>
+#include <vector>
 
 using namespace Settings::nCell;
 using namespace Settings::nEnvironment;
@@ -46,6 +51,18 @@ class SimulationEnvironment {
 	int numberOfFacetPerCell;
 	// Simulation properties
 	MASPlatform* platform;
+	// true if the agents are run on the shared thread pool
+	bool deterministic;
+	// checkpoint written during the simulation
+	IO::CPOP::CheckpointAction* checkpointAction;
+	std::string checkpointFile;
+	unsigned long int checkpointNbStep;
+	// checkpoint the simulation restarts from
+	std::string restartFile;
+	// duration of each stage, in seconds
+	std::vector<std::pair<std::string, double>> stageDurations;
+	
+	void addStageDuration(const std::string& stage, std::chrono::steady_clock::time_point start);
 	
 	G4Material* parseMaterial(const char* material);
 	
@@ -59,21 +76,36 @@ class SimulationEnvironment {
 						   double minRadiusMembrane, double maxRadiusMembrane,
 						   const std::string& cytoplasmMaterials,
 						   const std::string& nucleusMaterials);
-	void setSpheroidProperties(double internalRadius, double externalRadius, int nbCell);
+	// with bulkDistribution, the positions are drawn first and the cells are added in one batch,
+	// at least minimalDistance apart if it is not 0
+	void setSpheroidProperties(double internalRadius, double externalRadius, int nbCell,
+							   bool bulkDistribution = false, double minimalDistance = 0.);
 	void setMeshProperties(int nOfFacetPerCell);
 	void setForceProperties(double ratioToStableLength, double rigidity);
 	void setSimulationProperties(double duration, int numberOfAgentToExecute, 
 								 double displacementThreshold,
 								 double stepDuration);
 								 
-	// start the simulation
-	void startSimulation();
+	// run every stage on the shared thread pool with nbThread threads,
+	// the generated population does not depend on the number of threads
+	void setParallel(unsigned int nbThread);
+								 
+	// write a checkpoint every nbStep steps of the simulation
+	void setCheckpoint(const std::string& filename, unsigned long int nbStep);
+	// restart the simulation from a checkpoint written by a run of the same configuration file
+	void setRestart(const std::string& filename);
+								 
+	// start the simulation, return false if the restart checkpoint can't be loaded
+	bool startSimulation();
 						
 	// save the population
-	void savePopulation(const char* filename);
+	void savePopulation(const std::string& filename);
 	
 	// export to off format to visualise the population 		 
-	void exportToVis(const char* filename);
+	void exportToVis(const std::string& filename);
+	
+	// print the duration of each stage
+	void printTimingReport(std::ostream& out) const;
 };
 
 #endif
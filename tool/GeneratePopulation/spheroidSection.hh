@@ -60,8 +60,15 @@ public:
 		double externalRadius = this->template load<double>(sectionName, "externalRadius");
 		int nbCell = this->template load<int>(sectionName, "nbCell");
 		
+		// optional keys, cells are distributed one by one without them
+		bool bulkDistribution = false;
+		if (this->check((*this->getParser())(sectionName)["bulkDistribution"]))
+			bulkDistribution = this->template load<bool>(sectionName, "bulkDistribution");
+		double minimalDistance = 0.;
+		if (this->check((*this->getParser())(sectionName)["minimalDistance"]))
+			minimalDistance = this->template load<double>(sectionName, "minimalDistance");
 		
-		this->objToFill->setSpheroidProperties(internalRadius, externalRadius, nbCell);
+		this->objToFill->setSpheroidProperties(internalRadius, externalRadius, nbCell, bulkDistribution, minimalDistance);
     }
 };
 